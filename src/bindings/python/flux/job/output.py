@@ -12,6 +12,8 @@ import base64
 import errno
 from typing import NamedTuple
 
+from flux.constants import FLUX_NODEID_ANY
+from flux.core.inner import ffi, raw
 from flux.future import FutureExt
 from flux.idset import IDset
 from flux.job import (
@@ -83,6 +85,39 @@ class Taskset:
         return str(self.ids)
 
 
+class _BlobCache:
+    """
+    Cache of the most recently loaded output blob, since consecutive
+    output events usually refer to the same blob.  Blobs are content
+    addressed, so the cache may be shared by all handles.
+    """
+
+    blobref = None
+    data = None
+
+    @classmethod
+    def load(cls, flux_handle, blobref):
+        if blobref != cls.blobref:
+            digest = bytes.fromhex(blobref.partition("-")[2])
+            future = raw.flux_rpc_raw(
+                flux_handle,
+                "content.load",
+                ffi.from_buffer(digest),
+                len(digest),
+                FLUX_NODEID_ANY,
+                0,
+            )
+            try:
+                buf = ffi.new("void *[1]")
+                size = ffi.new("size_t [1]")
+                raw.flux_rpc_get_raw(future, buf, size)
+                cls.data = bytes(ffi.buffer(buf[0], size[0]))
+                cls.blobref = blobref
+            finally:
+                raw.flux_future_destroy(future)
+        return cls.data
+
+
 class OutputEvent(EventLogEvent):
     """
     Object representing RFC 24 Job Standard I/O data events
@@ -92,11 +127,15 @@ class OutputEvent(EventLogEvent):
         rank (Taskset): Set of ranks to which this event applies
         stream (str): name of output stream ("stdout", "stderr")
         eof (bool): True if this event marks EOF for stream
-        data (str): output data
+        data (str): output data. If data is stored in a blob, it is loaded
+            when ``flux_handle`` is provided, otherwise data is None
+        blobref (str): content store blob holding data, if any
+        offset (int): offset of data in blob
+        len (int): length of data in blob
         dict (dict): original event as dict
     """
 
-    def __init__(self, entry, labelio=False):
+    def __init__(self, entry, labelio=False, flux_handle=None):
         super().__init__(entry)
         if self.name != "data":
             raise ValueError(f"event {self.name} is not a data event")
@@ -105,10 +144,14 @@ class OutputEvent(EventLogEvent):
         self.stream = self.context["stream"]
         self.data = None
         self.eof = False
+        self.blobref = self.context.get("blobref")
+        self.offset = self.context.get("offset", 0)
+        self.len = self.context.get("len", 0)
 
         if "eof" in self.context:
             self.eof = self.context["eof"]
 
+        data = None
         if "data" in self.context:
             data = self.context["data"]
             if "encoding" in self.context:
@@ -118,6 +161,14 @@ class OutputEvent(EventLogEvent):
                     )
             if "repeat" in self.context:
                 data *= self.context["repeat"]
+        elif self.blobref and flux_handle is not None:
+            blob = _BlobCache.load(flux_handle, self.blobref)
+            if self.offset + self.len > len(blob):
+                raise ValueError(f"output blob {self.blobref} is too short")
+            data = blob[self.offset : self.offset + self.len].decode(
+                "utf-8", errors="surrogateescape"
+            )
+        if data is not None:
             if labelio:
                 data = [f"{self.rank}: {x}" for x in data.splitlines()]
                 data = "\n".join(data) + "\n"
@@ -270,11 +321,12 @@ class JobOutput(NamedTuple):
     log: str
 
 
-def _parse_output_eventlog_entry(entry, labelio=False):
+def _parse_output_eventlog_entry(entry, labelio=False, flux_handle=None):
     """
     Parse a single output eventlog entry, returning an object of the
     appropriate type: OutputEvent, LogEvent, OutputHeaderEvent,
-    RedirectEvent or JobExceptionEvent.
+    RedirectEvent or JobExceptionEvent.  If ``flux_handle`` is set, it
+    is used to load output data stored in blobs.
     """
     if entry is None:
         return None
@@ -284,7 +336,7 @@ def _parse_output_eventlog_entry(entry, labelio=False):
         event = EventLogEvent(entry)
     name = event.name
     if name == "data":
-        return OutputEvent(event, labelio)
+        return OutputEvent(event, labelio, flux_handle)
     elif name == "log":
         return LogEvent(event)
     elif name == "header":
@@ -298,7 +350,12 @@ def _parse_output_eventlog_entry(entry, labelio=False):
 
 
 def _output_eventlog_entry_decode(
-    entry, stream_dict, tasks, labelio=False, log_stderr_level=LOG_TRACE
+    entry,
+    stream_dict,
+    tasks,
+    labelio=False,
+    log_stderr_level=LOG_TRACE,
+    flux_handle=None,
 ):
     """
     Decode RFC 24 output eventlog entry ``entry``, appending the result
@@ -308,7 +365,7 @@ def _output_eventlog_entry_decode(
     """
     if not isinstance(tasks, Taskset):
         raise ValueError("tasks argument must be a Taskset, got " + type(tasks))
-    event = _parse_output_eventlog_entry(entry, labelio)
+    event = _parse_output_eventlog_entry(entry, labelio, flux_handle)
 
     #  Determine stream name of this event:
     stream = None
@@ -334,7 +391,7 @@ def _output_eventlog_entry_decode(
 
 
 def _parse_output_eventlog(
-    eventlog, tasks="*", labelio=False, log_stderr_level=LOG_TRACE
+    eventlog, tasks="*", labelio=False, log_stderr_level=LOG_TRACE, flux_handle=None
 ):
     """
     Given an eventlog, return a JobOutput tuple with stdout, stderr,
@@ -345,7 +402,7 @@ def _parse_output_eventlog(
 
     for line in eventlog.splitlines():
         _output_eventlog_entry_decode(
-            line, stream_dict, tasks, labelio, log_stderr_level
+            line, stream_dict, tasks, labelio, log_stderr_level, flux_handle
         )
 
     # Join lines and return result
@@ -407,7 +464,7 @@ def job_output(
             msg = f"job {jobid} does not exist or output not ready"
             raise FileNotFoundError(msg)
         return _parse_output_eventlog(
-            eventlog["guest.output"], tasks, labelio, log_stderr_level
+            eventlog["guest.output"], tasks, labelio, log_stderr_level, flux_handle
         )
 
     stream_dict = {"stdout": [], "stderr": [], "log": []}
@@ -429,7 +486,7 @@ def job_output(
     #  Output eventlog is ready, synchronously gather all output
     for event in event_watch(flux_handle, jobid, "guest.output"):
         _output_eventlog_entry_decode(
-            event, stream_dict, tasks, labelio, log_stderr_level
+            event, stream_dict, tasks, labelio, log_stderr_level, flux_handle
         )
 
     #  Join lines and return JobOutput result
@@ -464,7 +521,9 @@ class JobOutputEventWatch(FutureExt):
             return None
         if autoreset:
             self.reset()
-        return _parse_output_eventlog_entry(event, labelio=self.labelio)
+        return _parse_output_eventlog_entry(
+            event, labelio=self.labelio, flux_handle=self.get_flux()
+        )
 
     def _watch_output(self, future):
         #  Watch output events and propagate to output_watch_future.
@@ -20,6 +20,7 @@
 #include "src/common/libutil/iterators.h"
 #include "src/common/libutil/errprintf.h"
 #include "src/common/libutil/errno_safe.h"
+#include "src/common/librouter/subtrie.h"
 #include "ccan/str/str.h"
 #include "ccan/array_size/array_size.h"
 
@@ -31,6 +32,7 @@
 
 struct modhash {
     zhash_t *zh_byuuid;
+    struct subtrie *subscriptions;  // topic prefix => module_t
     flux_msg_handler_t **handlers;
     struct broker *ctx;
     struct flux_msglist *trace_requests;
@@ -195,6 +197,7 @@ static int modhash_add (modhash_t *mh, module_t *p)
 {
     if (module_aux_set (p, "modhash", mh, NULL) < 0)
         return -1;
+    module_set_subtrie (p, mh->subscriptions);
     /* always succeeds - uuids are by definition unique */
     (void)zhash_insert (mh->zh_byuuid, module_get_uuid (p), p);
     zhash_freefn (mh->zh_byuuid,
@@ -979,7 +982,8 @@ modhash_t *modhash_create (struct broker *ctx)
     if (flux_msg_handler_addvec (ctx->h, htab, ctx, &mh->handlers) < 0
         || !(mh->trace_requests = flux_msglist_create ()))
         goto error;
-    if (!(mh->zh_byuuid = zhash_new ())) {
+    if (!(mh->zh_byuuid = zhash_new ())
+        || !(mh->subscriptions = subtrie_create ())) {
         errno = ENOMEM;
         goto error;
     }
@@ -1015,6 +1019,7 @@ int modhash_destroy (modhash_t *mh)
             }
             zhash_destroy (&mh->zh_byuuid);
         }
+        subtrie_destroy (mh->subscriptions);
         flux_msg_handler_delvec (mh->handlers);
         flux_msglist_destroy (mh->trace_requests);
         flux_future_destroy (mh->f_builtins_load);
@@ -1100,29 +1105,44 @@ module_t *modhash_lookup_byname (modhash_t *mh, const char *name)
     return NULL;
 }
 
+struct mcast_arg {
+    modhash_t *mh;
+    const flux_msg_t *msg;
+    int errnum;
+};
+
+/* subtrie_match_f footprint */
+static void event_mcast_cb (void *subscriber, void *arg)
+{
+    module_t *p = subscriber;
+    struct mcast_arg *ma = arg;
+    flux_msg_t *cpy;
+
+    if (ma->errnum)
+        return;
+    trace_module_msg (ma->mh->ctx->h,
+                      "rx",
+                      module_get_name (p),
+                      ma->mh->trace_requests,
+                      ma->msg);
+    if (!(cpy = flux_msg_copy (ma->msg, true))
+        || module_sendmsg_new (p, &cpy) < 0) {
+        ma->errnum = errno;
+        flux_msg_decref (cpy);
+    }
+}
+
 int modhash_event_mcast (modhash_t *mh, const flux_msg_t *msg)
 {
+    struct mcast_arg ma = { .mh = mh, .msg = msg };
     const char *topic;
-    module_t *p;
 
-    if (flux_msg_get_topic (msg, &topic) < 0)
+    if (flux_msg_get_topic (msg, &topic) < 0
+        || subtrie_match (mh->subscriptions, topic, event_mcast_cb, &ma) < 0)
+        return -1;
+    if (ma.errnum) {
+        errno = ma.errnum;
         return -1;
-    p = zhash_first (mh->zh_byuuid);
-    while (p) {
-        if (module_is_subscribed (p, topic)) {
-            trace_module_msg (mh->ctx->h,
-                              "rx",
-                              module_get_name (p),
-                              mh->trace_requests,
-                              msg);
-            flux_msg_t *cpy;
-            if (!(cpy = flux_msg_copy (msg, true))
-                || module_sendmsg_new (p, &cpy) < 0) {
-                flux_msg_decref (cpy);
-                return -1;
-            }
-        }
-        p = zhash_next (mh->zh_byuuid);
     }
     return 0;
 }
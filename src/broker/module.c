@@ -29,6 +29,7 @@
 #include "src/common/libutil/aux.h"
 #include "src/common/libutil/basename.h"
 #include "src/common/librouter/subhash.h"
+#include "src/common/librouter/subtrie.h"
 #include "src/common/librouter/rpc_track.h"
 #include "ccan/str/str.h"
 
@@ -82,6 +83,7 @@ struct broker_module {
     struct disconnect *disconnect;
     struct flux_msglist *deferred_messages;
     struct subhash *sub;
+    struct subtrie *index;
 };
 
 void *module_thread (void *arg); // defined in module_thread.c
@@ -726,6 +728,27 @@ bool module_is_subscribed (module_t *p, const char *topic)
     return subhash_topic_match (p->sub, topic);
 }
 
+/* subhash subscribe_f footprint - first reference to 'topic' */
+static int module_index_add (const char *topic, void *arg)
+{
+    module_t *p = arg;
+    return subtrie_add (p->index, topic, p);
+}
+
+/* subhash subscribe_f footprint - last reference to 'topic' */
+static int module_index_remove (const char *topic, void *arg)
+{
+    module_t *p = arg;
+    return subtrie_remove (p->index, topic, p);
+}
+
+void module_set_subtrie (module_t *p, struct subtrie *index)
+{
+    p->index = index;
+    subhash_set_subscribe (p->sub, module_index_add, p);
+    subhash_set_unsubscribe (p->sub, module_index_remove, p);
+}
+
 ssize_t module_get_send_queue_count (module_t *p)
 {
     size_t count;
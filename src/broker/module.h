@@ -15,6 +15,7 @@
 #include <flux/core.h>
 
 #include "src/common/librouter/disconnect.h"
+#include "src/common/librouter/subtrie.h"
 
 /* Module states, for embedding in keepalive messages (rfc 5)
  */
@@ -132,6 +133,12 @@ int module_subscribe (module_t *p, const char *topic);
 int module_unsubscribe (module_t *p, const char *topic);
 bool module_is_subscribed (module_t *p, const char *topic);
 
+/* Mirror module subscriptions in a subtrie shared by all modules, with
+ * the module_t as subscriber.  Call before the module subscribes to
+ * anything.  The subtrie must outlive the module.
+ */
+void module_set_subtrie (module_t *p, struct subtrie *index);
+
 ssize_t module_get_send_queue_count (module_t *p);
 ssize_t module_get_recv_queue_count (module_t *p);
 
@@ -171,6 +171,86 @@ static int internal_content_dropcache (optparse_t *p, int ac, char *av[])
     return (0);
 }
 
+static double ratio (json_int_t raw, json_int_t stored)
+{
+    return stored > 0 ? (double)raw / stored : 1.;
+}
+
+static int internal_content_compression (optparse_t *p, int ac, char *av[])
+{
+    flux_t *h;
+    flux_future_t *f = NULL;
+    json_t *codecs;
+    size_t index;
+    json_t *entry;
+    json_int_t total_count = 0;
+    json_int_t total_raw = 0;
+    json_int_t total_stored = 0;
+
+    if (optparse_option_index (p) != ac) {
+        optparse_print_usage (p);
+        exit (1);
+    }
+    if (!(h = builtin_get_flux_handle (p)))
+        log_err_exit ("flux_open");
+    if (!(f = flux_rpc (h, "content-backing.compression-stats", NULL, 0, 0))
+        || flux_rpc_get_unpack (f, "{s:o}", "codecs", &codecs) < 0)
+        log_msg_exit ("content-backing.compression-stats: %s",
+                      future_strerror (f, errno));
+    if (optparse_hasopt (p, "json")) {
+        char *s = json_dumps (codecs, JSON_COMPACT);
+        printf ("%s\n", s);
+        free (s);
+        goto done;
+    }
+    if (!optparse_hasopt (p, "no-header")) {
+        printf ("%-8s %4s %12s %14s %14s %6s\n",
+                "CODEC",
+                "DICT",
+                "OBJECTS",
+                "RAW",
+                "STORED",
+                "RATIO");
+    }
+    json_array_foreach (codecs, index, entry) {
+        const char *codec;
+        int dict;
+        json_int_t count;
+        json_int_t raw;
+        json_int_t stored;
+
+        if (json_unpack (entry,
+                         "{s:s s:i s:I s:I s:I}",
+                         "codec", &codec,
+                         "dict", &dict,
+                         "count", &count,
+                         "raw_bytes", &raw,
+                         "stored_bytes", &stored) < 0)
+            log_msg_exit ("error parsing compression stats");
+        printf ("%-8s %4d %12jd %14jd %14jd %6.2f\n",
+                codec,
+                dict,
+                (intmax_t)count,
+                (intmax_t)raw,
+                (intmax_t)stored,
+                ratio (raw, stored));
+        total_count += count;
+        total_raw += raw;
+        total_stored += stored;
+    }
+    printf ("%-8s %4s %12jd %14jd %14jd %6.2f\n",
+            "total",
+            "",
+            (intmax_t)total_count,
+            (intmax_t)total_raw,
+            (intmax_t)total_stored,
+            ratio (total_raw, total_stored));
+done:
+    flux_future_destroy (f);
+    flux_close (h);
+    return (0);
+}
+
 static void checkpoint_list_output_header (void)
 {
     printf ("%-10s %-10s %-20s %s\n",
@@ -363,6 +443,14 @@ static struct optparse_option store_opts[] = {
       OPTPARSE_TABLE_END
 };
 
+static struct optparse_option compression_opts[] = {
+    { .name = "no-header",  .key = 'n',  .has_arg = 0,
+      .usage = "Do not output column headers", },
+    { .name = "json",  .key = 'j',  .has_arg = 0,
+      .usage = "Output raw json compression statistics", },
+      OPTPARSE_TABLE_END
+};
+
 static struct optparse_subcommand content_subcmds[] = {
     { "load",
       "[OPTIONS] BLOBREF ...",
@@ -392,6 +480,13 @@ static struct optparse_subcommand content_subcmds[] = {
       0,
       NULL,
     },
+    { "compression",
+      "[OPTIONS]",
+      "Report compression ratios achieved by the backing store",
+      internal_content_compression,
+      0,
+      compression_opts,
+    },
     { "checkpoint",
       NULL,
       "Perform checkpoint operations",
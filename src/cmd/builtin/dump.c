@@ -380,35 +380,48 @@ static void dump_dir (struct archive *ar,
     }
 }
 
+/* A dirref has one blobref referencing a dir, or is sharded (see
+ * treeobj_is_dirref_sharded()) with each blobref referencing a dir or
+ * another sharded dirref.  The entries of all shards are dumped under
+ * 'path'.
+ */
 static void dump_dirref (struct archive *ar,
                          flux_t *h,
                          const char *path,
                          json_t *treeobj)
 {
-    flux_future_t *f;
-    const void *buf;
-    size_t buflen;
-    json_t *treeobj_deref = NULL;
+    bool sharded = treeobj_is_dirref_sharded (treeobj);
+    int count = treeobj_get_count (treeobj);
 
-    if (treeobj_get_count (treeobj) != 1)
+    if (count != 1 && !sharded)
         log_msg_exit ("%s: blobref count is not 1", path);
-    if (!(f = content_load_byblobref (h,
-                                      treeobj_get_blobref (treeobj, 0),
-                                      content_flags))
-        || content_load_get (f, &buf, &buflen) < 0) {
-        read_error ("%s: missing blobref: %s",
-                    path,
-                    future_strerror (f, errno));
+    for (int i = 0; i < count; i++) {
+        flux_future_t *f;
+        const void *buf;
+        size_t buflen;
+        json_t *treeobj_deref = NULL;
+
+        if (!(f = content_load_byblobref (h,
+                                          treeobj_get_blobref (treeobj, i),
+                                          content_flags))
+            || content_load_get (f, &buf, &buflen) < 0) {
+            read_error ("%s: missing blobref: %s",
+                        path,
+                        future_strerror (f, errno));
+            flux_future_destroy (f);
+            return;
+        }
+        if (!(treeobj_deref = treeobj_decodeb (buf, buflen)))
+            log_err_exit ("%s: could not decode directory", path);
+        if (treeobj_is_dir (treeobj_deref))
+            dump_dir (ar, h, path, treeobj_deref); // recurse
+        else if (sharded && treeobj_is_dirref_sharded (treeobj_deref))
+            dump_dirref (ar, h, path, treeobj_deref); // recurse
+        else
+            log_msg_exit ("%s: dirref references non-directory", path);
+        json_decref (treeobj_deref);
         flux_future_destroy (f);
-        return;
     }
-    if (!(treeobj_deref = treeobj_decodeb (buf, buflen)))
-        log_err_exit ("%s: could not decode directory", path);
-    if (!treeobj_is_dir (treeobj_deref))
-        log_msg_exit ("%s: dirref references non-directory", path);
-    dump_dir (ar, h, path, treeobj_deref); // recurse
-    json_decref (treeobj_deref);
-    flux_future_destroy (f);
 }
 
 static void dump_treeobj (struct archive *ar,
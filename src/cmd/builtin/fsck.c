@@ -74,6 +74,10 @@ static void fsck_treeobj (struct fsck_ctx *ctx,
 
 static void valref_validate (struct fsck_valref_data *fvd);
 
+static json_t *lookup_dir_from_dirref (struct fsck_ctx *ctx,
+                                       const char *path,
+                                       json_t *treeobj);
+
 static void vmsg (struct fsck_ctx *ctx, const char *fmt, va_list ap)
 {
     char buf[128];
@@ -235,31 +239,15 @@ static json_t *get_dir (struct fsck_ctx *ctx,
     }
     else {
         if (treeobj_is_dirref (o)) {
-            flux_future_t *f;
-            const char *ref;
-            int refcount;
-            json_t *subdir, *subdirtmp;
-            const void *data;
-            size_t size;
-
-            if ((refcount = treeobj_get_count (o)) < 0
-                || refcount != 1
-                || !(ref = treeobj_get_blobref (o, 0)))
-                log_err_exit ("cannot get dirref blobref");
-
-            if (!(f = content_load_byblobref (ctx->h,
-                                              ref,
-                                              CONTENT_FLAG_CACHE_BYPASS))
-                || content_load_get (f, &data, &size) < 0)
-                log_err_exit ("failed to load treeobj dir");
-
-            /* deep copy b/c we may be modifying it */
-            if (!(subdirtmp = treeobj_decodeb (data, size))
-                || !(subdir = treeobj_deep_copy (subdirtmp))
-                || treeobj_insert_entry (treeobj_dir, dir_name, subdir) < 0)
+            json_t *subdir;
+
+            /* N.B. a sharded dirref is converted to a single dir */
+            if (!(subdir = lookup_dir_from_dirref (ctx, dir_name, o)))
+                log_msg_exit ("failed to load treeobj dir");
+            if (treeobj_insert_entry (treeobj_dir, dir_name, subdir) < 0)
                 log_err_exit ("failed to update entry from dirref to dir");
 
-            json_decref (subdirtmp);
+            json_decref (subdir);
             o = subdir;
         }
         else if (!treeobj_is_dir (o)) {
@@ -449,58 +437,72 @@ static void fsck_dir (struct fsck_ctx *ctx,
     }
 }
 
-static void fsck_dirref (struct fsck_ctx *ctx,
-                         const char *path,
-                         json_t *treeobj)
+/* Check a dirref, or each shard of a sharded dirref.  Return -1 if
+ * 'path' was unlinked by a repair and checking should stop, else 0.
+ */
+static int fsck_dirref (struct fsck_ctx *ctx,
+                        const char *path,
+                        json_t *treeobj)
 {
-    flux_future_t *f = NULL;
-    const void *buf;
-    size_t buflen;
-    json_t *treeobj_deref = NULL;
+    bool sharded = treeobj_is_dirref_sharded (treeobj);
     int count;
 
     count = treeobj_get_count (treeobj);
-    if (count != 1) {
+    if (count != 1 && !sharded) {
         errmsg (ctx,
                 "%s: invalid dirref treeobj count=%d",
                 path,
                 count);
         ctx->errorcount++;
-        return;
+        return 0;
     }
-    if (!(f = content_load_byblobref (ctx->h,
-                                      treeobj_get_blobref (treeobj, 0),
-                                      CONTENT_FLAG_CACHE_BYPASS))
-        || content_load_get (f, &buf, &buflen) < 0) {
-        if (errno == ENOENT)
-            errmsg (ctx, "%s: missing dirref blobref", path);
-        else
-            errmsg (ctx,
-                    "%s: error retrieving dirref blobref: %s",
-                    path,
-                    future_strerror (f, errno));
-        ctx->errorcount++;
-        if (ctx->repair && errno == ENOENT) {
-            unlink_path (ctx, path);
-            warn (ctx, "%s unlinked due to missing blobref", path);
-            ctx->unlink_dir_count++;
+    for (int i = 0; i < count; i++) {
+        flux_future_t *f = NULL;
+        const void *buf;
+        size_t buflen;
+        json_t *treeobj_deref = NULL;
+        int rc = 0;
+
+        if (!(f = content_load_byblobref (ctx->h,
+                                          treeobj_get_blobref (treeobj, i),
+                                          CONTENT_FLAG_CACHE_BYPASS))
+            || content_load_get (f, &buf, &buflen) < 0) {
+            if (errno == ENOENT)
+                errmsg (ctx, "%s: missing dirref blobref", path);
+            else
+                errmsg (ctx,
+                        "%s: error retrieving dirref blobref: %s",
+                        path,
+                        future_strerror (f, errno));
+            ctx->errorcount++;
+            if (ctx->repair && errno == ENOENT) {
+                unlink_path (ctx, path);
+                warn (ctx, "%s unlinked due to missing blobref", path);
+                ctx->unlink_dir_count++;
+                rc = -1;
+            }
+            goto next;
         }
-        goto cleanup;
-    }
-    if (!(treeobj_deref = treeobj_decodeb (buf, buflen))) {
-        errmsg (ctx, "%s: could not decode directory", path);
-        ctx->errorcount++;
-        goto cleanup;
-    }
-    if (!treeobj_is_dir (treeobj_deref)) {
-        errmsg (ctx, "%s: dirref references non-directory", path);
-        ctx->errorcount++;
-        goto cleanup;
+        if (!(treeobj_deref = treeobj_decodeb (buf, buflen))) {
+            errmsg (ctx, "%s: could not decode directory", path);
+            ctx->errorcount++;
+            goto next;
+        }
+        if (treeobj_is_dir (treeobj_deref))
+            fsck_dir (ctx, path, treeobj_deref); // recurse
+        else if (sharded && treeobj_is_dirref_sharded (treeobj_deref))
+            rc = fsck_dirref (ctx, path, treeobj_deref); // recurse
+        else {
+            errmsg (ctx, "%s: dirref references non-directory", path);
+            ctx->errorcount++;
+        }
+next:
+        json_decref (treeobj_deref);
+        flux_future_destroy (f);
+        if (rc < 0)
+            return -1;
     }
-    fsck_dir (ctx, path, treeobj_deref); // recurse
-cleanup:
-    json_decref (treeobj_deref);
-    flux_future_destroy (f);
+    return 0;
 }
 
 static void fsck_treeobj (struct fsck_ctx *ctx,
@@ -612,48 +614,81 @@ static json_t *lookup_job_dir (struct fsck_ctx *ctx, const char *job_path)
     return subdir;
 }
 
-static json_t *lookup_dir_from_dirref (struct fsck_ctx *ctx,
-                                       const char *path,
-                                       json_t *treeobj)
+static json_t *load_treeobj (struct fsck_ctx *ctx,
+                             const char *path,
+                             const char *blobref)
 {
-    flux_future_t *f = NULL;
+    flux_future_t *f;
     const void *buf;
     size_t buflen;
-    json_t *treeobj_deref = NULL;
-    int count;
+    json_t *treeobj;
 
-    count = treeobj_get_count (treeobj);
-    if (count != 1) {
-        errmsg (ctx,
-                "%s: invalid dirref treeobj count=%d",
-                path,
-                count);
-        return NULL;
-    }
     if (!(f = content_load_byblobref (ctx->h,
-                                      treeobj_get_blobref (treeobj, 0),
+                                      blobref,
                                       CONTENT_FLAG_CACHE_BYPASS))
         || content_load_get (f, &buf, &buflen) < 0) {
         errmsg (ctx,
                 "%s: error retrieving dirref blobref: %s",
                 path,
                 future_strerror (f, errno));
-        goto cleanup;
+        flux_future_destroy (f);
+        return NULL;
     }
-    if (!(treeobj_deref = treeobj_decodeb (buf, buflen))) {
+    if (!(treeobj = treeobj_decodeb (buf, buflen)))
         errmsg (ctx, "%s: could not decode directory", path);
-        goto cleanup;
-    }
-    if (!treeobj_is_dir (treeobj_deref)) {
-        errmsg (ctx, "%s: dirref references non-directory", path);
-        goto cleanup;
-    }
     flux_future_destroy (f);
-    return treeobj_deref;
+    return treeobj;
+}
 
-cleanup:
-    json_decref (treeobj_deref);
-    flux_future_destroy (f);
+/* Load the dir referenced by a dirref.  The shards of a sharded dirref
+ * are merged into one dir.
+ */
+static json_t *lookup_dir_from_dirref (struct fsck_ctx *ctx,
+                                       const char *path,
+                                       json_t *treeobj)
+{
+    bool sharded = treeobj_is_dirref_sharded (treeobj);
+    json_t *dir = NULL;
+    int count;
+
+    count = treeobj_get_count (treeobj);
+    if (count != 1 && !sharded) {
+        errmsg (ctx,
+                "%s: invalid dirref treeobj count=%d",
+                path,
+                count);
+        return NULL;
+    }
+    for (int i = 0; i < count; i++) {
+        json_t *treeobj_deref;
+
+        if (!(treeobj_deref = load_treeobj (ctx,
+                                            path,
+                                            treeobj_get_blobref (treeobj, i))))
+            goto error;
+        if (sharded && treeobj_is_dirref_sharded (treeobj_deref)) {
+            json_t *tmp = lookup_dir_from_dirref (ctx, path, treeobj_deref);
+            json_decref (treeobj_deref);
+            if (!(treeobj_deref = tmp))
+                goto error;
+        }
+        else if (!treeobj_is_dir (treeobj_deref)) {
+            errmsg (ctx, "%s: dirref references non-directory", path);
+            json_decref (treeobj_deref);
+            goto error;
+        }
+        if (!dir)
+            dir = treeobj_deref;
+        else {
+            if (json_object_update (treeobj_get_data (dir),
+                                    treeobj_get_data (treeobj_deref)) < 0)
+                log_msg_exit ("out of memory");
+            json_decref (treeobj_deref);
+        }
+    }
+    return dir;
+error:
+    json_decref (dir);
     return NULL;
 }
 
@@ -763,6 +763,9 @@ void cmd_get_one (flux_t *h, const char *key, struct lookup_ctx *ctx)
         flags |= FLUX_KVS_WAITCREATE;
     if (optparse_hasopt (ctx->p, "stream"))
         flags |= FLUX_KVS_STREAM;
+    /* fetch the value without base64 encoding if possible */
+    if (optparse_hasopt (ctx->p, "raw") && flags == 0)
+        flags = FLUX_KVS_RAW;
     if (optparse_hasopt (ctx->p, "at")) {
         const char *reference = optparse_get_str (ctx->p, "at", NULL);
         if (!(f = flux_kvs_lookupat (h, flags, key, reference)))
@@ -15,6 +15,7 @@
 #endif
 #include <unistd.h>
 #include <stdio.h>
+#include <string.h>
 #include <jansson.h>
 #include <sys/ioctl.h>
 #include <signal.h>
@@ -31,6 +32,7 @@
 #include "src/common/libeventlog/eventlog.h"
 #include "src/common/libeventlog/formatter.h"
 #include "src/common/libioencode/ioencode.h"
+#include "src/common/libcontent/content.h"
 #include "src/common/libutil/fdutils.h"
 #include "src/common/libsubprocess/fbuf.h"
 #include "src/common/libsubprocess/fbuf_watcher.h"
@@ -155,6 +157,8 @@ struct attach_ctx {
     zlist_t *tail_output;
     int tail_output_len;
     bool sentinel_reached;
+    char *blobref;
+    flux_future_t *blob_f;
 };
 
 struct attach_event {
@@ -241,17 +245,68 @@ void print_eventlog_entry (struct attach_ctx *ctx,
     free (context_s);
 }
 
+/* Prefix each line of 'data' with 'label', since data may hold several
+ * lines if the job shell chunked task output.
+ */
+static void fwrite_labeled (FILE *fp,
+                            const char *label,
+                            const char *data,
+                            int len)
+{
+    while (len > 0) {
+        const char *nl = memchr (data, '\n', len);
+        int n = nl ? nl - data + 1 : len;
+
+        fprintf (fp, "%s: ", label);
+        fwrite (data, n, 1, fp);
+        data += n;
+        len -= n;
+    }
+}
+
+/* Return 'len' bytes at 'offset' in output blob 'blobref'.  Consecutive
+ * data events usually reference the same blob, so the most recently
+ * loaded blob is kept.
+ */
+static const char *output_blob_data (struct attach_ctx *ctx,
+                                     const char *blobref,
+                                     int offset,
+                                     int len)
+{
+    const void *buf;
+    size_t size;
+
+    if (!ctx->blobref || !streq (ctx->blobref, blobref)) {
+        flux_future_destroy (ctx->blob_f);
+        free (ctx->blobref);
+        if (!(ctx->blob_f = content_load_byblobref (ctx->h, blobref, 0))
+            || !(ctx->blobref = strdup (blobref)))
+            log_err_exit ("error loading output blob %s", blobref);
+    }
+    if (content_load_get (ctx->blob_f, &buf, &size) < 0)
+        log_msg_exit ("error loading output blob %s: %s",
+                      blobref,
+                      future_strerror (ctx->blob_f, errno));
+    if ((size_t)offset + len > size)
+        log_msg_exit ("output blob %s is too short", blobref);
+    return (const char *)buf + offset;
+}
+
 static void handle_output_data (struct attach_ctx *ctx, json_t *context)
 {
     FILE *fp;
     const char *stream;
     const char *rank;
+    const char *blobref;
+    const char *buf;
     char *data;
+    int offset;
     int len;
     if (!ctx->output_header_parsed)
         log_msg_exit ("stream data read before header");
     if (iodecode (context, &stream, &rank, &data, &len, NULL) < 0)
         log_msg_exit ("malformed event context");
+    buf = data;
     /*
      * If this process is attached to a pty (ctx->pty_client != NULL)
      *  and output corresponds to rank 0 and the interactive pty is being
@@ -261,14 +316,19 @@ static void handle_output_data (struct attach_ctx *ctx, json_t *context)
         && streq (rank, "0")
         && ctx->pty_capture)
         goto out;
+    if (iodecode_blobref (context, &blobref, &offset, &len) == 0)
+        buf = output_blob_data (ctx, blobref, offset, len);
+    else if (errno != ENOENT)
+        log_msg_exit ("malformed event context");
     if (streq (stream, "stdout"))
         fp = stdout;
     else
         fp = stderr;
     if (len > 0) {
         if (optparse_hasopt (ctx->p, "label-io"))
-            fprintf (fp, "%s: ", rank);
-        fwrite (data, len, 1, fp);
+            fwrite_labeled (fp, rank, buf, len);
+        else
+            fwrite (buf, len, 1, fp);
         /*  If attached to a pty, terminal is in raw mode so a carriage
          *  return will be necessary to return cursor to the start of line.
          */
@@ -1636,6 +1696,8 @@ int cmd_attach (optparse_t *p, int argc, char **argv)
 
     zlist_destroy (&(ctx.tail_output));
     zlist_destroy (&(ctx.stdin_rpcs));
+    flux_future_destroy (ctx.blob_f);
+    free (ctx.blobref);
     flux_watcher_destroy (ctx.sigint_w);
     flux_watcher_destroy (ctx.sigtstp_w);
     flux_watcher_destroy (ctx.stdin_w);
@@ -14,6 +14,8 @@
 #include "config.h"
 #endif
 #include <stdio.h>
+#include <errno.h>
+#include <jansson.h>
 
 #include <flux/core.h>
 #include <flux/optparse.h>
@@ -93,47 +95,49 @@ static int purge_range (optparse_t *p, int argc, char **argv)
     return 0;
 }
 
-static void purge_id_continuation (flux_future_t *f, void *arg)
-{
-    int *count = arg;
-    int tmp;
-    if (flux_rpc_get_unpack (f, "{s:i}", "count", &tmp) < 0)
-        log_msg_exit ("purge: %s", future_strerror (f, errno));
-    (*count) += tmp;
-    flux_future_destroy (f);
-}
-
 static int purge_ids (optparse_t *p, int argc, char **argv)
 {
     int optindex = optparse_option_index (p);
+    int batch = optparse_get_int (p, "batch", 50);
     flux_t *h;
+    flux_future_t *f;
+    json_t *ids;
     int force = 0;
     int total = 0;
-    int i, ids_len;
+    int count;
 
     if (optparse_hasopt (p, "force"))
         force = 1;
     if (!(h = flux_open (NULL, 0)))
         log_err_exit ("flux_open");
-
-    ids_len = argc - optindex;
-    for (i = 0; i < ids_len; i++) {
-        flux_jobid_t id = parse_jobid (argv[optindex + i]);
-        flux_future_t *f;
-        if (!(f = flux_rpc_pack (h,
-                                 "job-manager.purge-id",
-                                 0,
-                                 0,
-                                 "{s:I s:i}",
-                                 "id", id,
-                                 "force", force)))
-            log_err_exit ("job-manager.purge-id");
-        if (flux_future_then (f, -1, purge_id_continuation, &total) < 0)
-            log_err_exit ("flux_future_then");
+    if (!(ids = json_array ()))
+        log_msg_exit ("out of memory");
+    while (optindex < argc) {
+        flux_jobid_t id = parse_jobid (argv[optindex++]);
+        json_t *o = json_integer (id);
+        if (!o || json_array_append_new (ids, o) < 0)
+            log_msg_exit ("out of memory");
     }
 
-    if (flux_reactor_run (flux_get_reactor (h), 0) < 0)
-        log_err_exit ("flux_reactor_run");
+    /* One streaming request purges all ids, one KVS commit per batch.
+     */
+    if (!(f = flux_rpc_pack (h,
+                             "job-manager.purge-ids",
+                             0,
+                             FLUX_RPC_STREAMING,
+                             "{s:O s:i s:b}",
+                             "ids", ids,
+                             "batch", batch,
+                             "force", force)))
+        log_err_exit ("job-manager.purge-ids");
+    while (flux_rpc_get_unpack (f, "{s:i}", "count", &count) == 0) {
+        total += count;
+        flux_future_reset (f);
+    }
+    if (errno != ENODATA)
+        log_msg_exit ("purge: %s", future_strerror (f, errno));
+    flux_future_destroy (f);
+    json_decref (ids);
 
     purge_finish (h, force, total);
     flux_close (h);
@@ -15,7 +15,7 @@
 
 #include "content-util.h"
 
-int content_register_backing_store (flux_t *h, const char *name)
+int content_register_backing_store (flux_t *h, const char *name, int flags)
 {
     flux_future_t *f;
 
@@ -23,9 +23,11 @@ int content_register_backing_store (flux_t *h, const char *name)
                              "content.register-backing",
                              0,
                              0,
-                             "{s:s}",
+                             "{s:s s:b}",
                              "name",
-                             name))) {
+                             name,
+                             "batch",
+                             (flags & CONTENT_BACKING_BATCH) ? 1 : 0))) {
         flux_log_error (h, "register-backing");
         return -1;
     }
@@ -14,10 +14,15 @@
 #ifndef _FLUX_CONTENT_UTIL_H
 #define _FLUX_CONTENT_UTIL_H
 
+/* register flags */
+enum {
+    CONTENT_BACKING_BATCH = 1,  /* backing store implements batch-store */
+};
+
 /* Let the rank 0 content-cache service know the backing store is available.
  * This function blocks while waiting for the RPC response.
  */
-int content_register_backing_store (flux_t *h, const char *name);
+int content_register_backing_store (flux_t *h, const char *name, int flags);
 
 /* Let the rank 0 content-cache service know the backing store is not available.
  * This function blocks while waiting for the RPC response.
@@ -13,7 +13,10 @@
 #endif
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 #include <errno.h>
+#include <stdint.h>
+#include <arpa/inet.h>
 #include <flux/core.h>
 
 #include "content.h"
@@ -120,6 +123,83 @@ int content_store_get_blobref (flux_future_t *f,
     return 0;
 }
 
+/* Batch store payload is a sequence of blobs, each preceded by its
+ * length as a 4 byte integer in network byte order.
+ */
+flux_future_t *content_store_batch (flux_t *h,
+                                    const struct iovec *iov,
+                                    int iovcnt)
+{
+    flux_future_t *f;
+    size_t size = 0;
+    char *buf;
+    char *p;
+
+    if (!h || !iov || iovcnt < 1) {
+        errno = EINVAL;
+        return NULL;
+    }
+    for (int i = 0; i < iovcnt; i++) {
+        if (iov[i].iov_len > UINT32_MAX) {
+            errno = EINVAL;
+            return NULL;
+        }
+        size += sizeof (uint32_t) + iov[i].iov_len;
+    }
+    if (!(buf = malloc (size)))
+        return NULL;
+    p = buf;
+    for (int i = 0; i < iovcnt; i++) {
+        uint32_t len = htonl (iov[i].iov_len);
+
+        memcpy (p, &len, sizeof (len));
+        p += sizeof (len);
+        if (iov[i].iov_len > 0)
+            memcpy (p, iov[i].iov_base, iov[i].iov_len);
+        p += iov[i].iov_len;
+    }
+    f = flux_rpc_raw (h, "content-backing.batch-store", buf, size, 0, 0);
+    ERRNO_SAFE_WRAP (free, buf);
+    return f;
+}
+
+int content_store_batch_get_hashes (flux_future_t *f,
+                                    const void **hashes,
+                                    size_t *len)
+{
+    return flux_rpc_get_raw (f, hashes, len);
+}
+
+int content_store_batch_next (const void *buf,
+                              size_t size,
+                              size_t *cursor,
+                              const void **data,
+                              size_t *len)
+{
+    uint32_t n;
+
+    if (!cursor || !data || !len || (size > 0 && !buf)) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (*cursor == size)
+        return 0;
+    if (*cursor > size || size - *cursor < sizeof (n)) {
+        errno = EPROTO;
+        return -1;
+    }
+    memcpy (&n, (char *)buf + *cursor, sizeof (n));
+    n = ntohl (n);
+    if (size - *cursor - sizeof (n) < n) {
+        errno = EPROTO;
+        return -1;
+    }
+    *data = (char *)buf + *cursor + sizeof (n);
+    *len = n;
+    *cursor += sizeof (n) + n;
+    return 1;
+}
+
 /*
  * vi:tabstop=4 shiftwidth=4 expandtab
  */
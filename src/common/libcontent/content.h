@@ -11,6 +11,8 @@
 #ifndef _FLUX_CONTENT_H
 #define _FLUX_CONTENT_H
 
+#include <sys/uio.h>
+
 /* flags */
 enum {
     CONTENT_FLAG_CACHE_BYPASS = 1,/* request direct to backing store */
@@ -52,6 +54,34 @@ int content_store_get_blobref (flux_future_t *f,
                                const char *hash_name,
                                const char **blobref);
 
+/* Send request to store several blobs directly to the rank 0 backing
+ * store, which stores them in a single transaction.  The backing store
+ * must have registered with CONTENT_BACKING_BATCH (see content-util.h).
+ */
+flux_future_t *content_store_batch (flux_t *h,
+                                    const struct iovec *iov,
+                                    int iovcnt);
+
+/* Get result of batch store request:  the hashes of the stored blobs,
+ * concatenated in request order.
+ * Storage belongs to 'f' and is valid until 'f' is destroyed.
+ * Returns 0 on success, -1 on failure with errno set.
+ */
+int content_store_batch_get_hashes (flux_future_t *f,
+                                    const void **hashes,
+                                    size_t *len);
+
+/* Iterate over the blobs in a batch store request payload 'buf'.
+ * Set '*cursor' to zero before the first call.
+ * Returns 1 with 'data' and 'len' set to the next blob, 0 when there are
+ * no more blobs, or -1 with errno set to EPROTO if the payload is malformed.
+ */
+int content_store_batch_next (const void *buf,
+                              size_t size,
+                              size_t *cursor,
+                              const void **data,
+                              size_t *len);
+
 #endif /* !_FLUX_CONTENT_H */
 
 /*
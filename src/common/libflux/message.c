@@ -34,8 +34,16 @@
 #include <assert.h>
 #include <fnmatch.h>
 #include <inttypes.h>
+#include <pthread.h>
 #include <jansson.h>
 #include <flux/core.h>
+#if HAVE_VALGRIND
+# if HAVE_VALGRIND_H
+#  include <valgrind.h>
+# elif HAVE_VALGRIND_VALGRIND_H
+#  include <valgrind/valgrind.h>
+# endif
+#endif
 
 #include "src/common/libutil/aux.h"
 #include "src/common/libutil/errno_safe.h"
@@ -78,11 +86,93 @@ static void msg_setup_type (flux_msg_t *msg)
     }
 }
 
+/* Destroyed messages are kept on a small per-thread cache for reuse, so
+ * that with inline route and topic storage, creating a message usually
+ * takes no allocator call.  A message destroyed by a thread other than
+ * the one that created it, e.g. after passing through the interthread
+ * connector, simply lands in the destroying thread's cache.  The cache is
+ * disabled under AddressSanitizer and valgrind so that use-after-free and
+ * leaks of messages are still caught.
+ */
+#define MSG_CACHE_SIZE 64
+
+struct msg_cache {
+    flux_msg_t *msgs[MSG_CACHE_SIZE];
+    int count;
+};
+
+static pthread_key_t msg_cache_key;
+static pthread_once_t msg_cache_once = PTHREAD_ONCE_INIT;
+static __thread struct msg_cache *msg_cache;
+
+static void msg_cache_destroy (void *arg)
+{
+    struct msg_cache *cache = arg;
+
+    if (cache) {
+        for (int i = 0; i < cache->count; i++)
+            free (cache->msgs[i]);
+        free (cache);
+    }
+    msg_cache = NULL;
+}
+
+static void msg_cache_init (void)
+{
+    (void)pthread_key_create (&msg_cache_key, msg_cache_destroy);
+}
+
+static struct msg_cache *msg_cache_get (void)
+{
+#ifndef __SANITIZE_ADDRESS__
+    if (!msg_cache) {
+        struct msg_cache *cache;
+
+#if HAVE_VALGRIND
+        if (RUNNING_ON_VALGRIND)
+            return NULL;
+#endif
+        pthread_once (&msg_cache_once, msg_cache_init);
+        if (!(cache = calloc (1, sizeof (*cache))))
+            return NULL;
+        if (pthread_setspecific (msg_cache_key, cache) != 0) {
+            free (cache);
+            return NULL;
+        }
+        msg_cache = cache;
+    }
+#endif
+    return msg_cache;
+}
+
+static void msg_free (flux_msg_t *msg)
+{
+    struct msg_cache *cache = msg_cache_get ();
+
+    if (cache && cache->count < MSG_CACHE_SIZE)
+        cache->msgs[cache->count++] = msg;
+    else
+        free (msg);
+}
+
+static flux_msg_t *msg_alloc (void)
+{
+    struct msg_cache *cache = msg_cache;
+    flux_msg_t *msg;
+
+    if (cache && cache->count > 0) {
+        msg = cache->msgs[--cache->count];
+        memset (msg, 0, sizeof (*msg));
+        return msg;
+    }
+    return calloc (1, sizeof (*msg));
+}
+
 flux_msg_t *msg_create (void)
 {
     flux_msg_t *msg;
 
-    if (!(msg = calloc (1, sizeof (*msg))))
+    if (!(msg = msg_alloc ()))
         return NULL;
     list_head_init (&msg->routes);
     list_node_init (&msg->list);
@@ -113,12 +203,12 @@ void flux_msg_destroy (flux_msg_t *msg)
         int saved_errno = errno;
         if (msg_has_route (msg))
             msg_route_clear (msg);
-        free (msg->topic);
+        msg_topic_clear (msg);
         free (msg->payload);
         json_decref (msg->json);
         aux_destroy (&msg->aux);
         free (msg->lasterr);
-        free (msg);
+        msg_free (msg);
         errno = saved_errno;
     }
 }
@@ -286,8 +376,9 @@ flux_msg_t *flux_msg_decode (const void *buf, size_t size)
 {
     flux_msg_t *msg;
     const uint8_t *p = buf;
-    struct msg_iovec *iov = NULL;
-    int iovlen = 0;
+    struct msg_iovec iovbuf[MSG_INLINE_ROUTES + 4];
+    struct msg_iovec *iov = iovbuf;
+    int iovlen = ARRAY_SIZE (iovbuf);
     int iovcnt = 0;
 
     while (p - (uint8_t *)buf < size) {
@@ -307,7 +398,12 @@ flux_msg_t *flux_msg_decode (const void *buf, size_t size)
         if (iovlen <= iovcnt) {
             struct msg_iovec *tmp;
             iovlen += IOVECINCR;
-            if (!(tmp = realloc (iov, sizeof (*iov) * iovlen)))
+            if (iov == iovbuf) {
+                if (!(tmp = malloc (sizeof (*iov) * iovlen)))
+                    goto error;
+                memcpy (tmp, iovbuf, sizeof (iovbuf));
+            }
+            else if (!(tmp = realloc (iov, sizeof (*iov) * iovlen)))
                 goto error;
             iov = tmp;
         }
@@ -318,10 +414,12 @@ flux_msg_t *flux_msg_decode (const void *buf, size_t size)
     }
     if (!(msg = iovec_to_msg (iov, iovcnt)))
         goto error;
-    free (iov);
+    if (iov != iovbuf)
+        free (iov);
     return msg;
 error:
-    ERRNO_SAFE_WRAP (free, iov);
+    if (iov != iovbuf)
+        ERRNO_SAFE_WRAP (free, iov);
     return NULL;
 }
 
@@ -891,6 +989,37 @@ int flux_msg_set_payload (flux_msg_t *msg, const void *buf, size_t size)
     return 0;
 }
 
+int flux_msg_set_payload_nocopy (flux_msg_t *msg, void *buf, size_t size)
+{
+    if (msg_validate (msg) < 0)
+        return -1;
+    if (buf == NULL || size == 0) {
+        if (buf != msg->payload)
+            free (buf);
+        return flux_msg_set_payload (msg, NULL, 0);
+    }
+    if (msg_has_payload (msg)) {
+        if (buf == msg->payload) {
+            if (size > msg->payload_size) {
+                errno = EINVAL;
+                return -1;
+            }
+        }
+        else if (payload_overlap (msg, buf)) {
+            errno = EINVAL;
+            return -1;
+        }
+    }
+    json_decref (msg->json);            /* invalidate cached json object */
+    msg->json = NULL;
+    if (msg->payload != buf)
+        free (msg->payload);
+    msg->payload = buf;
+    msg->payload_size = size;
+    msg_set_flag (msg, FLUX_MSGFLAG_PAYLOAD);
+    return 0;
+}
+
 static inline void msg_lasterr_reset (flux_msg_t *msg)
 {
     if (msg_validate (msg) == 0) {
@@ -914,9 +1043,63 @@ static inline void msg_lasterr_set (flux_msg_t *msg,
     errno = saved_errno;
 }
 
+/* Growable buffer for serializing JSON directly into a message payload
+ * with json_dump_callback(), avoiding the copy made by json_dumps()
+ * followed by flux_msg_set_string().
+ */
+struct payload_buf {
+    char *data;
+    size_t size;
+    size_t len;
+};
+
+static int payload_buf_append (const char *buf, size_t size, void *arg)
+{
+    struct payload_buf *pb = arg;
+
+    if (pb->len + size + 1 > pb->size) { // leave room for \0
+        size_t newsize = pb->size ? pb->size : 256;
+        char *data;
+
+        while (pb->len + size + 1 > newsize)
+            newsize *= 2;
+        if (!(data = realloc (pb->data, newsize)))
+            return -1;
+        pb->data = data;
+        pb->size = newsize;
+    }
+    memcpy (pb->data + pb->len, buf, size);
+    pb->len += size;
+    return 0;
+}
+
+/* Set payload of 'msg' to the compact encoding of 'o', including the
+ * \0 terminator, as flux_msg_set_string() would.
+ */
+static int msg_set_json (flux_msg_t *msg, json_t *o)
+{
+    struct payload_buf pb = { 0 };
+
+    if (json_dump_callback (o, payload_buf_append, &pb, JSON_COMPACT) < 0
+        || pb.len == 0) {
+        free (pb.data);
+        msg_lasterr_set (msg, "json_dumps failed on pack result");
+        errno = EINVAL;
+        return -1;
+    }
+    pb.data[pb.len++] = '\0';
+    if (flux_msg_set_payload_nocopy (msg, pb.data, pb.len) < 0) {
+        msg_lasterr_set (msg,
+                         "flux_msg_set_payload: %s",
+                         strerror (errno));
+        ERRNO_SAFE_WRAP (free, pb.data);
+        return -1;
+    }
+    return 0;
+}
+
 int flux_msg_vpack (flux_msg_t *msg, const char *fmt, va_list ap)
 {
-    char *json_str = NULL;
     json_t *json = NULL;
     json_error_t err;
     int saved_errno;
@@ -936,22 +1119,14 @@ int flux_msg_vpack (flux_msg_t *msg, const char *fmt, va_list ap)
         msg_lasterr_set (msg, "payload is not a JSON object");
         goto error_inval;
     }
-    if (!(json_str = json_dumps (json, JSON_COMPACT))) {
-        msg_lasterr_set (msg, "json_dumps failed on pack result");
-        goto error_inval;
-    }
-    if (flux_msg_set_string (msg, json_str) < 0) {
-        msg_lasterr_set (msg, "flux_msg_set_string: %s", strerror (errno));
+    if (msg_set_json (msg, json) < 0)
         goto error;
-    }
-    free (json_str);
     json_decref (json);
     return 0;
 error_inval:
     errno = EINVAL;
 error:
     saved_errno = errno;
-    free (json_str);
     json_decref (json);
     errno = saved_errno;
     return -1;
@@ -1091,6 +1266,29 @@ const char *flux_msg_last_error (const flux_msg_t *msg)
     return msg->lasterr;
 }
 
+void msg_topic_clear (flux_msg_t *msg)
+{
+    if (msg->topic != msg->topic_buf)
+        free (msg->topic);
+    msg->topic = NULL;
+}
+
+int msg_topic_set (flux_msg_t *msg, const char *topic, size_t len)
+{
+    char *cpy;
+
+    if (len < sizeof (msg->topic_buf))
+        cpy = msg->topic_buf;
+    else if (!(cpy = malloc (len + 1)))
+        return -1;
+    memmove (cpy, topic, len); // topic may be msg->topic
+    cpy[len] = '\0';
+    if (msg->topic != cpy)
+        msg_topic_clear (msg);
+    msg->topic = cpy;
+    return 0;
+}
+
 int flux_msg_set_topic (flux_msg_t *msg, const char *topic)
 {
     if (msg_validate (msg) < 0)
@@ -1100,16 +1298,14 @@ int flux_msg_set_topic (flux_msg_t *msg, const char *topic)
         return -1;
     }
     if (msg_has_topic (msg) && topic) {         /* case 1: replace topic */
-        free (msg->topic);
-        if (!(msg->topic = strdup (topic)))
+        if (msg_topic_set (msg, topic, strlen (topic)) < 0)
             return -1;
     } else if (!msg_has_topic (msg) && topic) { /* case 2: add topic */
-        if (!(msg->topic = strdup (topic)))
+        if (msg_topic_set (msg, topic, strlen (topic)) < 0)
             return -1;
         msg_set_flag (msg, FLUX_MSGFLAG_TOPIC);
     } else if (msg_has_topic (msg) && !topic) { /* case 3: delete topic */
-        free (msg->topic);
-        msg->topic = NULL;
+        msg_topic_clear (msg);
         msg_clear_flag (msg, FLUX_MSGFLAG_TOPIC);
     }
     return 0;
@@ -1151,7 +1347,7 @@ flux_msg_t *flux_msg_copy (const flux_msg_t *msg, bool payload)
         }
     }
     if (msg->topic) {
-        if (!(cpy->topic = strdup (msg->topic)))
+        if (msg_topic_set (cpy, msg->topic, strlen (msg->topic)) < 0)
             goto nomem;
     }
     if (msg->payload) {
@@ -172,6 +172,12 @@ int flux_msg_get_payload (const flux_msg_t *msg,
 int flux_msg_set_payload (flux_msg_t *msg, const void *buf, size_t size);
 bool flux_msg_has_payload (const flux_msg_t *msg);
 
+/* Like flux_msg_set_payload(), but on success the message takes ownership
+ * of 'buf', which must have been allocated with malloc(3), instead of
+ * copying it.  On failure, the caller retains ownership of 'buf'.
+ */
+int flux_msg_set_payload_nocopy (flux_msg_t *msg, void *buf, size_t size);
+
 /* Test/set/clear message flags
  */
 bool flux_msg_has_flag (const flux_msg_t *msg, int flag);
@@ -69,8 +69,9 @@ flux_msg_t *iovec_to_msg (struct msg_iovec *iov, int iovcnt)
             errno = EPROTO;
             goto error;
         }
-        if (!(msg->topic = strndup ((char *)iov[index].data,
-                                    iov[index].size)))
+        if (msg_topic_set (msg,
+                           iov[index].data,
+                           strnlen (iov[index].data, iov[index].size)) < 0)
             goto error;
         if (index < iovcnt)
             index++;
@@ -18,13 +18,34 @@
 
 #include "message_proto.h"
 
+/* Route ids and the topic are stored inline in the message when they fit,
+ * and spill to the heap otherwise.  The inline route size accommodates a
+ * UUID or a broker rank, and a few hops cover most broker routing.
+ */
+#define MSG_INLINE_ROUTES       4
+#define MSG_INLINE_ROUTE_SIZE   40
+#define MSG_INLINE_TOPIC_SIZE   64
+
+struct route_id {
+    struct list_node route_id_node;
+    char *id;                   /* variable length id stored at end of struct */
+};
+
+struct route_slot {
+    struct route_id r;
+    char id[MSG_INLINE_ROUTE_SIZE];
+};
+
 struct flux_msg {
     // optional route list, if FLUX_MSGFLAG_ROUTE
     struct list_head routes;
     int routes_len;     /* to avoid looping */
+    unsigned int route_slots_used;  /* bitmask of route_slots in use */
+    struct route_slot route_slots[MSG_INLINE_ROUTES];
 
     // optional topic frame, if FLUX_MSGFLAG_TOPIC
-    char *topic;
+    char *topic;        /* points to topic_buf or heap */
+    char topic_buf[MSG_INLINE_TOPIC_SIZE];
 
     // optional payload frame, if FLUX_MSGFLAG_PAYLOAD
     void *payload;
@@ -42,6 +63,12 @@ struct flux_msg {
 
 flux_msg_t *msg_create (void);
 
+/* Set msg->topic to a copy of the first 'len' chars of 'topic', or
+ * clear it.  These do not change FLUX_MSGFLAG_TOPIC.
+ */
+int msg_topic_set (flux_msg_t *msg, const char *topic, size_t len);
+void msg_topic_clear (flux_msg_t *msg);
+
 int msg_frames (const flux_msg_t *msg);
 
 #define msgtype_is_valid(tp) \
@@ -23,24 +23,53 @@
 #include "message_private.h"
 #include "message_route.h"
 
-static void route_id_destroy (void *data)
+static int route_slot_index (flux_msg_t *msg, struct route_id *r)
 {
-    if (data) {
-        struct route_id *r = data;
-        free (r);
+    for (int i = 0; i < MSG_INLINE_ROUTES; i++) {
+        if (r == &msg->route_slots[i].r)
+            return i;
     }
+    return -1;
 }
 
-static struct route_id *route_id_create (const char *id, unsigned int id_len)
+static void route_id_destroy (flux_msg_t *msg, struct route_id *r)
 {
-    struct route_id *r;
-    if (!(r = calloc (1, sizeof (*r) + id_len + 1)))
-        return NULL;
-    r->id = (char *)(r + 1);
-    if (id && id_len) {
-        memcpy (r->id, id, id_len);
-        list_node_init (&(r->route_id_node));
+    if (r) {
+        int i = route_slot_index (msg, r);
+        if (i >= 0)
+            msg->route_slots_used &= ~(1U << i);
+        else
+            free (r);
     }
+}
+
+/* Use a free inline route slot if 'id' fits, otherwise allocate.
+ */
+static struct route_id *route_id_create (flux_msg_t *msg,
+                                         const char *id,
+                                         unsigned int id_len)
+{
+    struct route_id *r = NULL;
+
+    if (id_len < MSG_INLINE_ROUTE_SIZE) {
+        for (int i = 0; i < MSG_INLINE_ROUTES; i++) {
+            if (!(msg->route_slots_used & (1U << i))) {
+                msg->route_slots_used |= 1U << i;
+                r = &msg->route_slots[i].r;
+                r->id = msg->route_slots[i].id;
+                break;
+            }
+        }
+    }
+    if (!r) {
+        if (!(r = malloc (sizeof (*r) + id_len + 1)))
+            return NULL;
+        r->id = (char *)(r + 1);
+    }
+    if (id && id_len)
+        memcpy (r->id, id, id_len);
+    r->id[id_len] = '\0';
+    list_node_init (&(r->route_id_node));
     return r;
 }
 
@@ -49,7 +78,7 @@ int msg_route_push (flux_msg_t *msg,
                     unsigned int id_len)
 {
     struct route_id *r;
-    if (!(r = route_id_create (id, strlen (id))))
+    if (!(r = route_id_create (msg, id, strlen (id))))
         return -1;
     list_add (&msg->routes, &r->route_id_node);
     msg->routes_len++;
@@ -64,7 +93,7 @@ int msg_route_append (flux_msg_t *msg,
     assert (msg);
     assert (msg_has_route (msg));
     assert (id);
-    if (!(r = route_id_create (id, id_len)))
+    if (!(r = route_id_create (msg, id, id_len)))
         return -1;
     list_add_tail (&msg->routes, &r->route_id_node);
     msg->routes_len++;
@@ -77,7 +106,7 @@ void msg_route_clear (flux_msg_t *msg)
     assert (msg);
     assert (msg_has_route (msg));
     while ((r = list_pop (&msg->routes, struct route_id, route_id_node)))
-        route_id_destroy (r);
+        route_id_destroy (msg, r);
     list_head_init (&msg->routes);
     msg->routes_len = 0;
 }
@@ -88,7 +117,7 @@ int msg_route_delete_last (flux_msg_t *msg)
     assert (msg);
     assert (msg_has_route (msg));
     if ((r = list_pop (&msg->routes, struct route_id, route_id_node))) {
-        route_id_destroy (r);
+        route_id_destroy (msg, r);
         msg->routes_len--;
     }
     return 0;
@@ -11,13 +11,6 @@
 #ifndef _FLUX_CORE_MESSAGE_ROUTE_H
 #define _FLUX_CORE_MESSAGE_ROUTE_H
 
-#include "ccan/list/list.h"
-
-struct route_id {
-    struct list_node route_id_node;
-    char *id;                   /* variable length id stored at end of struct */
-};
-
 int msg_route_push (flux_msg_t *msg,
                     const char *id,
                     unsigned int id_len);
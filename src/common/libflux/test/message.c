@@ -20,6 +20,7 @@
 #include <flux/core.h>
 
 #include "src/common/libtap/tap.h"
+#include "src/common/libutil/monotime.h"
 #include "ccan/array_size/array_size.h"
 #include "ccan/str/str.h"
 
@@ -714,6 +715,51 @@ void check_payload (void)
     flux_msg_destroy (msg);
 }
 
+void check_payload_nocopy (void)
+{
+    flux_msg_t *msg;
+    const void *buf;
+    const char *s;
+    size_t len;
+    char *p1, *p2;
+
+    if (!(msg = flux_msg_create (FLUX_MSGTYPE_REQUEST)))
+        BAIL_OUT ("flux_msg_create failed");
+    if (!(p1 = strdup ("hello")) || !(p2 = strdup ("world")))
+        BAIL_OUT ("strdup failed");
+
+    errno = 0;
+    ok (flux_msg_set_payload_nocopy (NULL, p1, 6) < 0 && errno == EINVAL,
+        "flux_msg_set_payload_nocopy msg=NULL fails with EINVAL");
+    ok (flux_msg_set_payload_nocopy (msg, p1, 6) == 0
+        && flux_msg_get_payload (msg, &buf, &len) == 0
+        && buf == p1
+        && len == 6,
+        "flux_msg_set_payload_nocopy adopts buffer");
+    errno = 0;
+    ok (flux_msg_set_payload_nocopy (msg, p1 + 1, 2) < 0 && errno == EINVAL,
+        "flux_msg_set_payload_nocopy fails on payload fragment");
+    ok (flux_msg_set_payload_nocopy (msg, p1, 3) == 0
+        && flux_msg_get_payload (msg, &buf, &len) == 0
+        && buf == p1
+        && len == 3,
+        "flux_msg_set_payload_nocopy can shorten current payload");
+    ok (flux_msg_set_payload_nocopy (msg, p2, 6) == 0
+        && flux_msg_get_payload (msg, &buf, &len) == 0
+        && buf == p2
+        && len == 6,
+        "flux_msg_set_payload_nocopy replaces payload");
+    ok (flux_msg_set_payload_nocopy (msg, NULL, 0) == 0
+        && !flux_msg_has_payload (msg),
+        "flux_msg_set_payload_nocopy buf=NULL clears payload");
+    ok (flux_msg_pack (msg, "{s:s}", "foo", "bar") == 0
+        && flux_msg_get_string (msg, &s) == 0
+        && streq (s, "{\"foo\":\"bar\"}"),
+        "flux_msg_pack sets payload with \\0 terminator");
+
+    flux_msg_destroy (msg);
+}
+
 /* flux_msg_set_type, flux_msg_get_type
  * flux_msg_set_nodeid, flux_msg_get_nodeid
  * flux_msg_set_errnum, flux_msg_get_errnum
@@ -1383,6 +1429,156 @@ void check_proto_internal (void)
     }
 }
 
+static bool routes_equal (const flux_msg_t *msg1, const flux_msg_t *msg2)
+{
+    struct route_id *r1;
+    struct route_id *r2;
+
+    if (msg1->routes_len != msg2->routes_len)
+        return false;
+    r2 = list_top (&msg2->routes, struct route_id, route_id_node);
+    list_for_each (&msg1->routes, r1, route_id_node) {
+        if (!r2 || !streq (r1->id, r2->id))
+            return false;
+        r2 = list_next (&msg2->routes, r2, route_id_node);
+    }
+    return true;
+}
+
+/* Exercise topic and routes that spill out of inline storage, and
+ * make sure they survive copy and encode/decode.
+ */
+void check_inline (void)
+{
+    flux_msg_t *msg, *cpy;
+    char longtopic[MSG_INLINE_TOPIC_SIZE * 2];
+    char longid[MSG_INLINE_ROUTE_SIZE * 2];
+    const char *topic;
+    char ids[MSG_INLINE_ROUTES + 2][16];
+    char buf[1024];
+    ssize_t size;
+    bool match;
+
+    memset (longtopic, 't', sizeof (longtopic) - 1);
+    longtopic[sizeof (longtopic) - 1] = '\0';
+    memset (longid, 'r', sizeof (longid) - 1);
+    longid[sizeof (longid) - 1] = '\0';
+
+    if (!(msg = flux_request_encode ("short", NULL)))
+        BAIL_OUT ("flux_request_encode failed");
+    ok (flux_msg_set_topic (msg, longtopic) == 0
+        && flux_msg_get_topic (msg, &topic) == 0
+        && streq (topic, longtopic),
+        "topic longer than inline buffer works");
+    ok (flux_msg_set_topic (msg, "short2") == 0
+        && flux_msg_get_topic (msg, &topic) == 0
+        && streq (topic, "short2"),
+        "topic can be replaced with one that fits inline buffer");
+    ok (flux_msg_get_topic (msg, &topic) == 0
+        && flux_msg_set_topic (msg, topic) == 0
+        && flux_msg_get_topic (msg, &topic) == 0
+        && streq (topic, "short2"),
+        "topic can be set to itself");
+
+    flux_msg_route_enable (msg);
+    for (int i = 0; i < ARRAY_SIZE (ids); i++) {
+        snprintf (ids[i], sizeof (ids[i]), "%d", i);
+        if (flux_msg_route_push (msg, ids[i]) < 0)
+            BAIL_OUT ("flux_msg_route_push failed");
+    }
+    ok (flux_msg_route_push (msg, longid) == 0,
+        "flux_msg_route_push works with id longer than inline buffer");
+    ok (flux_msg_route_count (msg) == ARRAY_SIZE (ids) + 1,
+        "route count is correct with routes beyond inline slots");
+    ok (flux_msg_route_delete_last (msg) == 0
+        && flux_msg_route_delete_last (msg) == 0
+        && streq (flux_msg_route_last (msg), ids[ARRAY_SIZE (ids) - 2]),
+        "flux_msg_route_delete_last works");
+    ok (flux_msg_route_push (msg, "x") == 0
+        && flux_msg_route_push (msg, "y") == 0
+        && streq (flux_msg_route_last (msg), "y"),
+        "routes can be pushed after delete");
+    ok (streq (flux_msg_route_first (msg), ids[0]),
+        "first route is intact");
+
+    if (!(cpy = flux_msg_copy (msg, true)))
+        BAIL_OUT ("flux_msg_copy failed");
+    ok (routes_equal (msg, cpy)
+        && flux_msg_get_topic (cpy, &topic) == 0
+        && streq (topic, "short2"),
+        "flux_msg_copy copies routes and topic");
+    flux_msg_destroy (cpy);
+
+    if (flux_msg_set_topic (msg, longtopic) < 0)
+        BAIL_OUT ("flux_msg_set_topic failed");
+    size = flux_msg_encode_size (msg);
+    ok (size > 0 && size <= sizeof (buf)
+        && flux_msg_encode (msg, buf, sizeof (buf)) == 0,
+        "flux_msg_encode works");
+    cpy = flux_msg_decode (buf, size);
+    match = cpy
+        && routes_equal (msg, cpy)
+        && flux_msg_get_topic (cpy, &topic) == 0
+        && streq (topic, longtopic);
+    ok (match,
+        "flux_msg_decode restores routes and long topic");
+    flux_msg_destroy (cpy);
+    flux_msg_destroy (msg);
+}
+
+/* Time the lifecycle of a message forwarded through a few hops of the
+ * broker: create, push routes, encode, decode, destroy.
+ * Timings are informational only.
+ */
+#define BENCH_MSGS 100000
+
+void check_bench (void)
+{
+    const char *hops[] = {
+        "6f2a7c1e-3b4d-4e5f-8a9b-0c1d2e3f4a5b",
+        "1",
+        "0",
+    };
+    char buf[256];
+    struct timespec t0;
+    double t;
+    int errors = 0;
+
+    monotime (&t0);
+    for (int i = 0; i < BENCH_MSGS; i++) {
+        flux_msg_t *msg;
+        flux_msg_t *cpy;
+        ssize_t size;
+
+        if (!(msg = flux_request_encode ("kvs.lookup", "{\"key\":\"a\"}")))
+            BAIL_OUT ("flux_request_encode failed");
+        flux_msg_route_enable (msg);
+        for (int j = 0; j < ARRAY_SIZE (hops); j++) {
+            if (flux_msg_route_push (msg, hops[j]) < 0)
+                errors++;
+        }
+        if ((size = flux_msg_encode_size (msg)) < 0
+            || size > sizeof (buf)
+            || flux_msg_encode (msg, buf, sizeof (buf)) < 0
+            || !(cpy = flux_msg_decode (buf, size))) {
+            errors++;
+            flux_msg_destroy (msg);
+            continue;
+        }
+        if (flux_msg_route_count (cpy) != ARRAY_SIZE (hops))
+            errors++;
+        flux_msg_destroy (cpy);
+        flux_msg_destroy (msg);
+    }
+    t = monotime_since (t0);
+    ok (errors == 0,
+        "bench: create/route-push/encode/decode/destroy %d messages",
+        BENCH_MSGS);
+    diag ("%.0f msg/s (%.3fus per message)",
+          BENCH_MSGS / (t / 1000),
+          t * 1000 / BENCH_MSGS);
+}
+
 int main (int argc, char *argv[])
 {
     int opt;
@@ -1401,6 +1597,7 @@ int main (int argc, char *argv[])
     check_payload ();
     check_payload_json ();
     check_payload_json_formatted ();
+    check_payload_nocopy ();
     check_matchtag ();
     check_security ();
     check_aux ();
@@ -1418,6 +1615,9 @@ int main (int argc, char *argv[])
 
     check_proto_internal ();
 
+    check_inline ();
+    check_bench ();
+
     done_testing();
     return (0);
 }
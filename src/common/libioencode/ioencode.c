@@ -99,6 +99,33 @@ json_t *ioencode (const char *stream,
     return o;
 }
 
+json_t *ioencode_blobref (const char *stream,
+                          const char *rank,
+                          const char *blobref,
+                          int offset,
+                          int len,
+                          bool eof)
+{
+    json_t *o;
+
+    if (!stream || !rank || !blobref || offset < 0 || len <= 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(o = json_pack ("{s:s s:s s:s s:i s:i}",
+                         "stream", stream,
+                         "rank", rank,
+                         "blobref", blobref,
+                         "offset", offset,
+                         "len", len))
+        || (eof && json_object_set_new (o, "eof", json_true ()) < 0)) {
+        json_decref (o);
+        errno = ENOMEM;
+        return NULL;
+    }
+    return o;
+}
+
 static int decode_data_base64 (char *src,
                                size_t srclen,
                                char **datap,
@@ -154,6 +181,8 @@ int iodecode (json_t *o,
     }
     if (json_unpack (o, "{s:s%}", "data", &data, &len) == 0)
         has_data = true;
+    else if (json_object_get (o, "blobref"))
+        has_data = true;
     if (json_unpack (o, "{s:b}", "eof", &eof) == 0)
         has_eof = true;
 
@@ -191,6 +220,42 @@ int iodecode (json_t *o,
     return 0;
 }
 
+int iodecode_blobref (json_t *o,
+                      const char **blobrefp,
+                      int *offsetp,
+                      int *lenp)
+{
+    const char *blobref;
+    int offset;
+    int len;
+
+    if (!o) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!json_object_get (o, "blobref")) {
+        errno = ENOENT;
+        return -1;
+    }
+    if (json_unpack (o,
+                     "{s:s s:i s:i}",
+                     "blobref", &blobref,
+                     "offset", &offset,
+                     "len", &len) < 0
+        || offset < 0
+        || len <= 0) {
+        errno = EPROTO;
+        return -1;
+    }
+    if (blobrefp)
+        *blobrefp = blobref;
+    if (offsetp)
+        *offsetp = offset;
+    if (lenp)
+        *lenp = len;
+    return 0;
+}
+
 /*
  * vi: ts=4 sw=4 expandtab
  */
@@ -26,11 +26,24 @@ json_t *ioencode (const char *stream,
                   int len,
                   bool eof);
 
+/* encode RFC24 data event object whose data is 'len' bytes at 'offset'
+ * in content store blob 'blobref', instead of inline data
+ * - returns RFC24 object on success, NULL on error with errno set
+ * - returned object should be json_decref()'d after use
+ */
+json_t *ioencode_blobref (const char *stream,
+                          const char *rank,
+                          const char *blobref,
+                          int offset,
+                          int len,
+                          bool eof);
+
 /* decode RFC24 data event object
  * - both data and EOF can be available
  * - if no data available, data set to NULL and len to 0
  * - data must be freed after return
  * - data can be NULL and len non-NULL to retrieve data length
+ * - data stored in a blob is not available (see iodecode_blobref())
  * - returns 0 on success, -1 on error with errno set
  */
 int iodecode (json_t *o,
@@ -40,4 +53,13 @@ int iodecode (json_t *o,
               int *len,
               bool *eof);
 
+/* decode blob reference from RFC24 data event object
+ * - returns 0 on success, -1 on error with errno set
+ * - errno is set to ENOENT if the object has no blob reference
+ */
+int iodecode_blobref (json_t *o,
+                      const char **blobref,
+                      int *offset,
+                      int *len);
+
 #endif /* !_IOENCODE_H */
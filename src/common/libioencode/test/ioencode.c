@@ -135,6 +135,67 @@ static void binary_data (void)
     json_decref (o);
 }
 
+static void blobref (void)
+{
+    json_t *o;
+    const char *stream;
+    const char *rank;
+    const char *ref;
+    char *data;
+    int offset;
+    int len;
+    bool eof;
+
+    ok (ioencode_blobref ("stdout", "0", NULL, 0, 1, false) == NULL
+        && errno == EINVAL,
+        "ioencode_blobref fails with EINVAL on NULL blobref");
+    ok (ioencode_blobref ("stdout", "0", "sha1-1234", -1, 1, false) == NULL
+        && errno == EINVAL,
+        "ioencode_blobref fails with EINVAL on negative offset");
+    ok (ioencode_blobref ("stdout", "0", "sha1-1234", 0, 0, false) == NULL
+        && errno == EINVAL,
+        "ioencode_blobref fails with EINVAL on zero length");
+
+    ok ((o = ioencode_blobref ("stderr", "[0-3]", "sha1-1234", 8, 42, true))
+        != NULL,
+        "ioencode_blobref works");
+    ok (iodecode_blobref (o, &ref, &offset, &len) == 0,
+        "iodecode_blobref works");
+    ok (streq (ref, "sha1-1234") && offset == 8 && len == 42,
+        "iodecode_blobref returned correct blobref, offset, and len");
+    data = (char *)"x";
+    ok (iodecode (o, &stream, &rank, &data, &len, &eof) == 0,
+        "iodecode works on blob reference");
+    ok (streq (stream, "stderr")
+        && streq (rank, "[0-3]")
+        && data == NULL
+        && len == 0
+        && eof == true,
+        "iodecode returned no inline data");
+    json_decref (o);
+
+    ok ((o = ioencode ("stdout", "1", "foo", 3, false)) != NULL,
+        "ioencode works");
+    errno = 0;
+    ok (iodecode_blobref (o, &ref, &offset, &len) < 0 && errno == ENOENT,
+        "iodecode_blobref fails with ENOENT on inline data");
+    json_decref (o);
+
+    if (!(o = json_pack ("{s:s s:s s:s}",
+                         "stream", "stdout",
+                         "rank", "0",
+                         "blobref", "sha1-1234")))
+        BAIL_OUT ("json_pack failed");
+    errno = 0;
+    ok (iodecode_blobref (o, &ref, &offset, &len) < 0 && errno == EPROTO,
+        "iodecode_blobref fails with EPROTO on missing offset and len");
+    json_decref (o);
+
+    errno = 0;
+    ok (iodecode_blobref (NULL, &ref, &offset, &len) < 0 && errno == EINVAL,
+        "iodecode_blobref fails with EINVAL on NULL object");
+}
+
 int main (int argc, char *argv[])
 {
     plan (NO_PLAN);
@@ -142,6 +203,7 @@ int main (int argc, char *argv[])
     basic_corner_case ();
     basic ();
     binary_data ();
+    blobref ();
 
     done_testing ();
 
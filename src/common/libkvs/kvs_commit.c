@@ -13,11 +13,15 @@
 #endif
 #include <jansson.h>
 #include <flux/core.h>
+#include <arpa/inet.h>
+#include <stdint.h>
+#include <string.h>
 
 #include "treeobj.h"
 #include "kvs_txn_private.h"
 #include "kvs_util_private.h"
 #include "src/common/libutil/blobref.h"
+#include "src/common/libutil/errno_safe.h"
 
 static const char *auxkey = "flux::commit_ctx";
 
@@ -35,6 +39,55 @@ static void free_ctx (struct commit_ctx *ctx)
     }
 }
 
+/* Send a kvs.commit request whose payload is the JSON header, a zero
+ * byte, then each blob as a 32-bit length in network byte order followed
+ * by its data.  The payload is built once and handed to the message.
+ */
+static flux_future_t *commit_rpc_blobs (flux_t *h,
+                                        json_t *hdr,
+                                        const struct iovec *iov,
+                                        int iovcnt)
+{
+    flux_msg_t *msg = NULL;
+    flux_future_t *f = NULL;
+    char *s;
+    size_t hdrsize;
+    size_t size;
+    char *buf = NULL;
+    char *p;
+
+    if (!(s = json_dumps (hdr, JSON_COMPACT))) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    hdrsize = strlen (s) + 1;
+    size = hdrsize;
+    for (int i = 0; i < iovcnt; i++)
+        size += sizeof (uint32_t) + iov[i].iov_len;
+    if (!(buf = malloc (size)))
+        goto error;
+    memcpy (buf, s, hdrsize);
+    p = buf + hdrsize;
+    for (int i = 0; i < iovcnt; i++) {
+        uint32_t len = htonl (iov[i].iov_len);
+
+        memcpy (p, &len, sizeof (len));
+        p += sizeof (len);
+        memcpy (p, iov[i].iov_base, iov[i].iov_len);
+        p += iov[i].iov_len;
+    }
+    if (!(msg = flux_request_encode_raw ("kvs.commit", NULL, 0))
+        || flux_msg_set_payload_nocopy (msg, buf, size) < 0)
+        goto error;
+    buf = NULL;
+    f = flux_rpc_message (h, msg, FLUX_NODEID_ANY, 0);
+error:
+    ERRNO_SAFE_WRAP (free, buf);
+    ERRNO_SAFE_WRAP (free, s);
+    flux_msg_decref (msg);
+    return f;
+}
+
 flux_future_t *flux_kvs_commit (flux_t *h,
                                 const char *ns,
                                 int flags,
@@ -43,6 +96,8 @@ flux_future_t *flux_kvs_commit (flux_t *h,
     flux_future_t *f;
     struct commit_ctx *ctx = NULL;
     json_t *ops;
+    struct iovec *iov;
+    int iovcnt;
 
     if (!txn) {
         errno = EINVAL;
@@ -60,23 +115,39 @@ flux_future_t *flux_kvs_commit (flux_t *h,
         flags &= ~FLUX_KVS_TXN_COMPACT;
     }
 
-    if (!(ops = txn_get_ops (txn))) {
-        errno = EINVAL;
+    if (txn_get_ops_blobs (txn, &ops, &iov, &iovcnt) < 0)
         return NULL;
-    }
 
     if (!(ctx = calloc (1, sizeof (*ctx))))
-        return NULL;
+        goto error_ops;
 
-    if (!(f = flux_rpc_pack (h,
-                             "kvs.commit",
-                             FLUX_NODEID_ANY,
-                             0,
-                             "{s:s s:i s:O}",
-                             "namespace", ns,
-                             "flags", flags,
-                             "ops", ops)))
+    if (iovcnt > 0) {
+        json_t *hdr;
+
+        if (!(hdr = json_pack ("{s:s s:i s:O}",
+                               "namespace", ns,
+                               "flags", flags,
+                               "ops", ops))) {
+            errno = ENOMEM;
+            goto error;
+        }
+        f = commit_rpc_blobs (h, hdr, iov, iovcnt);
+        json_decref (hdr);
+    }
+    else {
+        f = flux_rpc_pack (h,
+                           "kvs.commit",
+                           FLUX_NODEID_ANY,
+                           0,
+                           "{s:s s:i s:O}",
+                           "namespace", ns,
+                           "flags", flags,
+                           "ops", ops);
+    }
+    if (!f)
         goto error;
+    json_decref (ops);
+    free (iov);
 
     if (flux_future_aux_set (f, auxkey, ctx, (flux_free_f)free_ctx) < 0)
         goto error_future;
@@ -85,8 +156,13 @@ flux_future_t *flux_kvs_commit (flux_t *h,
 
 error_future:
     flux_future_destroy (f);
+    free_ctx (ctx);
+    return NULL;
 error:
     free_ctx (ctx);
+error_ops:
+    ERRNO_SAFE_WRAP (json_decref, ops);
+    ERRNO_SAFE_WRAP (free, iov);
     return NULL;
 }
 
@@ -81,6 +81,11 @@ nomem:
 
 static int validate_lookup_flags (int flags, bool watch_ok)
 {
+    /* FLUX_KVS_RAW is a one-shot lookup of a value, so it may not be
+     * combined with any other flag.
+     */
+    if ((flags & FLUX_KVS_RAW))
+        return flags == FLUX_KVS_RAW ? 0 : -1;
     if ((flags & FLUX_KVS_WATCH) && !watch_ok)
         return -1;
     if ((flags & FLUX_KVS_WATCH_FLAGS)
@@ -252,6 +257,28 @@ static void cleanup_ctx_data (struct lookup_data *data)
     memset (data, 0, sizeof (*data));
 }
 
+/* Parse a FLUX_KVS_RAW lookup response message.  The payload is the value
+ * followed by a terminating zero byte that is not reflected in 'len'.
+ * An empty value is returned as data=NULL, len=0, as for a treeobj val.
+ */
+static int parse_raw_response (flux_future_t *f,
+                               const void **data,
+                               size_t *len)
+{
+    const char *buf;
+    size_t size;
+
+    if (flux_rpc_get_raw (f, (const void **)&buf, &size) < 0)
+        return -1;
+    if (!buf || size == 0 || buf[size - 1] != '\0') {
+        errno = EPROTO;
+        return -1;
+    }
+    *data = size > 1 ? buf : NULL;
+    *len = size - 1;
+    return 0;
+}
+
 /* Parse the lookup response message, extracting the 'val' treeobj.
  * If decoded results were previously cached and the response has
  * changed (e.g. future has been reset and another response has arrived),
@@ -291,6 +318,17 @@ int flux_kvs_lookup_get (flux_future_t *f, const char **value)
 
     if (!(ctx = get_lookup_ctx (f)))
         return -1;
+    if ((ctx->flags & FLUX_KVS_RAW)) {
+        const void *data;
+        size_t len;
+
+        // N.B. raw payload includes xtra 0 byte term not reflected in len
+        if (parse_raw_response (f, &data, &len) < 0)
+            return -1;
+        if (value)
+            *value = data;
+        return 0;
+    }
     if (parse_response (f, ctx) < 0)
         return -1;
     if (!ctx->data.val_valid) {
@@ -315,7 +353,17 @@ int flux_kvs_lookup_get_treeobj (flux_future_t *f, const char **treeobj)
 
     if (!(ctx = get_lookup_ctx (f)))
         return -1;
-    if (parse_response (f, ctx) < 0)
+    if ((ctx->flags & FLUX_KVS_RAW)) {
+        if (!ctx->data.treeobj) {
+            const void *data;
+            size_t len;
+
+            if (parse_raw_response (f, &data, &len) < 0
+                || !(ctx->data.treeobj = treeobj_create_val (data, len)))
+                return -1;
+        }
+    }
+    else if (parse_response (f, ctx) < 0)
         return -1;
     if (!ctx->data.treeobj_str) {
         if (!(ctx->data.treeobj_str = treeobj_encode (ctx->data.treeobj)))
@@ -334,6 +382,23 @@ int flux_kvs_lookup_get_unpack (flux_future_t *f, const char *fmt, ...)
 
     if (!(ctx = get_lookup_ctx (f)))
         return -1;
+    if ((ctx->flags & FLUX_KVS_RAW)) {
+        if (!ctx->data.val_obj) {
+            const void *data;
+            size_t len;
+
+            if (parse_raw_response (f, &data, &len) < 0)
+                return -1;
+            if (!(ctx->data.val_obj = json_loadb (data,
+                                                  len,
+                                                  JSON_DECODE_ANY,
+                                                  NULL))) {
+                errno = EINVAL;
+                return -1;
+            }
+        }
+        goto unpack;
+    }
     if (parse_response (f, ctx) < 0)
         return -1;
     if (!ctx->data.val_valid) {
@@ -352,6 +417,7 @@ int flux_kvs_lookup_get_unpack (flux_future_t *f, const char *fmt, ...)
             return -1;
         }
     }
+unpack:
     va_start (ap, fmt);
     if ((rc = json_vunpack_ex (ctx->data.val_obj, NULL, 0, fmt, ap) < 0))
         errno = EINVAL;
@@ -366,6 +432,18 @@ int flux_kvs_lookup_get_raw (flux_future_t *f, const void **data, size_t *len)
 
     if (!(ctx = get_lookup_ctx (f)))
         return -1;
+    if ((ctx->flags & FLUX_KVS_RAW)) {
+        const void *d;
+        size_t l;
+
+        if (parse_raw_response (f, &d, &l) < 0)
+            return -1;
+        if (data)
+            *data = d;
+        if (len)
+            *len = l;
+        return 0;
+    }
     if (parse_response (f, ctx) < 0)
         return -1;
     if (!ctx->data.val_valid) {
@@ -391,6 +469,10 @@ int flux_kvs_lookup_get_dir (flux_future_t *f, const flux_kvsdir_t **dirp)
 
     if (!(ctx = get_lookup_ctx (f)))
         return -1;
+    if ((ctx->flags & FLUX_KVS_RAW)) {
+        errno = EINVAL;
+        return -1;
+    }
     if (parse_response (f, ctx) < 0)
         return -1;
     if (!ctx->data.dir) {
@@ -414,6 +496,10 @@ int flux_kvs_lookup_get_symlink (flux_future_t *f,
 
     if (!(ctx = get_lookup_ctx (f)))
         return -1;
+    if ((ctx->flags & FLUX_KVS_RAW)) {
+        errno = EINVAL;
+        return -1;
+    }
     if (parse_response (f, ctx) < 0)
         return -1;
     if (!treeobj_is_symlink (ctx->data.treeobj)) {
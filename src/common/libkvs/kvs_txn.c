@@ -14,6 +14,9 @@
 #include <jansson.h>
 #include <flux/core.h>
 #include <string.h>
+#include <stdint.h>
+
+#include "src/common/libutil/errno_safe.h"
 
 #include "kvs_txn_private.h"
 #include "treeobj.h"
@@ -30,16 +33,71 @@
  * are themselves JSON.  This is a change from the original design,
  * which stored only JSON values.
  *
+ * Large raw values:
+ * flux_kvs_txn_put_raw() values of at least TXN_BLOB_MIN bytes are kept
+ * in txn->blobs, keyed by their operation, whose dirent is an empty val.
+ * flux_kvs_commit() sends them as binary after the request JSON and the
+ * KVS module stores them and substitutes valrefs, so they are never
+ * base64 encoded.
+ *
  * NULL or empty values:
  * A zero-length value may be stored in the KVS via
  * flux_kvs_txn_put (value=NULL) or flux_kvs_txn_put_raw (data=NULL,len=0).
  * A NULL format string passed to flux_kvs_txn_pack() is invalid.
  */
 
+struct txn_blob {
+    void *data;
+    size_t len;
+};
+
+static void txn_blob_destroy (struct txn_blob *blob)
+{
+    if (blob) {
+        int saved_errno = errno;
+        free (blob->data);
+        free (blob);
+        errno = saved_errno;
+    }
+}
+
+// zhashx_destructor_t footprint
+static void txn_blob_destructor (void **item)
+{
+    if (item) {
+        txn_blob_destroy (*item);
+        *item = NULL;
+    }
+}
+
+// zhashx_destructor_t footprint
+static void op_destructor (void **key)
+{
+    if (key) {
+        json_decref (*key);
+        *key = NULL;
+    }
+}
+
+// zhashx_hash_fn footprint
+static size_t op_hasher (const void *key)
+{
+    return (uintptr_t)key;
+}
+
+// zhashx_comparator_fn footprint
+static int op_comparator (const void *key1, const void *key2)
+{
+    if (key1 < key2)
+        return -1;
+    return key1 > key2 ? 1 : 0;
+}
+
 void flux_kvs_txn_destroy (flux_kvs_txn_t *txn)
 {
     if (txn) {
         int saved_errno = errno;
+        zhashx_destroy (&txn->blobs);
         json_decref (txn->ops);
         free (txn);
         errno = saved_errno;
@@ -92,6 +150,60 @@ static int append_op_to_txn (flux_kvs_txn_t *txn,
     return 0;
 }
 
+/* Append an operation for a large raw value, whose data is copied to a
+ * blob.  Values to be appended are always encoded in the dirent, since
+ * the KVS module merges them with the existing value.
+ */
+static int append_blob_op_to_txn (flux_kvs_txn_t *txn,
+                                  const char *key,
+                                  const void *data,
+                                  size_t len)
+{
+    json_t *dirent;
+    json_t *op = NULL;
+    struct txn_blob *blob = NULL;
+
+    if (!txn->blobs) {
+        if (!(txn->blobs = zhashx_new ())) {
+            errno = ENOMEM;
+            return -1;
+        }
+        zhashx_set_key_hasher (txn->blobs, op_hasher);
+        zhashx_set_key_comparator (txn->blobs, op_comparator);
+        zhashx_set_key_duplicator (txn->blobs, NULL);
+        zhashx_set_key_destructor (txn->blobs, op_destructor);
+        zhashx_set_destructor (txn->blobs, txn_blob_destructor);
+    }
+    if (!(dirent = treeobj_create_val (NULL, 0)))
+        return -1;
+    if (txn_encode_op (key, 0, dirent, &op) < 0) {
+        ERRNO_SAFE_WRAP (json_decref, dirent);
+        return -1;
+    }
+    json_decref (dirent);
+    if (!(blob = calloc (1, sizeof (*blob)))
+        || !(blob->data = malloc (len)))
+        goto nomem;
+    memcpy (blob->data, data, len);
+    blob->len = len;
+    if (zhashx_insert (txn->blobs, json_incref (op), blob) < 0) {
+        json_decref (op);
+        goto nomem;
+    }
+    if (json_array_append_new (txn->ops, op) < 0) {
+        // jansson decrefs the new object on failure
+        zhashx_delete (txn->blobs, op);
+        errno = ENOMEM;
+        return -1;
+    }
+    return 0;
+nomem:
+    txn_blob_destroy (blob);
+    json_decref (op);
+    errno = ENOMEM;
+    return -1;
+}
+
 int flux_kvs_txn_put_raw (flux_kvs_txn_t *txn,
                           int flags,
                           const char *key,
@@ -107,6 +219,8 @@ int flux_kvs_txn_put_raw (flux_kvs_txn_t *txn,
     }
     if (validate_flags (flags, FLUX_KVS_APPEND) < 0)
         goto error;
+    if (flags == 0 && len >= TXN_BLOB_MIN && len <= UINT32_MAX && data)
+        return append_blob_op_to_txn (txn, key, data, len);
     if (!(dirent = treeobj_create_val (data, len)))
         goto error;
     if (append_op_to_txn (txn, flags, key, dirent) < 0)
@@ -332,6 +446,8 @@ int flux_kvs_txn_clear (flux_kvs_txn_t *txn)
         errno = ENOMEM;
         return -1;
     }
+    if (txn->blobs)
+        zhashx_purge (txn->blobs);
     return 0;
 }
 
@@ -366,6 +482,57 @@ int txn_get_op (flux_kvs_txn_t *txn, int index, json_t **op)
     return 0;
 }
 
+int txn_get_ops_blobs (flux_kvs_txn_t *txn,
+                       json_t **opsp,
+                       struct iovec **iovp,
+                       int *iovcntp)
+{
+    json_t *ops;
+    struct iovec *iov;
+    int iovcnt = 0;
+    size_t index;
+    json_t *op;
+
+    if (!txn->blobs || zhashx_size (txn->blobs) == 0) {
+        *opsp = json_incref (txn->ops);
+        *iovp = NULL;
+        *iovcntp = 0;
+        return 0;
+    }
+    if (!(iov = calloc (zhashx_size (txn->blobs), sizeof (iov[0]))))
+        return -1;
+    if (!(ops = json_array ()))
+        goto nomem;
+    json_array_foreach (txn->ops, index, op) {
+        struct txn_blob *blob;
+        json_t *o;
+
+        if ((blob = zhashx_lookup (txn->blobs, op))) {
+            if (!(o = json_pack ("{s:O s:i s:i}",
+                                 "key", json_object_get (op, "key"),
+                                 "flags", 0,
+                                 "blob", iovcnt)))
+                goto nomem;
+            iov[iovcnt].iov_base = blob->data;
+            iov[iovcnt].iov_len = blob->len;
+            iovcnt++;
+        }
+        else
+            o = json_incref (op);
+        if (json_array_append_new (ops, o) < 0)
+            goto nomem;
+    }
+    *opsp = ops;
+    *iovp = iov;
+    *iovcntp = iovcnt;
+    return 0;
+nomem:
+    json_decref (ops);
+    free (iov);
+    errno = ENOMEM;
+    return -1;
+}
+
 int txn_decode_op (json_t *op, const char **keyp, int *flagsp, json_t **direntp)
 {
     const char *key;
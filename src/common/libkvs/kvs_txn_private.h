@@ -11,8 +11,19 @@
 #ifndef _KVS_TXN_PRIVATE_H
 #define _KVS_TXN_PRIVATE_H
 
+#include <sys/uio.h>
+
+#include "src/common/libczmqcontainers/czmq_containers.h"
+
+/* flux_kvs_txn_put_raw() values of at least this size are carried by
+ * flux_kvs_commit() as binary blobs after the JSON request header,
+ * instead of base64 encoded in the operation's dirent.
+ */
+#define TXN_BLOB_MIN 4096
+
 struct flux_kvs_txn {
     json_t *ops;
+    zhashx_t *blobs;    // op => struct txn_blob, created on first use
 };
 
 int txn_get_op_count (flux_kvs_txn_t *txn);
@@ -25,6 +36,18 @@ int txn_decode_op (json_t *op, const char **key, int *flags, json_t **dirent);
 
 int txn_encode_op (const char *key, int flags, json_t *dirent, json_t **op);
 
+/* Get the operations of 'txn' for a kvs.commit request.  If the txn
+ * carries blobs, a new array is returned in which each operation with a
+ * blob is replaced by { "key":s "flags":i "blob":i }, where "blob" is an
+ * index into 'iov', which is allocated and must be freed by the caller.
+ * Otherwise the txn ops are returned and 'iovcnt' is set to zero.
+ * The caller must json_decref() 'ops'.
+ */
+int txn_get_ops_blobs (flux_kvs_txn_t *txn,
+                       json_t **ops,
+                       struct iovec **iov,
+                       int *iovcnt);
+
 int txn_compact (flux_kvs_txn_t *txn);
 
 #endif /* !_KVS_TXN_PRIVATE_H */
@@ -469,6 +469,70 @@ void test_corner_cases (void)
     flux_kvs_txn_destroy (txn);
 }
 
+void test_raw_blobs (void)
+{
+    flux_kvs_txn_t *txn;
+    char buf[TXN_BLOB_MIN];
+    json_t *ops, *entry;
+    struct iovec *iov;
+    int iovcnt;
+    const char *key;
+    int blob;
+
+    memset (buf, 'b', sizeof (buf));
+
+    txn = flux_kvs_txn_create ();
+    ok (txn != NULL,
+        "flux_kvs_txn_create works");
+    ok (flux_kvs_txn_put_raw (txn, 0, "small", buf, sizeof (buf) - 1) == 0,
+        "flux_kvs_txn_put_raw works with value smaller than TXN_BLOB_MIN");
+    ok (flux_kvs_txn_put_raw (txn, 0, "large", buf, sizeof (buf)) == 0,
+        "flux_kvs_txn_put_raw works with value of TXN_BLOB_MIN");
+    ok (flux_kvs_txn_put_raw (txn,
+                              FLUX_KVS_APPEND,
+                              "append",
+                              buf,
+                              sizeof (buf)) == 0,
+        "flux_kvs_txn_put_raw works with large value and FLUX_KVS_APPEND");
+    ok (txn_get_op_count (txn) == 3,
+        "txn contains three ops");
+    ok (txn_compact (txn) == 0,
+        "txn_compact works");
+
+    ok (txn_get_ops_blobs (txn, &ops, &iov, &iovcnt) == 0,
+        "txn_get_ops_blobs works");
+    ok (json_array_size (ops) == 3,
+        "ops array contains three ops");
+    ok (iovcnt == 1
+        && iov[0].iov_len == sizeof (buf)
+        && memcmp (iov[0].iov_base, buf, sizeof (buf)) == 0,
+        "one blob was returned containing the large value");
+    entry = json_array_get (ops, 0);
+    ok (txn_decode_op (entry, &key, NULL, NULL) == 0 && streq (key, "small"),
+        "small value is encoded in the op dirent");
+    entry = json_array_get (ops, 1);
+    jdiag (entry);
+    ok (json_unpack (entry, "{s:s s:i}", "key", &key, "blob", &blob) == 0
+        && streq (key, "large")
+        && blob == 0,
+        "large value op refers to blob 0");
+    entry = json_array_get (ops, 2);
+    ok (txn_decode_op (entry, &key, NULL, NULL) == 0 && streq (key, "append"),
+        "appended large value is encoded in the op dirent");
+    json_decref (ops);
+    free (iov);
+
+    ok (flux_kvs_txn_clear (txn) == 0,
+        "flux_kvs_txn_clear works");
+    ok (txn_get_ops_blobs (txn, &ops, &iov, &iovcnt) == 0
+        && json_array_size (ops) == 0
+        && iovcnt == 0,
+        "txn_get_ops_blobs returns no ops or blobs after clear");
+    json_decref (ops);
+
+    flux_kvs_txn_destroy (txn);
+}
+
 int main (int argc, char *argv[])
 {
 
@@ -476,6 +540,7 @@ int main (int argc, char *argv[])
 
     basic ();
     test_raw_values ();
+    test_raw_blobs ();
     test_corner_cases ();
 
     done_testing();
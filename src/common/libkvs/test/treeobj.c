@@ -289,6 +289,71 @@ void test_dirref (void)
     json_decref (dirref);
 }
 
+void test_dirref_sharded (void)
+{
+    json_t *dirref;
+    int i;
+    int counts[TREEOBJ_SHARD_FANOUT] = { 0 };
+    int index, depth;
+    bool inrange = true;
+    bool spread = true;
+
+    if (!(dirref = treeobj_create_dirref (blobrefs[0])))
+        BAIL_OUT ("treeobj_create_dirref failed");
+    ok (!treeobj_is_dirref_sharded (dirref),
+        "treeobj_is_dirref_sharded returns false for 1 blobref");
+    for (i = 1; i < TREEOBJ_SHARD_FANOUT; i++) {
+        if (treeobj_append_blobref (dirref, blobrefs[0]) < 0)
+            BAIL_OUT ("treeobj_append_blobref failed");
+    }
+    ok (treeobj_validate (dirref) == 0,
+        "treeobj_validate likes sharded dirref");
+    ok (treeobj_is_dirref_sharded (dirref),
+        "treeobj_is_dirref_sharded returns true for %d blobrefs",
+        TREEOBJ_SHARD_FANOUT);
+    json_decref (dirref);
+
+    ok (treeobj_is_dirref_sharded (NULL) == false,
+        "treeobj_is_dirref_sharded returns false on NULL");
+    errno = 0;
+    ok (treeobj_shard_index (NULL, 0) < 0 && errno == EINVAL,
+        "treeobj_shard_index name=NULL fails with EINVAL");
+    errno = 0;
+    ok (treeobj_shard_index ("a", -1) < 0 && errno == EINVAL,
+        "treeobj_shard_index depth=-1 fails with EINVAL");
+    errno = 0;
+    ok (treeobj_shard_index ("a", TREEOBJ_SHARD_MAX_DEPTH) < 0
+        && errno == EINVAL,
+        "treeobj_shard_index depth=%d fails with EINVAL",
+        TREEOBJ_SHARD_MAX_DEPTH);
+    ok (treeobj_shard_index ("entry-1", 0)
+        == treeobj_shard_index ("entry-1", 0),
+        "treeobj_shard_index is deterministic");
+
+    for (depth = 0; depth < TREEOBJ_SHARD_MAX_DEPTH; depth++) {
+        memset (counts, 0, sizeof (counts));
+        for (i = 0; i < large_dir_entries; i++) {
+            char name[256];
+            snprintf (name, sizeof (name), "entry-%.10d", i);
+            index = treeobj_shard_index (name, depth);
+            if (index < 0 || index >= TREEOBJ_SHARD_FANOUT) {
+                inrange = false;
+                break;
+            }
+            counts[index]++;
+        }
+        for (i = 0; i < TREEOBJ_SHARD_FANOUT; i++) {
+            if (counts[i] == 0)
+                spread = false;
+        }
+    }
+    ok (inrange,
+        "treeobj_shard_index returns index < %d at all depths",
+        TREEOBJ_SHARD_FANOUT);
+    ok (spread,
+        "treeobj_shard_index uses every shard at all depths");
+}
+
 void test_dir (void)
 {
     json_t *dir;
@@ -853,6 +918,7 @@ int main(int argc, char** argv)
     test_valref ();
     test_val ();
     test_dirref ();
+    test_dirref_sharded ();
     test_dir ();
     test_dir_peek ();
     test_copy ();
@@ -17,6 +17,7 @@
 #include <string.h>
 #include <assert.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <jansson.h>
 
 #include "ccan/base64/base64.h"
@@ -466,6 +467,29 @@ done:
     return blobref;
 }
 
+bool treeobj_is_dirref_sharded (const json_t *obj)
+{
+    return treeobj_is_dirref (obj)
+        && treeobj_get_count (obj) == TREEOBJ_SHARD_FANOUT;
+}
+
+/* 32-bit FNV-1a hash, consumed 4 bits (one shard index) per depth.
+ */
+int treeobj_shard_index (const char *name, int depth)
+{
+    uint32_t hash = 2166136261U;
+
+    if (!name || depth < 0 || depth >= TREEOBJ_SHARD_MAX_DEPTH) {
+        errno = EINVAL;
+        return -1;
+    }
+    while (*name) {
+        hash ^= (unsigned char)*name++;
+        hash *= 16777619U;
+    }
+    return (hash >> (depth * 4)) & (TREEOBJ_SHARD_FANOUT - 1);
+}
+
 json_t *treeobj_create_dir (void)
 {
     json_t *obj;
@@ -121,6 +121,25 @@ int treeobj_append_blobref (json_t *obj, const char *blobref);
  */
 const char *treeobj_get_blobref (const json_t *obj, int index);
 
+/* Sharded directories (an extension of RFC 11).
+ * A dirref with TREEOBJ_SHARD_FANOUT blobrefs is one directory split
+ * into shards by a hash of the entry names.  Blobref i refers to the
+ * shard holding the names whose index at that depth is i: either a dir,
+ * or another sharded dirref one level deeper.  Entries are found by
+ * following the shard for their name, so modifying an entry rewrites
+ * only the shards along that path.  Depth is counted from 0 and is less
+ * than TREEOBJ_SHARD_MAX_DEPTH.
+ */
+#define TREEOBJ_SHARD_FANOUT    16
+#define TREEOBJ_SHARD_MAX_DEPTH 8
+
+bool treeobj_is_dirref_sharded (const json_t *obj);
+
+/* Return the shard index of directory entry 'name' at 'depth',
+ * or -1 with errno = EINVAL on invalid argument.
+ */
+int treeobj_shard_index (const char *name, int depth);
+
 /* Create valref that refers to 'data', a blob of 'len' bytes using
  * 'hashtype' hash algorithm (e.g. "sha1").  If 'maxblob' > 0, split the
  * blob into maxblob size chunks.
@@ -20,6 +20,7 @@
 
 #include "router.h"
 #include "subhash.h"
+#include "subtrie.h"
 #include "servhash.h"
 #include "disconnect.h"
 
@@ -37,6 +38,7 @@ struct router {
     zhashx_t *routes;               // uuid => 'struct router_entry'
     void *arg;
     struct subhash *subscriptions;  // router's subscriber hash
+    struct subtrie *index;          // topic prefix => router entries
     struct servhash *services;
     flux_msg_handler_t **handlers;
     bool mute;
@@ -226,24 +228,36 @@ static int broker_unsubscribe (const char *topic, void *arg)
     return 0;
 }
 
-/* A client asks the router to subscribe.
+/* A client asks the router to subscribe to a new topic.
  * This might generate a broker_subscribe() or just usecount++.
+ * The client is added to the router's subscription index for event_cb().
  */
 static int router_subscribe (const char *topic, void *arg)
 {
-    struct router *rtr = arg;
+    struct router_entry *entry = arg;
+    struct router *rtr = entry->rtr;
 
-    return subhash_subscribe (rtr->subscriptions, topic);
+    if (subhash_subscribe (rtr->subscriptions, topic) < 0)
+        return -1;
+    if (subtrie_add (rtr->index, topic, entry) < 0) {
+        ERRNO_SAFE_WRAP (subhash_unsubscribe, rtr->subscriptions, topic);
+        return -1;
+    }
+    return 0;
 }
 
-/* A client asks the router to unsubscribe.
+/* A client asks the router to unsubscribe from its last reference to topic.
  * This might generate a broker_unsubscribe() or just usecount--.
  */
 static int router_unsubscribe (const char *topic, void *arg)
 {
-    struct router *rtr = arg;
+    struct router_entry *entry = arg;
+    struct router *rtr = entry->rtr;
 
-    return subhash_unsubscribe (rtr->subscriptions, topic);
+    if (subhash_unsubscribe (rtr->subscriptions, topic) < 0)
+        return -1;
+    (void)subtrie_remove (rtr->index, topic, entry);
+    return 0;
 }
 
 static void disconnect_cb (const flux_msg_t *msg, void *arg)
@@ -319,15 +333,14 @@ struct router_entry *router_entry_add (struct router *rtr,
     if (!(entry = router_entry_create (uuid, cb, arg)))
         return NULL;
 
-    subhash_set_subscribe (entry->subscriptions, router_subscribe, rtr);
-    subhash_set_unsubscribe (entry->subscriptions, router_unsubscribe, rtr);
-
     if (zhashx_insert (rtr->routes, uuid, entry) < 0) {
         router_entry_destroy (entry);
         errno = EEXIST;
         return NULL;
     }
     entry->rtr = rtr;
+    subhash_set_subscribe (entry->subscriptions, router_subscribe, entry);
+    subhash_set_unsubscribe (entry->subscriptions, router_unsubscribe, entry);
     return entry;
 }
 
@@ -398,6 +411,19 @@ error:
     return;
 }
 
+/* subtrie_match_f footprint */
+static void event_send_cb (void *subscriber, void *arg)
+{
+    struct router_entry *entry = subscriber;
+    const flux_msg_t *msg = arg;
+
+    if (entry->send (msg, entry->arg) < 0) {
+        flux_log_error (entry->rtr->h,
+                        "router: event > client=%.5s",
+                        entry->uuid);
+    }
+}
+
 /* Receive event from broker.
  * Distribute to all router entries with matching subscriptions.
  */
@@ -407,22 +433,13 @@ static void event_cb (flux_t *h,
                       void *arg)
 {
     struct router *rtr = arg;
-    struct router_entry *entry;
     const char *topic;
 
     if (flux_msg_get_topic (msg, &topic) < 0) {
         flux_log_error (h, "router: event > client");
         return;
     }
-
-    entry = zhashx_first (rtr->routes);
-    while ((entry)) {
-        if (subhash_topic_match (entry->subscriptions, topic)) {
-            if (entry->send (msg, entry->arg) < 0)
-                flux_log_error (h, "router: event > client=%.5s", entry->uuid);
-        }
-        entry = zhashx_next (rtr->routes);
-    }
+    (void)subtrie_match (rtr->index, topic, event_send_cb, (void *)msg);
 }
 
 static const struct flux_msg_handler_spec htab[] = {
@@ -453,6 +470,9 @@ struct router *router_create (flux_t *h)
     subhash_set_subscribe (rtr->subscriptions, broker_subscribe, rtr);
     subhash_set_unsubscribe (rtr->subscriptions, broker_unsubscribe, rtr);
 
+    if (!(rtr->index = subtrie_create ()))
+        goto error;
+
     if (!(rtr->services = servhash_create (h)))
         goto error;
     servhash_set_respond (rtr->services, router_entry_respond_byuuid, rtr);
@@ -469,13 +489,39 @@ void router_destroy (struct router *rtr)
 {
     if (rtr) {
         flux_msg_handler_delvec (rtr->handlers);
+        /* Destroy entries first since they unsubscribe from
+         * rtr->subscriptions and rtr->index, and disconnect services.
+         */
+        ERRNO_SAFE_WRAP (zhashx_destroy, &rtr->routes);
         subhash_destroy (rtr->subscriptions);
+        subtrie_destroy (rtr->index);
         servhash_destroy (rtr->services);
-        ERRNO_SAFE_WRAP (zhashx_destroy, &rtr->routes);
         ERRNO_SAFE_WRAP (free, rtr);
     }
 }
 
+json_t *router_stats_get (struct router *rtr)
+{
+    json_t *services;
+    json_t *o;
+
+    if (!rtr) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(services = servhash_stats_get (rtr->services)))
+        return NULL;
+    if (!(o = json_pack ("{s:O s:i}",
+                         "services", services,
+                         "subscribers", subtrie_count (rtr->index)))) {
+        json_decref (services);
+        errno = ENOMEM;
+        return NULL;
+    }
+    json_decref (services);
+    return o;
+}
+
 void router_mute (struct router *rtr)
 {
     if (rtr)
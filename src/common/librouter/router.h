@@ -11,6 +11,8 @@
 #ifndef _ROUTER_ROUTER_H
 #define _ROUTER_ROUTER_H
 
+#include <jansson.h>
+
 #include "subhash.h"
 
 struct router;
@@ -47,6 +49,11 @@ int router_renew (struct router *rtr);
 struct router *router_create (flux_t *h);
 void router_destroy (struct router *rtr);
 
+/* Get router statistics as a JSON object, including servhash_match()
+ * counters for routing requests to client services.
+ */
+json_t *router_stats_get (struct router *rtr);
+
 /* Avoid unsubscribe deadlock during broker shutdown - issue #1025
  */
 void router_mute (struct router *rtr);
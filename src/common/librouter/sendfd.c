@@ -42,6 +42,15 @@
  * - sendfd/recvfd do not encrypt messages, therefore this transport
  *   is only appropriate for use on AF_LOCAL sockets or on file descriptors
  *   tunneled through a secure channel.
+ *
+ * The iostream functions use the same encoding, so either end of a
+ * connection may use them without the other end knowing.  An output
+ * iostream accumulates encoded messages so they can be written with one
+ * write(2).  An input iostream reads as much as is available into a reusable
+ * buffer, then messages are decoded from it until it runs out of complete
+ * messages, at which point any partial message is moved to the front of the
+ * buffer.  The buffer grows as needed to hold a large message and is freed
+ * when it is empty if it grew beyond IOSTREAM_MAXKEEP.
  */
 
 #if HAVE_CONFIG_H
@@ -49,12 +58,19 @@
 #endif
 #include <arpa/inet.h>
 #include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
 #include <flux/core.h>
 
 #include "sendfd.h"
 
 #define IOBUF_MAGIC 0xffee0012
 
+#define IOSTREAM_MINSIZE    65536
+#define IOSTREAM_MINREAD    4096
+#define IOSTREAM_MAXKEEP    (16*IOSTREAM_MINSIZE)
+
 void iobuf_init (struct iobuf *iobuf)
 {
     memset (iobuf, 0, sizeof (*iobuf));
@@ -178,6 +194,186 @@ done:
     return msg;
 }
 
+void iostream_init (struct iostream *ios)
+{
+    memset (ios, 0, sizeof (*ios));
+}
+
+void iostream_clean (struct iostream *ios)
+{
+    free (ios->buf);
+    memset (ios, 0, sizeof (*ios));
+}
+
+size_t iostream_pending (const struct iostream *ios)
+{
+    return ios->tail - ios->head;
+}
+
+/* Reset an empty stream, freeing the buffer if it grew too large.
+ */
+static void iostream_reset (struct iostream *ios)
+{
+    if (ios->size > IOSTREAM_MAXKEEP)
+        iostream_clean (ios);
+    ios->head = ios->tail = 0;
+}
+
+/* Make room for at least 'needed' bytes after ios->tail.
+ */
+static int iostream_reserve (struct iostream *ios, size_t needed)
+{
+    size_t used = ios->tail - ios->head;
+    size_t newsize;
+    uint8_t *buf;
+
+    if (ios->tail + needed <= ios->size)
+        return 0;
+    if (ios->head > 0) {
+        memmove (ios->buf, ios->buf + ios->head, used);
+        ios->head = 0;
+        ios->tail = used;
+        if (used + needed <= ios->size)
+            return 0;
+    }
+    newsize = ios->size > 0 ? ios->size : IOSTREAM_MINSIZE;
+    while (newsize < used + needed)
+        newsize *= 2;
+    if (!(buf = realloc (ios->buf, newsize)))
+        return -1;
+    ios->buf = buf;
+    ios->size = newsize;
+    return 0;
+}
+
+/* Get the size of the message at the head of the stream, including
+ * the 8 byte header.  Return 0 if the header is incomplete.
+ */
+static size_t iostream_msgsize (const struct iostream *ios, uint32_t *magic)
+{
+    uint32_t n;
+
+    if (ios->tail - ios->head < 8)
+        return 0;
+    memcpy (magic, ios->buf + ios->head, 4);
+    memcpy (&n, ios->buf + ios->head + 4, 4);
+    return (size_t)ntohl (n) + 8;
+}
+
+ssize_t iostream_read (int fd, struct iostream *ios)
+{
+    size_t needed = IOSTREAM_MINREAD;
+    uint32_t magic;
+    size_t used;
+    size_t size;
+    ssize_t rc;
+
+    if (fd < 0 || !ios) {
+        errno = EINVAL;
+        return -1;
+    }
+    used = ios->tail - ios->head;
+    /* Don't trust the size in a header with bad magic.
+     */
+    if ((size = iostream_msgsize (ios, &magic)) > 0 && magic != IOBUF_MAGIC) {
+        errno = EPROTO;
+        return -1;
+    }
+    if (size > used && size - used > needed)
+        needed = size - used;
+    if (iostream_reserve (ios, needed) < 0)
+        return -1;
+    if ((rc = read (fd, ios->buf + ios->tail, ios->size - ios->tail)) < 0)
+        return -1;
+    if (rc == 0) {
+        errno = ECONNRESET;
+        return -1;
+    }
+    ios->tail += rc;
+    return rc;
+}
+
+bool iostream_has_msg (const struct iostream *ios)
+{
+    uint32_t magic;
+    size_t size;
+
+    if (!ios || (size = iostream_msgsize (ios, &magic)) == 0)
+        return false;
+    /* Report a bad header as ready so iostream_recv() can fail with EPROTO.
+     */
+    if (magic != IOBUF_MAGIC)
+        return true;
+    return size <= ios->tail - ios->head;
+}
+
+flux_msg_t *iostream_recv (struct iostream *ios)
+{
+    flux_msg_t *msg;
+    uint32_t magic;
+    size_t size;
+
+    if (!ios) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if ((size = iostream_msgsize (ios, &magic)) == 0) {
+        errno = EWOULDBLOCK;
+        return NULL;
+    }
+    if (magic != IOBUF_MAGIC) {
+        errno = EPROTO;
+        return NULL;
+    }
+    if (size > ios->tail - ios->head) {
+        errno = EWOULDBLOCK;
+        return NULL;
+    }
+    msg = flux_msg_decode (ios->buf + ios->head + 8, size - 8);
+    ios->head += size;
+    if (ios->head == ios->tail)
+        iostream_reset (ios);
+    return msg;
+}
+
+int iostream_append (struct iostream *ios, const flux_msg_t *msg)
+{
+    uint32_t magic = IOBUF_MAGIC;
+    uint32_t n;
+    ssize_t s;
+
+    if (!ios || !msg) {
+        errno = EINVAL;
+        return -1;
+    }
+    if ((s = flux_msg_encode_size (msg)) < 0
+        || iostream_reserve (ios, s + 8) < 0
+        || flux_msg_encode (msg, ios->buf + ios->tail + 8, s) < 0)
+        return -1;
+    n = htonl (s);
+    memcpy (ios->buf + ios->tail, &magic, 4);
+    memcpy (ios->buf + ios->tail + 4, &n, 4);
+    ios->tail += s + 8;
+    return 0;
+}
+
+int iostream_write (int fd, struct iostream *ios)
+{
+    ssize_t rc;
+
+    if (fd < 0 || !ios) {
+        errno = EINVAL;
+        return -1;
+    }
+    while (ios->head < ios->tail) {
+        if ((rc = write (fd, ios->buf + ios->head, ios->tail - ios->head)) < 0)
+            return -1;
+        ios->head += rc;
+    }
+    iostream_reset (ios);
+    return 0;
+}
+
 /*
  * vi:tabstop=4 shiftwidth=4 expandtab
  */
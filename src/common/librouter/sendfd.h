@@ -11,6 +11,7 @@
 #ifndef _ROUTER_SENDFD_H
 #define _ROUTER_SENDFD_H
 
+#include <stdbool.h>
 #include <flux/core.h>
 
 struct iobuf {
@@ -41,6 +42,53 @@ void iobuf_init (struct iobuf *iobuf);
  */
 void iobuf_clean (struct iobuf *iobuf);
 
+/* Buffered stream I/O.
+ * The encoding is the same as sendfd()/recvfd(), but many messages may be
+ * moved per system call.  Separate iostreams are required for input and
+ * output.  Call iostream_init() before first use and iostream_clean()
+ * after last use.
+ */
+struct iostream {
+    uint8_t *buf;
+    size_t size;        // allocated size of buf
+    size_t head;        // offset of first unconsumed byte
+    size_t tail;        // offset past last valid byte
+};
+
+void iostream_init (struct iostream *ios);
+void iostream_clean (struct iostream *ios);
+
+/* Read as much as is available from 'fd' (up to the buffer size) into the
+ * stream.  Returns the number of bytes read, or -1 on failure with errno set.
+ * EOF is reported as ECONNRESET.
+ */
+ssize_t iostream_read (int fd, struct iostream *ios);
+
+/* Decode the next complete message in the stream.
+ * Returns message on success, NULL on failure with errno set.
+ * EWOULDBLOCK means more data must be read first.
+ */
+flux_msg_t *iostream_recv (struct iostream *ios);
+
+/* Return true if a complete message can be decoded without further reads.
+ */
+bool iostream_has_msg (const struct iostream *ios);
+
+/* Encode message and append it to the stream for iostream_write().
+ * Returns 0 on success, -1 on failure with errno set.
+ */
+int iostream_append (struct iostream *ios, const flux_msg_t *msg);
+
+/* Write buffered data to 'fd'.  Returns 0 if the buffer was completely
+ * written, or -1 on failure with errno set.  EWOULDBLOCK means some data
+ * remains to be written when 'fd' is ready again.
+ */
+int iostream_write (int fd, struct iostream *ios);
+
+/* Return the number of bytes buffered but not yet written or decoded.
+ */
+size_t iostream_pending (const struct iostream *ios);
+
 #endif /* !_ROUTER_SENDFD_H */
 
 /*
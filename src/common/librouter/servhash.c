@@ -21,7 +21,10 @@
  *   should be directed to servhash_add() and servhash_remove().
  * - servhash_add() and servhash_remove() asynchronously request upstream reg/
  *   unreg, add/remove a servhash->services entry, and respond to the client
- * - servhash_match() can match a request message to a client uuid
+ * - servhash_match() can match a request message to a client uuid.
+ *   Services are looked up by the first component of the request topic,
+ *   as in the broker service switch.  Only names that cannot be found that
+ *   way (containing '.' or glob characters) require a scan of all entries.
  * - when a client disconnects, the router must call servhash_disconnect()
  *   with its uuid so that any services can be unregistered
  * - we have to handle some corner cases like client disconnects with
@@ -52,13 +55,19 @@ struct servhash_entry {
     flux_future_t *f_add;
     flux_future_t *f_remove;
     unsigned char live:1;
+    unsigned char is_glob:1;    // name not usable as a topic hash key
+    unsigned char hashed:1;     // entry is in sh->services
 };
 
 struct servhash {
     flux_t *h;
     zhashx_t *services;         // name => servhash_entry
+    int glob_count;             // number of entries with is_glob set
     respond_f respond_cb;
     void *respond_arg;
+    unsigned long hash_hits;
+    unsigned long scan_hits;
+    unsigned long misses;
 };
 
 /* Create a copy of request 'msg' with the route stack cleared.
@@ -109,6 +118,8 @@ done:
 static void servhash_entry_destroy (struct servhash_entry *entry)
 {
     if (entry) {
+        if (entry->hashed && entry->is_glob)
+            entry->sh->glob_count--;
         ERRNO_SAFE_WRAP (service_remove_best_effort, entry);
         flux_future_destroy (entry->f_add);
         flux_future_destroy (entry->f_remove);
@@ -143,6 +154,8 @@ static struct servhash_entry *servhash_entry_create (const char *name,
         goto error;
     entry->match = FLUX_MATCH_REQUEST;
     entry->match.topic_glob = entry->glob;
+    if (strpbrk (name, ".*?[\\"))
+        entry->is_glob = 1;
     return entry;
 error:
     servhash_entry_destroy (entry);
@@ -197,6 +210,9 @@ int servhash_add (struct servhash *sh,
     if (flux_future_then (entry->f_add, -1, add_continuation, entry) < 0)
         goto error;
     zhashx_update (sh->services, name, entry);
+    entry->hashed = 1;
+    if (entry->is_glob)
+        sh->glob_count++;
     flux_msg_destroy (cpy);
     return 0;
 error:
@@ -276,23 +292,73 @@ void servhash_disconnect (struct servhash *sh, const char *uuid)
     }
 }
 
+/* Look up a service by the first "word" of 'topic'.
+ * Avoid an extra malloc here if the substring is short.
+ */
+static struct servhash_entry *lookup_subtopic (struct servhash *sh,
+                                               const char *topic)
+{
+    const char *p;
+    size_t length;
+    char buf[64];
+    char *cpy = NULL;
+    char *service;
+    struct servhash_entry *entry;
+
+    if ((p = strchr (topic, '.')))
+        length = p - topic;
+    else
+        length = strlen (topic);
+    if (length < sizeof (buf))
+        service = buf;
+    else {
+        if (!(cpy = malloc (length + 1)))
+            return NULL;
+        service = cpy;
+    }
+    memcpy (service, topic, length);
+    service[length] = '\0';
+    entry = zhashx_lookup (sh->services, service);
+    free (cpy);
+    return entry;
+}
+
+/* Fall back to trying each entry whose name couldn't be found by
+ * lookup_subtopic().
+ */
+static struct servhash_entry *scan_globs (struct servhash *sh,
+                                          const flux_msg_t *msg)
+{
+    struct servhash_entry *entry;
+
+    entry = zhashx_first (sh->services);
+    while ((entry)) {
+        if (entry->is_glob && flux_msg_cmp (msg, entry->match))
+            return entry;
+        entry = zhashx_next (sh->services);
+    }
+    return NULL;
+}
+
 int servhash_match (struct servhash *sh,
                     const flux_msg_t *msg,
                     const char **uuid)
 {
-    struct servhash_entry *entry;
+    struct servhash_entry *entry = NULL;
+    const char *topic;
 
     if (!sh || !msg || !uuid) {
         errno = EINVAL;
         return -1;
     }
-    entry = zhashx_first (sh->services);
-    while ((entry)) {
-        if (flux_msg_cmp (msg, entry->match))
-            break;
-        entry = zhashx_next (sh->services);
-    }
-    if (!entry) {
+    if (flux_msg_get_topic (msg, &topic) == 0
+        && (entry = lookup_subtopic (sh, topic))
+        && flux_msg_cmp (msg, entry->match))
+        sh->hash_hits++;
+    else if (sh->glob_count > 0 && (entry = scan_globs (sh, msg)))
+        sh->scan_hits++;
+    else {
+        sh->misses++;
         errno = ENOENT;
         return -1;
     }
@@ -300,6 +366,26 @@ int servhash_match (struct servhash *sh,
     return 0;
 }
 
+json_t *servhash_stats_get (struct servhash *sh)
+{
+    json_t *o;
+
+    if (!sh) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(o = json_pack ("{s:i s:i s:I s:I s:I}",
+                         "services", (int)zhashx_size (sh->services),
+                         "globs", sh->glob_count,
+                         "hash_hits", (json_int_t)sh->hash_hits,
+                         "scan_hits", (json_int_t)sh->scan_hits,
+                         "misses", (json_int_t)sh->misses))) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    return o;
+}
+
 void servhash_set_respond (struct servhash *sh, respond_f cb, void *arg)
 {
     if (sh) {
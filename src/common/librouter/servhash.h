@@ -11,6 +11,7 @@
 #ifndef _ROUTER_SERVHASH_H
 #define _ROUTER_SERVHASH_H
 
+#include <jansson.h>
 #include <flux/core.h>
 
 struct servhash;
@@ -42,6 +43,14 @@ int servhash_match (struct servhash *sh,
                     const flux_msg_t *msg,
                     const char **uuid);
 
+/* Get servhash_match() counters as a JSON object:
+ *   {"services":i, "globs":i, "hash_hits":I, "scan_hits":I, "misses":I}
+ * where hash_hits are requests matched by looking up the first topic
+ * component, and scan_hits are requests that required a scan of services
+ * with '.' or glob characters in their names.
+ */
+json_t *servhash_stats_get (struct servhash *sh);
+
 void servhash_disconnect (struct servhash *sh, const char *uuid);
 
 int servhash_renew (struct servhash *sh);
@@ -0,0 +1,426 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* subtrie.c - event subscription index shared by many subscribers
+ *
+ * Event subscriptions are topic prefixes:  subscription "foo" matches
+ * "foo", "foobar", and "foo.bar", and "" matches all topics.  Testing each
+ * subscriber's subhash in turn costs O(subscribers * subscriptions) per
+ * event.  This class instead stores every subscription of every subscriber
+ * in a radix tree keyed by prefix, so that the set of subscribers for a
+ * topic can be found by walking the topic string once from the root,
+ * collecting subscribers at each node passed.
+ *
+ * A subscriber with more than one matching prefix (e.g. "job-" and
+ * "job-state") must only be reported once.  Each subscriber has a record,
+ * shared by all of its nodes, that carries the generation number of the last
+ * match that reported it.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+
+#include "src/common/libutil/errno_safe.h"
+#include "src/common/libczmqcontainers/czmq_containers.h"
+
+#include "subtrie.h"
+
+struct subscriber {
+    void *ptr;
+    int refcount;           // number of prefixes held
+    uint64_t gen;           // generation of last match
+};
+
+struct node {
+    char *label;            // edge label from parent (NULL for root)
+    size_t len;
+    struct node **children; // children have distinct label[0]
+    int nchildren;
+    struct subscriber **subs;
+    int nsubs;
+    int maxsubs;
+};
+
+struct subtrie {
+    struct node root;
+    zhashx_t *subscribers;  // subscriber pointer => struct subscriber
+    uint64_t gen;
+};
+
+static void node_destroy (struct node *n)
+{
+    if (n) {
+        for (int i = 0; i < n->nchildren; i++)
+            node_destroy (n->children[i]);
+        free (n->children);
+        free (n->subs);
+        free (n->label);
+        free (n);
+    }
+}
+
+static struct node *node_create (const char *label, size_t len)
+{
+    struct node *n;
+
+    if (!(n = calloc (1, sizeof (*n))))
+        return NULL;
+    if (!(n->label = strndup (label, len))) {
+        free (n);
+        return NULL;
+    }
+    n->len = len;
+    return n;
+}
+
+static int node_child_index (struct node *n, char c)
+{
+    for (int i = 0; i < n->nchildren; i++) {
+        if (n->children[i]->label[0] == c)
+            return i;
+    }
+    return -1;
+}
+
+static int node_child_add (struct node *n, struct node *child)
+{
+    struct node **new;
+
+    if (!(new = realloc (n->children, sizeof (new[0]) * (n->nchildren + 1))))
+        return -1;
+    new[n->nchildren++] = child;
+    n->children = new;
+    return 0;
+}
+
+static void node_child_delete (struct node *n, int index)
+{
+    n->children[index] = n->children[--n->nchildren];
+}
+
+static int node_sub_index (struct node *n, struct subscriber *sub)
+{
+    for (int i = 0; i < n->nsubs; i++) {
+        if (n->subs[i] == sub)
+            return i;
+    }
+    return -1;
+}
+
+static int node_sub_add (struct node *n, struct subscriber *sub)
+{
+    if (node_sub_index (n, sub) >= 0) {
+        errno = EEXIST;
+        return -1;
+    }
+    if (n->nsubs == n->maxsubs) {
+        int newmax = n->maxsubs ? n->maxsubs * 2 : 4;
+        struct subscriber **new;
+
+        if (!(new = realloc (n->subs, sizeof (new[0]) * newmax)))
+            return -1;
+        n->subs = new;
+        n->maxsubs = newmax;
+    }
+    n->subs[n->nsubs++] = sub;
+    return 0;
+}
+
+static int node_sub_delete (struct node *n, struct subscriber *sub)
+{
+    int i;
+
+    if ((i = node_sub_index (n, sub)) < 0) {
+        errno = ENOENT;
+        return -1;
+    }
+    n->subs[i] = n->subs[--n->nsubs];
+    return 0;
+}
+
+/* Find or create the node whose path from the root spells 'prefix',
+ * splitting an existing edge if 'prefix' ends or diverges within it.
+ */
+static struct node *node_lookup_create (struct node *n, const char *prefix)
+{
+    const char *s = prefix;
+
+    while (*s) {
+        struct node *child;
+        size_t l;
+        int i;
+
+        if ((i = node_child_index (n, *s)) < 0) {
+            if (!(child = node_create (s, strlen (s))))
+                return NULL;
+            if (node_child_add (n, child) < 0) {
+                node_destroy (child);
+                return NULL;
+            }
+            return child;
+        }
+        child = n->children[i];
+        for (l = 0; l < child->len && s[l] == child->label[l]; l++)
+            ;
+        if (l < child->len) {
+            struct node *mid;
+            char *label;
+
+            if (!(mid = node_create (child->label, l)))
+                return NULL;
+            if (!(label = strdup (child->label + l))
+                || node_child_add (mid, child) < 0) {
+                ERRNO_SAFE_WRAP (free, label);
+                mid->nchildren = 0;
+                node_destroy (mid);
+                return NULL;
+            }
+            free (child->label);
+            child->label = label;
+            child->len -= l;
+            n->children[i] = mid;
+            child = mid;
+        }
+        n = child;
+        s += l;
+    }
+    return n;
+}
+
+/* Remove 'sub' from the node spelling 'prefix' below 'n', then prune
+ * empty nodes and merge nodes left with a single child on the way back up,
+ * so the tree stays compressed.
+ */
+static int node_remove (struct node *n,
+                        const char *prefix,
+                        struct subscriber *sub)
+{
+    struct node *child;
+    int i;
+
+    if (*prefix == '\0')
+        return node_sub_delete (n, sub);
+    if ((i = node_child_index (n, *prefix)) < 0
+        || strncmp (n->children[i]->label,
+                    prefix,
+                    n->children[i]->len) != 0) {
+        errno = ENOENT;
+        return -1;
+    }
+    child = n->children[i];
+    if (node_remove (child, prefix + child->len, sub) < 0)
+        return -1;
+    if (child->nsubs == 0) {
+        if (child->nchildren == 0) {
+            node_child_delete (n, i);
+            node_destroy (child);
+        }
+        else if (child->nchildren == 1) {
+            struct node *grandchild = child->children[0];
+            char *label;
+
+            if (asprintf (&label, "%s%s", child->label, grandchild->label) < 0)
+                return 0; // leave uncompressed, still correct
+            free (grandchild->label);
+            grandchild->label = label;
+            grandchild->len += child->len;
+            n->children[i] = grandchild;
+            child->nchildren = 0;
+            node_destroy (child);
+        }
+    }
+    return 0;
+}
+
+static struct subscriber *subscriber_get (struct subtrie *st, void *ptr)
+{
+    struct subscriber *sub;
+
+    if (!(sub = zhashx_lookup (st->subscribers, ptr))) {
+        if (!(sub = calloc (1, sizeof (*sub))))
+            return NULL;
+        sub->ptr = ptr;
+        (void)zhashx_insert (st->subscribers, ptr, sub);
+    }
+    return sub;
+}
+
+static void subscriber_put (struct subtrie *st, struct subscriber *sub)
+{
+    if (sub->refcount == 0)
+        zhashx_delete (st->subscribers, sub->ptr);
+}
+
+int subtrie_add (struct subtrie *st, const char *prefix, void *subscriber)
+{
+    struct subscriber *sub;
+    struct node *n;
+
+    if (!st || !prefix || !subscriber) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!(sub = subscriber_get (st, subscriber)))
+        return -1;
+    if (!(n = node_lookup_create (&st->root, prefix))
+        || node_sub_add (n, sub) < 0) {
+        int saved_errno = errno;
+        subscriber_put (st, sub);
+        errno = saved_errno;
+        return -1;
+    }
+    sub->refcount++;
+    return 0;
+}
+
+int subtrie_remove (struct subtrie *st, const char *prefix, void *subscriber)
+{
+    struct subscriber *sub;
+
+    if (!st || !prefix || !subscriber) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!(sub = zhashx_lookup (st->subscribers, subscriber))) {
+        errno = ENOENT;
+        return -1;
+    }
+    if (node_remove (&st->root, prefix, sub) < 0)
+        return -1;
+    sub->refcount--;
+    subscriber_put (st, sub);
+    return 0;
+}
+
+static int node_match (struct node *n,
+                       uint64_t gen,
+                       subtrie_match_f cb,
+                       void *arg)
+{
+    int count = 0;
+
+    for (int i = 0; i < n->nsubs; i++) {
+        struct subscriber *sub = n->subs[i];
+        if (sub->gen != gen) {
+            sub->gen = gen;
+            if (cb)
+                cb (sub->ptr, arg);
+            count++;
+        }
+    }
+    return count;
+}
+
+int subtrie_match (struct subtrie *st,
+                   const char *topic,
+                   subtrie_match_f cb,
+                   void *arg)
+{
+    struct node *n;
+    const char *s;
+    uint64_t gen;
+    int count;
+
+    if (!st || !topic) {
+        errno = EINVAL;
+        return -1;
+    }
+    gen = ++st->gen;
+    n = &st->root;
+    s = topic;
+    count = node_match (n, gen, cb, arg);
+    while (*s) {
+        int i;
+
+        if ((i = node_child_index (n, *s)) < 0)
+            break;
+        n = n->children[i];
+        if (strncmp (n->label, s, n->len) != 0)
+            break;
+        count += node_match (n, gen, cb, arg);
+        s += n->len;
+    }
+    return count;
+}
+
+int subtrie_count (struct subtrie *st)
+{
+    return st ? zhashx_size (st->subscribers) : 0;
+}
+
+/* Hash the subscriber pointer in 'key'.
+ * N.B. zhashx_hash_fn signature
+ */
+static size_t subscriber_hasher (const void *key)
+{
+    return (uintptr_t)key >> 3;
+}
+
+/* N.B. zhashx_comparator_fn signature
+ */
+static int subscriber_key_cmp (const void *key1, const void *key2)
+{
+    if (key1 == key2)
+        return 0;
+    return key1 < key2 ? -1 : 1;
+}
+
+// zhashx_destructor_fn signature
+static void subscriber_destructor (void **item)
+{
+    if (item) {
+        free (*item);
+        *item = NULL;
+    }
+}
+
+void subtrie_destroy (struct subtrie *st)
+{
+    if (st) {
+        int saved_errno = errno;
+        for (int i = 0; i < st->root.nchildren; i++)
+            node_destroy (st->root.children[i]);
+        free (st->root.children);
+        free (st->root.subs);
+        zhashx_destroy (&st->subscribers);
+        free (st);
+        errno = saved_errno;
+    }
+}
+
+struct subtrie *subtrie_create (void)
+{
+    struct subtrie *st;
+
+    if (!(st = calloc (1, sizeof (*st))))
+        return NULL;
+    if (!(st->subscribers = zhashx_new ()))
+        goto nomem;
+    zhashx_set_key_hasher (st->subscribers, subscriber_hasher);
+    zhashx_set_key_comparator (st->subscribers, subscriber_key_cmp);
+    zhashx_set_key_duplicator (st->subscribers, NULL);
+    zhashx_set_key_destructor (st->subscribers, NULL);
+    zhashx_set_destructor (st->subscribers, subscriber_destructor);
+    return st;
+nomem:
+    subtrie_destroy (st);
+    errno = ENOMEM;
+    return NULL;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -0,0 +1,52 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _ROUTER_SUBTRIE_H
+#define _ROUTER_SUBTRIE_H
+
+/* Called once per subscriber matching a topic.
+ * The callback must not add or remove subtrie subscriptions.
+ */
+typedef void (*subtrie_match_f)(void *subscriber, void *arg);
+
+struct subtrie *subtrie_create (void);
+void subtrie_destroy (struct subtrie *st);
+
+/* Subscribe opaque 'subscriber' to topics beginning with 'prefix'.
+ * Each (prefix, subscriber) pair may be added only once (EEXIST).
+ * Callers that allow duplicate subscriptions (e.g. subhash) should
+ * reference count them and add/remove on the first/last reference.
+ */
+int subtrie_add (struct subtrie *st, const char *prefix, void *subscriber);
+
+/* Remove a (prefix, subscriber) pair previously added with subtrie_add().
+ * Fails with ENOENT if not found.
+ */
+int subtrie_remove (struct subtrie *st, const char *prefix, void *subscriber);
+
+/* Call 'cb' exactly once for each subscriber that has at least one prefix
+ * matching 'topic'.  The cost is proportional to the topic length plus the
+ * number of matches, independent of the total number of subscriptions.
+ * Returns the number of subscribers matched, or -1 on error.
+ */
+int subtrie_match (struct subtrie *st,
+                   const char *topic,
+                   subtrie_match_f cb,
+                   void *arg);
+
+/* Return the number of distinct subscribers in the trie.
+ */
+int subtrie_count (struct subtrie *st);
+
+#endif /* !_ROUTER_SUBTRIE_H */
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
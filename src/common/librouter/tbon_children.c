@@ -0,0 +1,181 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* tbon_children.c - get the subtree of each TBON child of this broker
+ *
+ * Services that fan a request out along the TBON need to know which
+ * child leads to each target rank.  The overlay.topology response for
+ * this broker's rank is turned into a list of children, each with an
+ * idset of the ranks in its subtree.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <jansson.h>
+#include <flux/core.h>
+#include <flux/idset.h>
+
+#include "tbon_children.h"
+
+struct tbon_children {
+    flux_t *h;
+    uint32_t rank;
+    flux_future_t *f;
+    struct tbon_child *children;    // NULL until the topology is known
+    size_t count;
+};
+
+static void children_destroy (struct tbon_child *children, size_t count)
+{
+    if (children) {
+        int saved_errno = errno;
+        for (int i = 0; i < count; i++)
+            idset_destroy (children[i].subtree);
+        free (children);
+        errno = saved_errno;
+    }
+}
+
+/* Recursive function to walk 'topology', adding all subtree ranks to 'ids'.
+ * Returns 0 on success, -1 on failure (errno is not set).
+ */
+static int add_subtree_ids (struct idset *ids, json_t *topology)
+{
+    int rank;
+    json_t *a;
+    size_t index;
+    json_t *entry;
+
+    if (json_unpack (topology, "{s:i s:o}", "rank", &rank, "children", &a) < 0
+        || idset_set (ids, rank) < 0)
+        return -1;
+    json_array_foreach (a, index, entry) {
+        if (add_subtree_ids (ids, entry) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+/* On failure, log and leave the future fulfilled with an error so that
+ * tbon_children_get() sends the request again.
+ */
+static void topology_continuation (flux_future_t *f, void *arg)
+{
+    struct tbon_children *tc = arg;
+    struct tbon_child *children = NULL;
+    json_t *topology;
+    json_t *a;
+    size_t index;
+    json_t *entry;
+
+    if (flux_rpc_get_unpack (f, "o", &topology) < 0
+        || json_unpack (topology, "{s:o}", "children", &a) < 0) {
+        flux_log (tc->h,
+                  LOG_ERR,
+                  "overlay.topology: %s",
+                  future_strerror (f, errno));
+        return;
+    }
+    /* N.B. allocate at least one entry so that a leaf has non-NULL
+     * children, which indicates the topology is known.
+     */
+    if (!(children = calloc (json_array_size (a) + 1, sizeof (children[0]))))
+        goto error;
+    json_array_foreach (a, index, entry) {
+        int rank;
+        if (json_unpack (entry, "{s:i}", "rank", &rank) < 0
+            || !(children[index].subtree = idset_create (0,
+                                                         IDSET_FLAG_AUTOGROW))
+            || add_subtree_ids (children[index].subtree, entry) < 0)
+            goto error;
+        children[index].rank = rank;
+    }
+    tc->children = children;
+    tc->count = json_array_size (a);
+    return;
+error:
+    flux_log (tc->h, LOG_ERR, "error parsing overlay.topology response");
+    children_destroy (children, json_array_size (a));
+}
+
+static int topology_request (struct tbon_children *tc)
+{
+    flux_future_t *f;
+
+    if (!(f = flux_rpc_pack (tc->h,
+                             "overlay.topology",
+                             FLUX_NODEID_ANY,
+                             0,
+                             "{s:i}",
+                             "rank", tc->rank))
+        || flux_future_then (f, -1, topology_continuation, tc) < 0) {
+        flux_future_destroy (f);
+        return -1;
+    }
+    flux_future_destroy (tc->f);
+    tc->f = f;
+    return 0;
+}
+
+const struct tbon_child *tbon_children_get (struct tbon_children *tc,
+                                            size_t *count)
+{
+    if (!tc) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!tc->children) {
+        /* The response was received but could not be used.  Ask again.
+         */
+        if (!tc->f || flux_future_is_ready (tc->f)) {
+            if (topology_request (tc) < 0)
+                flux_log_error (tc->h, "error sending overlay.topology");
+        }
+        errno = EAGAIN;
+        return NULL;
+    }
+    if (count)
+        *count = tc->count;
+    return tc->children;
+}
+
+void tbon_children_destroy (struct tbon_children *tc)
+{
+    if (tc) {
+        int saved_errno = errno;
+        flux_future_destroy (tc->f);
+        children_destroy (tc->children, tc->count);
+        free (tc);
+        errno = saved_errno;
+    }
+}
+
+struct tbon_children *tbon_children_create (flux_t *h, uint32_t rank)
+{
+    struct tbon_children *tc;
+
+    if (!h) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(tc = calloc (1, sizeof (*tc))))
+        return NULL;
+    tc->h = h;
+    tc->rank = rank;
+    if (topology_request (tc) < 0)
+        goto error;
+    return tc;
+error:
+    tbon_children_destroy (tc);
+    return NULL;
+}
+
+// vi:ts=4 sw=4 expandtab
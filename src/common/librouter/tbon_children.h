@@ -0,0 +1,41 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _ROUTER_TBON_CHILDREN_H
+#define _ROUTER_TBON_CHILDREN_H
+
+#include <flux/core.h>
+#include <flux/idset.h>
+
+/* A TBON child of this broker and the ranks of its subtree,
+ * including the child itself.
+ */
+struct tbon_child {
+    uint32_t rank;
+    struct idset *subtree;
+};
+
+/* Create/destroy.  The overlay.topology RPC for 'rank' is sent
+ * immediately and its response is handled asynchronously.
+ */
+struct tbon_children *tbon_children_create (flux_t *h, uint32_t rank);
+void tbon_children_destroy (struct tbon_children *tc);
+
+/* Get the children of this broker.  If the topology is not yet known,
+ * return NULL with errno set to EAGAIN.  If the overlay.topology RPC
+ * failed, it is sent again, so that a caller retrying later may succeed.
+ * The returned array is valid until tbon_children_destroy() is called.
+ */
+const struct tbon_child *tbon_children_get (struct tbon_children *tc,
+                                            size_t *count);
+
+#endif /* !_ROUTER_TBON_CHILDREN_H */
+
+// vi:ts=4 sw=4 expandtab
@@ -13,6 +13,8 @@
 #endif
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
 #include <fcntl.h>
 #include <unistd.h>
 #ifndef HAVE_PIPE2
@@ -25,6 +27,7 @@
 #include "src/common/libczmqcontainers/czmq_containers.h"
 #include "src/common/librouter/sendfd.h"
 #include "src/common/libutil/fdutils.h"
+#include "src/common/libutil/monotime.h"
 #include "src/common/libtap/tap.h"
 #include "ccan/str/str.h"
 
@@ -314,6 +317,230 @@ next:
     free (buf);
 }
 
+/* Send 'count' messages of payload 'size' plus one large message through
+ * output and input iostreams over a nonblocking socketpair, alternating
+ * between writing and reading so both sides see partial messages.
+ */
+void test_iostream (int size, int count)
+{
+    int sv[2];
+    struct iostream out;
+    struct iostream in;
+    char *buf;
+    int bigsize = 1048576;
+    flux_msg_t *msg;
+    int sent = 0;
+    int received = 0;
+    int errors = 0;
+    bool big_ok = false;
+
+    if (!(buf = calloc (1, bigsize)))
+        BAIL_OUT ("calloc failed");
+    memset (buf, 0xf0, size);
+    if (socketpair (AF_UNIX, SOCK_STREAM, 0, sv) < 0
+        || fd_set_nonblocking (sv[0]) < 0
+        || fd_set_nonblocking (sv[1]) < 0)
+        BAIL_OUT ("could not create nonblocking socketpair");
+    iostream_init (&out);
+    iostream_init (&in);
+
+    for (int i = 0; i < count + 1; i++) {
+        if (!(msg = flux_request_encode_raw ("foo.bar",
+                                             buf,
+                                             i < count ? size : bigsize)))
+            BAIL_OUT ("flux_request_encode failed");
+        if (iostream_append (&out, msg) < 0)
+            BAIL_OUT ("iostream_append failed");
+        flux_msg_destroy (msg);
+    }
+    ok (iostream_pending (&out) > (size_t)count * size + bigsize,
+        "iostream %d,%d: iostream_append buffered all messages",
+        count,
+        size);
+    while (received < count + 1) {
+        if (iostream_pending (&out) > 0) {
+            if (iostream_write (sv[1], &out) < 0
+                && errno != EWOULDBLOCK && errno != EAGAIN)
+                BAIL_OUT ("iostream_write failed: %s", strerror (errno));
+            sent++;
+        }
+        if (iostream_read (sv[0], &in) < 0) {
+            if (errno != EWOULDBLOCK && errno != EAGAIN)
+                BAIL_OUT ("iostream_read failed: %s", strerror (errno));
+        }
+        while ((msg = iostream_recv (&in))) {
+            const char *topic;
+            const void *buf2;
+            size_t buf2len;
+
+            if (flux_request_decode_raw (msg, &topic, &buf2, &buf2len) < 0
+                || !streq (topic, "foo.bar"))
+                errors++;
+            else if (received < count) {
+                if (buf2len != size || memcmp (buf, buf2, size) != 0)
+                    errors++;
+            }
+            else if (buf2len == bigsize && memcmp (buf, buf2, bigsize) == 0)
+                big_ok = true;
+            received++;
+            flux_msg_destroy (msg);
+        }
+        if (errno != EWOULDBLOCK)
+            BAIL_OUT ("iostream_recv failed: %s", strerror (errno));
+    }
+    diag ("iostream %d,%d: %d write passes", count, size, sent);
+    ok (errors == 0,
+        "iostream %d,%d: received messages are intact",
+        count,
+        size);
+    ok (big_ok,
+        "iostream %d,%d: large message is intact",
+        count,
+        size);
+    ok (iostream_pending (&in) == 0 && !iostream_has_msg (&in),
+        "iostream %d,%d: input stream is empty",
+        count,
+        size);
+
+    iostream_clean (&out);
+    iostream_clean (&in);
+    close (sv[0]);
+    close (sv[1]);
+    free (buf);
+}
+
+void test_iostream_errors (void)
+{
+    struct iostream ios;
+    uint32_t bad[2] = { 0xdeadbeef, 0 };
+    int pfd[2];
+
+    iostream_init (&ios);
+    errno = 0;
+    ok (iostream_recv (&ios) == NULL && errno == EWOULDBLOCK,
+        "iostream_recv on empty stream fails with EWOULDBLOCK");
+    ok (iostream_has_msg (&ios) == false,
+        "iostream_has_msg on empty stream returns false");
+    errno = 0;
+    ok (iostream_append (&ios, NULL) < 0 && errno == EINVAL,
+        "iostream_append msg=NULL fails with EINVAL");
+    errno = 0;
+    ok (iostream_read (-1, &ios) < 0 && errno == EINVAL,
+        "iostream_read fd=-1 fails with EINVAL");
+    errno = 0;
+    ok (iostream_write (-1, &ios) < 0 && errno == EINVAL,
+        "iostream_write fd=-1 fails with EINVAL");
+
+    if (pipe2 (pfd, O_CLOEXEC) < 0)
+        BAIL_OUT ("pipe2 failed");
+    if (write (pfd[1], bad, sizeof (bad)) != sizeof (bad))
+        BAIL_OUT ("write failed");
+    ok (iostream_read (pfd[0], &ios) == sizeof (bad),
+        "iostream_read works");
+    errno = 0;
+    ok (iostream_recv (&ios) == NULL && errno == EPROTO,
+        "iostream_recv fails with EPROTO on bad magic");
+    ok (iostream_has_msg (&ios) == true,
+        "iostream_has_msg returns true on bad magic");
+    close (pfd[1]);
+    iostream_clean (&ios);
+    errno = 0;
+    ok (iostream_read (pfd[0], &ios) < 0 && errno == ECONNRESET,
+        "iostream_read fails with ECONNRESET when sender closes pipe");
+    close (pfd[0]);
+    iostream_clean (&ios);
+
+    /* A bad header claiming a huge size must not grow the buffer.
+     */
+    bad[1] = htonl (0xfffffff0);
+    if (pipe2 (pfd, O_CLOEXEC) < 0)
+        BAIL_OUT ("pipe2 failed");
+    if (write (pfd[1], bad, sizeof (bad)) != sizeof (bad))
+        BAIL_OUT ("write failed");
+    ok (iostream_read (pfd[0], &ios) == sizeof (bad),
+        "iostream_read of bad header with huge size works");
+    errno = 0;
+    ok (iostream_read (pfd[0], &ios) < 0 && errno == EPROTO,
+        "iostream_read fails with EPROTO once bad header is buffered");
+    ok (ios.size <= 65536,
+        "iostream_read did not grow buffer for bad header");
+    close (pfd[1]);
+    close (pfd[0]);
+    iostream_clean (&ios);
+}
+
+/* Compare one sendfd()/recvfd() per message with iostream batching over
+ * a socketpair.  Timings are informational only.
+ */
+#define BENCH_MSGS      100000
+#define BENCH_BATCH     64
+
+void test_bench (void)
+{
+    int sv[2];
+    struct iostream out;
+    struct iostream in;
+    flux_msg_t *msg;
+    struct timespec t0;
+    double t_fd, t_ios;
+    int count = 0;
+
+    if (socketpair (AF_UNIX, SOCK_STREAM, 0, sv) < 0)
+        BAIL_OUT ("socketpair failed");
+    if (!(msg = flux_request_encode ("foo.bar", "{\"a\":42}")))
+        BAIL_OUT ("flux_request_encode failed");
+
+    monotime (&t0);
+    for (int i = 0; i < BENCH_MSGS / BENCH_BATCH; i++) {
+        for (int j = 0; j < BENCH_BATCH; j++) {
+            if (sendfd (sv[1], msg, NULL) < 0)
+                BAIL_OUT ("sendfd failed");
+        }
+        for (int j = 0; j < BENCH_BATCH; j++) {
+            flux_msg_t *msg2;
+            if (!(msg2 = recvfd (sv[0], NULL)))
+                BAIL_OUT ("recvfd failed");
+            flux_msg_destroy (msg2);
+            count++;
+        }
+    }
+    t_fd = monotime_since (t0);
+
+    iostream_init (&out);
+    iostream_init (&in);
+    monotime (&t0);
+    for (int i = 0; i < BENCH_MSGS / BENCH_BATCH; i++) {
+        for (int j = 0; j < BENCH_BATCH; j++) {
+            if (iostream_append (&out, msg) < 0)
+                BAIL_OUT ("iostream_append failed");
+        }
+        if (iostream_write (sv[1], &out) < 0)
+            BAIL_OUT ("iostream_write failed");
+        for (int j = 0; j < BENCH_BATCH; j++) {
+            flux_msg_t *msg2;
+            while (!(msg2 = iostream_recv (&in))) {
+                if (errno != EWOULDBLOCK || iostream_read (sv[0], &in) < 0)
+                    BAIL_OUT ("iostream read failed");
+            }
+            flux_msg_destroy (msg2);
+            count--;
+        }
+    }
+    t_ios = monotime_since (t0);
+    ok (count == 0,
+        "sendfd/recvfd and iostream moved the same number of messages");
+    diag ("%d messages: sendfd/recvfd %.0f msg/s, iostream %.0f msg/s",
+          BENCH_MSGS,
+          t_fd > 0 ? 1000. * BENCH_MSGS / t_fd : 0.,
+          t_ios > 0 ? 1000. * BENCH_MSGS / t_ios : 0.);
+
+    iostream_clean (&out);
+    iostream_clean (&in);
+    flux_msg_destroy (msg);
+    close (sv[0]);
+    close (sv[1]);
+}
+
 void test_inval (void)
 {
     flux_msg_t *msg;
@@ -346,6 +573,10 @@ int main (int argc, char *argv[])
     test_nonblock (4096, 256);
     test_nonblock (16384, 64);
     test_nonblock (1048586, 1);
+    test_iostream (1024, 1024);
+    test_iostream (16384, 64);
+    test_iostream_errors ();
+    test_bench ();
     test_inval ();
 
     done_testing();
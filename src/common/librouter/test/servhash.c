@@ -158,12 +158,37 @@ void test_invalid (flux_t *h)
     ok (servhash_remove (sh, "foo", "uuid", NULL) < 0 && errno == EINVAL,
         "servhash_remove msg=NULL fails with EINVAL");
 
+    errno = 0;
+    ok (servhash_stats_get (NULL) == NULL && errno == EINVAL,
+        "servhash_stats_get sh=NULL fails with EINVAL");
+
     flux_msg_destroy (msg);
     servhash_destroy (sh);
 }
 
 int last_errnum;
 
+void check_stats (struct servhash *sh, int hash_hits, int scan_hits, int misses)
+{
+    json_t *o;
+    int h = -1, s = -1, m = -1;
+
+    ok ((o = servhash_stats_get (sh)) != NULL
+        && json_unpack (o,
+                        "{s:i s:i s:i}",
+                        "hash_hits", &h,
+                        "scan_hits", &s,
+                        "misses", &m) == 0
+        && h == hash_hits
+        && s == scan_hits
+        && m == misses,
+        "servhash_stats_get hash_hits=%d scan_hits=%d misses=%d",
+        hash_hits,
+        scan_hits,
+        misses);
+    json_decref (o);
+}
+
 void respond_cb (const flux_msg_t *msg, const char *uuid, int errnum, void *arg)
 {
     flux_reactor_t *r = arg;
@@ -241,6 +266,7 @@ void test_basic (flux_t *h)
     errno = 0;
     ok (servhash_match (sh, req2, &uuid) < 0 && errno == ENOENT,
         "servhash_match rejected unregistered request");
+    check_stats (sh, 1, 0, 1);
 
     /* remove 'fubar' */
     ok (servhash_remove (sh, "fubar", "basic-uuid", remove) == 0,
@@ -262,6 +288,59 @@ void test_basic (flux_t *h)
     servhash_destroy (sh);
 }
 
+/* A service name containing '.' can't be found by hashing the first
+ * topic component, so servhash_match() falls back to a scan.
+ */
+void test_glob (flux_t *h)
+{
+    struct servhash *sh;
+    flux_msg_t *add;
+    flux_msg_t *req;
+    flux_msg_t *req2;
+    flux_reactor_t *r;
+    const char *uuid;
+    json_t *o;
+    int globs;
+
+    if (!(add = flux_request_encode ("service.add", NULL))
+            || flux_msg_pack (add, "{s:s}", "service", "foo.bar") < 0)
+        BAIL_OUT ("request encode failed");
+    if (!(req = flux_request_encode ("foo.bar.baz", NULL)))
+        BAIL_OUT ("request encode failed");
+    if (!(req2 = flux_request_encode ("foo.baz", NULL)))
+        BAIL_OUT ("request encode failed");
+    if (!(sh = servhash_create (h)))
+        BAIL_OUT ("servhash_create failed");
+    r = flux_get_reactor (h);
+    servhash_set_respond (sh, respond_cb, r);
+
+    ok (servhash_add (sh, "foo.bar", "glob-uuid", add) == 0,
+        "servhash_add foo.bar sent add request");
+    last_errnum = 42;
+    ok (flux_reactor_run (r, 0) >= 0 && last_errnum == 0,
+        "add request was successful");
+    globs = -1;
+    ok ((o = servhash_stats_get (sh)) != NULL
+        && json_unpack (o, "{s:i}", "globs", &globs) == 0
+        && globs == 1,
+        "servhash_stats_get reports globs=1");
+    json_decref (o);
+
+    uuid = NULL;
+    ok (servhash_match (sh, req, &uuid) == 0
+        && uuid != NULL && streq (uuid, "glob-uuid"),
+        "servhash_match matched foo.bar.baz to foo.bar");
+    errno = 0;
+    ok (servhash_match (sh, req2, &uuid) < 0 && errno == ENOENT,
+        "servhash_match rejected foo.baz");
+    check_stats (sh, 0, 1, 1);
+
+    flux_msg_destroy (add);
+    flux_msg_destroy (req);
+    flux_msg_destroy (req2);
+    servhash_destroy (sh);
+}
+
 int main (int argc, char *argv[])
 {
     flux_t *h;
@@ -274,6 +353,7 @@ int main (int argc, char *argv[])
         BAIL_OUT ("test_server_create failed");
 
     test_basic (h);
+    test_glob (h);
     test_invalid (h);
 
     diag ("stopping test server");
@@ -0,0 +1,230 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#include "src/common/libtap/tap.h"
+#include "src/common/libutil/monotime.h"
+#include "src/common/librouter/subtrie.h"
+#include "src/common/librouter/subhash.h"
+
+struct client {
+    const char *name;
+    int count;
+};
+
+static void count_cb (void *subscriber, void *arg)
+{
+    struct client *c = subscriber;
+    c->count++;
+}
+
+static void reset (struct client *c, int n)
+{
+    for (int i = 0; i < n; i++)
+        c[i].count = 0;
+}
+
+void test_match (void)
+{
+    struct subtrie *st;
+    struct client c[3] = { { "a" }, { "b" }, { "c" } };
+
+    st = subtrie_create ();
+    ok (st != NULL,
+        "subtrie_create works");
+
+    ok (subtrie_add (st, "foo", &c[0]) == 0,
+        "subtrie_add foo a");
+    ok (subtrie_add (st, "foo.bar", &c[0]) == 0,
+        "subtrie_add foo.bar a");
+    ok (subtrie_add (st, "foo.baz", &c[1]) == 0,
+        "subtrie_add foo.baz b");
+    ok (subtrie_add (st, "fo", &c[2]) == 0,
+        "subtrie_add fo c (splits edge)");
+    ok (subtrie_count (st) == 3,
+        "subtrie_count returns 3");
+
+    errno = 0;
+    ok (subtrie_add (st, "foo", &c[0]) < 0 && errno == EEXIST,
+        "subtrie_add foo a again fails with EEXIST");
+
+    reset (c, 3);
+    ok (subtrie_match (st, "foo.bar.x", count_cb, NULL) == 2
+        && c[0].count == 1 && c[1].count == 0 && c[2].count == 1,
+        "foo.bar.x matches a once and c once");
+    reset (c, 3);
+    ok (subtrie_match (st, "foo.baz", count_cb, NULL) == 3
+        && c[0].count == 1 && c[1].count == 1 && c[2].count == 1,
+        "foo.baz matches a, b, c");
+    reset (c, 3);
+    ok (subtrie_match (st, "fox", count_cb, NULL) == 1 && c[2].count == 1,
+        "fox matches c");
+    ok (subtrie_match (st, "f", count_cb, NULL) == 0,
+        "f matches nothing");
+    ok (subtrie_match (st, "foo.ba", count_cb, NULL) == 2,
+        "foo.ba matches a, c");
+    ok (subtrie_match (st, "bar", count_cb, NULL) == 0,
+        "bar matches nothing");
+
+    ok (subtrie_add (st, "", &c[1]) == 0,
+        "subtrie_add \"\" b");
+    ok (subtrie_match (st, "bar", NULL, NULL) == 1,
+        "bar matches b");
+
+    ok (subtrie_remove (st, "fo", &c[2]) == 0,
+        "subtrie_remove fo c");
+    ok (subtrie_count (st) == 2,
+        "subtrie_count returns 2");
+    ok (subtrie_match (st, "fox", NULL, NULL) == 1,
+        "fox matches only b");
+    ok (subtrie_match (st, "foo.bar", NULL, NULL) == 2,
+        "foo.bar matches a, b");
+    ok (subtrie_remove (st, "foo", &c[0]) == 0,
+        "subtrie_remove foo a");
+    ok (subtrie_match (st, "foo.x", NULL, NULL) == 1,
+        "foo.x matches only b");
+    ok (subtrie_match (st, "foo.bar", NULL, NULL) == 2,
+        "foo.bar still matches a, b");
+    ok (subtrie_remove (st, "foo.bar", &c[0]) == 0
+        && subtrie_remove (st, "foo.baz", &c[1]) == 0
+        && subtrie_remove (st, "", &c[1]) == 0,
+        "remaining subscriptions removed");
+    ok (subtrie_count (st) == 0,
+        "subtrie_count returns 0");
+    ok (subtrie_match (st, "foo.bar", NULL, NULL) == 0,
+        "foo.bar matches nothing");
+
+    subtrie_destroy (st);
+}
+
+void test_errors (void)
+{
+    struct subtrie *st;
+    int x;
+
+    if (!(st = subtrie_create ()))
+        BAIL_OUT ("subtrie_create failed");
+
+    errno = 0;
+    ok (subtrie_add (NULL, "foo", &x) < 0 && errno == EINVAL,
+        "subtrie_add st=NULL fails with EINVAL");
+    errno = 0;
+    ok (subtrie_add (st, NULL, &x) < 0 && errno == EINVAL,
+        "subtrie_add prefix=NULL fails with EINVAL");
+    errno = 0;
+    ok (subtrie_add (st, "foo", NULL) < 0 && errno == EINVAL,
+        "subtrie_add subscriber=NULL fails with EINVAL");
+    errno = 0;
+    ok (subtrie_remove (st, "foo", &x) < 0 && errno == ENOENT,
+        "subtrie_remove unknown subscriber fails with ENOENT");
+    ok (subtrie_add (st, "foobar", &x) == 0,
+        "subtrie_add foobar");
+    errno = 0;
+    ok (subtrie_remove (st, "foo", &x) < 0 && errno == ENOENT,
+        "subtrie_remove foo fails with ENOENT");
+    errno = 0;
+    ok (subtrie_remove (st, "foobarbaz", &x) < 0 && errno == ENOENT,
+        "subtrie_remove foobarbaz fails with ENOENT");
+    errno = 0;
+    ok (subtrie_match (st, NULL, NULL, NULL) < 0 && errno == EINVAL,
+        "subtrie_match topic=NULL fails with EINVAL");
+    ok (subtrie_count (NULL) == 0,
+        "subtrie_count st=NULL returns 0");
+    lives_ok ({ subtrie_destroy (NULL);},
+        "subtrie_destroy st=NULL doesn't crash");
+
+    subtrie_destroy (st);
+}
+
+/* Compare event fan-out cost of one subtrie against per-client subhash
+ * scanning, as done by connector-local and the broker before subtrie.
+ * Each client subscribes to a few common topics and one unique topic,
+ * like 'flux job attach' does.  Timings are informational only.
+ */
+#define BENCH_CLIENTS   4096
+#define BENCH_EVENTS    500
+
+void test_bench (void)
+{
+    static struct client c[BENCH_CLIENTS];
+    static struct subhash *sh[BENCH_CLIENTS];
+    struct subtrie *st;
+    struct timespec t0;
+    char topic[64];
+    double t_trie, t_hash;
+    int n_trie = 0;
+    int n_hash = 0;
+
+    if (!(st = subtrie_create ()))
+        BAIL_OUT ("subtrie_create failed");
+    for (int i = 0; i < BENCH_CLIENTS; i++) {
+        if (!(sh[i] = subhash_create ()))
+            BAIL_OUT ("subhash_create failed");
+        snprintf (topic, sizeof (topic), "shell-%d.", i);
+        if (subtrie_add (st, "job-state", &c[i]) < 0
+            || subtrie_add (st, "heartbeat.pulse", &c[i]) < 0
+            || subtrie_add (st, topic, &c[i]) < 0
+            || subhash_subscribe (sh[i], "job-state") < 0
+            || subhash_subscribe (sh[i], "heartbeat.pulse") < 0
+            || subhash_subscribe (sh[i], topic) < 0)
+            BAIL_OUT ("subscribe failed");
+    }
+
+    monotime (&t0);
+    for (int e = 0; e < BENCH_EVENTS; e++) {
+        snprintf (topic, sizeof (topic), "shell-%d.exception", e);
+        n_trie += subtrie_match (st, topic, NULL, NULL);
+    }
+    t_trie = monotime_since (t0);
+
+    monotime (&t0);
+    for (int e = 0; e < BENCH_EVENTS; e++) {
+        snprintf (topic, sizeof (topic), "shell-%d.exception", e);
+        for (int i = 0; i < BENCH_CLIENTS; i++) {
+            if (subhash_topic_match (sh[i], topic))
+                n_hash++;
+        }
+    }
+    t_hash = monotime_since (t0);
+
+    ok (n_trie == n_hash,
+        "subtrie and subhash agree on %d matches", n_trie);
+    diag ("%d clients, %d events: subtrie %.3fms subhash %.3fms",
+          BENCH_CLIENTS,
+          BENCH_EVENTS,
+          t_trie,
+          t_hash);
+
+    for (int i = 0; i < BENCH_CLIENTS; i++)
+        subhash_destroy (sh[i]);
+    subtrie_destroy (st);
+}
+
+int main (int argc, char *argv[])
+{
+    plan (NO_PLAN);
+
+    test_match ();
+    test_errors ();
+    test_bench ();
+
+    done_testing ();
+    return (0);
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
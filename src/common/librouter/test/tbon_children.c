@@ -0,0 +1,170 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <flux/core.h>
+#include <flux/idset.h>
+
+#include "src/common/libtap/tap.h"
+#include "src/common/libtestutil/util.h"
+#include "ccan/str/str.h"
+#include "src/common/librouter/tbon_children.h"
+
+/*
+ * Test server
+ *
+ * The first overlay.topology request fails, as it might if the overlay
+ * module is not loaded yet.  Later ones get a topology where rank 0 has
+ * children 1 and 2, and rank 1 has child 3.
+ */
+
+void topology_cb (flux_t *h,
+                  flux_msg_handler_t *mh,
+                  const flux_msg_t *msg,
+                  void *arg)
+{
+    int *count = arg;
+    int rank;
+
+    if (flux_request_unpack (msg, NULL, "{s:i}", "rank", &rank) < 0)
+        goto error;
+    diag ("overlay.topology rank=%d", rank);
+    if ((*count)++ == 0) {
+        errno = ENOSYS;
+        goto error;
+    }
+    if (flux_respond_pack (h,
+                           msg,
+                           "{s:i s:[{s:i s:[{s:i s:[]}]} {s:i s:[]}]}",
+                           "rank", 0,
+                           "children",
+                             "rank", 1,
+                             "children",
+                               "rank", 3,
+                               "children",
+                             "rank", 2,
+                             "children") < 0)
+        diag ("flux_respond_pack failed");
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        diag ("flux_respond_error failed");
+}
+
+static const struct flux_msg_handler_spec htab[] = {
+    { FLUX_MSGTYPE_REQUEST,   "overlay.topology", topology_cb, 0 },
+    FLUX_MSGHANDLER_TABLE_END,
+};
+
+int server_cb (flux_t *h, void *arg)
+{
+    flux_msg_handler_t **handlers = NULL;
+    int count = 0;
+
+    if (flux_msg_handler_addvec (h, htab, &count, &handlers) < 0) {
+        diag ("flux_msg_handler_addvec failed");
+        return -1;
+    }
+    if (flux_reactor_run (flux_get_reactor (h), 0) < 0) {
+        diag ("flux_reactor_run failed");
+        return -1;
+    }
+    flux_msg_handler_delvec (handlers);
+    return 0;
+}
+
+static bool subtree_is (const struct tbon_child *child, const char *s)
+{
+    char *ids = idset_encode (child->subtree, IDSET_FLAG_RANGE);
+    bool result = ids && streq (ids, s);
+
+    diag ("child %u subtree %s", child->rank, ids ? ids : "(null)");
+    free (ids);
+    return result;
+}
+
+void test_basic (flux_t *h)
+{
+    struct tbon_children *tc;
+    const struct tbon_child *children = NULL;
+    size_t count = 0;
+    int i;
+
+    ok ((tc = tbon_children_create (h, 0)) != NULL,
+        "tbon_children_create works");
+    errno = 0;
+    ok (tbon_children_get (tc, &count) == NULL && errno == EAGAIN,
+        "tbon_children_get fails with EAGAIN before topology is known");
+
+    /* Once the failed response arrives, tbon_children_get() sends the
+     * request again, and the second one succeeds.
+     */
+    for (i = 0; i < 100; i++) {
+        if ((children = tbon_children_get (tc, &count)) || errno != EAGAIN)
+            break;
+        if (flux_reactor_run (flux_get_reactor (h), FLUX_REACTOR_ONCE) < 0)
+            BAIL_OUT ("flux_reactor_run failed");
+    }
+    ok (children != NULL,
+        "tbon_children_get works after overlay.topology is retried");
+    ok (count == 2,
+        "there are 2 children");
+    ok (children
+        && children[0].rank == 1
+        && subtree_is (&children[0], "1,3"),
+        "child 1 subtree is 1,3");
+    ok (children
+        && children[1].rank == 2
+        && subtree_is (&children[1], "2"),
+        "child 2 subtree is 2");
+
+    tbon_children_destroy (tc);
+}
+
+void test_invalid (void)
+{
+    errno = 0;
+    ok (tbon_children_create (NULL, 0) == NULL && errno == EINVAL,
+        "tbon_children_create h=NULL fails with EINVAL");
+    errno = 0;
+    ok (tbon_children_get (NULL, NULL) == NULL && errno == EINVAL,
+        "tbon_children_get tc=NULL fails with EINVAL");
+    lives_ok ({tbon_children_destroy (NULL);},
+        "tbon_children_destroy NULL doesn't crash");
+}
+
+int main (int argc, char *argv[])
+{
+    flux_t *h;
+
+    plan (NO_PLAN);
+
+    diag ("starting test server");
+
+    if (!(h = test_server_create (0, server_cb, NULL)))
+        BAIL_OUT ("test_server_create failed");
+
+    test_basic (h);
+    test_invalid ();
+
+    diag ("stopping test server");
+    if (test_server_stop (h) < 0)
+        BAIL_OUT ("test_server_stop failed");
+    flux_close (h);
+    done_testing ();
+
+    return 0;
+}
+
+/*
+ * vi: ts=4 sw=4 expandtab
+ */
@@ -17,6 +17,7 @@
 
 #include "src/common/libtap/tap.h"
 #include "src/common/libutil/unlink_recursive.h"
+#include "src/common/libutil/monotime.h"
 #include "src/common/libtestutil/util.h"
 #include "src/common/librouter/usock.h"
 #include "ccan/str/str.h"
@@ -272,6 +273,8 @@ static void test_async_stream (flux_t *h, int size, int count)
     char *buf;
     int i;
     int errors;
+    struct timespec t0;
+    double t;
 
     memset (&ctx, 0, sizeof (ctx));
     ctx.r = flux_get_reactor (h);
@@ -296,6 +299,7 @@ static void test_async_stream (flux_t *h, int size, int count)
 
     diag ("connected");
 
+    monotime (&t0);
     errors = 0;
     for (i = 0; i < count; i++) {
         if (cli_send (cli, ctx.msg) < 0)
@@ -306,6 +310,12 @@ static void test_async_stream (flux_t *h, int size, int count)
 
     if (flux_reactor_run (ctx.r, 0) < 0)
         BAIL_OUT ("flux_reactor_run returned -1: %s", flux_strerror (errno));
+    t = monotime_since (t0);
+    diag ("echoed %d messages size %d in %.3fms (%.0f msg/s)",
+          count,
+          size,
+          t,
+          t > 0 ? 1000. * count / t : 0.);
 
     diag ("disconnecting");
 
@@ -336,6 +346,7 @@ int main (int argc, char *argv[])
     test_async_stream (h, 4096, 256);
     test_async_stream (h, 16384, 64);
     test_async_stream (h, 1048576, 1);
+    test_async_stream (h, 64, 65536);
 
     diag ("stopping test server");
     if (test_server_stop (h) < 0)
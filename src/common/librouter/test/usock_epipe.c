@@ -12,6 +12,8 @@
 #include "config.h"
 #endif
 #include <sys/param.h>
+#include <arpa/inet.h>
+#include <unistd.h>
 #include <pthread.h>
 #include <flux/core.h>
 
@@ -33,12 +35,18 @@
  * A global mutex "server_mutex" is locked before tests are run and
  *  unlocked by the server only after each client connection exits,
  *  allowing the test to synchronize with the server
+ *
+ * Bad header test:
+ *
+ * Client sends a header with bad magic and a huge size.  Server should
+ *  drop the connection with EPROTO without receiving any messages.
  */
 
 struct test_params {
     int ready;
     int expected;
     int recvd;
+    int errnum;
 };
 
 pthread_mutex_t server_mutex = PTHREAD_MUTEX_INITIALIZER;
@@ -91,6 +99,9 @@ static void server_recv_cb (struct usock_conn *conn, flux_msg_t *msg, void *arg)
 
 static void server_error_cb (struct usock_conn *conn, int errnum, void *arg)
 {
+    struct test_params *tp = arg;
+
+    tp->errnum = errnum;
     diag ("server_error_cb uuid=%.5s: %s",
          usock_conn_get_uuid (conn),
          flux_strerror (errnum));
@@ -213,6 +224,35 @@ static void test_send_and_exit (flux_t *h, int count)
     flux_msg_destroy (msg);
     flux_msg_destroy (nmsg);
 }
+/* Send a header with bad magic that claims a huge message size,
+ * then wait for the server to drop the connection.
+ */
+static void test_bad_header (struct test_params *tp)
+{
+    char sockpath[PATH_MAX + 1];
+    uint32_t bad[2] = { 0xdeadbeef, htonl (0xfffffff0) };
+    int fd;
+
+    if (snprintf (sockpath,
+                  sizeof (sockpath),
+                  "%s/server",
+                  tmpdir) >= sizeof (sockpath))
+        BAIL_OUT ("buffer overflow");
+    fd = usock_client_connect (sockpath, USOCK_RETRY_DEFAULT);
+    ok (fd >= 0,
+        "usock_client_connect %s works", sockpath);
+    ok (write (fd, bad, sizeof (bad)) == sizeof (bad),
+        "wrote bad header with huge size");
+
+    pthread_mutex_lock (&server_mutex);
+    while (!tp->ready)
+        pthread_cond_wait (&server_cond, &server_mutex);
+    ok (tp->errnum == EPROTO && tp->recvd == 0,
+        "server dropped connection with EPROTO");
+    pthread_mutex_unlock (&server_mutex);
+    (void)close (fd);
+}
+
 int main (int argc, char *argv[])
 {
     struct test_params tp = {0};
@@ -245,6 +285,9 @@ int main (int argc, char *argv[])
     check_result (&tp);
     memset (&tp, 0, sizeof (tp));
 
+    test_bad_header (&tp);
+    memset (&tp, 0, sizeof (tp));
+
     diag ("stopping test server");
     if (test_server_stop (h) < 0)
         BAIL_OUT ("test_server_stop failed");
@@ -31,6 +31,14 @@
  * - usock_conn_send() adds a message to a queue, starts fd (write) watcher.
  * - Register a receive callback to receive complete messages from client.
  * - Register an error callback to be notified when I/O errors occur.
+ *
+ * Batching:
+ * - The write watcher encodes queued messages into one buffer, up to
+ *   OUT_BATCH_SIZE bytes, and writes the buffer with as few write(2) calls
+ *   as possible.  Likewise, the read watcher and usock_client_recv() read
+ *   as much as is available and decode all the complete messages in it.
+ * - The wire encoding is unchanged (see sendfd.c), so no negotiation with
+ *   the peer is required.
  */
 
 #if HAVE_CONFIG_H
@@ -61,6 +69,8 @@
 
 #define LISTEN_BACKLOG 5
 
+#define OUT_BATCH_SIZE 65536
+
 #ifndef UUID_STR_LEN
 #define UUID_STR_LEN 37     // defined in later libuuid headers
 #endif
@@ -79,7 +89,7 @@ struct usock_server {
 struct usock_io {
     int fd;
     flux_watcher_t *w;
-    struct iobuf iobuf;
+    struct iostream ios;
 };
 
 struct usock_conn {
@@ -88,6 +98,7 @@ struct usock_conn {
     struct usock_io in;
     struct usock_io out;
     zlist_t *outqueue;
+    int outbatch;           // messages in out.ios not yet fully written
 
     int txcount;
     int rxcount;
@@ -113,7 +124,7 @@ struct usock_conn {
 
 struct usock_client {
     int fd;
-    struct iobuf in_iobuf;
+    struct iostream in;
     struct iobuf out_iobuf;
 };
 
@@ -218,21 +229,25 @@ static void conn_read_cb (flux_reactor_t *r,
     if ((revents & FLUX_POLLIN)) {
         flux_msg_t *msg;
 
-        if (!(msg = recvfd (conn->in.fd, &conn->in.iobuf))) {
+        if (iostream_read (conn->in.fd, &conn->in.ios) < 0) {
             if (errno != EWOULDBLOCK && errno != EAGAIN)
                 goto error;
+            return;
         }
-        else {
+        while ((msg = iostream_recv (&conn->in.ios))) {
             /* Update message credentials based on connected creds.
              */
-            if (auth_init_message (msg, &conn->cred) < 0)
+            if (auth_init_message (msg, &conn->cred) < 0) {
+                flux_msg_destroy (msg);
                 goto error;
-
+            }
             if (conn->recv_cb)
                 conn->recv_cb (conn, msg, conn->recv_arg);
             flux_msg_destroy (msg);
             conn->txcount++;
         }
+        if (errno != EWOULDBLOCK && errno != EAGAIN)
+            goto error;
     }
     return;
 error:
@@ -248,6 +263,24 @@ static int conn_outqueue_drop (struct usock_conn *conn)
     return 1;
 }
 
+/* Encode queued messages into the output buffer, up to OUT_BATCH_SIZE
+ * bytes, or at least one message.
+ */
+static int conn_outqueue_fill (struct usock_conn *conn)
+{
+    const flux_msg_t *msg;
+
+    while ((msg = zlist_head (conn->outqueue))
+           && (conn->outbatch == 0
+               || iostream_pending (&conn->out.ios) < OUT_BATCH_SIZE)) {
+        if (iostream_append (&conn->out.ios, msg) < 0)
+            return -1;
+        (void)conn_outqueue_drop (conn);
+        conn->outbatch++;
+    }
+    return 0;
+}
+
 static void conn_write_cb (flux_reactor_t *r,
                            flux_watcher_t *w,
                            int revents,
@@ -261,30 +294,37 @@ static void conn_write_cb (flux_reactor_t *r,
     }
 
     if ((revents & FLUX_POLLOUT)) {
-        const flux_msg_t *msg = zlist_head (conn->outqueue);
-        if (msg) {
-            if (sendfd (conn->out.fd, msg, &conn->out.iobuf) < 0) {
-                if (errno == EPIPE) {
-                    /* Remote peer has closed connection.
-                     * However, there may still be pending messages sent
-                     * by peer, so do not destroy connection here. Instead,
-                     * drop all pending messages in the output queue, and
-                     * let connection be closed after EOF/ECONNRESET from
-                     * *read* side of connection.
-                     */
-                    while (conn_outqueue_drop (conn))
-                        ;
-                    flux_watcher_stop (conn->out.w);
-                }
-                else if (errno != EWOULDBLOCK && errno != EAGAIN)
-                    goto error;
+        if (conn->outbatch == 0) {
+            if (conn_outqueue_fill (conn) < 0)
+                goto error;
+            if (conn->outbatch == 0) {
+                flux_watcher_stop (conn->out.w);
+                return;
             }
-            else {
-                (void) conn_outqueue_drop (conn);
-                if (zlist_size (conn->outqueue) == 0)
-                    flux_watcher_stop (conn->out.w);
-                conn->rxcount++;
+        }
+        if (iostream_write (conn->out.fd, &conn->out.ios) < 0) {
+            if (errno == EPIPE) {
+                /* Remote peer has closed connection.
+                 * However, there may still be pending messages sent
+                 * by peer, so do not destroy connection here. Instead,
+                 * drop all pending messages in the output queue, and
+                 * let connection be closed after EOF/ECONNRESET from
+                 * *read* side of connection.
+                 */
+                while (conn_outqueue_drop (conn))
+                    ;
+                iostream_clean (&conn->out.ios);
+                conn->outbatch = 0;
+                flux_watcher_stop (conn->out.w);
             }
+            else if (errno != EWOULDBLOCK && errno != EAGAIN)
+                goto error;
+        }
+        else {
+            conn->rxcount += conn->outbatch;
+            conn->outbatch = 0;
+            if (zlist_size (conn->outqueue) == 0)
+                flux_watcher_stop (conn->out.w);
         }
     }
     return;
@@ -341,7 +381,7 @@ void usock_conn_destroy (struct usock_conn *conn)
             (*conn->close_cb) (conn, conn->close_arg);
         aux_destroy (&conn->aux);
         flux_watcher_destroy (conn->in.w);
-        iobuf_clean (&conn->in.iobuf);
+        iostream_clean (&conn->in.ios);
         if (conn->outqueue) {
             const flux_msg_t *msg;
             while ((msg = zlist_pop (conn->outqueue)))
@@ -349,7 +389,7 @@ void usock_conn_destroy (struct usock_conn *conn)
             zlist_destroy (&conn->outqueue);
         }
         flux_watcher_destroy (conn->out.w);
-        iobuf_clean (&conn->out.iobuf);
+        iostream_clean (&conn->out.ios);
         if (conn->server)
             zlist_remove (conn->server->connections, conn);
         if (conn->enable_close_on_destroy) {
@@ -460,7 +500,7 @@ struct usock_conn *usock_conn_create (flux_reactor_t *r, int infd, int outfd)
                                                conn_read_cb,
                                                conn)))
         goto error;
-    iobuf_init (&conn->in.iobuf);
+    iostream_init (&conn->in.ios);
 
     if (!(conn->out.w = flux_fd_watcher_create (r,
                                                 conn->out.fd,
@@ -468,7 +508,7 @@ struct usock_conn *usock_conn_create (flux_reactor_t *r, int infd, int outfd)
                                                 conn_write_cb,
                                                 conn)))
         goto error;
-    iobuf_init (&conn->out.iobuf);
+    iostream_init (&conn->out.ios);
     uuid_generate (conn->uuid);
     uuid_unparse (conn->uuid, conn->uuid_str);
 
@@ -641,7 +681,7 @@ int usock_client_pollevents (struct usock_client *client)
 
     if (poll (&pfd, 1, 0) < 0)
         return FLUX_POLLERR;
-    if ((pfd.revents & POLLIN))
+    if ((pfd.revents & POLLIN) || iostream_has_msg (&client->in))
         flux_revents |= FLUX_POLLIN;
     if ((pfd.revents & POLLOUT))
         flux_revents |= FLUX_POLLOUT;
@@ -654,6 +694,8 @@ int usock_client_pollevents (struct usock_client *client)
 /* Get a file descriptor that can be polled for events.
  * Upon wakeup, call usock_client_pollevents() to see what events occurred.
  * N.B. see op->pollfd in libflux/connector.h
+ * N.B. messages may be buffered after a read, so the fd may not become
+ * ready again until usock_client_recv() has drained them.
  */
 int usock_client_pollfd (struct usock_client *client)
 {
@@ -699,21 +741,26 @@ int usock_client_send (struct usock_client *client,
     return 0;
 }
 
-/* Try to recv message.  If flags does not include FLUX_O_NONBLOCK,
- * and recvfd fails with EWOULDBLOCK/EAGAIN, then poll(POLLIN) and
- * keep trying until the full message is received
+/* Try to recv a buffered message.  If none is available, read more
+ * from the socket.  If flags does not include FLUX_O_NONBLOCK, and the
+ * read fails with EWOULDBLOCK/EAGAIN, then poll(POLLIN) and keep trying
+ * until a full message is received.
  */
 flux_msg_t *usock_client_recv (struct usock_client *client, int flags)
 {
     flux_msg_t *msg;
 
-    while (!(msg = recvfd (client->fd, &client->in_iobuf))) {
+    while (!(msg = iostream_recv (&client->in))) {
         if (errno != EWOULDBLOCK && errno != EAGAIN)
             return NULL;
-        if ((flags & FLUX_O_NONBLOCK))
-            return NULL;
-        if (usock_client_poll (client->fd, POLLIN) < 0)
-            return NULL;
+        if (iostream_read (client->fd, &client->in) < 0) {
+            if (errno != EWOULDBLOCK && errno != EAGAIN)
+                return NULL;
+            if ((flags & FLUX_O_NONBLOCK))
+                return NULL;
+            if (usock_client_poll (client->fd, POLLIN) < 0)
+                return NULL;
+        }
     }
     return msg;
 }
@@ -804,7 +851,7 @@ struct usock_client *usock_client_create (int fd)
         return NULL;
 
     client->fd = fd;
-    iobuf_init (&client->in_iobuf);
+    iostream_init (&client->in);
     iobuf_init (&client->out_iobuf);
 
     if (usock_client_read_zero (client->fd) < 0)
@@ -820,7 +867,7 @@ error:
 void usock_client_destroy (struct usock_client *client)
 {
     if (client) {
-        iobuf_clean (&client->in_iobuf);
+        iostream_clean (&client->in);
         iobuf_clean (&client->out_iobuf);
         ERRNO_SAFE_WRAP (free, client);
     }
@@ -834,7 +881,8 @@ static json_t *usock_client_stats_get (struct usock_conn *conn)
                       "pid", conn->pid,
                       "txcount", conn->txcount,
                       "rxcount", conn->rxcount,
-                      "rxbacklog", (int)zlist_size (conn->outqueue));
+                      "rxbacklog",
+                      (int)zlist_size (conn->outqueue) + conn->outbatch);
 }
 
 json_t *usock_server_stats_get (struct usock_server *server)
@@ -21,9 +21,15 @@
 
 #include "src/common/libczmqcontainers/czmq_containers.h"
 #include "src/common/libutil/aux.h"
+#include "src/common/libutil/errno_safe.h"
 #include "src/common/libjob/idf58.h"
+#include "src/common/libioencode/ioencode.h"
 #include "ccan/str/str.h"
 #include "bulk-exec.h"
+#include "subprocess_private.h"
+#include "command_private.h"
+#include "client.h"
+#include "remote.h"
 
 struct exec_cmd {
     struct idset *ranks;
@@ -31,6 +37,17 @@ struct exec_cmd {
     int flags;
 };
 
+/* A tree-exec request covering all ranks of one command.  Members are
+ * indexed by rank for dispatch of responses.
+ */
+struct exec_tree {
+    struct bulk_exec *exec;
+    flux_future_t *f;
+    struct idset *ranks;
+    flux_subprocess_t **procs;
+    size_t nprocs;
+};
+
 struct bulk_exec {
     flux_t *h;
 
@@ -48,6 +65,7 @@ struct bulk_exec {
     int exit_status;         /* Largest wait status of all complete procs */
 
     unsigned int active:1;
+    unsigned int tree_launch:1;
 
     flux_watcher_t *prep;
     flux_watcher_t *check;
@@ -61,6 +79,7 @@ struct bulk_exec {
 
     zlist_t *commands;
     zlist_t *processes;
+    zlist_t *trees;
 
     struct bulk_exec_ops *handlers;
     void *arg;
@@ -134,6 +153,196 @@ error:
     return NULL;
 }
 
+static void exec_tree_destroy (void *arg)
+{
+    struct exec_tree *t = arg;
+    if (t) {
+        int saved_errno = errno;
+        flux_future_destroy (t->f);
+        idset_destroy (t->ranks);
+        free (t->procs);
+        free (t);
+        errno = saved_errno;
+    }
+}
+
+static flux_subprocess_t *exec_tree_lookup (struct exec_tree *t,
+                                            unsigned long rank)
+{
+    if (rank >= t->nprocs)
+        return NULL;
+    return t->procs[rank];
+}
+
+static void exec_tree_fail (struct exec_tree *t,
+                            const struct idset *ranks,
+                            int errnum,
+                            const char *errstr)
+{
+    unsigned int rank;
+
+    rank = idset_first (ranks);
+    while (rank != IDSET_INVALID_ID) {
+        flux_subprocess_t *p;
+        if ((p = exec_tree_lookup (t, rank)))
+            remote_tree_failed (p, errnum, errstr);
+        rank = idset_next (ranks, rank);
+    }
+}
+
+static void exec_tree_started (struct exec_tree *t, json_t *pids)
+{
+    const char *key;
+    json_t *value;
+
+    json_object_foreach (pids, key, value) {
+        flux_subprocess_t *p;
+        if ((p = exec_tree_lookup (t, strtoul (key, NULL, 10))))
+            remote_tree_started (p, json_integer_value (value));
+    }
+}
+
+static void exec_add_completed_ranks (struct bulk_exec *exec,
+                                      const struct idset *ranks,
+                                      int status);
+
+/*  A finished response maps each wait status to the set of ranks that
+ *   exited with it, already merged along the TBON.  Account for each set
+ *   at once, with one exit notification per distinct status, instead of
+ *   driving each member subprocess through its own callbacks.  Members
+ *   that cannot be finished quietly, e.g. with output still pending, are
+ *   finished individually.
+ */
+static void exec_tree_finished (struct exec_tree *t, json_t *status)
+{
+    struct bulk_exec *exec = t->exec;
+    int complete = exec->complete;
+    const char *key;
+    json_t *value;
+
+    json_object_foreach (status, key, value) {
+        int wstatus = strtol (key, NULL, 10);
+        struct idset *ranks;
+        struct idset *done;
+        unsigned int rank;
+
+        if (!(ranks = idset_decode (json_string_value (value)))) {
+            flux_log_error (exec->h, "tree-exec: invalid finished ranks");
+            continue;
+        }
+        if (!(done = idset_create (0, IDSET_FLAG_AUTOGROW))) {
+            flux_log_error (exec->h, "tree-exec: idset_create");
+            idset_destroy (ranks);
+            continue;
+        }
+        rank = idset_first (ranks);
+        while (rank != IDSET_INVALID_ID) {
+            flux_subprocess_t *p;
+            if ((p = exec_tree_lookup (t, rank))) {
+                if (remote_tree_finished_quiet (p, wstatus))
+                    (void)idset_set (done, rank);
+                else
+                    remote_tree_finished (p, wstatus);
+            }
+            rank = idset_next (ranks, rank);
+        }
+        exec_add_completed_ranks (exec, done, wstatus);
+        idset_destroy (done);
+        idset_destroy (ranks);
+    }
+    if (exec->complete > complete
+        && exec->complete == exec->total
+        && exec->handlers->on_complete)
+        (*exec->handlers->on_complete) (exec, exec->arg);
+}
+
+static void exec_tree_continuation (flux_future_t *f, void *arg)
+{
+    struct exec_tree *t = arg;
+    flux_t *h = t->exec->h;
+    const char *type;
+    json_t *o = NULL;
+    const char *s;
+    int errnum;
+    const char *errstr = NULL;
+
+    if (flux_rpc_get_unpack (f, "{s:s}", "type", &type) < 0) {
+        /* Any rank not yet finished when the stream ends has failed.
+         */
+        if (errno == ENODATA)
+            exec_tree_fail (t, t->ranks, EPROTO, NULL);
+        else
+            exec_tree_fail (t, t->ranks, errno, future_strerror (f, errno));
+        return;
+    }
+    if (streq (type, "started")) {
+        if (flux_rpc_get_unpack (f, "{s:o}", "pids", &o) < 0)
+            goto error;
+        exec_tree_started (t, o);
+    }
+    else if (streq (type, "finished")) {
+        if (flux_rpc_get_unpack (f, "{s:o}", "status", &o) < 0)
+            goto error;
+        exec_tree_finished (t, o);
+    }
+    else if (streq (type, "failed")) {
+        struct idset *ranks;
+        if (flux_rpc_get_unpack (f,
+                                 "{s:s s:i s?s}",
+                                 "ranks", &s,
+                                 "errnum", &errnum,
+                                 "errstr", &errstr) < 0
+            || !(ranks = idset_decode (s)))
+            goto error;
+        exec_tree_fail (t, ranks, errnum, errstr);
+        idset_destroy (ranks);
+    }
+    else if (streq (type, "output")) {
+        flux_subprocess_t *p;
+        const char *stream;
+        const char *rank;
+        char *data = NULL;
+        int len;
+        bool eof;
+
+        if (flux_rpc_get_unpack (f, "{s:o}", "io", &o) < 0
+            || iodecode (o, &stream, &rank, &data, &len, &eof) < 0)
+            goto error;
+        if ((p = exec_tree_lookup (t, strtoul (rank, NULL, 10))))
+            remote_tree_output (p, stream, data, len, eof);
+        free (data);
+    }
+    flux_future_reset (f);
+    return;
+error:
+    flux_log_error (h, "tree-exec: error decoding response");
+    flux_future_reset (f);
+}
+
+static int exec_tree_write (struct bulk_exec *exec,
+                            const char *stream,
+                            const char *buf,
+                            int len,
+                            bool eof)
+{
+    struct exec_tree *t;
+
+    t = zlist_first (exec->trees);
+    while (t) {
+        if (subprocess_tree_write (exec->h,
+                                   bulk_exec_service_name (exec),
+                                   0,
+                                   flux_rpc_get_matchtag (t->f),
+                                   stream,
+                                   buf,
+                                   len,
+                                   eof) < 0)
+            return -1;
+        t = zlist_next (exec->trees);
+    }
+    return 0;
+}
+
 int bulk_exec_write (struct bulk_exec *exec,
                      const char *stream,
                      const char *buf,
@@ -145,6 +354,8 @@ int bulk_exec_write (struct bulk_exec *exec,
         errno = EINVAL;
         return -1;
     }
+    if (exec->tree_launch)
+        return exec_tree_write (exec, stream, buf, len, false);
 
     p = zlist_first (exec->processes);
     while (p) {
@@ -163,6 +374,8 @@ int bulk_exec_close (struct bulk_exec *exec, const char *stream)
         errno = EINVAL;
         return -1;
     }
+    if (exec->tree_launch)
+        return exec_tree_write (exec, stream, NULL, 0, true);
 
     p = zlist_first (exec->processes);
     while (p) {
@@ -180,8 +393,8 @@ static int exec_exit_notify (struct bulk_exec *exec)
     if (exec->exit_batch_timer) {
         flux_watcher_destroy (exec->exit_batch_timer);
         exec->exit_batch_timer = NULL;
-        idset_range_clear (exec->exit_batch, 0, INT_MAX);
     }
+    idset_range_clear (exec->exit_batch, 0, INT_MAX);
     return 0;
 }
 
@@ -236,6 +449,29 @@ static void exec_add_completed (struct bulk_exec *exec, flux_subprocess_t *p)
     }
 }
 
+/*  Account for a set of 'ranks' that exited with wait 'status'.  The set
+ *   is notified immediately, along with any ranks already in the current
+ *   batch, since it may cover many ranks.  The caller is responsible
+ *   for calling on_complete once all ranks are complete.
+ */
+static void exec_add_completed_ranks (struct bulk_exec *exec,
+                                      const struct idset *ranks,
+                                      int status)
+{
+    size_t count = idset_count (ranks);
+
+    if (count == 0)
+        return;
+    if (status > exec->exit_status)
+        exec->exit_status = status;
+    if (idset_add (exec->exit_batch, ranks) < 0) {
+        flux_log_error (exec->h, "exec_add_completed_ranks:idset_add");
+        return;
+    }
+    exec->complete += count;
+    exec_exit_notify (exec);
+}
+
 static void exec_complete_cb (flux_subprocess_t *p)
 {
     int status = flux_subprocess_status (p);
@@ -364,12 +600,95 @@ static int subprocess_destroy (flux_t *h, flux_subprocess_t *p)
     return 0;
 }
 
+/*  Start all ranks of 'cmd' with one tree-exec request sent to rank 0,
+ *   which forwards it down the TBON.  A subprocess is created for each
+ *   rank up front so that callers see the same objects as in the
+ *   default launch mode, and their state and output are driven by the
+ *   tree-exec responses.
+ */
+static int exec_start_tree (struct bulk_exec *exec, struct exec_cmd *cmd)
+{
+    struct exec_tree *t;
+    unsigned int rank;
+    int count = 0;
+    int flags = SUBPROCESS_REXEC_STDOUT | SUBPROCESS_REXEC_STDERR;
+
+    if (!(t = calloc (1, sizeof (*t)))
+        || !(t->ranks = idset_copy (cmd->ranks)))
+        goto error;
+    t->exec = exec;
+    t->nprocs = idset_last (cmd->ranks) + 1;
+    if (!(t->procs = calloc (t->nprocs, sizeof (t->procs[0]))))
+        goto error;
+    rank = idset_first (cmd->ranks);
+    while (rank != IDSET_INVALID_ID) {
+        flux_subprocess_t *p;
+
+        if (!(p = subprocess_tree_member (exec->h,
+                                          bulk_exec_service_name (exec),
+                                          rank,
+                                          cmd->flags,
+                                          cmd->cmd,
+                                          &exec->ops,
+                                          flux_llog,
+                                          exec->h)))
+            goto error;
+        if (flux_subprocess_aux_set (p, "job-exec::exec", exec, NULL) < 0
+            || zlist_append (exec->processes, p) < 0) {
+            flux_subprocess_destroy (p);
+            goto error;
+        }
+        zlist_freefn (exec->processes,
+                      p,
+                      (zlist_free_fn *) flux_subprocess_destroy,
+                      true);
+        t->procs[rank] = p;
+        rank = idset_next (cmd->ranks, rank);
+        count++;
+    }
+    if (zlist_size (cmd_channel_list (cmd->cmd)) > 0)
+        flags |= SUBPROCESS_REXEC_CHANNEL;
+    if (!(t->f = subprocess_tree_exec (exec->h,
+                                       bulk_exec_service_name (exec),
+                                       0,
+                                       cmd->cmd,
+                                       cmd->ranks,
+                                       flags,
+                                       cmd->flags
+                                       & ~FLUX_SUBPROCESS_FLAGS_LOCAL_UNBUF))
+        || flux_future_then (t->f, -1., exec_tree_continuation, t) < 0
+        || zlist_append (exec->trees, t) < 0) {
+        /* No tree-exec response will arrive for the members, so fail
+         * them.  Each is then completed like any other failed process.
+         */
+        exec_tree_fail (t, t->ranks, errno, NULL);
+        idset_range_clear (cmd->ranks, 0, INT_MAX);
+        exec_tree_destroy (t);
+        return count;
+    }
+    zlist_freefn (exec->trees, t, exec_tree_destroy, true);
+    idset_range_clear (cmd->ranks, 0, INT_MAX);
+    return count;
+error:
+    /* Fail members already appended to exec->processes so they do not
+     * wait for a tree-exec response.  The caller's on_error handler is
+     * called for the rest.
+     */
+    if (t && t->procs)
+        exec_tree_fail (t, t->ranks, errno, NULL);
+    exec_tree_destroy (t);
+    return -1;
+}
+
 static int exec_start_cmd (struct bulk_exec *exec,
                            struct exec_cmd *cmd,
                            int max)
 {
     int count = 0;
     uint32_t rank;
+
+    if (exec->tree_launch)
+        return exec_start_tree (exec, cmd);
     rank = idset_first (cmd->ranks);
     while (rank != IDSET_INVALID_ID && (max < 0 || count < max)) {
         /* Set the unit name for the "sdexec" service.  This is done here
@@ -492,6 +811,7 @@ void bulk_exec_destroy (struct bulk_exec *exec)
 {
     if (exec) {
         int saved_errno = errno;
+        zlist_destroy (&exec->trees);
         zlist_destroy (&exec->processes);
         zlist_destroy (&exec->commands);
         idset_destroy (exec->exit_batch);
@@ -531,6 +851,7 @@ struct bulk_exec * bulk_exec_create (struct bulk_exec_ops *ops,
     exec->arg = arg;
     exec->processes = zlist_new ();
     exec->commands = zlist_new ();
+    exec->trees = zlist_new ();
     exec->exit_batch = idset_create (0, IDSET_FLAG_AUTOGROW);
     exec->max_start_per_loop = 1;
 
@@ -550,6 +871,22 @@ int bulk_exec_set_max_per_loop (struct bulk_exec *exec, int max)
     return 0;
 }
 
+int bulk_exec_set_tree_launch (struct bulk_exec *exec, bool enable)
+{
+    if (!exec || exec->active) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* sdexec requires a unit name per rank, see exec_start_cmd()
+     */
+    if (enable && streq (exec->service, "sdexec")) {
+        errno = ENOTSUP;
+        return -1;
+    }
+    exec->tree_launch = enable;
+    return 0;
+}
+
 int bulk_exec_push_cmd (struct bulk_exec *exec,
                        const struct idset *ranks,
                        flux_cmd_t *cmd,
@@ -667,6 +1004,62 @@ void bulk_exec_kill_log_error (flux_future_t *f, flux_jobid_t id)
     }
 }
 
+/*  Send one tree-kill request per tree-exec request that has active
+ *   processes on 'ranks' (or any ranks if NULL), and push the futures
+ *   onto 'cf'.
+ */
+static int exec_tree_kill (struct bulk_exec *exec,
+                           flux_future_t *cf,
+                           const struct idset *ranks,
+                           int signum)
+{
+    struct exec_tree *t;
+
+    t = zlist_first (exec->trees);
+    while (t) {
+        struct idset *active;
+        unsigned int rank;
+
+        if (!(active = idset_create (0, IDSET_FLAG_AUTOGROW)))
+            return -1;
+        rank = idset_first (t->ranks);
+        while (rank != IDSET_INVALID_ID) {
+            flux_subprocess_t *p = t->procs[rank];
+            if ((!ranks || idset_test (ranks, rank))
+                && flux_subprocess_active (p)
+                && idset_set (active, rank) < 0) {
+                idset_destroy (active);
+                return -1;
+            }
+            rank = idset_next (t->ranks, rank);
+        }
+        if (idset_count (active) > 0) {
+            uint32_t matchtag = flux_rpc_get_matchtag (t->f);
+            flux_future_t *f;
+            char s[64];
+
+            if (!(f = subprocess_tree_kill (exec->h,
+                                            bulk_exec_service_name (exec),
+                                            0,
+                                            matchtag,
+                                            active,
+                                            signum))) {
+                idset_destroy (active);
+                return -1;
+            }
+            (void) snprintf (s, sizeof (s), "tree-%ju", (uintmax_t)matchtag);
+            if (flux_future_push (cf, s, f) < 0) {
+                flux_future_destroy (f);
+                idset_destroy (active);
+                return -1;
+            }
+        }
+        idset_destroy (active);
+        t = zlist_next (exec->trees);
+    }
+    return 0;
+}
+
 flux_future_t *bulk_exec_kill (struct bulk_exec *exec,
                                const struct idset *ranks,
                                int signum)
@@ -683,6 +1076,14 @@ flux_future_t *bulk_exec_kill (struct bulk_exec *exec,
         return NULL;
     flux_future_set_flux (cf, exec->h);
 
+    if (exec->tree_launch) {
+        if (exec_tree_kill (exec, cf, ranks, signum) < 0) {
+            ERRNO_SAFE_WRAP (flux_future_destroy, cf);
+            return NULL;
+        }
+        goto done;
+    }
+
     p = zlist_first (exec->processes);
     while (p) {
         if ((!ranks || idset_test (ranks, flux_subprocess_rank (p)))) {
@@ -712,6 +1113,7 @@ flux_future_t *bulk_exec_kill (struct bulk_exec *exec,
         p = zlist_next (exec->processes);
     }
 
+done:
     /*  If no child futures were pushed into the wait_all future `cf`,
      *   then no signals were sent and we should immediately return ENOENT.
      */
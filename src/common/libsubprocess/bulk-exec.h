@@ -60,6 +60,13 @@ int bulk_exec_aux_set (struct bulk_exec *exec,
  */
 int bulk_exec_set_max_per_loop (struct bulk_exec *exec, int max);
 
+/*  Launch each pushed command with a single tree-exec request that is
+ *   forwarded down the TBON from rank 0, instead of one rexec request
+ *   per rank.  Must be set before bulk_exec_start().  Not supported
+ *   with the "sdexec" service (ENOTSUP).
+ */
+int bulk_exec_set_tree_launch (struct bulk_exec *exec, bool enable);
+
 void bulk_exec_destroy (struct bulk_exec *exec);
 
 int bulk_exec_push_cmd (struct bulk_exec *exec,
@@ -536,4 +536,111 @@ flux_future_t *subprocess_kill (flux_t *h,
     return f;
 }
 
+flux_future_t *subprocess_tree_exec (flux_t *h,
+                                     const char *service_name,
+                                     uint32_t rank,
+                                     const flux_cmd_t *cmd,
+                                     const struct idset *ranks,
+                                     int flags,
+                                     int local_flags)
+{
+    flux_future_t *f = NULL;
+    json_t *ocmd = NULL;
+    char *topic = NULL;
+    char *s = NULL;
+
+    if (!h || !service_name || !cmd || !ranks
+        || (local_flags & FLUX_SUBPROCESS_FLAGS_SIGN)) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (asprintf (&topic, "%s.tree-exec", service_name) < 0
+        || !(ocmd = cmd_tojson (cmd))
+        || !(s = idset_encode (ranks, IDSET_FLAG_RANGE)))
+        goto out;
+    f = flux_rpc_pack (h,
+                       topic,
+                       rank,
+                       FLUX_RPC_STREAMING,
+                       "{s:O s:i s:i s:s}",
+                       "cmd", ocmd,
+                       "flags", flags,
+                       "local_flags", local_flags,
+                       "ranks", s);
+out:
+    ERRNO_SAFE_WRAP (free, s);
+    ERRNO_SAFE_WRAP (free, topic);
+    ERRNO_SAFE_WRAP (json_decref, ocmd);
+    return f;
+}
+
+int subprocess_tree_write (flux_t *h,
+                           const char *service_name,
+                           uint32_t rank,
+                           uint32_t matchtag,
+                           const char *stream,
+                           const char *data,
+                           int len,
+                           bool eof)
+{
+    flux_future_t *f = NULL;
+    json_t *io = NULL;
+    char *topic;
+    int rc = -1;
+
+    if (!h || !service_name || !stream) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (asprintf (&topic, "%s.tree-write", service_name) < 0)
+        return -1;
+    if (!(io = ioencode (stream, "0", data, len, eof))
+        || !(f = flux_rpc_pack (h,
+                                topic,
+                                rank,
+                                FLUX_RPC_NORESPONSE,
+                                "{s:i s:O}",
+                                "matchtag", matchtag,
+                                "io", io)))
+        goto out;
+    rc = 0;
+out:
+    flux_future_destroy (f);
+    ERRNO_SAFE_WRAP (json_decref, io);
+    ERRNO_SAFE_WRAP (free, topic);
+    return rc;
+}
+
+flux_future_t *subprocess_tree_kill (flux_t *h,
+                                     const char *service_name,
+                                     uint32_t rank,
+                                     uint32_t matchtag,
+                                     const struct idset *ranks,
+                                     int signum)
+{
+    flux_future_t *f = NULL;
+    char *topic = NULL;
+    char *s = NULL;
+
+    if (!h || !service_name || !ranks) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (asprintf (&topic, "%s.tree-kill", service_name) < 0
+        || !(s = idset_encode (ranks, IDSET_FLAG_RANGE)))
+        goto out;
+    f = flux_rpc_pack (h,
+                       topic,
+                       rank,
+                       0,
+                       "{s:i s:s s:i}",
+                       "matchtag", matchtag,
+                       "ranks", s,
+                       "signum", signum);
+out:
+    ERRNO_SAFE_WRAP (free, s);
+    ERRNO_SAFE_WRAP (free, topic);
+    return f;
+}
+
 // vi: ts=4 sw=4 expandtab
@@ -21,6 +21,7 @@
 
 #include <jansson.h>
 #include <flux/core.h>
+#include <flux/idset.h>
 #include "subprocess.h"
 
 #if HAVE_FLUX_SECURITY
@@ -80,6 +81,45 @@ flux_future_t *subprocess_kill (flux_t *h,
                                 bool sign);
 
 
+/* Tree-exec: run 'cmd' on each rank in 'ranks', forwarding the request
+ * down the TBON from 'rank'.  Responses are streamed:
+ *   {"type":"started", "pids":{"<rank>":i, ...}}
+ *   {"type":"finished", "status":{"<wait status>":"<idset>", ...}}
+ *   {"type":"failed", "ranks":s, "errnum":i, "errstr"?:s}
+ *   {"type":"output", "io":o}  (io rank field is the target rank)
+ * followed by ENODATA once all ranks are finished or failed.
+ * Started and finished responses are batched per subtree.
+ */
+flux_future_t *subprocess_tree_exec (flux_t *h,
+                                     const char *service_name,
+                                     uint32_t rank,
+                                     const flux_cmd_t *cmd,
+                                     const struct idset *ranks,
+                                     int flags,
+                                     int local_flags);
+
+/* Write to (or close, if eof is true) 'stream' of all running processes
+ * of the tree-exec request with 'matchtag'.
+ */
+int subprocess_tree_write (flux_t *h,
+                           const char *service_name,
+                           uint32_t rank,
+                           uint32_t matchtag,
+                           const char *stream,
+                           const char *data,
+                           int len,
+                           bool eof);
+
+/* Signal processes on 'ranks' of the tree-exec request with 'matchtag'.
+ */
+flux_future_t *subprocess_tree_kill (flux_t *h,
+                                     const char *service_name,
+                                     uint32_t rank,
+                                     uint32_t matchtag,
+                                     const struct idset *ranks,
+                                     int signum);
+
+
 #endif /* !_SUBPROCESS_CLIENT_H */
 
 // vi: ts=4 sw=4 expandtab
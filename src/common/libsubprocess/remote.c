@@ -612,6 +612,72 @@ int remote_exec (flux_subprocess_t *p)
     return 0;
 }
 
+void remote_tree_started (flux_subprocess_t *p, pid_t pid)
+{
+    if (p->state != FLUX_SUBPROCESS_INIT)
+        return;
+    p->pid = pid;
+    p->pid_set = true;
+    process_new_state (p, FLUX_SUBPROCESS_RUNNING);
+}
+
+void remote_tree_finished (flux_subprocess_t *p, int status)
+{
+    if (p->state != FLUX_SUBPROCESS_RUNNING)
+        return;
+    p->status = status;
+    process_new_state (p, FLUX_SUBPROCESS_EXITED);
+    /* The tree-exec server reports a rank finished only after its
+     * output is complete, so there is no separate ENODATA per rank.
+     */
+    p->remote_completed = true;
+    subprocess_check_completed (p);
+}
+
+bool remote_tree_finished_quiet (flux_subprocess_t *p, int status)
+{
+    if (p->state != FLUX_SUBPROCESS_RUNNING
+        || p->state_reported != FLUX_SUBPROCESS_RUNNING
+        || p->channels_eof_sent != p->channels_eof_expected)
+        return false;
+    p->status = status;
+    p->state = p->state_reported = FLUX_SUBPROCESS_EXITED;
+    stop_in_watchers (p);
+    p->remote_completed = true;
+    p->completed = true;
+    return true;
+}
+
+void remote_tree_failed (flux_subprocess_t *p,
+                         int errnum,
+                         const char *errmsg)
+{
+    if (p->state == FLUX_SUBPROCESS_EXITED
+        || p->state == FLUX_SUBPROCESS_FAILED)
+        return;
+    errno = errnum;
+    set_failed (p, "%s", errmsg ? errmsg : strerror (errnum));
+    process_new_state (p, FLUX_SUBPROCESS_FAILED);
+}
+
+void remote_tree_output (flux_subprocess_t *p,
+                         const char *stream,
+                         const char *data,
+                         int len,
+                         bool eof)
+{
+    int rc;
+
+    if (p->state == FLUX_SUBPROCESS_FAILED)
+        return;
+    if (p->flags & FLUX_SUBPROCESS_FLAGS_LOCAL_UNBUF)
+        rc = remote_output_local_unbuf (p, stream, data, len, eof);
+    else
+        rc = remote_output_buffered (p, stream, data, len, eof);
+    if (rc < 0)
+        process_new_state (p, FLUX_SUBPROCESS_FAILED);
+}
+
 flux_future_t *remote_kill (flux_subprocess_t *p, int signum)
 {
     bool sign = false;
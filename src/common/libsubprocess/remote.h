@@ -19,6 +19,28 @@ int remote_exec (flux_subprocess_t *p);
 
 flux_future_t *remote_kill (flux_subprocess_t *p, int signum);
 
+/* Deliver the state and output of a subprocess created with
+ * subprocess_tree_member(), as reported by a tree-exec response.
+ */
+void remote_tree_started (flux_subprocess_t *p, pid_t pid);
+void remote_tree_finished (flux_subprocess_t *p, int status);
+
+/* Like remote_tree_finished(), but mark 'p' exited and completed without
+ * calling its state change or completion callbacks, so that the owner
+ * can account for a set of ranks that finished with the same status at
+ * once.  Returns false without changing 'p' if it is not running, has
+ * an unreported state change, or has output channels still open.
+ */
+bool remote_tree_finished_quiet (flux_subprocess_t *p, int status);
+void remote_tree_failed (flux_subprocess_t *p,
+                         int errnum,
+                         const char *errmsg);
+void remote_tree_output (flux_subprocess_t *p,
+                         const char *stream,
+                         const char *data,
+                         int len,
+                         bool eof);
+
 #endif /* !_SUBPROCESS_REMOTE_H */
 
 // vi: ts=4 sw=4 expandtab
@@ -140,6 +140,8 @@ struct subprocess_server {
     flux_msg_handler_t **handlers;
     subprocess_server_auth_f auth_cb;
     void *arg;
+    subprocess_server_disconnect_f disconnect_cb;
+    void *disconnect_arg;
     // The shutdown future is created when user calls shutdown,
     //  and fulfilled once subprocesses list becomes empty.
     flux_future_t *shutdown;
@@ -1070,6 +1072,8 @@ static void server_disconnect_cb (flux_t *h,
             p = zlistx_next (s->subprocesses);
         }
     }
+    if (s->disconnect_cb)
+        (*s->disconnect_cb) (msg, s->disconnect_arg);
 }
 
 static void server_wait_cb (flux_t *h,
@@ -1279,6 +1283,14 @@ void subprocess_server_set_auth_cb (subprocess_server_t *s,
     s->arg = arg;
 }
 
+void subprocess_server_set_disconnect_cb (subprocess_server_t *s,
+                                          subprocess_server_disconnect_f fn,
+                                          void *arg)
+{
+    s->disconnect_cb = fn;
+    s->disconnect_arg = arg;
+}
+
 #if HAVE_FLUX_SECURITY
 void subprocess_server_set_security (subprocess_server_t *s,
                                      flux_security_t *sec,
@@ -26,6 +26,9 @@ typedef int (*subprocess_server_auth_f) (const flux_msg_t *msg,
                                          void *arg,
                                          flux_error_t *error);
 
+typedef void (*subprocess_server_disconnect_f) (const flux_msg_t *msg,
+                                                void *arg);
+
 /* Create a subprocess server.
  * This sets up a signal watcher for SIGCHLD.  Make sure SIGCHLD cannot be
  * delivered to other threads. Also, it may be wise to block SIGPIPE to
@@ -45,6 +48,15 @@ void subprocess_server_set_auth_cb (subprocess_server_t *s,
                                     subprocess_server_auth_f fn,
                                     void *arg);
 
+/* Register a callback to be notified of client disconnects, after the
+ * server has cleaned up the client's subprocesses.  This allows services
+ * that share the server's topic namespace to clean up their own state,
+ * since only one handler may be registered for the disconnect topic.
+ */
+void subprocess_server_set_disconnect_cb (subprocess_server_t *s,
+                                          subprocess_server_disconnect_f fn,
+                                          void *arg);
+
 /* Destroy a subprocess server.  This sends a SIGKILL to any remaining
  * subprocesses, then destroys them.
  */
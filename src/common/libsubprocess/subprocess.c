@@ -618,14 +618,16 @@ out:
 }
 
 
-flux_subprocess_t *flux_rexec_ex (flux_t *h,
-                                  const char *service_name,
-                                  int rank,
-                                  int flags,
-                                  const flux_cmd_t *cmd,
-                                  const flux_subprocess_ops_t *ops,
-                                  subprocess_log_f log_fn,
-                                  void *log_data)
+/* Create a remote subprocess object without sending the exec request.
+ */
+static flux_subprocess_t *remote_create (flux_t *h,
+                                         const char *service_name,
+                                         int rank,
+                                         int flags,
+                                         const flux_cmd_t *cmd,
+                                         const flux_subprocess_ops_t *ops,
+                                         subprocess_log_f log_fn,
+                                         void *log_data)
 {
     flux_subprocess_t *p = NULL;
     flux_reactor_t *r;
@@ -680,9 +682,6 @@ flux_subprocess_t *flux_rexec_ex (flux_t *h,
     if (subprocess_setup_completed (p) < 0)
         goto error;
 
-    if (remote_exec (p) < 0)
-        goto error;
-
     return p;
 
 error:
@@ -690,6 +689,58 @@ error:
     return NULL;
 }
 
+flux_subprocess_t *flux_rexec_ex (flux_t *h,
+                                  const char *service_name,
+                                  int rank,
+                                  int flags,
+                                  const flux_cmd_t *cmd,
+                                  const flux_subprocess_ops_t *ops,
+                                  subprocess_log_f log_fn,
+                                  void *log_data)
+{
+    flux_subprocess_t *p;
+
+    if (!(p = remote_create (h,
+                             service_name,
+                             rank,
+                             flags,
+                             cmd,
+                             ops,
+                             log_fn,
+                             log_data)))
+        return NULL;
+
+    if (remote_exec (p) < 0) {
+        subprocess_decref (p);
+        return NULL;
+    }
+
+    return p;
+}
+
+flux_subprocess_t *subprocess_tree_member (flux_t *h,
+                                           const char *service_name,
+                                           int rank,
+                                           int flags,
+                                           const flux_cmd_t *cmd,
+                                           const flux_subprocess_ops_t *ops,
+                                           subprocess_log_f log_fn,
+                                           void *log_data)
+{
+    if (flags & FLUX_SUBPROCESS_FLAGS_SIGN) {
+        errno = EINVAL;
+        return NULL;
+    }
+    return remote_create (h,
+                          service_name,
+                          rank,
+                          flags,
+                          cmd,
+                          ops,
+                          log_fn,
+                          log_data);
+}
+
 flux_subprocess_t *flux_rexec (flux_t *h,
                                int rank,
                                int flags,
@@ -140,6 +140,19 @@ void subprocess_decref (flux_subprocess_t *p);
 
 void subprocess_standard_output (flux_subprocess_t *p, const char *name);
 
+/* Create a remote subprocess for one rank of a tree-exec request.  No
+ * request is sent for it.  Its state and output are delivered by the
+ * owner of the tree-exec request with the remote_tree_*() functions.
+ */
+flux_subprocess_t *subprocess_tree_member (flux_t *h,
+                                           const char *service_name,
+                                           int rank,
+                                           int flags,
+                                           const flux_cmd_t *cmd,
+                                           const flux_subprocess_ops_t *ops,
+                                           subprocess_log_f log_fn,
+                                           void *log_data);
+
 #endif /* !_SUBPROCESS_PRIVATE_H */
 
 // vi: ts=4 sw=4 expandtab
@@ -27,6 +27,8 @@ int main (int argc, char *argv[])
         "bulk_exec_aux_set (NULL, ..) returns EINVAL");
     ok (bulk_exec_set_max_per_loop (NULL, 1) < 0 && errno == EINVAL,
         "bulk_exec_set_max_per_loop (NULL, 1) returns EINVAL");
+    ok (bulk_exec_set_tree_launch (NULL, true) < 0 && errno == EINVAL,
+        "bulk_exec_set_tree_launch (NULL, true) returns EINVAL");
     ok (bulk_exec_push_cmd (NULL, NULL, NULL, 0) < 0 && errno == EINVAL,
         "bulk_exec_push_cmd (NULL, ...) returns EINVAL");
     ok (bulk_exec_start (NULL, NULL) < 0 && errno == EINVAL,
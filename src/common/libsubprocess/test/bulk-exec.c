@@ -204,6 +204,11 @@ int main (int ac, char **av)
           .arginfo = "NCMDS",
           .usage = "Cancel after NCMDS cmds have been launched"
         },
+        { .name = "tree",
+          .key  = 't',
+          .has_arg = 0,
+          .usage = "Launch each cmd with a single tree-exec request"
+        },
         OPTPARSE_TABLE_END
     };
 
@@ -253,6 +258,10 @@ int main (int ac, char **av)
     if (bulk_exec_set_max_per_loop (exec, optparse_get_int (p, "mpl", -1)) < 0)
         log_err_exit ("bulk_exec_set_max_per_loop");
 
+    if (optparse_hasopt (p, "tree")
+        && bulk_exec_set_tree_launch (exec, true) < 0)
+        log_err_exit ("bulk_exec_set_tree_launch");
+
     ncmds = optparse_get_int (p, "ncmds", 1);
 
     push_commands (exec, idset, ncmds, ac, av);
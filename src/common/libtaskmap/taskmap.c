@@ -30,11 +30,23 @@ struct taskmap_block {
     int nnodes;
     int ppn;
     int repeat;
+    int first_task;     /* first taskid in block, set by taskmap_index */
+};
+
+/*  Array of blocks ordered by first taskid, built on demand so that
+ *   taskmap_nodeid() is a binary search rather than a walk of all blocks.
+ */
+struct taskmap_index {
+    bool valid;
+    struct taskmap_block **blocks;
+    size_t count;
+    size_t size;
 };
 
 struct taskmap {
     zlistx_t *blocklist;
     lru_cache_t *idsets;
+    struct taskmap_index *index;
 };
 
 static struct taskmap_block * taskmap_block_create (int nodeid,
@@ -114,6 +126,10 @@ void taskmap_destroy (struct taskmap *map)
         int saved_errno = errno;
         zlistx_destroy (&map->blocklist);
         lru_cache_destroy (map->idsets);
+        if (map->index) {
+            free (map->index->blocks);
+            free (map->index);
+        }
         free (map);
         errno = saved_errno;
     }
@@ -125,7 +141,8 @@ struct taskmap *taskmap_create (void)
 
     if (!(map = calloc (1, sizeof (*map)))
         || !(map->blocklist = zlistx_new ())
-        || !(map->idsets = lru_cache_create (16))) {
+        || !(map->idsets = lru_cache_create (16))
+        || !(map->index = calloc (1, sizeof (*map->index)))) {
         errno = ENOMEM;
         goto error;
     }
@@ -180,24 +197,60 @@ static int append_to_zlistx (zlistx_t *l, void *item)
     return 0;
 }
 
+/*  Only the tail block is modified by taskmap_append(), so only the tail
+ *  can newly repeat the block before it.
+ */
 static void taskmap_find_repeats (struct taskmap *map)
 {
     struct taskmap_block *block;
-    struct taskmap_block *prev = NULL;
+    struct taskmap_block *prev;
+    void *handle;
+
+    if (!(block = zlistx_last (map->blocklist)))
+        return;
+    handle = zlistx_cursor (map->blocklist);
+    if ((prev = zlistx_prev (map->blocklist))
+        && block->start == prev->start
+        && block->nnodes == prev->nnodes
+        && block->ppn == prev->ppn) {
+        prev->repeat += block->repeat;
+        zlistx_delete (map->blocklist, handle);
+    }
+}
 
-    prev = zlistx_first (map->blocklist);
-    block = zlistx_next (map->blocklist);
-    while (block) {
-        if (block->start == prev->start
-            && block->nnodes == prev->nnodes
-            && block->ppn == prev->ppn) {
-            prev->repeat += block->repeat;
-            zlistx_delete (map->blocklist, zlistx_cursor (map->blocklist));
+static void taskmap_index_invalidate (struct taskmap *map)
+{
+    map->index->valid = false;
+}
+
+static int taskmap_index_update (const struct taskmap *map)
+{
+    struct taskmap_index *index = map->index;
+    struct taskmap_block *block;
+    size_t count = zlistx_size (map->blocklist);
+    int current = 0;
+
+    if (index->valid)
+        return 0;
+    if (count > index->size) {
+        struct taskmap_block **blocks;
+        if (!(blocks = realloc (index->blocks, count * sizeof (*blocks)))) {
+            errno = ENOMEM;
+            return -1;
         }
-        else
-            prev = block;
+        index->blocks = blocks;
+        index->size = count;
+    }
+    index->count = 0;
+    block = zlistx_first (map->blocklist);
+    while (block) {
+        block->first_task = current;
+        current += block->nnodes * block->ppn * block->repeat;
+        index->blocks[index->count++] = block;
         block = zlistx_next (map->blocklist);
     }
+    index->valid = true;
+    return 0;
 }
 
 int taskmap_append (struct taskmap *map, int nodeid, int nnodes, int ppn)
@@ -209,6 +262,7 @@ int taskmap_append (struct taskmap *map, int nodeid, int nnodes, int ppn)
         return -1;
     }
     decache_idset (map, nodeid);
+    taskmap_index_invalidate (map);
     if ((block = zlistx_tail (map->blocklist))) {
         /*  If previous block ends at nodeid - 1, and has the same ppn
          *  and a repeat of 1, then add nnodes to the previous block
@@ -429,6 +483,15 @@ static void item_destructor (void **item)
     }
 }
 
+/*  Growable array of raw_task runs.  Runs are stored inline rather
+ *  than as separately allocated list items.
+ */
+struct raw_task_list {
+    struct raw_task *tasks;
+    size_t count;
+    size_t size;
+};
+
 static int taskid_cmp (const void *a, const void *b)
 {
     const struct raw_task *t1 = a;
@@ -436,34 +499,28 @@ static int taskid_cmp (const void *a, const void *b)
     return (t1->taskid - t2->taskid);
 }
 
-static int raw_task_append (zlistx_t *l, int taskid, int nodeid, int repeat)
+static int raw_task_append (struct raw_task_list *l,
+                            int taskid,
+                            int nodeid,
+                            int repeat)
 {
-    struct raw_task *t = calloc (1, sizeof (*t));
-    if (!t)
-        return -1;
+    struct raw_task *t;
+
+    if (l->count == l->size) {
+        size_t size = l->size ? l->size * 2 : 64;
+        if (!(t = realloc (l->tasks, size * sizeof (*t))))
+            return -1;
+        l->tasks = t;
+        l->size = size;
+    }
+    t = &l->tasks[l->count++];
     t->taskid = taskid;
     t->nodeid = nodeid;
     t->repeat = repeat;
-    if (!zlistx_add_end (l, t)) {
-        free (t);
-        return -1;
-    }
     return 0;
 }
 
-static zlistx_t *raw_task_list_create (void)
-{
-    zlistx_t *l;
-    if (!(l = zlistx_new ())) {
-        errno = ENOMEM;
-        return NULL;
-    }
-    zlistx_set_destructor (l, item_destructor);
-    zlistx_set_comparator (l, &taskid_cmp);
-    return l;
-}
-
-static int raw_task_list_append (zlistx_t *l,
+static int raw_task_list_append (struct raw_task_list *l,
                                  const char *s,
                                  int nodeid,
                                  flux_error_t *errp)
@@ -549,17 +606,16 @@ static struct taskmap *taskmap_decode_raw (const char *s, flux_error_t *errp)
     char *q;
     char *cpy = NULL;
     struct taskmap *map = NULL;
-    zlistx_t *l = NULL;
+    struct raw_task_list l = { 0 };
     int nodeid = 0;
-    struct raw_task *t, *prev;
+    struct raw_task *prev;
 
     if (!s || strlen (s) == 0) {
         errprintf (errp, "Invalid argument");
         return NULL;
     }
     if (!(map = taskmap_create ())
-        || !(cpy = strdup (s))
-        || !(l = raw_task_list_create ())) {
+        || !(cpy = strdup (s))) {
         errprintf (errp, "Out of memory");
         goto error;
     }
@@ -567,17 +623,17 @@ static struct taskmap *taskmap_decode_raw (const char *s, flux_error_t *errp)
     p = cpy;
 
     while ((tok = strtok_r (p, ";", &q))) {
-        if (raw_task_list_append (l, tok, nodeid++, errp) < 0)
+        if (raw_task_list_append (&l, tok, nodeid++, errp) < 0)
             goto error;
         p = NULL;
     }
 
     /* sort by taskid */
-    zlistx_sort (l);
-    t = zlistx_first (l);
+    qsort (l.tasks, l.count, sizeof (l.tasks[0]), taskid_cmp);
     prev = NULL;
 
-    while (t) {
+    for (size_t i = 0; i < l.count; i++) {
+        struct raw_task *t = &l.tasks[i];
         if (raw_task_check (prev, t, errp) < 0)
             goto error;
         if (taskmap_append (map, t->nodeid, 1, t->repeat) < 0) {
@@ -585,13 +641,12 @@ static struct taskmap *taskmap_decode_raw (const char *s, flux_error_t *errp)
             goto error;
         }
         prev = t;
-        t = zlistx_next (l);
     }
-    zlistx_destroy (&l);
+    free (l.tasks);
     free (cpy);
     return map;
 error:
-    zlistx_destroy (&l);
+    free (l.tasks);
     taskmap_destroy (map);
     free (cpy);
     return NULL;
@@ -685,35 +740,60 @@ const struct idset *taskmap_taskids (const struct taskmap *map, int nodeid)
 int taskmap_nodeid (const struct taskmap *map, int taskid)
 {
     struct taskmap_block *block;
-    int current = 0;
+    size_t lo, hi;
+    int offset;
 
     if (!map || taskid < 0 || taskmap_unknown (map)) {
         errno = EINVAL;
         return -1;
     }
+    if (taskmap_index_update (map) < 0)
+        return -1;
 
-    block = zlistx_first (map->blocklist);
-    while (block) {
-        for (int n = 0; n < block->repeat; n++) {
-            int last = current + block->nnodes * block->ppn - 1;
-            if (taskid <= last) {
-                int distance = taskid - current;
-                return block->start + (distance / block->ppn);
-            }
-            current = last + 1;
-        }
-        block = zlistx_next (map->blocklist);
+    /*  Find the last block whose first taskid is <= taskid
+     */
+    lo = 0;
+    hi = map->index->count;
+    while (hi - lo > 1) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (map->index->blocks[mid]->first_task <= taskid)
+            lo = mid;
+        else
+            hi = mid;
     }
-    errno = ENOENT;
-    return -1;
+    block = map->index->blocks[lo];
+    offset = taskid - block->first_task;
+    if (offset >= block->nnodes * block->ppn * block->repeat) {
+        errno = ENOENT;
+        return -1;
+    }
+    offset %= block->nnodes * block->ppn;
+    return block->start + (offset / block->ppn);
 }
 
+/*  Count tasks directly from the blocks containing 'nodeid', so that
+ *  calling this for every node does not construct an idset per node.
+ */
 int taskmap_ntasks (const struct taskmap *map, int nodeid)
 {
-    const struct idset *taskids = taskmap_taskids (map, nodeid);
-    if (!taskids)
+    struct taskmap_block *block;
+    int ntasks = 0;
+
+    if (!map || nodeid < 0 || taskmap_unknown (map)) {
+        errno = EINVAL;
         return -1;
-    return idset_count (taskids);
+    }
+    block = zlistx_first (map->blocklist);
+    while (block) {
+        if (nodeid >= block->start && nodeid <= taskmap_block_end (block))
+            ntasks += block->ppn * block->repeat;
+        block = zlistx_next (map->blocklist);
+    }
+    if (ntasks == 0) {
+        errno = ENOENT;
+        return -1;
+    }
+    return ntasks;
 }
 
 int taskmap_nnodes (const struct taskmap *map)
@@ -593,6 +593,55 @@ static void test_raw_decode_errors (void)
     }
 }
 
+/*  Build a map with one block per node by alternating ppn, then check
+ *  that taskid and nodeid lookups agree with a linear reference.
+ */
+static void test_large_irregular (void)
+{
+    const int nnodes = 16384;
+    struct taskmap *map;
+    int *first;
+    int taskid = 0;
+    int errors = 0;
+
+    if (!(map = taskmap_create ())
+        || !(first = calloc (nnodes + 1, sizeof (int))))
+        BAIL_OUT ("out of memory");
+    for (int n = 0; n < nnodes; n++) {
+        int ppn = (n % 3) + 1;
+        first[n] = taskid;
+        if (taskmap_append (map, n, 1, ppn) < 0)
+            BAIL_OUT ("taskmap_append failed");
+        taskid += ppn;
+    }
+    first[nnodes] = taskid;
+    ok (taskmap_total_ntasks (map) == taskid,
+        "large irregular map has %d tasks", taskid);
+    ok (taskmap_nnodes (map) == nnodes,
+        "large irregular map has %d nodes", nnodes);
+    for (int n = 0; n < nnodes; n++) {
+        if (taskmap_ntasks (map, n) != first[n + 1] - first[n])
+            errors++;
+        for (int t = first[n]; t < first[n + 1]; t++) {
+            if (taskmap_nodeid (map, t) != n)
+                errors++;
+        }
+    }
+    ok (errors == 0,
+        "taskmap_nodeid and taskmap_ntasks correct for all tasks");
+    ok (taskmap_nodeid (map, taskid) < 0 && errno == ENOENT,
+        "taskmap_nodeid of taskid past end returns ENOENT");
+
+    /*  Appending to the map invalidates the taskid index
+     */
+    ok (taskmap_append (map, nnodes, 1, 2) == 0,
+        "taskmap_append to existing map works");
+    ok (taskmap_nodeid (map, taskid + 1) == nnodes,
+        "taskmap_nodeid finds task in appended block");
+    free (first);
+    taskmap_destroy (map);
+}
+
 int main (int ac, char **av)
 {
     plan (NO_PLAN);
@@ -606,6 +655,7 @@ int main (int ac, char **av)
     test_check ();
     test_deranged ();
     test_raw_decode_errors ();
+    test_large_irregular ();
     done_testing ();
 }
 
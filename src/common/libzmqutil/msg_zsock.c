@@ -110,6 +110,107 @@ int zmqutil_msg_send (void *sock, const flux_msg_t *msg)
     return zmqutil_msg_send_ex (sock, msg, false);
 }
 
+struct zmqutil_msg_mcast {
+    zmq_msg_t *parts;
+    int count;
+    size_t size;
+};
+
+void zmqutil_msg_mcast_destroy (struct zmqutil_msg_mcast *mc)
+{
+    if (mc) {
+        int saved_errno = errno;
+        for (int i = 0; i < mc->count; i++)
+            zmq_msg_close (&mc->parts[i]); // may call zerocopy_free
+        free (mc->parts);
+        free (mc);
+        errno = saved_errno;
+    }
+}
+
+struct zmqutil_msg_mcast *zmqutil_msg_mcast_create (const flux_msg_t *msg)
+{
+    struct zmqutil_msg_mcast *mc;
+    struct msg_iovec *iov = NULL;
+    int iovcnt;
+    uint8_t proto[PROTO_SIZE];
+
+    if (!msg) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(mc = calloc (1, sizeof (*mc))))
+        return NULL;
+    if (msg_to_iovec (msg, proto, PROTO_SIZE, &iov, &iovcnt) < 0)
+        goto error;
+    if (!(mc->parts = calloc (iovcnt, sizeof (mc->parts[0]))))
+        goto error;
+    for (int i = 0; i < iovcnt; i++) {
+        zmq_msg_t *part = &mc->parts[i];
+
+        if (iov[i].size >= ZEROCOPY_THRESHOLD) {
+            flux_msg_incref (msg);
+            if (zmq_msg_init_data (part,
+                                   (void *)iov[i].data,
+                                   iov[i].size,
+                                   zerocopy_free,
+                                   (void *)msg) < 0) {
+                flux_msg_decref (msg);
+                goto error;
+            }
+        }
+        else {
+            if (zmq_msg_init_size (part, iov[i].size) < 0)
+                goto error;
+            if (iov[i].size > 0)
+                memcpy (zmq_msg_data (part), iov[i].data, iov[i].size);
+        }
+        mc->count++;
+        mc->size += iov[i].size;
+    }
+    free (iov);
+    return mc;
+error:
+    ERRNO_SAFE_WRAP (free, iov);
+    zmqutil_msg_mcast_destroy (mc);
+    return NULL;
+}
+
+int zmqutil_msg_mcast_send (void *sock,
+                            struct zmqutil_msg_mcast *mc,
+                            const char *id,
+                            bool nonblock)
+{
+    int flags = ZMQ_SNDMORE;
+
+    if (!sock || !mc || !id || mc->count == 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (nonblock)
+        flags |= ZMQ_DONTWAIT;
+    if (zmq_send (sock, id, strlen (id), flags) < 0)
+        return -1;
+    for (int i = 0; i < mc->count; i++) {
+        zmq_msg_t part;
+
+        if ((i + 1) == mc->count)
+            flags &= ~ZMQ_SNDMORE;
+        zmq_msg_init (&part);
+        if (zmq_msg_copy (&part, &mc->parts[i]) < 0
+            || zmq_msg_send (&part, sock, flags) < 0) {
+            ERRNO_SAFE_WRAP (zmq_msg_close, &part);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+size_t zmqutil_msg_mcast_size (struct zmqutil_msg_mcast *mc)
+{
+    return mc ? mc->size : 0;
+}
+
 flux_msg_t *zmqutil_msg_recv (void *sock)
 {
     struct msg_iovec *iov = NULL;
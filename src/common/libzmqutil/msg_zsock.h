@@ -31,6 +31,22 @@ int zmqutil_msg_send_ex (void *dest, const flux_msg_t *msg, bool nonblock);
  */
 flux_msg_t *zmqutil_msg_recv (void *dest);
 
+/* Encode 'msg' once into ZeroMQ message parts that may be sent to many
+ * peers of a ROUTER socket.  Each send prepends the peer identity frame
+ * and shares the encoded parts by reference (see zmq_msg_copy(3)).
+ */
+struct zmqutil_msg_mcast *zmqutil_msg_mcast_create (const flux_msg_t *msg);
+void zmqutil_msg_mcast_destroy (struct zmqutil_msg_mcast *mc);
+
+int zmqutil_msg_mcast_send (void *dest,
+                            struct zmqutil_msg_mcast *mc,
+                            const char *id,
+                            bool nonblock);
+
+/* Return the size in bytes of the encoded parts, without identity frame.
+ */
+size_t zmqutil_msg_mcast_size (struct zmqutil_msg_mcast *mc);
+
 #ifdef __cplusplus
 }
 #endif
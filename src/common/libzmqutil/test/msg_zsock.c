@@ -15,6 +15,7 @@
 #include <zmq.h>
 #include <errno.h>
 #include <stdio.h>
+#include <unistd.h>
 #include <flux/core.h>
 
 #include "src/common/libzmqutil/msg_zsock.h"
@@ -149,6 +150,87 @@ void check_sendzsock_large (void)
     zmq_close (zsock[1]);
 }
 
+/* Send one encoded message from a ROUTER socket to two DEALER peers.
+ */
+void check_mcast (size_t paysize)
+{
+    void *router;
+    void *dealer[2];
+    const char *ids[] = { "peer0", "peer1" };
+    const char *uri = "inproc://test-mcast";
+    struct zmqutil_msg_mcast *mc;
+    flux_msg_t *msg;
+    void *payload;
+
+    if (!(router = zmq_socket (zctx, ZMQ_ROUTER))
+        || zsetsockopt_int (router, ZMQ_ROUTER_MANDATORY, 1) < 0
+        || zsetsockopt_int (router, ZMQ_LINGER, 5) < 0
+        || zmq_bind (router, uri) < 0)
+        BAIL_OUT ("could not create ROUTER socket");
+    for (int i = 0; i < 2; i++) {
+        if (!(dealer[i] = zmq_socket (zctx, ZMQ_DEALER))
+            || zsetsockopt_str (dealer[i], ZMQ_IDENTITY, ids[i]) < 0
+            || zsetsockopt_int (dealer[i], ZMQ_LINGER, 5) < 0
+            || zmq_connect (dealer[i], uri) < 0)
+            BAIL_OUT ("could not create DEALER socket");
+    }
+    if (!(payload = malloc (paysize)))
+        BAIL_OUT ("out of memory");
+    memset (payload, 0xcd, paysize);
+    if (!(msg = flux_msg_create (FLUX_MSGTYPE_EVENT))
+        || flux_msg_set_topic (msg, "mcast.test") < 0
+        || flux_msg_set_payload (msg, payload, paysize) < 0)
+        BAIL_OUT ("could not create test message");
+    free (payload);
+    flux_msg_route_enable (msg);
+
+    errno = 0;
+    ok (zmqutil_msg_mcast_create (NULL) == NULL && errno == EINVAL,
+        "zmqutil_msg_mcast_create msg=NULL fails with EINVAL");
+    ok ((mc = zmqutil_msg_mcast_create (msg)) != NULL,
+        "zmqutil_msg_mcast_create works with %zu byte payload", paysize);
+    ok (zmqutil_msg_mcast_size (mc) > paysize,
+        "zmqutil_msg_mcast_size returns encoded size");
+    /* zerocopy parts should keep msg alive via incref */
+    flux_msg_decref (msg);
+
+    /* Wait for peers to connect, since ROUTER_MANDATORY fails
+     * immediately for unknown peers.
+     */
+    for (int i = 0; i < 2; i++) {
+        int tries = 0;
+        while (zmqutil_msg_mcast_send (router, mc, ids[i], true) < 0
+               && errno == EHOSTUNREACH
+               && tries++ < 1000)
+            usleep (1000);
+    }
+    ok (zmqutil_msg_mcast_send (router, mc, "nopeer", true) < 0
+        && errno == EHOSTUNREACH,
+        "zmqutil_msg_mcast_send to unknown peer fails with EHOSTUNREACH");
+    zmqutil_msg_mcast_destroy (mc);
+
+    for (int i = 0; i < 2; i++) {
+        flux_msg_t *msg2;
+        const char *topic;
+        const void *buf;
+        size_t size;
+
+        ok ((msg2 = zmqutil_msg_recv (dealer[i])) != NULL
+            && flux_msg_get_topic (msg2, &topic) == 0
+            && streq (topic, "mcast.test")
+            && flux_msg_get_payload (msg2, &buf, &size) == 0
+            && size == paysize
+            && ((uint8_t *)buf)[size - 1] == 0xcd
+            && flux_msg_route_count (msg2) == 0,
+            "%s received the message", ids[i]);
+        flux_msg_destroy (msg2);
+    }
+
+    zmq_close (dealer[0]);
+    zmq_close (dealer[1]);
+    zmq_close (router);
+}
+
 int main (int argc, char *argv[])
 {
     plan (NO_PLAN);
@@ -158,6 +240,8 @@ int main (int argc, char *argv[])
 
     check_sendzsock ();
     check_sendzsock_large ();
+    check_mcast (16);
+    check_mcast (128 * 1024);
 
     zmq_ctx_term (zctx);
 
@@ -280,24 +280,30 @@ static void stats_get_cb (flux_t *h,
                           void *arg)
 {
     struct connector_local *ctx = arg;
-    json_t *clients;
+    json_t *clients = NULL;
+    json_t *router = NULL;
 
     if (flux_request_decode (msg, NULL, NULL) < 0)
         goto error;
-    if (!(clients = usock_server_stats_get (ctx->server)))
+    if (!(clients = usock_server_stats_get (ctx->server))
+        || !(router = router_stats_get (ctx->router)))
         goto error;
     if (flux_respond_pack (h,
                            msg,
-                           "{s:O s:b s:b}",
+                           "{s:O s:O s:b s:b}",
                            "server", clients,
+                           "router", router,
                            "allow_guest_user", ctx->allow_guest_user,
                            "allow_root_owner", ctx->allow_root_owner) < 0)
         flux_log_error (h, "error responding to stats.get request");
+    json_decref (router);
     json_decref (clients);
     return;
 error:
     if (flux_respond_error (h, msg, errno, NULL) < 0)
         flux_log_error (h, "error responding to stats.get request");
+    json_decref (router);
+    json_decref (clients);
 }
 
 static const struct flux_msg_handler_spec htab[] = {
@@ -468,7 +468,7 @@ int mod_main (flux_t *h, int argc, char **argv)
     if (content_register_service (h, "content-backing") < 0)
         goto done;
     if (!testing) {
-        if (content_register_backing_store (h, "content-files") < 0)
+        if (content_register_backing_store (h, "content-files", 0) < 0)
             goto done;
     }
     if (flux_reactor_run (flux_get_reactor (h), 0) < 0) {
@@ -0,0 +1,415 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* codec.c - blob compression for content-sqlite
+ *
+ * Small blobs such as KVS treeobj directories, eventlog entries, and
+ * jobspecs are repetitive JSON that LZ4 compresses poorly on its own,
+ * since each blob is compressed independently.  A dictionary of typical
+ * content, used as history for every blob, lets LZ4 find matches anyway.
+ *
+ * LZ4 has no dictionary trainer, so the dictionary is simply the
+ * concatenation of early sample blobs.  Dictionaries are identified by
+ * an integer id recorded with each row, so they may be replaced without
+ * breaking access to rows compressed with an earlier one.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <lz4.h>
+#include <lz4hc.h>
+#include <flux/core.h>
+
+#include "src/common/libutil/errprintf.h"
+#include "src/common/libutil/errno_safe.h"
+#include "ccan/str/str.h"
+
+#include "codec.h"
+
+enum method {
+    METHOD_NONE,
+    METHOD_LZ4,
+    METHOD_LZ4HC,
+};
+
+/* Blobs smaller than this are stored as is.  A dictionary makes
+ * compressing much smaller blobs worthwhile.
+ */
+static const int compression_threshold = 256;
+static const int compression_threshold_dict = 32;
+
+/* Sample blobs in this size range for dictionary training.
+ */
+static const int train_min_size = 32;
+static const int train_max_size = 8192;
+
+static const size_t buf_chunksize = 1024*1024;
+
+struct dict {
+    int id;
+    size_t size;
+    char data[];
+};
+
+struct codec_stats {
+    unsigned long compressed;
+    unsigned long uncompressed;
+    unsigned long long raw_bytes;
+    unsigned long long stored_bytes;
+};
+
+struct codec {
+    enum method method;
+    const char *name;
+    int level;
+
+    void *buf;
+    size_t bufsize;
+
+    struct dict **dicts;
+    int ndicts;
+    struct dict *dict;              // current dictionary, if any
+    LZ4_stream_t *dict_stream;      // lz4 state preloaded with dict
+    LZ4_stream_t *stream;
+
+    char *train;
+    size_t train_size;
+
+    struct codec_stats stats;
+};
+
+static int grow_buf (struct codec *c, size_t size)
+{
+    size_t newsize = c->bufsize;
+    void *newbuf;
+
+    while (newsize < size)
+        newsize += buf_chunksize;
+    if (!(newbuf = realloc (c->buf, newsize))) {
+        errno = ENOMEM;
+        return -1;
+    }
+    c->bufsize = newsize;
+    c->buf = newbuf;
+    return 0;
+}
+
+static struct dict *dict_lookup (struct codec *c, int id)
+{
+    for (int i = 0; i < c->ndicts; i++) {
+        if (c->dicts[i]->id == id)
+            return c->dicts[i];
+    }
+    return NULL;
+}
+
+int codec_dict_add (struct codec *c, int id, const void *data, size_t size)
+{
+    struct dict **dicts;
+    struct dict *d;
+
+    if (!c || id <= 0 || size > CODEC_DICT_MAX || (size > 0 && !data)) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (dict_lookup (c, id)) {
+        errno = EEXIST;
+        return -1;
+    }
+    if (!(d = malloc (sizeof (*d) + size)))
+        return -1;
+    d->id = id;
+    d->size = size;
+    memcpy (d->data, data, size);
+    if (!(dicts = realloc (c->dicts, sizeof (dicts[0]) * (c->ndicts + 1)))) {
+        free (d);
+        return -1;
+    }
+    dicts[c->ndicts++] = d;
+    c->dicts = dicts;
+    return 0;
+}
+
+int codec_dict_use (struct codec *c, int id)
+{
+    struct dict *d = NULL;
+
+    if (!c) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (id != 0) {
+        if (c->method != METHOD_LZ4) {
+            errno = EINVAL;
+            return -1;
+        }
+        if (!(d = dict_lookup (c, id))) {
+            errno = ENOENT;
+            return -1;
+        }
+        if (!c->dict_stream) {
+            if (!(c->dict_stream = LZ4_createStream ())
+                || !(c->stream = LZ4_createStream ())) {
+                errno = ENOMEM;
+                return -1;
+            }
+        }
+        /* Hashing the dictionary is costly, so do it once here, then
+         * start each blob from a copy of the preloaded state.
+         */
+        LZ4_resetStream_fast (c->dict_stream);
+        LZ4_loadDict (c->dict_stream, d->data, d->size);
+    }
+    c->dict = d;
+    return 0;
+}
+
+int codec_dict_current (struct codec *c)
+{
+    return c && c->dict ? c->dict->id : 0;
+}
+
+bool codec_dict_train (struct codec *c, const void *data, int size)
+{
+    size_t n;
+
+    if (!c)
+        return false;
+    if (c->train_size == CODEC_DICT_MAX)
+        return true;
+    if (size < train_min_size || size > train_max_size)
+        return false;
+    if (!c->train && !(c->train = malloc (CODEC_DICT_MAX)))
+        return false;
+    n = CODEC_DICT_MAX - c->train_size;
+    if (n > size)
+        n = size;
+    memcpy (c->train + c->train_size, data, n);
+    c->train_size += n;
+    return c->train_size == CODEC_DICT_MAX;
+}
+
+const void *codec_dict_train_get (struct codec *c, size_t *size)
+{
+    if (!c || c->train_size < CODEC_DICT_MAX) {
+        errno = EAGAIN;
+        return NULL;
+    }
+    *size = c->train_size;
+    return c->train;
+}
+
+int codec_compress (struct codec *c,
+                    const void *data,
+                    int size,
+                    int *codec,
+                    int *dict,
+                    const void **out,
+                    int *outsize)
+{
+    int threshold = c->dict ? compression_threshold_dict
+                            : compression_threshold;
+    int bound;
+    int r;
+
+    if (c->method == METHOD_NONE || size < threshold)
+        goto store_uncompressed;
+    bound = LZ4_compressBound (size);
+    if (c->bufsize < bound && grow_buf (c, bound) < 0)
+        return -1;
+    if (c->method == METHOD_LZ4HC)
+        r = LZ4_compress_HC (data, c->buf, size, bound, c->level);
+    else if (c->dict) {
+        memcpy (c->stream, c->dict_stream, sizeof (*c->stream));
+        r = LZ4_compress_fast_continue (c->stream,
+                                        data,
+                                        c->buf,
+                                        size,
+                                        bound,
+                                        c->level);
+    }
+    else
+        r = LZ4_compress_fast (data, c->buf, size, bound, c->level);
+    if (r == 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (r >= size)
+        goto store_uncompressed;
+    c->stats.compressed++;
+    c->stats.raw_bytes += size;
+    c->stats.stored_bytes += r;
+    *codec = CODEC_LZ4;
+    *dict = c->dict ? c->dict->id : 0;
+    *out = c->buf;
+    *outsize = r;
+    return 0;
+store_uncompressed:
+    c->stats.uncompressed++;
+    c->stats.raw_bytes += size;
+    c->stats.stored_bytes += size;
+    *codec = CODEC_NONE;
+    *dict = 0;
+    *out = data;
+    *outsize = size;
+    return 0;
+}
+
+int codec_decompress (struct codec *c,
+                      int codec,
+                      int dict,
+                      const void *data,
+                      int size,
+                      int uncompressed_size,
+                      const void **out)
+{
+    int r;
+
+    if (codec == CODEC_NONE) {
+        *out = data;
+        return 0;
+    }
+    if (codec != CODEC_LZ4 || uncompressed_size < 0) {
+        errno = EPROTO;
+        return -1;
+    }
+    if (c->bufsize < uncompressed_size
+        && grow_buf (c, uncompressed_size) < 0)
+        return -1;
+    if (dict != 0) {
+        struct dict *d;
+
+        if (!(d = dict_lookup (c, dict))) {
+            errno = ENOENT;
+            return -1;
+        }
+        r = LZ4_decompress_safe_usingDict (data,
+                                           c->buf,
+                                           size,
+                                           uncompressed_size,
+                                           d->data,
+                                           d->size);
+    }
+    else
+        r = LZ4_decompress_safe (data, c->buf, size, uncompressed_size);
+    if (r != uncompressed_size) {
+        errno = EINVAL;
+        return -1;
+    }
+    *out = c->buf;
+    return 0;
+}
+
+json_t *codec_stats_get (struct codec *c)
+{
+    json_t *o;
+
+    if (!(o = json_pack ("{s:s s:i s:i s:I s:I s:I s:I}",
+                         "method", c->name,
+                         "level", c->level,
+                         "dictionary", codec_dict_current (c),
+                         "compressed", (json_int_t)c->stats.compressed,
+                         "uncompressed", (json_int_t)c->stats.uncompressed,
+                         "raw_bytes", (json_int_t)c->stats.raw_bytes,
+                         "stored_bytes", (json_int_t)c->stats.stored_bytes))) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    return o;
+}
+
+const char *codec_name (struct codec *c)
+{
+    return c ? c->name : NULL;
+}
+
+int codec_level (struct codec *c)
+{
+    return c ? c->level : 0;
+}
+
+void codec_destroy (struct codec *c)
+{
+    if (c) {
+        int saved_errno = errno;
+        for (int i = 0; i < c->ndicts; i++)
+            free (c->dicts[i]);
+        free (c->dicts);
+        if (c->dict_stream)
+            LZ4_freeStream (c->dict_stream);
+        if (c->stream)
+            LZ4_freeStream (c->stream);
+        free (c->train);
+        free (c->buf);
+        free (c);
+        errno = saved_errno;
+    }
+}
+
+struct codec *codec_create (const char *name, int level, flux_error_t *error)
+{
+    struct codec *c;
+
+    if (!(c = calloc (1, sizeof (*c))))
+        goto nomem;
+    if (!name || streq (name, "lz4")) {
+        c->method = METHOD_LZ4;
+        c->name = "lz4";
+        if (level == 0)
+            level = 1;
+        if (level < 1) {
+            errprintf (error, "lz4 acceleration must be >= 1");
+            goto inval;
+        }
+    }
+    else if (streq (name, "lz4hc")) {
+        c->method = METHOD_LZ4HC;
+        c->name = "lz4hc";
+        if (level == 0)
+            level = LZ4HC_CLEVEL_DEFAULT;
+        if (level < 1 || level > LZ4HC_CLEVEL_MAX) {
+            errprintf (error,
+                       "lz4hc level must be in the range of 1-%d",
+                       LZ4HC_CLEVEL_MAX);
+            goto inval;
+        }
+    }
+    else if (streq (name, "none")) {
+        c->method = METHOD_NONE;
+        c->name = "none";
+        level = 0;
+    }
+    else {
+        errprintf (error, "unknown compression method '%s'", name);
+        goto inval;
+    }
+    c->level = level;
+    if (!(c->buf = malloc (buf_chunksize)))
+        goto nomem;
+    c->bufsize = buf_chunksize;
+    return c;
+nomem:
+    errprintf (error, "out of memory");
+    codec_destroy (c);
+    errno = ENOMEM;
+    return NULL;
+inval:
+    codec_destroy (c);
+    errno = EINVAL;
+    return NULL;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -0,0 +1,96 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _CONTENT_SQLITE_CODEC_H
+#define _CONTENT_SQLITE_CODEC_H
+
+#include <stdbool.h>
+#include <jansson.h>
+#include <flux/core.h>
+
+/* Values stored in the objects table 'codec' column.
+ * Rows written before that column existed have codec NULL, which means
+ * CODEC_LZ4 without a dictionary if 'size' is not -1, else CODEC_NONE.
+ */
+enum {
+    CODEC_NONE = 0,     // stored as is
+    CODEC_LZ4 = 1,      // LZ4 block format, possibly with a dictionary
+};
+
+/* LZ4 can only reference the last 64K of a dictionary.
+ */
+#define CODEC_DICT_MAX  65536
+
+/* Create a codec that compresses with method 'name', which may be
+ * "none", "lz4", or "lz4hc".  'level' is the lz4 acceleration factor or
+ * the lz4hc compression level, or 0 for the default.  Any codec can
+ * decompress blobs stored by any other.
+ */
+struct codec *codec_create (const char *name, int level, flux_error_t *error);
+void codec_destroy (struct codec *c);
+
+const char *codec_name (struct codec *c);
+int codec_level (struct codec *c);
+
+/* Make dictionary 'id' (> 0) available for decompression.
+ * The dictionary is copied.
+ */
+int codec_dict_add (struct codec *c, int id, const void *data, size_t size);
+
+/* Compress subsequent blobs with dictionary 'id', or none if id is 0.
+ * Dictionaries are only supported by the "lz4" method.
+ */
+int codec_dict_use (struct codec *c, int id);
+int codec_dict_current (struct codec *c);
+
+/* Collect a sample blob for training a dictionary.  Returns true once
+ * enough samples are collected, after which codec_dict_train_get()
+ * returns the dictionary.  Samples are concatenated so that the most
+ * recently seen data, which LZ4 finds most cheaply, ends up last.
+ */
+bool codec_dict_train (struct codec *c, const void *data, int size);
+const void *codec_dict_train_get (struct codec *c, size_t *size);
+
+/* Compress 'data' of length 'size' for storage.  On success, set 'codec'
+ * and 'dict' to the values to be recorded with the row, and 'out' and
+ * 'outsize' to the data to store.  If the blob is not worth compressing,
+ * codec is CODEC_NONE and 'out' is 'data'.  Otherwise 'out' points to
+ * storage owned by the codec and is valid until the next call.
+ * Returns 0 on success, -1 on failure with errno set.
+ */
+int codec_compress (struct codec *c,
+                    const void *data,
+                    int size,
+                    int *codec,
+                    int *dict,
+                    const void **out,
+                    int *outsize);
+
+/* Decompress 'data' stored with 'codec' and 'dict'.  'out' points to
+ * storage owned by the codec and is valid until the next call.
+ * Returns 0 on success, -1 on failure with errno set.
+ */
+int codec_decompress (struct codec *c,
+                      int codec,
+                      int dict,
+                      const void *data,
+                      int size,
+                      int uncompressed_size,
+                      const void **out);
+
+/* Get counts of blobs and bytes compressed by this codec.
+ */
+json_t *codec_stats_get (struct codec *c);
+
+#endif /* !_CONTENT_SQLITE_CODEC_H */
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -18,7 +18,6 @@
 #include <unistd.h>
 #include <sys/statvfs.h>
 #include <sqlite3.h>
-#include <lz4.h>
 #include <flux/core.h>
 #include <jansson.h>
 #include <assert.h>
@@ -30,21 +29,24 @@
 #include "src/common/libutil/monotime.h"
 #include "src/common/libkvs/kvs_checkpoint.h"
 
+#include "src/common/libcontent/content.h"
 #include "src/common/libcontent/content-util.h"
 #include "ccan/str/str.h"
 
-const size_t lzo_buf_chunksize = 1024*1024;
-const size_t compression_threshold = 256; /* compress blobs >= this size */
+#include "codec.h"
 
 const char *sql_create_table = "CREATE TABLE if not exists objects("
                                "  hash BLOB PRIMARY KEY,"
                                "  size INT,"
                                "  object BLOB"
                                ");";
-const char *sql_load = "SELECT object,size FROM objects"
+const char *sql_load = "SELECT object,size,codec,dict FROM objects"
                        "  WHERE hash = ?1 LIMIT 1";
-const char *sql_store = "INSERT INTO objects (hash,size,object) "
-                        "  values (?1, ?2, ?3)";
+const char *sql_store = "INSERT INTO objects (hash,size,object,codec,dict) "
+                        "  values (?1, ?2, ?3, ?4, ?5)";
+const char *sql_objects_columns = "PRAGMA table_info(objects)";
+const char *sql_add_codec_column = "ALTER TABLE objects ADD COLUMN codec INT";
+const char *sql_add_dict_column = "ALTER TABLE objects ADD COLUMN dict INT";
 const char *sql_validate = "SELECT EXISTS("
                            "  SELECT 1 FROM objects WHERE hash = ?1)";
 const char *sql_objects_count = "SELECT count(1) FROM objects";
@@ -73,11 +75,48 @@ const char *sql_table_list = "SELECT tbl_name FROM sqlite_master where type = 't
 
 const char *sql_checkpt_get_all = "SELECT * FROM checkpt_v2 ORDER BY id DESC";
 
+const char *sql_create_table_dict =
+    "CREATE TABLE if not exists dictionaries("
+    "  id INTEGER PRIMARY KEY AUTOINCREMENT NOT NULL,"
+    "  dict BLOB"
+    ");";
+const char *sql_dict_get_all = "SELECT id,dict FROM dictionaries ORDER BY id";
+const char *sql_dict_put = "INSERT INTO dictionaries (dict) values (?1)";
+
+/* Count objects stored before the module was loaded, a range of rows at
+ * a time.  Rows stored before the codec column was added have codec NULL.
+ */
+const char *sql_compression_count =
+    "SELECT"
+    "  coalesce(codec, CASE WHEN size = -1 THEN 0 ELSE 1 END),"
+    "  coalesce(dict, 0),"
+    "  count(1),"
+    "  sum(CASE WHEN size = -1 THEN length(object) ELSE size END),"
+    "  sum(length(object))"
+    " FROM objects WHERE rowid > ?1 AND rowid <= ?2 GROUP BY 1, 2";
+const char *sql_objects_max_rowid = "SELECT max(rowid) FROM objects";
+
 #define MAX_CHECKPOINTS_DEFAULT 5
 
+/* Rows counted per reactor loop while seeding compression counts.
+ */
+#define COMPRESSION_COUNT_ROWS 10000
+
 struct content_stats {
     tstat_t load;
     tstat_t store;
+    tstat_t batch_size;
+    tstat_t batch_commit;
+};
+
+/* Objects stored with one codec and dictionary.
+ */
+struct compression_count {
+    int codec;
+    int dict;
+    int64_t count;
+    int64_t raw_bytes;
+    int64_t stored_bytes;
 };
 
 struct content_sqlite {
@@ -94,13 +133,23 @@ struct content_sqlite {
     flux_t *h;
     char *hashfun;
     int hash_size;
-    size_t lzo_bufsize;
-    void *lzo_buf;
+    struct codec *codec;
     struct content_stats stats;
     char *journal_mode;
     char *synchronous;
     int max_checkpoints;
     bool truncate;
+    char *compression;
+    int compression_level;
+    bool dictionary;
+    struct compression_count *counts;   // sorted by codec, dict
+    int counts_size;
+    sqlite3_stmt *count_stmt;
+    sqlite3_int64 count_rowid;          // rows up to here are counted
+    sqlite3_int64 count_max_rowid;      // last row stored before counting
+    int count_errno;
+    flux_watcher_t *count_w;
+    struct flux_msglist *count_requests;
 };
 
 static int set_config (char **conf, const char *val)
@@ -161,21 +210,6 @@ static void set_errno_from_sqlite_error (struct content_sqlite *ctx)
     }
 }
 
-static int grow_lzo_buf (struct content_sqlite *ctx, size_t size)
-{
-    size_t newsize = ctx->lzo_bufsize;
-    void *newbuf;
-    while (newsize < size)
-        newsize += lzo_buf_chunksize;
-    if (!(newbuf = realloc (ctx->lzo_buf, newsize))) {
-        errno = ENOMEM;
-        return -1;
-    }
-    ctx->lzo_bufsize = newsize;
-    ctx->lzo_buf = newbuf;
-    return 0;
-}
-
 /* Load blob from objects table, uncompressing if necessary.
  * Returns 0 on success, -1 on error with errno set.
  * On successful return, must call sqlite3_reset (ctx->load_stmt),
@@ -190,6 +224,8 @@ static int content_sqlite_load (struct content_sqlite *ctx,
     const void *data = NULL;
     int size = 0;
     int uncompressed_size;
+    int codec;
+    int dict;
 
     if (sqlite3_bind_text (ctx->load_stmt,
                            1,
@@ -218,24 +254,22 @@ static int content_sqlite_load (struct content_sqlite *ctx,
         goto error;
     }
     uncompressed_size = sqlite3_column_int (ctx->load_stmt, 1);
-    if (uncompressed_size != -1) {
-        if (ctx->lzo_bufsize < uncompressed_size
-                                && grow_lzo_buf (ctx, uncompressed_size) < 0)
-            goto error;
-        int r = LZ4_decompress_safe (data,
-                                     ctx->lzo_buf,
-                                     size,
-                                     uncompressed_size);
-        if (r < 0) {
-            errno = EINVAL;
-            goto error;
-        }
-        if (r != uncompressed_size) {
-            flux_log (ctx->h, LOG_ERR, "load: blob size mismatch");
-            errno = EINVAL;
+    if (sqlite3_column_type (ctx->load_stmt, 2) == SQLITE_NULL)
+        codec = uncompressed_size == -1 ? CODEC_NONE : CODEC_LZ4;
+    else
+        codec = sqlite3_column_int (ctx->load_stmt, 2);
+    dict = sqlite3_column_int (ctx->load_stmt, 3); // NULL => 0
+    if (codec != CODEC_NONE) {
+        if (codec_decompress (ctx->codec,
+                              codec,
+                              dict,
+                              data,
+                              size,
+                              uncompressed_size,
+                              &data) < 0) {
+            flux_log_error (ctx->h, "load: decompress (codec=%d)", codec);
             goto error;
         }
-        data = ctx->lzo_buf;
         size = uncompressed_size;
     }
     *datap = data;
@@ -248,6 +282,259 @@ error:
     return -1;
 }
 
+/* If dictionary compression is enabled and there is no dictionary yet,
+ * offer a stored blob as a training sample.  Once enough samples are
+ * collected, save the dictionary and use it for subsequent stores.
+ * N.B. call outside of any transaction, so the dictionary is never
+ * referenced by rows when its own insert could be rolled back.
+ * On failure, dictionary compression is disabled.
+ */
+static void content_sqlite_dict_train (struct content_sqlite *ctx,
+                                       const void *data,
+                                       int size)
+{
+    sqlite3_stmt *stmt = NULL;
+    const void *dict;
+    size_t dict_size;
+    int id;
+
+    if (!ctx->dictionary
+        || codec_dict_current (ctx->codec) != 0
+        || !codec_dict_train (ctx->codec, data, size)
+        || !(dict = codec_dict_train_get (ctx->codec, &dict_size)))
+        return;
+    if (sqlite3_prepare_v2 (ctx->db,
+                            sql_dict_put,
+                            -1,
+                            &stmt,
+                            NULL) != SQLITE_OK
+        || sqlite3_bind_blob (stmt,
+                              1,
+                              dict,
+                              dict_size,
+                              SQLITE_STATIC) != SQLITE_OK
+        || sqlite3_step (stmt) != SQLITE_DONE) {
+        log_sqlite_error (ctx, "saving compression dictionary");
+        goto error;
+    }
+    id = sqlite3_last_insert_rowid (ctx->db);
+    if (codec_dict_add (ctx->codec, id, dict, dict_size) < 0
+        || codec_dict_use (ctx->codec, id) < 0) {
+        flux_log_error (ctx->h, "error activating compression dictionary");
+        goto error;
+    }
+    flux_log (ctx->h,
+              LOG_DEBUG,
+              "compression dictionary %d: %zu bytes",
+              id,
+              dict_size);
+    (void)sqlite3_finalize (stmt);
+    return;
+error:
+    flux_log (ctx->h, LOG_ERR, "disabling dictionary compression");
+    ctx->dictionary = false;
+    if (stmt)
+        (void)sqlite3_finalize (stmt);
+}
+
+/* Add to the count of objects stored with 'codec' and 'dict'.
+ */
+static int compression_count_add (struct content_sqlite *ctx,
+                                  int codec,
+                                  int dict,
+                                  int64_t count,
+                                  int64_t raw_bytes,
+                                  int64_t stored_bytes)
+{
+    struct compression_count *cc;
+    int i;
+
+    for (i = 0; i < ctx->counts_size; i++) {
+        cc = &ctx->counts[i];
+        if (cc->codec > codec || (cc->codec == codec && cc->dict >= dict))
+            break;
+    }
+    if (i == ctx->counts_size
+        || ctx->counts[i].codec != codec
+        || ctx->counts[i].dict != dict) {
+        if (!(cc = realloc (ctx->counts,
+                            (ctx->counts_size + 1) * sizeof (*cc))))
+            return -1;
+        memmove (&cc[i + 1], &cc[i], (ctx->counts_size - i) * sizeof (*cc));
+        memset (&cc[i], 0, sizeof (*cc));
+        cc[i].codec = codec;
+        cc[i].dict = dict;
+        ctx->counts = cc;
+        ctx->counts_size++;
+    }
+    cc = &ctx->counts[i];
+    cc->count += count;
+    cc->raw_bytes += raw_bytes;
+    cc->stored_bytes += stored_bytes;
+    return 0;
+}
+
+static void compression_count_respond (struct content_sqlite *ctx,
+                                       const flux_msg_t *msg)
+{
+    json_t *codecs;
+    int i;
+
+    if (!(codecs = json_array ()))
+        goto nomem;
+    for (i = 0; i < ctx->counts_size; i++) {
+        struct compression_count *cc = &ctx->counts[i];
+        json_t *o;
+
+        if (!(o = json_pack ("{s:s s:i s:I s:I s:I}",
+                             "codec", cc->codec == CODEC_NONE ? "none"
+                                    : cc->codec == CODEC_LZ4 ? "lz4"
+                                    : "unknown",
+                             "dict", cc->dict,
+                             "count", (json_int_t)cc->count,
+                             "raw_bytes", (json_int_t)cc->raw_bytes,
+                             "stored_bytes", (json_int_t)cc->stored_bytes))
+            || json_array_append_new (codecs, o) < 0) {
+            json_decref (o);
+            goto nomem;
+        }
+    }
+    if (flux_respond_pack (ctx->h, msg, "{s:O}", "codecs", codecs) < 0)
+        flux_log_error (ctx->h,
+                        "error responding to compression-stats request");
+    json_decref (codecs);
+    return;
+nomem:
+    if (flux_respond_error (ctx->h, msg, ENOMEM, NULL) < 0)
+        flux_log_error (ctx->h,
+                        "error responding to compression-stats request");
+    json_decref (codecs);
+}
+
+/* Respond to compression-stats requests that were waiting for existing
+ * objects to be counted, or fail them with 'errnum'.
+ */
+static void compression_count_respond_all (struct content_sqlite *ctx,
+                                           int errnum)
+{
+    const flux_msg_t *msg;
+
+    while ((msg = flux_msglist_pop (ctx->count_requests))) {
+        if (errnum == 0)
+            compression_count_respond (ctx, msg);
+        else if (flux_respond_error (ctx->h, msg, errnum, NULL) < 0)
+            flux_log_error (ctx->h,
+                            "error responding to compression-stats request");
+        flux_msg_decref (msg);
+    }
+}
+
+/* Start counting objects already stored in the database, by codec and
+ * dictionary.  This is done COMPRESSION_COUNT_ROWS rows per reactor loop
+ * so that a large database does not hold up backing store requests.
+ * Objects stored from now on get higher rowids and are counted as they
+ * are stored.
+ */
+static int compression_count_restart (struct content_sqlite *ctx)
+{
+    sqlite3_stmt *stmt = NULL;
+
+    free (ctx->counts);
+    ctx->counts = NULL;
+    ctx->counts_size = 0;
+    ctx->count_rowid = 0;
+    ctx->count_max_rowid = 0;
+    ctx->count_errno = 0;
+    if (sqlite3_prepare_v2 (ctx->db,
+                            sql_objects_max_rowid,
+                            -1,
+                            &stmt,
+                            NULL) != SQLITE_OK
+        || sqlite3_step (stmt) != SQLITE_ROW) {
+        log_sqlite_error (ctx, "querying objects max rowid");
+        set_errno_from_sqlite_error (ctx);
+        goto error;
+    }
+    ctx->count_max_rowid = sqlite3_column_int64 (stmt, 0); // NULL => 0
+    (void)sqlite3_finalize (stmt);
+    flux_timer_watcher_reset (ctx->count_w, 0., 0.);
+    flux_watcher_start (ctx->count_w);
+    return 0;
+error:
+    ctx->count_errno = errno;
+    (void)sqlite3_finalize (stmt);
+    flux_watcher_stop (ctx->count_w);
+    compression_count_respond_all (ctx, ctx->count_errno);
+    errno = ctx->count_errno;
+    return -1;
+}
+
+static void compression_count_cb (flux_reactor_t *r,
+                                  flux_watcher_t *w,
+                                  int revents,
+                                  void *arg)
+{
+    struct content_sqlite *ctx = arg;
+    sqlite3_int64 end = ctx->count_rowid + COMPRESSION_COUNT_ROWS;
+    int rc;
+
+    if (end > ctx->count_max_rowid)
+        end = ctx->count_max_rowid;
+    if (sqlite3_bind_int64 (ctx->count_stmt,
+                            1,
+                            ctx->count_rowid) != SQLITE_OK
+        || sqlite3_bind_int64 (ctx->count_stmt, 2, end) != SQLITE_OK) {
+        log_sqlite_error (ctx, "compression count: binding rowid");
+        set_errno_from_sqlite_error (ctx);
+        goto error;
+    }
+    while ((rc = sqlite3_step (ctx->count_stmt)) == SQLITE_ROW) {
+        sqlite3_stmt *stmt = ctx->count_stmt;
+
+        if (compression_count_add (ctx,
+                                   sqlite3_column_int (stmt, 0),
+                                   sqlite3_column_int (stmt, 1),
+                                   sqlite3_column_int64 (stmt, 2),
+                                   sqlite3_column_int64 (stmt, 3),
+                                   sqlite3_column_int64 (stmt, 4)) < 0) {
+            flux_log_error (ctx->h, "compression count");
+            goto error;
+        }
+    }
+    if (rc != SQLITE_DONE) {
+        log_sqlite_error (ctx, "compression count: executing stmt");
+        set_errno_from_sqlite_error (ctx);
+        goto error;
+    }
+    sqlite3_reset (ctx->count_stmt);
+    ctx->count_rowid = end;
+    if (ctx->count_rowid < ctx->count_max_rowid) {
+        flux_timer_watcher_reset (w, 0., 0.);
+        flux_watcher_start (w);
+        return;
+    }
+    compression_count_respond_all (ctx, 0);
+    return;
+error:
+    ctx->count_errno = errno;
+    (void)sqlite3_reset (ctx->count_stmt);
+    compression_count_respond_all (ctx, ctx->count_errno);
+}
+
+/* Count an object as it is stored.  If that fails, count them all again.
+ */
+static void compression_count_store (struct content_sqlite *ctx,
+                                     int codec,
+                                     int dict,
+                                     int raw_size,
+                                     int size)
+{
+    if (compression_count_add (ctx, codec, dict, 1, raw_size, size) < 0) {
+        flux_log_error (ctx->h, "error updating compression counts");
+        (void)compression_count_restart (ctx);
+    }
+}
+
 /* Store blob to objects table, compressing if necessary.
  * hash over 'data' is stored to 'hash'.
  * Returns hash size on success, -1 on error with errno set.
@@ -259,7 +546,11 @@ static int content_sqlite_store (struct content_sqlite *ctx,
                                  int hash_len)
 {
     int uncompressed_size = -1;
+    int raw_size = size;
     int hash_size;
+    int codec;
+    int dict;
+    int rc;
 
     if ((hash_size = blobref_hash_raw (ctx->hashfun,
                                        data,
@@ -268,20 +559,16 @@ static int content_sqlite_store (struct content_sqlite *ctx,
                                        hash_len)) < 0)
         return -1;
     assert (hash_size == ctx->hash_size);
-    if (size >= compression_threshold) {
-        int r;
-        int out_len = LZ4_compressBound(size);
-        if (ctx->lzo_bufsize < out_len && grow_lzo_buf (ctx, out_len) < 0)
-            return -1;
-        r = LZ4_compress_default (data, ctx->lzo_buf, size, out_len);
-        if (r == 0) {
-            errno = EINVAL;
-            return -1;
-        }
-        uncompressed_size = size;
-        size = r;
-        data = ctx->lzo_buf;
-    }
+    if (codec_compress (ctx->codec,
+                        data,
+                        size,
+                        &codec,
+                        &dict,
+                        &data,
+                        &size) < 0)
+        return -1;
+    if (codec != CODEC_NONE)
+        uncompressed_size = raw_size;
     if (sqlite3_bind_text (ctx->store_stmt,
                            1,
                            hash,
@@ -307,17 +594,30 @@ static int content_sqlite_store (struct content_sqlite *ctx,
         set_errno_from_sqlite_error (ctx);
         goto error;
     }
+    if (sqlite3_bind_int (ctx->store_stmt, 4, codec) != SQLITE_OK) {
+        log_sqlite_error (ctx, "store: binding codec");
+        set_errno_from_sqlite_error (ctx);
+        goto error;
+    }
+    if ((dict > 0 ? sqlite3_bind_int (ctx->store_stmt, 5, dict)
+                  : sqlite3_bind_null (ctx->store_stmt, 5)) != SQLITE_OK) {
+        log_sqlite_error (ctx, "store: binding dict");
+        set_errno_from_sqlite_error (ctx);
+        goto error;
+    }
     /* N.B. ignore SQLITE_CONSTRAINT errors - it means the insert failed
      * because it violated the implicit primary key uniqueness constraint.
      * Blob and blobref are indeed stored and storage is conserved - success!
      */
-    if (sqlite3_step (ctx->store_stmt) != SQLITE_DONE
+    if ((rc = sqlite3_step (ctx->store_stmt)) != SQLITE_DONE
                     && sqlite3_errcode (ctx->db) != SQLITE_CONSTRAINT) {
         log_sqlite_error (ctx, "store: executing stmt");
         set_errno_from_sqlite_error (ctx);
         goto error;
     }
     sqlite3_reset (ctx->store_stmt);
+    if (rc == SQLITE_DONE)
+        compression_count_store (ctx, codec, dict, raw_size, size);
     return hash_size;
 error:
     ERRNO_SAFE_WRAP (sqlite3_reset, ctx->store_stmt);
@@ -419,6 +719,7 @@ void store_cb (flux_t *h,
                                            sizeof (hash))) < 0)
         goto error;
     tstat_push (&ctx->stats.store, monotime_since (t0));
+    content_sqlite_dict_train (ctx, data, size);
     if (flux_respond_raw (h, msg, hash, hash_size) < 0)
         flux_log_error (h, "store: flux_respond_raw");
     return;
@@ -427,6 +728,93 @@ error:
         flux_log_error (h, "store: flux_respond_error");
 }
 
+/* Store a batch of blobs in one transaction, so that the cost of
+ * committing (e.g. WAL sync) is paid once per batch rather than once per
+ * blob.  If any store fails, the transaction is rolled back and the whole
+ * batch fails.  Respond with the concatenated hashes.
+ */
+static void batch_store_cb (flux_t *h,
+                            flux_msg_handler_t *mh,
+                            const flux_msg_t *msg,
+                            void *arg)
+{
+    struct content_sqlite *ctx = arg;
+    const void *buf;
+    size_t size;
+    size_t cursor;
+    const void *data;
+    size_t len;
+    int count = 0;
+    uint8_t *hashes = NULL;
+    bool in_transaction = false;
+    struct timespec t0;
+    int rc;
+
+    if (flux_request_decode_raw (msg, NULL, &buf, &size) < 0) {
+        flux_log_error (h, "batch-store: request decode failed");
+        goto error;
+    }
+    cursor = 0;
+    while ((rc = content_store_batch_next (buf,
+                                           size,
+                                           &cursor,
+                                           &data,
+                                           &len)) > 0)
+        count++;
+    if (rc < 0)
+        goto error;
+    if (count == 0) {
+        errno = EPROTO;
+        goto error;
+    }
+    if (!(hashes = malloc (count * ctx->hash_size)))
+        goto error;
+    monotime (&t0);
+    if (sqlite3_exec (ctx->db, "BEGIN", NULL, NULL, NULL) != SQLITE_OK) {
+        log_sqlite_error (ctx, "batch-store: begin transaction");
+        set_errno_from_sqlite_error (ctx);
+        goto error;
+    }
+    in_transaction = true;
+    cursor = 0;
+    for (int i = 0; i < count; i++) {
+        (void)content_store_batch_next (buf, size, &cursor, &data, &len);
+        if (content_sqlite_store (ctx,
+                                  data,
+                                  len,
+                                  hashes + i * ctx->hash_size,
+                                  ctx->hash_size) < 0)
+            goto error;
+    }
+    if (sqlite3_exec (ctx->db, "COMMIT", NULL, NULL, NULL) != SQLITE_OK) {
+        log_sqlite_error (ctx, "batch-store: commit transaction");
+        set_errno_from_sqlite_error (ctx);
+        goto error;
+    }
+    tstat_push (&ctx->stats.batch_commit, monotime_since (t0));
+    tstat_push (&ctx->stats.batch_size, count);
+    cursor = 0;
+    while (content_store_batch_next (buf, size, &cursor, &data, &len) > 0)
+        content_sqlite_dict_train (ctx, data, len);
+    if (flux_respond_raw (h, msg, hashes, count * ctx->hash_size) < 0)
+        flux_log_error (h, "batch-store: flux_respond_raw");
+    free (hashes);
+    return;
+error:
+    if (in_transaction) {
+        int saved_errno = errno;
+        if (sqlite3_exec (ctx->db, "ROLLBACK", NULL, NULL, NULL) != SQLITE_OK)
+            log_sqlite_error (ctx, "batch-store: rollback transaction");
+        /* Stores in the batch were counted, so start over.
+         */
+        (void)compression_count_restart (ctx);
+        errno = saved_errno;
+    }
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        flux_log_error (h, "batch-store: flux_respond_error");
+    ERRNO_SAFE_WRAP (free, hashes);
+}
+
 static void validate_cb (flux_t *h,
                          flux_msg_handler_t *mh,
                          const flux_msg_t *msg,
@@ -653,6 +1041,10 @@ static void content_sqlite_closedb (struct content_sqlite *ctx)
             if (sqlite3_finalize (ctx->checkpt_get_all_stmt) != SQLITE_OK)
                 log_sqlite_error (ctx, "sqlite_finalize checkpt_get_all_stmt");
         }
+        if (ctx->count_stmt) {
+            if (sqlite3_finalize (ctx->count_stmt) != SQLITE_OK)
+                log_sqlite_error (ctx, "sqlite_finalize count_stmt");
+        }
         if (ctx->db) {
             if (sqlite3_close (ctx->db) != SQLITE_OK)
                 log_sqlite_error (ctx, "sqlite3_close");
@@ -725,6 +1117,9 @@ void stats_get_cb (flux_t *h,
     const char *errmsg = NULL;
     json_t *load_time = NULL;
     json_t *store_time = NULL;
+    json_t *batch_size = NULL;
+    json_t *batch_commit_time = NULL;
+    json_t *compression = NULL;
     json_t *checkpoints = NULL;
 
     if (sqlite3_exec (ctx->db,
@@ -737,25 +1132,39 @@ void stats_get_cb (flux_t *h,
         goto error;
     }
     if (!(load_time = pack_tstat (&ctx->stats.load))
-        || !(store_time = pack_tstat (&ctx->stats.store)))
+        || !(store_time = pack_tstat (&ctx->stats.store))
+        || !(batch_size = pack_tstat (&ctx->stats.batch_size))
+        || !(batch_commit_time = pack_tstat (&ctx->stats.batch_commit))
+        || !(compression = codec_stats_get (ctx->codec)))
         goto error;
     if (!(checkpoints = stats_checkpoints (ctx)))
         goto error;
     if (flux_respond_pack (h,
                            msg,
-                           "{s:i s:I s:I s:O s:O s:{s:s s:s} s:O}",
+                           "{s:i s:I s:I s:O s:O s:{s:O s:O} s:O"
+                           " s:{s:s s:s s:s s:i s:b} s:O}",
                            "object_count", count,
                            "dbfile_size", get_file_size (ctx->dbfile),
                            "dbfile_free", get_fs_free (ctx->dbfile),
                            "load_time", load_time,
                            "store_time", store_time,
+                           "batch_store",
+                             "size", batch_size,
+                             "commit_time", batch_commit_time,
+                           "compression", compression,
                            "config",
                              "journal_mode", ctx->journal_mode,
                              "synchronous", ctx->synchronous,
+                             "compression", codec_name (ctx->codec),
+                             "compression_level", codec_level (ctx->codec),
+                             "dictionary", ctx->dictionary ? 1 : 0,
                            "checkpoints", checkpoints) < 0)
         flux_log_error (h, "error responding to stats-get request");
     json_decref (load_time);
     json_decref (store_time);
+    json_decref (batch_size);
+    json_decref (batch_commit_time);
+    json_decref (compression);
     json_decref (checkpoints);
     return;
 error:
@@ -763,9 +1172,186 @@ error:
         flux_log_error (h, "error responding to stats-get request");
     json_decref (load_time);
     json_decref (store_time);
+    json_decref (batch_size);
+    json_decref (batch_commit_time);
+    json_decref (compression);
     json_decref (checkpoints);
 }
 
+/* sqlite3_exec() callback from sql_objects_columns query.
+ * Column 1 of PRAGMA table_info is the column name.
+ */
+static int set_has_codec (void *arg, int ncols, char **cols, char **col_names)
+{
+    bool *result = arg;
+
+    if (ncols > 1 && cols[1] && streq (cols[1], "codec"))
+        *result = true;
+    return 0;
+}
+
+/* Add the codec and dict columns to an objects table created by an
+ * earlier version.  Existing rows get NULL values for both.
+ */
+static int content_sqlite_objects_migrate (struct content_sqlite *ctx)
+{
+    bool has_codec = false;
+
+    if (sqlite3_exec (ctx->db,
+                      sql_objects_columns,
+                      set_has_codec,
+                      &has_codec,
+                      NULL) != SQLITE_OK) {
+        log_sqlite_error (ctx, "querying objects table columns");
+        return -1;
+    }
+    if (has_codec)
+        return 0;
+    if (sqlite3_exec (ctx->db,
+                      sql_add_codec_column,
+                      NULL,
+                      NULL,
+                      NULL) != SQLITE_OK
+        || sqlite3_exec (ctx->db,
+                         sql_add_dict_column,
+                         NULL,
+                         NULL,
+                         NULL) != SQLITE_OK) {
+        log_sqlite_error (ctx, "adding codec columns to objects table");
+        return -1;
+    }
+    flux_log (ctx->h, LOG_DEBUG, "added codec columns to objects table");
+    return 0;
+}
+
+/* Make all stored dictionaries available for decompression.  If dictionary
+ * compression is enabled, compress new blobs with the most recent one.
+ */
+static int content_sqlite_dict_load (struct content_sqlite *ctx)
+{
+    sqlite3_stmt *stmt = NULL;
+    int last_id = 0;
+    int rc = -1;
+
+    if (sqlite3_prepare_v2 (ctx->db,
+                            sql_dict_get_all,
+                            -1,
+                            &stmt,
+                            NULL) != SQLITE_OK) {
+        log_sqlite_error (ctx, "preparing dict_get_all stmt");
+        return -1;
+    }
+    while (sqlite3_step (stmt) == SQLITE_ROW) {
+        int id = sqlite3_column_int (stmt, 0);
+        const void *dict = sqlite3_column_blob (stmt, 1);
+        int size = sqlite3_column_bytes (stmt, 1);
+
+        if (codec_dict_add (ctx->codec, id, dict, size) < 0) {
+            flux_log_error (ctx->h, "error loading dictionary %d", id);
+            goto done;
+        }
+        last_id = id;
+    }
+    if (ctx->dictionary && last_id > 0) {
+        if (codec_dict_use (ctx->codec, last_id) < 0) {
+            flux_log_error (ctx->h, "error using dictionary %d", last_id);
+            goto done;
+        }
+    }
+    rc = 0;
+done:
+    (void)sqlite3_finalize (stmt);
+    return rc;
+}
+
+/* Report the compression ratio achieved for all stored objects, grouped
+ * by codec and dictionary.  If objects stored before the module was loaded
+ * are still being counted, respond once that is done.
+ */
+void compression_stats_cb (flux_t *h,
+                           flux_msg_handler_t *mh,
+                           const flux_msg_t *msg,
+                           void *arg)
+{
+    struct content_sqlite *ctx = arg;
+
+    if (flux_request_decode (msg, NULL, NULL) < 0)
+        goto error;
+    if (ctx->count_errno != 0 && compression_count_restart (ctx) < 0)
+        goto error;
+    if (ctx->count_rowid < ctx->count_max_rowid) {
+        if (flux_msglist_append (ctx->count_requests, msg) < 0)
+            goto error;
+        return;
+    }
+    compression_count_respond (ctx, msg);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        flux_log_error (h, "error responding to compression-stats request");
+}
+
+/* The codec is created when the module is loaded, so reject a config
+ * update that changes the compression settings rather than ignore it.
+ */
+static bool compression_config_changed (const flux_conf_t *old_conf,
+                                        const flux_conf_t *new_conf)
+{
+    const char *keys[] = { "compression", "compression_level", "dictionary",
+                           NULL };
+    json_t *old_table = NULL;
+    json_t *new_table = NULL;
+
+    (void)flux_conf_unpack (old_conf,
+                            NULL,
+                            "{s?o}",
+                            "content-sqlite", &old_table);
+    (void)flux_conf_unpack (new_conf,
+                            NULL,
+                            "{s?o}",
+                            "content-sqlite", &new_table);
+    for (int i = 0; keys[i] != NULL; i++) {
+        json_t *old_val = json_object_get (old_table, keys[i]);
+        json_t *new_val = json_object_get (new_table, keys[i]);
+
+        if (old_val != new_val && !json_equal (old_val, new_val))
+            return true;
+    }
+    return false;
+}
+
+static void config_reload_cb (flux_t *h,
+                              flux_msg_handler_t *mh,
+                              const flux_msg_t *msg,
+                              void *arg)
+{
+    flux_conf_t *conf;
+    const char *errstr = NULL;
+
+    if (flux_module_config_request_decode (msg, &conf) < 0) {
+        errstr = "error unpacking config-reload request";
+        goto error;
+    }
+    if (compression_config_changed (flux_get_conf (h), conf)) {
+        errstr = "content-sqlite compression settings cannot be changed"
+                 " until the instance is restarted";
+        errno = EINVAL;
+        goto error_decref;
+    }
+    if (flux_set_conf_new (h, conf) < 0) {
+        errstr = "error updating config";
+        goto error_decref;
+    }
+    if (flux_respond (h, msg, NULL) < 0)
+        flux_log_error (h, "error responding to config-reload request");
+    return;
+error_decref:
+    flux_conf_decref (conf);
+error:
+    if (flux_respond_error (h, msg, errno, errstr) < 0)
+        flux_log_error (h, "error responding to config-reload request");
+}
+
 /* Open the database file ctx->dbfile and set up the database.
  */
 static int content_sqlite_opendb (struct content_sqlite *ctx, bool truncate)
@@ -823,6 +1409,8 @@ static int content_sqlite_opendb (struct content_sqlite *ctx, bool truncate)
         log_sqlite_error (ctx, "creating object table");
         goto error;
     }
+    if (content_sqlite_objects_migrate (ctx) < 0)
+        goto error;
     if (sqlite3_exec (ctx->db,
                       sql_create_table_checkpt_v2,
                       NULL,
@@ -831,6 +1419,16 @@ static int content_sqlite_opendb (struct content_sqlite *ctx, bool truncate)
         log_sqlite_error (ctx, "creating checkpt table");
         goto error;
     }
+    if (sqlite3_exec (ctx->db,
+                      sql_create_table_dict,
+                      NULL,
+                      NULL,
+                      NULL) != SQLITE_OK) {
+        log_sqlite_error (ctx, "creating dictionaries table");
+        goto error;
+    }
+    if (content_sqlite_dict_load (ctx) < 0)
+        goto error;
     if (sqlite3_prepare_v2 (ctx->db,
                             sql_load,
                             -1,
@@ -887,6 +1485,14 @@ static int content_sqlite_opendb (struct content_sqlite *ctx, bool truncate)
         log_sqlite_error (ctx, "preparing checkpt get_all stmt");
         goto error;
     }
+    if (sqlite3_prepare_v2 (ctx->db,
+                            sql_compression_count,
+                            -1,
+                            &ctx->count_stmt,
+                            NULL) != SQLITE_OK) {
+        log_sqlite_error (ctx, "preparing compression count stmt");
+        goto error;
+    }
     if (sqlite3_exec (ctx->db,
                       sql_objects_count,
                       set_count,
@@ -1030,8 +1636,15 @@ static void content_sqlite_destroy (struct content_sqlite *ctx)
     if (ctx) {
         int saved_errno = errno;
         flux_msg_handler_delvec (ctx->handlers);
+        if (ctx->count_requests) {
+            compression_count_respond_all (ctx, ENOSYS);
+            flux_msglist_destroy (ctx->count_requests);
+        }
+        flux_watcher_destroy (ctx->count_w);
+        free (ctx->counts);
         free (ctx->dbfile);
-        free (ctx->lzo_buf);
+        codec_destroy (ctx->codec);
+        free (ctx->compression);
         free (ctx->hashfun);
         free (ctx->journal_mode);
         free (ctx->synchronous);
@@ -1053,6 +1666,12 @@ static const struct flux_msg_handler_spec htab[] = {
         store_cb,
         0
     },
+    {
+        FLUX_MSGTYPE_REQUEST,
+        "content-backing.batch-store",
+        batch_store_cb,
+        0
+    },
     {
         FLUX_MSGTYPE_REQUEST,
         "content-backing.validate",
@@ -1077,6 +1696,18 @@ static const struct flux_msg_handler_spec htab[] = {
         stats_get_cb,
         FLUX_ROLE_USER
     },
+    {
+        FLUX_MSGTYPE_REQUEST,
+        "content-backing.compression-stats",
+        compression_stats_cb,
+        0
+    },
+    {
+        FLUX_MSGTYPE_REQUEST,
+        "content-sqlite.config-reload",
+        config_reload_cb,
+        0
+    },
     FLUX_MSGHANDLER_TABLE_END,
 };
 
@@ -1088,15 +1719,21 @@ static struct content_sqlite *content_sqlite_create (flux_t *h)
 
     if (!(ctx = calloc (1, sizeof (*ctx))))
         return NULL;
-    if (!(ctx->lzo_buf = calloc (1, lzo_buf_chunksize)))
-        goto error;
-    ctx->lzo_bufsize = lzo_buf_chunksize;
     ctx->h = h;
     if (set_config (&ctx->journal_mode, "WAL") < 0)
         goto error;
     if (set_config (&ctx->synchronous, "NORMAL") < 0)
         goto error;
+    if (set_config (&ctx->compression, "lz4") < 0)
+        goto error;
     ctx->max_checkpoints = MAX_CHECKPOINTS_DEFAULT;
+    if (!(ctx->count_requests = flux_msglist_create ())
+        || !(ctx->count_w = flux_timer_watcher_create (flux_get_reactor (h),
+                                                       0.,
+                                                       0.,
+                                                       compression_count_cb,
+                                                       ctx)))
+        goto error;
 
     /* Some tunables:
      * - the hash function, e.g. sha1, sha256
@@ -1178,15 +1815,20 @@ static int process_config (struct content_sqlite *ctx,
     flux_error_t error;
     const char *journal_mode = NULL;
     const char *synchronous = NULL;
+    const char *compression = NULL;
+    int dictionary = ctx->dictionary;
     int tmp_max_checkpoints = ctx->max_checkpoints;
 
     if (flux_conf_unpack (conf,
                           &error,
-                          "{s?{s?s s?s s?i}}",
+                          "{s?{s?s s?s s?i s?s s?i s?b}}",
                           "content-sqlite",
                             "journal_mode", &journal_mode,
                             "synchronous", &synchronous,
-                            "max_checkpoints", &tmp_max_checkpoints) < 0) {
+                            "max_checkpoints", &tmp_max_checkpoints,
+                            "compression", &compression,
+                            "compression_level", &ctx->compression_level,
+                            "dictionary", &dictionary) < 0) {
         flux_log_error (ctx->h, "%s", error.text);
         return -1;
     }
@@ -1214,6 +1856,9 @@ static int process_config (struct content_sqlite *ctx,
         return -1;
     }
     ctx->max_checkpoints = tmp_max_checkpoints;
+    if (compression && set_config (&ctx->compression, compression) < 0)
+        return -1;
+    ctx->dictionary = dictionary ? true : false;
 
     return 0;
 }
@@ -1257,6 +1902,25 @@ static int process_args (struct content_sqlite *ctx,
             }
             ctx->max_checkpoints = tmp_max_checkpoints;
         }
+        else if (strstarts (argv[i], "compression=")) {
+            if (set_config (&ctx->compression, argv[i] + 12) < 0)
+                return -1;
+        }
+        else if (strstarts (argv[i], "compression-level=")) {
+            char *endptr;
+            errno = 0;
+            ctx->compression_level = strtol (argv[i] + 18, &endptr, 10);
+            if (errno != 0 || *endptr != '\0') {
+                flux_log (ctx->h,
+                          LOG_ERR,
+                          "invalid compression-level specified");
+                errno = EINVAL;
+                return -1;
+            }
+        }
+        else if (streq ("dictionary", argv[i])) {
+            ctx->dictionary = true;
+        }
         else if (streq ("truncate", argv[i])) {
             *truncate = true;
         }
@@ -1274,6 +1938,7 @@ int mod_main (flux_t *h, int argc, char **argv)
     struct content_sqlite *ctx;
     bool truncate = false;
     bool exists = false;
+    flux_error_t error;
     int rc = -1;
 
     if (!(ctx = content_sqlite_create (h))) {
@@ -1284,15 +1949,30 @@ int mod_main (flux_t *h, int argc, char **argv)
         goto done;
     if (process_args (ctx, argc, argv, &truncate) < 0)
         goto done;
+    if (!(ctx->codec = codec_create (ctx->compression,
+                                     ctx->compression_level,
+                                     &error))) {
+        flux_log (h, LOG_ERR, "%s", error.text);
+        goto done;
+    }
+    if (ctx->dictionary && !streq (codec_name (ctx->codec), "lz4")) {
+        flux_log (h, LOG_ERR, "dictionary requires lz4 compression");
+        errno = EINVAL;
+        goto done;
+    }
     if (content_sqlite_opendb (ctx, truncate) < 0)
         goto done;
+    if (compression_count_restart (ctx) < 0)
+        goto done;
     if (content_sqlite_table_exists (ctx, "checkpt", &exists) < 0
         || (exists
             && content_sqlite_checkpt_migrate (ctx) < 0))
         goto done;
     if (content_register_service (h, "content-backing") < 0)
         goto done;
-    if (content_register_backing_store (h, "content-sqlite") < 0)
+    if (content_register_backing_store (h,
+                                        "content-sqlite",
+                                        CONTENT_BACKING_BATCH) < 0)
         goto done;
     if (flux_reactor_run (flux_get_reactor (h), 0) < 0) {
         flux_log_error (h, "flux_reactor_run");
@@ -29,6 +29,7 @@
 #include "cache.h"
 #include "checkpoint.h"
 #include "mmap.h"
+#include "preload.h"
 
 /* A periodic callback purges the cache of least recently used entries.
  * The callback is synchronized with the instance heartbeat, with a
@@ -50,6 +51,10 @@ static const uint32_t default_blob_size_limit = 1048576*1024;
 
 static const uint32_t default_flush_batch_limit = 256;
 
+/* Limit the payload size of a batch-store request.
+ */
+static const size_t store_batch_max_size = 1048576*16;
+
 /* Hash digests are used as zhashx keys.  The digest size needs to be
  * available to zhashx comparator so make this global.
  */
@@ -87,6 +92,8 @@ struct content_cache {
     uint32_t rank;
     zhashx_t *entries;
     uint8_t backing:1;              // 'content.backing' service available
+    uint8_t backing_batch:1;        // backing store supports batch-store
+    uint8_t store_batch_pending:1;  // batch-store request in progress
     char *backing_name;
     char *hash_name;
     struct msgstack *flush_requests;
@@ -108,6 +115,7 @@ struct content_cache {
 
     struct content_checkpoint *checkpoint;
     struct content_mmap *mmap;
+    struct content_preload *preload;
 };
 
 static void flush_respond (struct content_cache *cache);
@@ -583,6 +591,137 @@ error:
     cache_resume_flush (cache);
 }
 
+/* A batch-store request stores a vector of dirty entries to the backing
+ * store in one transaction.  At most one batch is in progress at a time.
+ * Entries that become dirty while it is in progress accumulate on the flush
+ * list and are sent together in the next batch (group commit).
+ */
+struct store_batch {
+    int count;
+    struct cache_entry *entries[];
+};
+
+static void cache_store_batch_continuation (flux_future_t *f, void *arg)
+{
+    struct content_cache *cache = arg;
+    struct store_batch *batch = flux_future_aux_get (f, "batch");
+    const uint8_t *hashes;
+    size_t len;
+    int errnum = 0;
+    int failed = 0;
+
+    cache->store_batch_pending = 0;
+    assert (cache->flush_batch_count >= batch->count);
+    cache->flush_batch_count -= batch->count;
+    if (content_store_batch_get_hashes (f, (const void **)&hashes, &len) < 0) {
+        errnum = errno;
+        if (errno == ENOSYS) {
+            flux_log (cache->h,
+                      LOG_DEBUG,
+                      "content batch-store: %s",
+                      "backing store service unavailable");
+        }
+        else {
+            flux_log (cache->h,
+                      LOG_CRIT,
+                      "content batch-store: %s",
+                      strerror (errno));
+        }
+    }
+    else if (len != batch->count * content_hash_size)
+        errnum = EIO;
+    for (int i = 0; i < batch->count; i++) {
+        struct cache_entry *e = batch->entries[i];
+
+        e->store_pending = 0;
+        if (errnum == 0
+            && memcmp (hashes + i * content_hash_size,
+                       e->hash,
+                       content_hash_size) == 0)
+            cache_entry_dirty_clear (cache, e);
+        else {
+            int e_errnum = errnum ? errnum : EIO;
+            request_list_respond_error (&e->store_requests,
+                                        cache->h,
+                                        e_errnum,
+                                        NULL,
+                                        "store");
+            request_list_respond_error (&cache->flush_requests,
+                                        cache->h,
+                                        e_errnum,
+                                        NULL,
+                                        "flush");
+            cache->flush_errno = e_errnum;
+            failed++;
+        }
+    }
+    /* clear flush errno if backing store functional/recovered */
+    if (failed == 0)
+        cache->flush_errno = 0;
+    flux_future_destroy (f);
+    cache_resume_flush (cache);
+}
+
+/* Send up to flush_batch_limit entries (or store_batch_max_size bytes)
+ * from the flush list in one batch-store request, unless one is already in
+ * progress.
+ */
+static int cache_store_batch (struct content_cache *cache)
+{
+    struct store_batch *batch;
+    struct iovec *iov;
+    struct cache_entry *e;
+    flux_future_t *f = NULL;
+    int count = 0;
+    size_t size = 0;
+
+    if (cache->store_batch_pending
+        || cache->flush_batch_limit == 0
+        || list_empty (&cache->flush))
+        return 0;
+    if (!(batch = malloc (sizeof (*batch)
+                          + sizeof (batch->entries[0])
+                            * cache->flush_batch_limit))
+        || !(iov = calloc (cache->flush_batch_limit, sizeof (iov[0])))) {
+        ERRNO_SAFE_WRAP (free, batch);
+        return -1;
+    }
+    list_for_each (&cache->flush, e, list) {
+        if (count == cache->flush_batch_limit
+            || (count > 0 && size + e->len > store_batch_max_size))
+            break;
+        assert (e->valid);
+        size += e->len;
+        iov[count].iov_base = (void *)e->data;
+        iov[count].iov_len = e->len;
+        batch->entries[count++] = e;
+    }
+    batch->count = count;
+    if (!(f = content_store_batch (cache->h, iov, count))
+        || flux_future_aux_set (f, "batch", batch, free) < 0) {
+        flux_log_error (cache->h, "content batch-store");
+        ERRNO_SAFE_WRAP (free, batch);
+        goto error;
+    }
+    if (flux_future_then (f, -1., cache_store_batch_continuation, cache) < 0) {
+        flux_log_error (cache->h, "content batch-store");
+        goto error;
+    }
+    for (int i = 0; i < count; i++) {
+        e = batch->entries[i];
+        list_del_init (&e->list);
+        e->store_pending = 1;
+    }
+    cache->flush_batch_count += count;
+    cache->store_batch_pending = 1;
+    free (iov);
+    return 0;
+error:
+    ERRNO_SAFE_WRAP (flux_future_destroy, f);
+    ERRNO_SAFE_WRAP (free, iov);
+    return -1;
+}
+
 /* Issue #4482, there is a small chance a dirty entry could be added
  * to the flush list twice which can lead to list corruption.  As an
  * extra measure, perform a delete from the list first.  If the node
@@ -605,6 +744,10 @@ static int cache_store (struct content_cache *cache, struct cache_entry *e)
     if (e->store_pending)
         return 0;
     if (cache->rank == 0) {
+        if (cache->backing_batch) {
+            flush_list_append (cache, e);
+            return cache_store_batch (cache);
+        }
         if (cache->flush_batch_count >= cache->flush_batch_limit) {
             flush_list_append (cache, e);
             return 0;
@@ -720,6 +863,8 @@ static int cache_flush (struct content_cache *cache)
     int last_errno = 0;
     int rc = 0;
 
+    if (cache->rank == 0 && cache->backing_batch)
+        return cache_store_batch (cache);
     while (cache->flush_batch_count < cache->flush_batch_limit) {
         if (!(e = list_top (&cache->flush, struct cache_entry, list)))
             break;
@@ -732,7 +877,7 @@ static int cache_flush (struct content_cache *cache)
                 || errno == ENOMEM)
                 break;
         }
-        (void)list_pop (&cache->flush, struct cache_entry, list);
+        list_del_init (&e->list);
     }
     if (rc < 0)
         errno = last_errno;
@@ -746,10 +891,15 @@ static void content_register_backing_request (flux_t *h,
 {
     struct content_cache *cache = arg;
     const char *name;
+    int batch = 0;
     flux_error_t error;
     const char *errstr = NULL;
 
-    if (flux_request_unpack (msg, NULL, "{s:s}", "name", &name) < 0)
+    if (flux_request_unpack (msg,
+                             NULL,
+                             "{s:s s?b}",
+                             "name", &name,
+                             "batch", &batch) < 0)
         goto error;
     if (cache->rank != 0) {
         errno = EINVAL;
@@ -783,6 +933,7 @@ static void content_register_backing_request (flux_t *h,
         goto error;
     }
     cache->backing = 1;
+    cache->backing_batch = batch ? 1 : 0;
     flux_log (h, LOG_DEBUG, "content backing store: enabled %s", name);
     if (flux_respond (h, msg, NULL) < 0)
         flux_log_error (h, "error responding to register-backing request");
@@ -807,6 +958,7 @@ static void content_unregister_backing_request (flux_t *h,
         goto error;
     }
     cache->backing = 0;
+    cache->backing_batch = 0;
     flux_log (h, LOG_DEBUG, "content backing store: disabled");
     if (flux_respond (h, msg, NULL) < 0)
         flux_log_error (h, "error responding to unregister-backing request");
@@ -1127,6 +1279,7 @@ void content_cache_destroy (struct content_cache *cache)
         msgstack_destroy (&cache->flush_requests);
         content_checkpoint_destroy (cache->checkpoint);
         content_mmap_destroy (cache->mmap);
+        content_preload_destroy (cache->preload);
         free (cache->hash_name);
         free (cache);
         errno = saved_errno;
@@ -1174,6 +1327,8 @@ struct content_cache *content_cache_create (flux_t *h, int argc, char **argv)
                                                          cache->rank,
                                                          cache)))
         goto error;
+    if (!(cache->preload = content_preload_create (h, cache->rank)))
+        goto error;
     if (cache->rank == 0) {
         if (!(cache->mmap = content_mmap_create (h,
                                                  cache->hash_name,
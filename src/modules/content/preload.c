@@ -0,0 +1,304 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* preload.c - prime content caches along the TBON
+ *
+ * A content.preload request carries a list of blobrefs and an idset of
+ * target ranks.  The receiving broker loads the blobs into its own cache,
+ * then forwards the request to each child whose subtree contains targets.
+ * Because each level is primed before its children are asked, a blob is
+ * loaded from each broker at most once per child, and rank 0 handles one
+ * load per child instead of one per target when many targets then fault
+ * the same blobs at once, e.g. job shells starting on every rank of a
+ * large job.
+ *
+ * The response is sent once this broker and all forwarded requests have
+ * loaded the blobs.  Preloading is an optimization, so callers normally
+ * only log errors.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <jansson.h>
+#include <flux/core.h>
+#include <flux/idset.h>
+
+#include "src/common/libczmqcontainers/czmq_containers.h"
+#include "src/common/libcontent/content.h"
+#include "src/common/libutil/errno_safe.h"
+#include "src/common/librouter/tbon_children.h"
+
+#include "preload.h"
+
+struct content_preload {
+    flux_t *h;
+    uint32_t rank;
+    struct tbon_children *tbon;
+    zlistx_t *requests;
+    flux_msg_handler_t **handlers;
+};
+
+struct preload_request {
+    struct content_preload *preload;
+    const flux_msg_t *msg;
+    json_t *blobrefs;
+    struct idset *ranks;
+    flux_future_t *f_load;
+    flux_future_t *f_fwd;
+    void *handle;
+};
+
+static void preload_request_destroy (struct preload_request *pr)
+{
+    if (pr) {
+        int saved_errno = errno;
+        flux_future_destroy (pr->f_load);
+        flux_future_destroy (pr->f_fwd);
+        idset_destroy (pr->ranks);
+        json_decref (pr->blobrefs);
+        flux_msg_decref (pr->msg);
+        free (pr);
+        errno = saved_errno;
+    }
+}
+
+// zlistx_destructor_t footprint
+static void preload_request_destructor (void **item)
+{
+    if (item) {
+        preload_request_destroy (*item);
+        *item = NULL;
+    }
+}
+
+static void preload_request_respond (struct preload_request *pr,
+                                     int errnum,
+                                     const char *errstr)
+{
+    struct content_preload *preload = pr->preload;
+    int rc;
+
+    if (errnum == 0)
+        rc = flux_respond (preload->h, pr->msg, NULL);
+    else
+        rc = flux_respond_error (preload->h, pr->msg, errnum, errstr);
+    if (rc < 0)
+        flux_log_error (preload->h, "error responding to preload request");
+    zlistx_delete (preload->requests, pr->handle);
+}
+
+static void preload_fwd_continuation (flux_future_t *f, void *arg)
+{
+    struct preload_request *pr = arg;
+
+    if (flux_future_get (f, NULL) < 0) {
+        preload_request_respond (pr, errno, "error preloading children");
+        return;
+    }
+    preload_request_respond (pr, 0, NULL);
+}
+
+/* Send one content.preload request to each child whose subtree contains
+ * targets.  A leaf, or a broker with no targets below it, creates an empty
+ * composite future which is fulfilled immediately.
+ */
+static int preload_forward (struct preload_request *pr)
+{
+    struct content_preload *preload = pr->preload;
+    const struct tbon_child *children;
+    size_t nchildren;
+
+    if (!(children = tbon_children_get (preload->tbon, &nchildren))
+        || !(pr->f_fwd = flux_future_wait_all_create ()))
+        return -1;
+    flux_future_set_flux (pr->f_fwd, preload->h);
+    for (int i = 0; i < nchildren; i++) {
+        struct idset *ids;
+        flux_future_t *f = NULL;
+        char *s = NULL;
+
+        if (!(ids = idset_intersect (pr->ranks, children[i].subtree)))
+            return -1;
+        if (idset_count (ids) > 0) {
+            if (!(s = idset_encode (ids, IDSET_FLAG_RANGE))
+                || !(f = flux_rpc_pack (preload->h,
+                                        "content.preload",
+                                        children[i].rank,
+                                        0,
+                                        "{s:s s:O}",
+                                        "ranks", s,
+                                        "blobrefs", pr->blobrefs))
+                || flux_future_push (pr->f_fwd, s, f) < 0) {
+                ERRNO_SAFE_WRAP (free, s);
+                flux_future_destroy (f);
+                idset_destroy (ids);
+                return -1;
+            }
+        }
+        free (s);
+        idset_destroy (ids);
+    }
+    if (flux_future_then (pr->f_fwd, -1., preload_fwd_continuation, pr) < 0)
+        return -1;
+    return 0;
+}
+
+static void preload_load_continuation (flux_future_t *f, void *arg)
+{
+    struct preload_request *pr = arg;
+
+    if (flux_future_get (f, NULL) < 0) {
+        preload_request_respond (pr, errno, "error loading blobs");
+        return;
+    }
+    if (preload_forward (pr) < 0)
+        preload_request_respond (pr, errno, "error forwarding request");
+}
+
+/* Load each blob through this broker's own content.load service, so
+ * that it is cached here and loads are shared with any other requests
+ * for the same blob.
+ */
+static int preload_load (struct preload_request *pr)
+{
+    struct content_preload *preload = pr->preload;
+    size_t index;
+    json_t *entry;
+
+    if (!(pr->f_load = flux_future_wait_all_create ()))
+        return -1;
+    flux_future_set_flux (pr->f_load, preload->h);
+    json_array_foreach (pr->blobrefs, index, entry) {
+        const char *blobref = json_string_value (entry);
+        flux_future_t *f;
+
+        if (flux_future_get_child (pr->f_load, blobref))
+            continue; // duplicate
+        if (!(f = content_load_byblobref (preload->h, blobref, 0))
+            || flux_future_push (pr->f_load, blobref, f) < 0) {
+            flux_future_destroy (f);
+            return -1;
+        }
+    }
+    if (flux_future_then (pr->f_load,
+                          -1.,
+                          preload_load_continuation,
+                          pr) < 0)
+        return -1;
+    return 0;
+}
+
+static void content_preload_request (flux_t *h,
+                                     flux_msg_handler_t *mh,
+                                     const flux_msg_t *msg,
+                                     void *arg)
+{
+    struct content_preload *preload = arg;
+    struct preload_request *pr = NULL;
+    const char *ranks;
+    json_t *blobrefs;
+    size_t index;
+    json_t *entry;
+    const char *errmsg = NULL;
+
+    if (flux_request_unpack (msg,
+                             NULL,
+                             "{s:s s:o}",
+                             "ranks", &ranks,
+                             "blobrefs", &blobrefs) < 0)
+        goto error;
+    if (!json_is_array (blobrefs)) {
+        errno = EPROTO;
+        goto error;
+    }
+    json_array_foreach (blobrefs, index, entry) {
+        if (!json_is_string (entry)) {
+            errno = EPROTO;
+            goto error;
+        }
+    }
+    if (!tbon_children_get (preload->tbon, NULL)) {
+        errmsg = "TBON topology is not yet known";
+        errno = EAGAIN;
+        goto error;
+    }
+    if (!(pr = calloc (1, sizeof (*pr))))
+        goto error;
+    pr->preload = preload;
+    pr->msg = flux_msg_incref (msg);
+    pr->blobrefs = json_incref (blobrefs);
+    if (!(pr->ranks = idset_decode (ranks))) {
+        errmsg = "error decoding ranks";
+        goto error;
+    }
+    if (!(pr->handle = zlistx_add_end (preload->requests, pr))) {
+        errno = ENOMEM;
+        goto error;
+    }
+    if (preload_load (pr) < 0) {
+        zlistx_detach (preload->requests, pr->handle);
+        goto error;
+    }
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, errmsg) < 0)
+        flux_log_error (h, "error responding to preload request");
+    preload_request_destroy (pr);
+}
+
+static const struct flux_msg_handler_spec htab[] = {
+    {
+        FLUX_MSGTYPE_REQUEST,
+        "content.preload",
+        content_preload_request,
+        0
+    },
+    FLUX_MSGHANDLER_TABLE_END,
+};
+
+void content_preload_destroy (struct content_preload *preload)
+{
+    if (preload) {
+        int saved_errno = errno;
+        flux_msg_handler_delvec (preload->handlers);
+        zlistx_destroy (&preload->requests);
+        tbon_children_destroy (preload->tbon);
+        free (preload);
+        errno = saved_errno;
+    }
+}
+
+struct content_preload *content_preload_create (flux_t *h, uint32_t rank)
+{
+    struct content_preload *preload;
+
+    if (!(preload = calloc (1, sizeof (*preload))))
+        return NULL;
+    preload->h = h;
+    preload->rank = rank;
+    if (!(preload->requests = zlistx_new ()))
+        goto nomem;
+    zlistx_set_destructor (preload->requests, preload_request_destructor);
+    if (flux_msg_handler_addvec (h, htab, preload, &preload->handlers) < 0)
+        goto error;
+    if (!(preload->tbon = tbon_children_create (h, rank)))
+        goto error;
+    return preload;
+nomem:
+    errno = ENOMEM;
+error:
+    content_preload_destroy (preload);
+    return NULL;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
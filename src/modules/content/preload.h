@@ -0,0 +1,21 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _CONTENT_PRELOAD_H
+#define _CONTENT_PRELOAD_H 1
+
+struct content_preload *content_preload_create (flux_t *h, uint32_t rank);
+void content_preload_destroy (struct content_preload *preload);
+
+#endif /* !_CONTENT_PRELOAD_H */
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -879,6 +879,14 @@ static int exec_init (struct jobinfo *job)
         flux_log_error (job->h, "exec_init: bulk_exec_create");
         goto err;
     }
+    /* Tree launch is not supported by sdexec, so ignore it in that case.
+     */
+    if (config_get_tree_launch ()
+        && !streq (service, "sdexec")
+        && bulk_exec_set_tree_launch (exec, true) < 0) {
+        flux_log_error (job->h, "exec_init: bulk_exec_set_tree_launch");
+        goto err;
+    }
     if (!(ctx = exec_ctx_create (job, ranks, &error))) {
         flux_log (job->h, LOG_ERR, "exec_ctx_create: %s", error.text);
         goto err;
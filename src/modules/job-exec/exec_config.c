@@ -42,6 +42,7 @@ struct exec_config {
     int sdexec_stop_timer_sec;
     int sdexec_stop_timer_signal;
     int sdexec_constrain_resources;
+    int tree_launch;
     double default_barrier_timeout;
     double shell_exit_timeout;  /* <=0 means disabled */
 };
@@ -95,6 +96,11 @@ bool config_get_sdexec_constrain_resources (void)
     return exec_conf.sdexec_constrain_resources ? true : false;
 }
 
+bool config_get_tree_launch (void)
+{
+    return exec_conf.tree_launch ? true : false;
+}
+
 static int derive_sdexec_stop_timer_sec (void)
 {
     int value = exec_conf.sdexec_stop_timer_sec;
@@ -143,7 +149,7 @@ int config_get_stats (json_t **config_stats)
 {
     json_t *o = NULL;
 
-    if (!(o = json_pack ("{s:s? s:s? s:s? s:s? s:i s:f s:f s:i s:i s:i}",
+    if (!(o = json_pack ("{s:s? s:s? s:s? s:s? s:i s:f s:f s:i s:i s:i s:i}",
                          "default_cwd", default_cwd,
                          "default_job_shell", exec_conf.default_job_shell,
                          "flux_imp_path", exec_conf.flux_imp_path,
@@ -159,7 +165,9 @@ int config_get_stats (json_t **config_stats)
                          "sdexec_stop_timer_signal",
                          exec_conf.sdexec_stop_timer_signal,
                          "sdexec_constrain_resources",
-                         exec_conf.sdexec_constrain_resources))) {
+                         exec_conf.sdexec_constrain_resources,
+                         "tree_launch",
+                         exec_conf.tree_launch))) {
         errno = ENOMEM;
         return -1;
     }
@@ -191,6 +199,7 @@ static void exec_config_init (struct exec_config *ec)
     ec->sdexec_stop_timer_sec = -1;
     ec->sdexec_stop_timer_signal = 10; // SIGUSR1
     ec->sdexec_constrain_resources = 0;
+    ec->tree_launch = 0;
     ec->default_barrier_timeout = 1800.;
     ec->shell_exit_timeout = DEFAULT_SHELL_EXIT_TIMEOUT;
 }
@@ -319,6 +328,18 @@ int config_setup (flux_t *h,
         return -1;
     }
 
+    /*  Check configuration for exec.tree-launch */
+    if (flux_conf_unpack (conf,
+                          &err,
+                          "{s?{s?b}}",
+                          "exec",
+                            "tree-launch", &tmpconf.tree_launch) < 0) {
+        errprintf (errp,
+                   "error reading config value exec.tree-launch: %s",
+                   err.text);
+        return -1;
+    }
+
     /*  Check configuration for exec.barrier-timeout */
     if (flux_conf_unpack (conf,
                           &err,
@@ -32,6 +32,8 @@ json_t *config_get_sdexec_properties (void);
 
 bool config_get_sdexec_constrain_resources (void);
 
+bool config_get_tree_launch (void);
+
 bool config_get_exec_service_override (void);
 
 double config_get_default_barrier_timeout (void);
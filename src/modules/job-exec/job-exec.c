@@ -107,6 +107,7 @@
 #include "job-exec.h"
 #include "checkpoint.h"
 #include "exec_config.h"
+#include "preload.h"
 
 static double max_start_delay_percent;
 static double kill_timeout;
@@ -177,6 +178,7 @@ void jobinfo_decref (struct jobinfo *job)
         int saved_errno = errno;
         idset_destroy (job->critical_ranks);
         eventlogger_destroy (job->ev);
+        flux_future_destroy (job->preload_f);
         flux_watcher_destroy (job->kill_timer);
         flux_watcher_destroy (job->kill_shell_timer);
         flux_watcher_destroy (job->max_kill_timer);
@@ -1309,6 +1311,43 @@ static void evlog_idle (struct eventlogger *ev, void *arg)
     jobinfo_decref ((struct jobinfo *) arg);
 }
 
+static void preload_continuation (flux_future_t *f, void *arg)
+{
+    struct jobinfo *job = arg;
+
+    if (flux_future_get (f, NULL) < 0) {
+        flux_log (job->h,
+                  LOG_DEBUG,
+                  "%s: preload: %s",
+                  idf58 (job->id),
+                  future_strerror (f, errno));
+    }
+    flux_future_destroy (f);
+    job->preload_f = NULL;
+}
+
+/*  Prime the content cache of the job's brokers with job data while the
+ *   shells are launched.  Rank 0 already has it, so skip jobs that only
+ *   run there.  This is an optimization, so failures are not fatal.
+ */
+static void job_preload (struct jobinfo *job)
+{
+    const struct idset *ranks = resource_set_ranks (job->R);
+
+    if (job->reattach
+        || (idset_count (ranks) == 1 && idset_first (ranks) == 0))
+        return;
+    if (!(job->preload_f = preload_job_data (job->h, job->id, ranks))
+        || flux_future_then (job->preload_f,
+                             -1.,
+                             preload_continuation,
+                             job) < 0) {
+        flux_log_error (job->h, "%s: preload", idf58 (job->id));
+        flux_future_destroy (job->preload_f);
+        job->preload_f = NULL;
+    }
+}
+
 static int job_start (struct job_exec_ctx *ctx, const flux_msg_t *msg)
 {
     struct eventlogger_ops ev_ops = {
@@ -1388,6 +1427,7 @@ static int job_start (struct job_exec_ctx *ctx, const flux_msg_t *msg)
         jobinfo_fatal_error (job, errno, "failed to hash job");
         goto error;
     }
+    job_preload (job);
     if (!(f = jobinfo_start_init (job))) {
         flux_log_error (ctx->h, "start: jobinfo_kvs_lookup");
         goto error;
@@ -96,6 +96,8 @@ struct jobinfo {
 
     struct eventlogger *  ev;           /* event batcher */
 
+    flux_future_t *       preload_f;    /* content.preload of job data */
+
     double                kill_timeout; /* grace time between sigterm,kill */
     flux_watcher_t       *kill_timer;
     int                   kill_count;
@@ -0,0 +1,176 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* Push job data to brokers at exec start
+ *
+ * DESCRIPTION
+ *
+ * Each job shell looks up J and R through its local broker, and every
+ * broker then faults the same KVS objects from its TBON parent at about
+ * the same time.  For large jobs this is a burst of identical loads that
+ * ends at rank 0.
+ *
+ * OPERATION
+ *
+ * Look up the treeobj of each directory on the path to the job directory
+ * and of the values read by the shell, and send their blobrefs in a
+ * content.preload request, which primes the content cache of the job's
+ * brokers down the TBON while the shells are being launched.
+ *
+ * Directories above the job directory change with every job, so they may
+ * have been replaced by the time a shell looks them up.  Only the job's
+ * own directory and values are certain to be reused.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <string.h>
+#include <errno.h>
+#include <jansson.h>
+#include <flux/core.h>
+#include <flux/idset.h>
+
+#include "src/common/libkvs/treeobj.h"
+#include "src/common/libutil/errno_safe.h"
+
+#include "preload.h"
+
+static const char *job_keys[] = { "jobspec", "J", "R", "eventlog", NULL };
+
+/* Append the blobrefs of a dirref or valref 'treeobj' to 'blobrefs'.
+ * Other object types have their data inline and are skipped.
+ */
+static int append_blobrefs (json_t *blobrefs, const char *treeobj)
+{
+    json_t *obj;
+    int count;
+    int rc = -1;
+
+    if (!(obj = treeobj_decode (treeobj)))
+        return -1;
+    if (treeobj_is_dirref (obj) || treeobj_is_valref (obj)) {
+        if ((count = treeobj_get_count (obj)) < 0)
+            goto out;
+        for (int i = 0; i < count; i++) {
+            const char *blobref = treeobj_get_blobref (obj, i);
+            if (!blobref
+                || json_array_append_new (blobrefs,
+                                          json_string (blobref)) < 0) {
+                errno = ENOMEM;
+                goto out;
+            }
+        }
+    }
+    rc = 0;
+out:
+    ERRNO_SAFE_WRAP (json_decref, obj);
+    return rc;
+}
+
+static void lookup_continuation (flux_future_t *f, void *arg)
+{
+    const struct idset *ranks = arg;
+    flux_t *h = flux_future_get_flux (f);
+    flux_future_t *f2 = NULL;
+    const char *name;
+    json_t *blobrefs;
+    char *s = NULL;
+
+    if (!(blobrefs = json_array ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    name = flux_future_first_child (f);
+    while (name) {
+        flux_future_t *child = flux_future_get_child (f, name);
+        const char *treeobj;
+
+        if (flux_kvs_lookup_get_treeobj (child, &treeobj) < 0
+            || append_blobrefs (blobrefs, treeobj) < 0)
+            goto error;
+        name = flux_future_next_child (f);
+    }
+    if (!(s = idset_encode (ranks, IDSET_FLAG_RANGE))
+        || !(f2 = flux_rpc_pack (h,
+                                 "content.preload",
+                                 FLUX_NODEID_ANY,
+                                 0,
+                                 "{s:s s:O}",
+                                 "ranks", s,
+                                 "blobrefs", blobrefs)))
+        goto error;
+    free (s);
+    json_decref (blobrefs);
+    flux_future_continue (f, f2);
+    flux_future_destroy (f);
+    return;
+error:
+    ERRNO_SAFE_WRAP (free, s);
+    ERRNO_SAFE_WRAP (json_decref, blobrefs);
+    flux_future_continue_error (f, errno, NULL);
+    flux_future_destroy (f);
+}
+
+static int push_lookup (flux_future_t *f, flux_t *h, const char *key)
+{
+    flux_future_t *f_lookup;
+
+    if (!(f_lookup = flux_kvs_lookup (h, NULL, FLUX_KVS_TREEOBJ, key))
+        || flux_future_push (f, key, f_lookup) < 0) {
+        flux_future_destroy (f_lookup);
+        return -1;
+    }
+    return 0;
+}
+
+flux_future_t *preload_job_data (flux_t *h,
+                                 flux_jobid_t id,
+                                 const struct idset *ranks)
+{
+    flux_future_t *f;
+    flux_future_t *f2;
+    char dir[128];
+    char key[128];
+
+    if (!h || !ranks) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (flux_job_kvs_key (dir, sizeof (dir), id, NULL) < 0
+        || !(f = flux_future_wait_all_create ()))
+        return NULL;
+    flux_future_set_flux (f, h);
+
+    /* Each prefix of the job directory path, e.g. "job", "job.0000", ...
+     */
+    for (char *p = dir; (p = strchr (p, '.')); p++) {
+        *p = '\0';
+        if (push_lookup (f, h, dir) < 0)
+            goto error;
+        *p = '.';
+    }
+    if (push_lookup (f, h, dir) < 0)
+        goto error;
+    for (int i = 0; job_keys[i] != NULL; i++) {
+        if (flux_job_kvs_key (key, sizeof (key), id, job_keys[i]) < 0
+            || push_lookup (f, h, key) < 0)
+            goto error;
+    }
+    if (!(f2 = flux_future_and_then (f, lookup_continuation, (void *)ranks)))
+        goto error;
+    return f2;
+error:
+    flux_future_destroy (f);
+    return NULL;
+}
+
+/* vi: ts=4 sw=4 expandtab
+ */
@@ -0,0 +1,29 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef HAVE_JOB_EXEC_PRELOAD_H
+#define HAVE_JOB_EXEC_PRELOAD_H 1
+
+#include <flux/core.h>
+#include <flux/idset.h>
+
+/* Prime the content cache of brokers 'ranks' with the KVS objects that
+ * job shells read at startup: the job directory and the directories
+ * leading to it, and the jobspec, J, R, and eventlog values.
+ * The returned future is fulfilled when all brokers have been primed.
+ */
+flux_future_t *preload_job_data (flux_t *h,
+                                 flux_jobid_t id,
+                                 const struct idset *ranks);
+
+#endif /* !HAVE_JOB_EXEC_PRELOAD_H */
+
+/* vi: ts=4 sw=4 expandtab
+ */
@@ -52,13 +52,17 @@ static void stats_cb (flux_t *h,
         return;
     }
 
-    int pending = zlistx_size (ctx->jsctx->pending);
-    int running = zlistx_size (ctx->jsctx->running);
-    int inactive = zlistx_size (ctx->jsctx->inactive);
+    int pending = sortlist_size (ctx->jsctx->pending);
+    int running = sortlist_size (ctx->jsctx->running);
+    int inactive = sortlist_size (ctx->jsctx->inactive);
     int idsync_lookups = zlistx_size (ctx->isctx->lookups);
     int idsync_waits = zhashx_size (ctx->isctx->waits);
     int stats_watchers = job_stats_watchers (ctx->jsctx->statsctx);
-    if (flux_respond_pack (h, msg, "{s:{s:i s:i s:i} s:{s:i s:i} s:i}",
+    json_t *index;
+
+    if (!(index = job_index_stats_get (ctx->jsctx->secondary)))
+        goto error;
+    if (flux_respond_pack (h, msg, "{s:{s:i s:i s:i} s:{s:i s:i} s:i s:o}",
                            "jobs",
                            "pending", pending,
                            "running", running,
@@ -66,7 +70,8 @@ static void stats_cb (flux_t *h,
                            "idsync",
                            "lookups", idsync_lookups,
                            "waits", idsync_waits,
-                           "stats_watchers", stats_watchers) < 0)
+                           "stats_watchers", stats_watchers,
+                           "index", index) < 0)
         flux_log_error (h, "error responding to stats-get request");
     return;
 error:
@@ -95,8 +100,9 @@ static void purge_cb (flux_t *h,
             if (job->state != FLUX_JOB_STATE_INACTIVE)
                 continue;
             job_stats_purge (ctx->jsctx->statsctx, job);
+            job_index_remove (ctx->jsctx->secondary, job);
             if (job->list_handle)
-                zlistx_delete (ctx->jsctx->inactive, job->list_handle);
+                sortlist_delete (ctx->jsctx->inactive, job->list_handle);
             zhashx_delete (ctx->jsctx->index, &id);
             count++;
         }
@@ -19,6 +19,8 @@
 #include "src/common/libutil/grudgeset.h"
 #include "src/common/libczmqcontainers/czmq_containers.h"
 
+#include "job_index.h"
+
 /* timestamp of when we enter the state
  *
  * associated eventlog entries when restarting
@@ -82,6 +84,7 @@ struct job {
     unsigned int states_mask;
     unsigned int states_events_mask;
     void *list_handle;
+    struct job_index_entry index;   /* secondary index membership */
 
     int submit_version;         /* version number in submit context */
 };
@@ -0,0 +1,341 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* job_index.c - secondary indexes on job attributes
+ *
+ * Each index maps a key to a bucket holding a sortlist of matching jobs
+ * per job list.  Buckets, and the lists within them, are created on
+ * demand and buckets are destroyed when they become empty, since some
+ * keys such as job names may be unique to one job.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <flux/core.h>
+
+#include "src/common/libczmqcontainers/czmq_containers.h"
+#include "ccan/str/str.h"
+
+#include "job_data.h"
+#include "job_index.h"
+
+#define NLISTS 3
+
+struct job_index_bucket {
+    char *key;
+    size_t count;
+    struct sortlist *lists[NLISTS];
+};
+
+struct job_index {
+    zhashx_t *hash[JOB_INDEX_COUNT];
+    sortlist_cmp_f cmp[NLISTS];
+    unsigned long queries[JOB_INDEX_COUNT + 1]; // last entry is scans
+};
+
+static const char *index_names[] = {
+    "userid",
+    "queue",
+    "name",
+    "result",
+};
+
+static void bucket_destroy (struct job_index_bucket *b)
+{
+    if (b) {
+        int saved_errno = errno;
+        for (int i = 0; i < NLISTS; i++)
+            sortlist_destroy (b->lists[i]);
+        free (b->key);
+        free (b);
+        errno = saved_errno;
+    }
+}
+
+// zhashx_destructor_fn signature
+static void bucket_destructor (void **item)
+{
+    if (item) {
+        bucket_destroy (*item);
+        *item = NULL;
+    }
+}
+
+static struct job_index_bucket *bucket_create (const char *key)
+{
+    struct job_index_bucket *b;
+
+    if (!(b = calloc (1, sizeof (*b)))
+        || !(b->key = strdup (key))) {
+        bucket_destroy (b);
+        errno = ENOMEM;
+        return NULL;
+    }
+    return b;
+}
+
+/* Return the key of 'job' in index 'type', or NULL if it has none.
+ */
+static const char *job_key (struct job *job,
+                            enum job_index_type type,
+                            char *buf,
+                            size_t size)
+{
+    switch (type) {
+        case JOB_INDEX_USERID:
+            snprintf (buf, size, "%u", (unsigned int)job->userid);
+            return buf;
+        case JOB_INDEX_QUEUE:
+            return job->queue;
+        case JOB_INDEX_NAME:
+            return job->name;
+        case JOB_INDEX_RESULT:
+            if (job->index.list != JOB_INDEX_LIST_INACTIVE)
+                return NULL;
+            snprintf (buf, size, "%d", (int)job->result);
+            return buf;
+        case JOB_INDEX_COUNT:
+            break;
+    }
+    return NULL;
+}
+
+static int ref_add (struct job_index *idx,
+                    struct job *job,
+                    enum job_index_type type)
+{
+    int l = job->index.list - 1;
+    struct job_index_bucket *b;
+    const char *key;
+    char buf[32];
+    void *handle;
+
+    if (!(key = job_key (job, type, buf, sizeof (buf))))
+        return 0;
+    if (!(b = zhashx_lookup (idx->hash[type], key))) {
+        if (!(b = bucket_create (key)))
+            return -1;
+        (void)zhashx_insert (idx->hash[type], b->key, b);
+    }
+    if ((!b->lists[l] && !(b->lists[l] = sortlist_create (idx->cmp[l])))
+        || !(handle = sortlist_insert (b->lists[l], job))) {
+        if (b->count == 0)
+            zhashx_delete (idx->hash[type], b->key);
+        errno = ENOMEM;
+        return -1;
+    }
+    b->count++;
+    job->index.refs[type].bucket = b;
+    job->index.refs[type].handle = handle;
+    return 0;
+}
+
+static void ref_remove (struct job_index *idx,
+                        struct job *job,
+                        enum job_index_type type)
+{
+    struct job_index_bucket *b = job->index.refs[type].bucket;
+
+    if (b) {
+        sortlist_delete (b->lists[job->index.list - 1],
+                         job->index.refs[type].handle);
+        if (--b->count == 0)
+            zhashx_delete (idx->hash[type], b->key);
+        job->index.refs[type].bucket = NULL;
+        job->index.refs[type].handle = NULL;
+    }
+}
+
+void job_index_remove (struct job_index *idx, struct job *job)
+{
+    if (idx && job && job->index.list != JOB_INDEX_LIST_NONE) {
+        for (int type = 0; type < JOB_INDEX_COUNT; type++)
+            ref_remove (idx, job, type);
+        job->index.list = JOB_INDEX_LIST_NONE;
+    }
+}
+
+int job_index_add (struct job_index *idx,
+                   struct job *job,
+                   enum job_index_list list)
+{
+    if (!idx
+        || !job
+        || job->index.list != JOB_INDEX_LIST_NONE
+        || list < JOB_INDEX_LIST_PENDING
+        || list > JOB_INDEX_LIST_INACTIVE) {
+        errno = EINVAL;
+        return -1;
+    }
+    job->index.list = list;
+    for (int type = 0; type < JOB_INDEX_COUNT; type++) {
+        if (ref_add (idx, job, type) < 0) {
+            int saved_errno = errno;
+            job_index_remove (idx, job);
+            errno = saved_errno;
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void job_index_reorder (struct job_index *idx, struct job *job)
+{
+    if (idx && job && job->index.list != JOB_INDEX_LIST_NONE) {
+        int l = job->index.list - 1;
+
+        for (int type = 0; type < JOB_INDEX_COUNT; type++) {
+            struct job_index_bucket *b = job->index.refs[type].bucket;
+            if (b)
+                sortlist_reorder (b->lists[l], job->index.refs[type].handle);
+        }
+    }
+}
+
+int job_index_update (struct job_index *idx, struct job *job)
+{
+    if (!idx || !job) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (job->index.list == JOB_INDEX_LIST_NONE)
+        return 0;
+    for (int type = 0; type < JOB_INDEX_COUNT; type++) {
+        struct job_index_bucket *b = job->index.refs[type].bucket;
+        const char *key;
+        char buf[32];
+
+        key = job_key (job, type, buf, sizeof (buf));
+        if ((!key && !b) || (key && b && streq (key, b->key)))
+            continue;
+        ref_remove (idx, job, type);
+        if (ref_add (idx, job, type) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+static struct job_index_bucket *bucket_lookup (struct job_index *idx,
+                                               enum job_index_type type,
+                                               const char *key)
+{
+    if (!idx || type < 0 || type >= JOB_INDEX_COUNT || !key)
+        return NULL;
+    return zhashx_lookup (idx->hash[type], key);
+}
+
+struct sortlist *job_index_lookup (struct job_index *idx,
+                                   enum job_index_type type,
+                                   const char *key,
+                                   enum job_index_list list)
+{
+    struct job_index_bucket *b;
+
+    if (list < JOB_INDEX_LIST_PENDING
+        || list > JOB_INDEX_LIST_INACTIVE
+        || !(b = bucket_lookup (idx, type, key)))
+        return NULL;
+    return b->lists[list - 1];
+}
+
+size_t job_index_count (struct job_index *idx,
+                        enum job_index_type type,
+                        const char *key)
+{
+    struct job_index_bucket *b;
+
+    if (!(b = bucket_lookup (idx, type, key)))
+        return 0;
+    return b->count;
+}
+
+void job_index_note_query (struct job_index *idx, enum job_index_type type)
+{
+    if (idx && type >= 0 && type <= JOB_INDEX_COUNT)
+        idx->queries[type]++;
+}
+
+json_t *job_index_stats_get (struct job_index *idx)
+{
+    json_int_t scans;
+    json_t *o;
+
+    if (!idx || !(o = json_object ()))
+        goto nomem;
+    for (int type = 0; type < JOB_INDEX_COUNT; type++) {
+        json_t *entry;
+
+        if (!(entry = json_pack ("{s:I s:I}",
+                                 "keys",
+                                 (json_int_t)zhashx_size (idx->hash[type]),
+                                 "queries",
+                                 (json_int_t)idx->queries[type]))
+            || json_object_set_new (o, index_names[type], entry) < 0) {
+            json_decref (entry);
+            json_decref (o);
+            goto nomem;
+        }
+    }
+    scans = idx->queries[JOB_INDEX_COUNT];
+    if (json_object_set_new (o, "scans", json_integer (scans)) < 0) {
+        json_decref (o);
+        goto nomem;
+    }
+    return o;
+nomem:
+    errno = ENOMEM;
+    return NULL;
+}
+
+void job_index_destroy (struct job_index *idx)
+{
+    if (idx) {
+        int saved_errno = errno;
+        for (int type = 0; type < JOB_INDEX_COUNT; type++)
+            zhashx_destroy (&idx->hash[type]);
+        free (idx);
+        errno = saved_errno;
+    }
+}
+
+struct job_index *job_index_create (sortlist_cmp_f pending_cmp,
+                                    sortlist_cmp_f running_cmp,
+                                    sortlist_cmp_f inactive_cmp)
+{
+    struct job_index *idx;
+
+    if (!(idx = calloc (1, sizeof (*idx))))
+        goto nomem;
+    idx->cmp[JOB_INDEX_LIST_PENDING - 1] = pending_cmp;
+    idx->cmp[JOB_INDEX_LIST_RUNNING - 1] = running_cmp;
+    idx->cmp[JOB_INDEX_LIST_INACTIVE - 1] = inactive_cmp;
+    for (int type = 0; type < JOB_INDEX_COUNT; type++) {
+        if (!(idx->hash[type] = zhashx_new ()))
+            goto nomem;
+        /* buckets own their keys */
+        zhashx_set_key_duplicator (idx->hash[type], NULL);
+        zhashx_set_key_destructor (idx->hash[type], NULL);
+        zhashx_set_destructor (idx->hash[type], bucket_destructor);
+    }
+    return idx;
+nomem:
+    job_index_destroy (idx);
+    errno = ENOMEM;
+    return NULL;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
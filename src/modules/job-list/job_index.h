@@ -0,0 +1,107 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _FLUX_JOB_LIST_JOB_INDEX_H
+#define _FLUX_JOB_LIST_JOB_INDEX_H
+
+#include <stddef.h>
+#include <jansson.h>
+
+#include "sortlist.h"
+
+/* Secondary indexes on job attributes.  For each key, an index holds the
+ * jobs having that key on pending, running, and inactive lists sorted the
+ * same way as the main job lists, so that a query may iterate over only
+ * the jobs with a given key and return them in the usual order.
+ *
+ * Keys are strings.  Userids are formatted as "%u" and results as "%d".
+ * Results are only indexed for inactive jobs.
+ */
+enum job_index_type {
+    JOB_INDEX_USERID = 0,
+    JOB_INDEX_QUEUE,
+    JOB_INDEX_NAME,
+    JOB_INDEX_RESULT,
+    JOB_INDEX_COUNT,
+};
+
+enum job_index_list {
+    JOB_INDEX_LIST_NONE = 0,
+    JOB_INDEX_LIST_PENDING,
+    JOB_INDEX_LIST_RUNNING,
+    JOB_INDEX_LIST_INACTIVE,
+};
+
+/* Per-job index membership, embedded in struct job.
+ */
+struct job_index_entry {
+    enum job_index_list list;
+    struct {
+        struct job_index_bucket *bucket;
+        void *handle;
+    } refs[JOB_INDEX_COUNT];
+};
+
+struct job;
+
+/* Create indexes whose lists are sorted like the main job lists.
+ */
+struct job_index *job_index_create (sortlist_cmp_f pending_cmp,
+                                    sortlist_cmp_f running_cmp,
+                                    sortlist_cmp_f inactive_cmp);
+void job_index_destroy (struct job_index *idx);
+
+/* Index 'job' under its current keys as a member of job list 'list'.
+ * Must be called when the job is added to a job list.
+ */
+int job_index_add (struct job_index *idx,
+                   struct job *job,
+                   enum job_index_list list);
+
+/* Remove 'job' from all indexes.  Must be called when the job is removed
+ * from a job list.
+ */
+void job_index_remove (struct job_index *idx, struct job *job);
+
+/* Re-sort 'job' after its job list sort key has changed.
+ */
+void job_index_reorder (struct job_index *idx, struct job *job);
+
+/* Re-index 'job' after an indexed attribute such as the queue or name
+ * has changed.
+ */
+int job_index_update (struct job_index *idx, struct job *job);
+
+/* Return the list of jobs on job list 'list' with key 'key' in index
+ * 'type', or NULL if there are none.
+ */
+struct sortlist *job_index_lookup (struct job_index *idx,
+                                   enum job_index_type type,
+                                   const char *key,
+                                   enum job_index_list list);
+
+/* Return the number of jobs with key 'key' in index 'type'.
+ */
+size_t job_index_count (struct job_index *idx,
+                        enum job_index_type type,
+                        const char *key);
+
+/* Count a query that used index 'type', or a full scan if type is
+ * JOB_INDEX_COUNT, for reporting by job_index_stats_get().
+ */
+void job_index_note_query (struct job_index *idx, enum job_index_type type);
+
+json_t *job_index_stats_get (struct job_index *idx);
+
+#endif /* ! _FLUX_JOB_LIST_JOB_INDEX_H */
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
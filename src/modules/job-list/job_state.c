@@ -78,7 +78,7 @@ static void update_jobspec (struct job_state_ctx *jsctx,
                             bool update_stats);
 
 /* Compare items for sorting in list, priority first (higher priority
- * before lower priority), job id second N.B. zlistx_comparator_fn signature
+ * before lower priority), job id second N.B. sortlist_cmp_f signature
  */
 static int job_urgency_cmp (const void *a1, const void *a2)
 {
@@ -93,8 +93,7 @@ static int job_urgency_cmp (const void *a1, const void *a2)
 
 /* Compare items for sorting in list by timestamp (note that sorting
  * is in reverse order, most recently (i.e. bigger timestamp)
- * running/completed comes first).  N.B. zlistx_comparator_fn
- * signature
+ * running/completed comes first).  N.B. sortlist_cmp_f signature
  */
 static int job_running_cmp (const void *a1, const void *a2)
 {
@@ -118,20 +117,6 @@ static void job_destroy_wrapper (void **data)
     job_destroy (*job);
 }
 
-/* zlistx_insert() and zlistx_reorder() take a 'low_value' parameter
- * which indicates which end of the list to search from.
- * false=search begins at tail (lowest urgency, youngest)
- * true=search begins at head (highest urgency, oldest)
- * Attempt to minimize search distance based on job urgency.
- */
-static bool search_direction (struct job *job)
-{
-    if (job->priority > (FLUX_JOB_PRIORITY_MAX / 2))
-        return true;
-    else
-        return false;
-}
-
 static void set_submit_timestamp (struct job *job, double timestamp)
 {
     job->t_submit = timestamp;
@@ -160,43 +145,46 @@ static int job_insert_list (struct job_state_ctx *jsctx,
                             struct job *job,
                             flux_job_state_t newstate)
 {
+    struct sortlist *list;
+    enum job_index_list index_list;
+
     if (newstate == FLUX_JOB_STATE_DEPEND
         || newstate == FLUX_JOB_STATE_PRIORITY
         || newstate == FLUX_JOB_STATE_SCHED) {
-        if (!(job->list_handle = zlistx_insert (jsctx->pending,
-                                                job,
-                                                search_direction (job))))
-            goto enomem;
+        list = jsctx->pending;
+        index_list = JOB_INDEX_LIST_PENDING;
     }
     else if (newstate == FLUX_JOB_STATE_RUN
              || newstate == FLUX_JOB_STATE_CLEANUP) {
-        if (!(job->list_handle = zlistx_insert (jsctx->running, job, true)))
-            goto enomem;
+        list = jsctx->running;
+        index_list = JOB_INDEX_LIST_RUNNING;
     }
     else { /* newstate == FLUX_JOB_STATE_INACTIVE */
-        if (!(job->list_handle = zlistx_insert (jsctx->inactive, job, true)))
-            goto enomem;
+        list = jsctx->inactive;
+        index_list = JOB_INDEX_LIST_INACTIVE;
     }
 
+    if (!(job->list_handle = sortlist_insert (list, job)))
+        return -1;
+    if (job_index_add (jsctx->secondary, job, index_list) < 0) {
+        int saved_errno = errno;
+        sortlist_delete (list, job->list_handle);
+        job->list_handle = NULL;
+        errno = saved_errno;
+        return -1;
+    }
     return 0;
-
-enomem:
-    errno = ENOMEM;
-    return -1;
 }
 
 /* remove job from one list and move it to another based on the
  * newstate */
 static void job_change_list (struct job_state_ctx *jsctx,
                              struct job *job,
-                             zlistx_t *oldlist,
+                             struct sortlist *oldlist,
                              flux_job_state_t newstate)
 {
-    if (zlistx_detach (oldlist, job->list_handle) < 0)
-        flux_log (jsctx->h,
-                  LOG_ERR,
-                  "%s: zlistx_detach: out of memory",
-                  __FUNCTION__);
+    job_index_remove (jsctx->secondary, job);
+    sortlist_delete (oldlist, job->list_handle);
     job->list_handle = NULL;
 
     if (job_insert_list (jsctx, job, newstate) < 0)
@@ -205,7 +193,8 @@ static void job_change_list (struct job_state_ctx *jsctx,
                         flux_job_statetostr (newstate, "L"));
 }
 
-static zlistx_t *get_list (struct job_state_ctx *jsctx, flux_job_state_t state)
+static struct sortlist *get_list (struct job_state_ctx *jsctx,
+                                  flux_job_state_t state)
 {
     if (state == FLUX_JOB_STATE_NEW)
         return jsctx->processing;
@@ -225,7 +214,7 @@ static void update_job_state_and_list (struct job_state_ctx *jsctx,
                                        flux_job_state_t newstate,
                                        double timestamp)
 {
-    zlistx_t *oldlist, *newlist;
+    struct sortlist *oldlist, *newlist;
 
     oldlist = get_list (jsctx, job->state);
     newlist = get_list (jsctx, newstate);
@@ -242,10 +231,10 @@ static void update_job_state_and_list (struct job_state_ctx *jsctx,
     if (oldlist != newlist)
         job_change_list (jsctx, job, oldlist, newstate);
     else if (oldlist == jsctx->pending
-             && newstate == FLUX_JOB_STATE_SCHED)
-        zlistx_reorder (jsctx->pending,
-                        job->list_handle,
-                        search_direction (job));
+             && newstate == FLUX_JOB_STATE_SCHED) {
+        sortlist_reorder (jsctx->pending, job->list_handle);
+        job_index_reorder (jsctx->secondary, job);
+    }
 
     idsync_check_waiting_id (jsctx->ctx->isctx, job);
 }
@@ -340,6 +329,12 @@ static void update_jobspec (struct job_state_ctx *jsctx,
 
     job_jobspec_update (job, context);
 
+    /* the queue or job name may have changed */
+    if (job_index_update (jsctx->secondary, job) < 0)
+        flux_log_error (jsctx->h,
+                        "%s: error updating job index",
+                        idf58 (job->id));
+
     if (update_stats)
         job_stats_add_queue (jsctx->statsctx, job);
 }
@@ -501,10 +496,8 @@ static int journal_submit_event (struct job_state_ctx *jsctx,
             return -1;
         }
         /* job always starts off on processing list */
-        if (!(job->list_handle = zlistx_add_end (jsctx->processing, job))) {
-            errno = ENOMEM;
+        if (!(job->list_handle = sortlist_insert (jsctx->processing, job)))
             return -1;
-        }
     }
 
     if (submit_context_parse (jsctx->h, job, context) < 0)
@@ -541,10 +534,10 @@ static int journal_priority_event (struct job_state_ctx *jsctx,
         return -1;
 
     if (job->state & FLUX_JOB_STATE_PENDING
-        && job->priority != orig_priority)
-        zlistx_reorder (jsctx->pending,
-                        job->list_handle,
-                        search_direction (job));
+        && job->priority != orig_priority) {
+        sortlist_reorder (jsctx->pending, job->list_handle);
+        job_index_reorder (jsctx->secondary, job);
+    }
 
     return job_transition_state (jsctx,
                                  job,
@@ -865,7 +858,7 @@ static int journal_process_event (struct job_state_ctx *jsctx,
      */
     if (job && streq (name, "invalidate")) {
         if (job->list_handle) {
-            zlistx_detach (jsctx->processing, job->list_handle);
+            sortlist_delete (jsctx->processing, job->list_handle);
             job->list_handle = NULL;
         }
         zhashx_delete (jsctx->index, &job->id);
@@ -1127,19 +1120,13 @@ struct job_state_ctx *job_state_create (struct list_ctx *ctx)
         goto error;
     zhashx_set_destructor (jsctx->index, job_destroy_wrapper);
 
-    if (!(jsctx->pending = zlistx_new ()))
-        goto error;
-    zlistx_set_comparator (jsctx->pending, job_urgency_cmp);
-
-    if (!(jsctx->running = zlistx_new ()))
-        goto error;
-    zlistx_set_comparator (jsctx->running, job_running_cmp);
-
-    if (!(jsctx->inactive = zlistx_new ()))
-        goto error;
-    zlistx_set_comparator (jsctx->inactive, job_inactive_cmp);
-
-    if (!(jsctx->processing = zlistx_new ()))
+    if (!(jsctx->pending = sortlist_create (job_urgency_cmp))
+        || !(jsctx->running = sortlist_create (job_running_cmp))
+        || !(jsctx->inactive = sortlist_create (job_inactive_cmp))
+        || !(jsctx->processing = sortlist_create (NULL))
+        || !(jsctx->secondary = job_index_create (job_urgency_cmp,
+                                                  job_running_cmp,
+                                                  job_inactive_cmp)))
         goto error;
 
     if (!(jsctx->statsctx = job_stats_ctx_create (jsctx->h)))
@@ -1165,10 +1152,11 @@ void job_state_destroy (void *data)
         int saved_errno = errno;
         /* Destroy index last, as it is the one that will actually
          * destroy the job objects */
-        zlistx_destroy (&jsctx->processing);
-        zlistx_destroy (&jsctx->inactive);
-        zlistx_destroy (&jsctx->running);
-        zlistx_destroy (&jsctx->pending);
+        sortlist_destroy (jsctx->processing);
+        sortlist_destroy (jsctx->inactive);
+        sortlist_destroy (jsctx->running);
+        sortlist_destroy (jsctx->pending);
+        job_index_destroy (jsctx->secondary);
         zhashx_destroy (&jsctx->index);
         job_stats_ctx_destroy (jsctx->statsctx);
         flux_msglist_destroy (jsctx->backlog);
@@ -18,6 +18,8 @@
 
 #include "idsync.h"
 #include "stats.h"
+#include "sortlist.h"
+#include "job_index.h"
 
 /* To handle the common case of user queries on job state, we will
  * store jobs in three different lists.
@@ -34,6 +36,10 @@
  *
  * There is also an additional list `processing` that stores jobs that
  * cannot yet be stored on one of the lists above.
+ *
+ * Jobs on the pending, running, and inactive lists are also indexed by
+ * userid, queue, name, and result in 'secondary', so that queries with
+ * those constraints need not scan the full lists.
  */
 
 struct job_state_ctx {
@@ -41,10 +47,11 @@ struct job_state_ctx {
     struct list_ctx *ctx;
 
     zhashx_t *index;
-    zlistx_t *pending;
-    zlistx_t *running;
-    zlistx_t *inactive;
-    zlistx_t *processing;
+    struct sortlist *pending;
+    struct sortlist *running;
+    struct sortlist *inactive;
+    struct sortlist *processing;
+    struct job_index *secondary;
 
     /*  Job statistics: */
     struct job_stats_ctx *statsctx;
@@ -39,22 +39,30 @@ json_t *get_job_by_id (struct job_state_ctx *jsctx,
                        bool *stall);
 
 /* Put jobs from list onto jobs array, breaking if max_entries has
- * been reached. Returns 1 if jobs array is full, 0 if continue, -1
- * one error with errno set:
+ * been reached. If 'plan' is non-NULL, 'list' is sorted by t_inactive
+ * and iteration is limited to the t_inactive bounds in the plan.
+ * Returns 1 if jobs array is full, 0 if continue, -1 one error with
+ * errno set:
  *
  * ENOMEM - out of memory
  */
 int get_jobs_from_list (json_t *jobs,
                         flux_error_t *errp,
-                        zlistx_t *list,
+                        struct sortlist *list,
                         int max_entries,
                         json_t *attrs,
                         double since,
+                        const struct list_plan *plan,
                         struct list_constraint *c)
 {
     struct job *job;
 
-    job = zlistx_first (list);
+    if (plan && plan->t_inactive_max_set) {
+        struct job key = { .t_inactive = plan->t_inactive_max };
+        job = sortlist_seek (list, &key);
+    }
+    else
+        job = sortlist_first (list);
     while (job) {
         int ret;
 
@@ -68,6 +76,11 @@ int get_jobs_from_list (json_t *jobs,
          */
         if (job->t_inactive > 0. && job->t_inactive <= since)
             break;
+        if (plan
+            && (job->t_inactive < plan->t_inactive_min
+                || (job->t_inactive == plan->t_inactive_min
+                    && !plan->t_inactive_min_inclusive)))
+            break;
 
         if ((ret = job_match (job, c, errp)) < 0)
             return -1;
@@ -83,12 +96,34 @@ int get_jobs_from_list (json_t *jobs,
             if (json_array_size (jobs) == max_entries)
                 return 1;
         }
-        job = zlistx_next (list);
+        job = sortlist_next (list);
     }
 
     return 0;
 }
 
+/* list_plan_cost_f signature */
+static size_t plan_cost (enum job_index_type type, const char *key, void *arg)
+{
+    return job_index_count (arg, type, key);
+}
+
+/* Return the list to search for jobs on job list 'which' (one of
+ * jsctx->pending, running, or inactive) according to 'plan'.
+ */
+static struct sortlist *plan_list (struct job_state_ctx *jsctx,
+                                   const struct list_plan *plan,
+                                   struct sortlist *which,
+                                   enum job_index_list index_list)
+{
+    if (plan->index == JOB_INDEX_COUNT)
+        return which;
+    return job_index_lookup (jsctx->secondary,
+                             plan->index,
+                             plan->key,
+                             index_list);
+}
+
 /* Create a JSON array of 'job' objects.  'max_entries' determines the
  * max number of jobs to return, 0=unlimited. 'since' limits jobs returned
  * to those with t_inactive greater than timestamp.  Returns JSON object
@@ -106,34 +141,51 @@ json_t *get_jobs (struct job_state_ctx *jsctx,
                   struct state_constraint *statec)
 {
     json_t *jobs = NULL;
+    struct list_plan plan;
     int saved_errno;
     int ret = 0;
 
     if (!(jobs = json_array ()))
         goto error_nomem;
 
+    /* Use a secondary index to avoid scanning all jobs if possible.
+     * Jobs found are still checked against the full constraint.
+     */
+    list_constraint_plan (c, plan_cost, jsctx->secondary, &plan);
+    job_index_note_query (jsctx->secondary, plan.index);
+
     /* We return jobs in the following order, pending, running,
      * inactive */
 
-    if (state_match (FLUX_JOB_STATE_PENDING, statec)) {
+    if (!plan.inactive_only
+        && state_match (FLUX_JOB_STATE_PENDING, statec)) {
         if ((ret = get_jobs_from_list (jobs,
                                        errp,
-                                       jsctx->pending,
+                                       plan_list (jsctx,
+                                                  &plan,
+                                                  jsctx->pending,
+                                                  JOB_INDEX_LIST_PENDING),
                                        max_entries,
                                        attrs,
                                        0.,
+                                       NULL,
                                        c)) < 0)
             goto error;
     }
 
-    if (state_match (FLUX_JOB_STATE_RUNNING, statec)) {
+    if (!plan.inactive_only
+        && state_match (FLUX_JOB_STATE_RUNNING, statec)) {
         if (!ret) {
             if ((ret = get_jobs_from_list (jobs,
                                            errp,
-                                           jsctx->running,
+                                           plan_list (jsctx,
+                                                      &plan,
+                                                      jsctx->running,
+                                                      JOB_INDEX_LIST_RUNNING),
                                            max_entries,
                                            attrs,
                                            0.,
+                                           NULL,
                                            c)) < 0)
                 goto error;
         }
@@ -143,10 +195,14 @@ json_t *get_jobs (struct job_state_ctx *jsctx,
         if (!ret) {
             if ((ret = get_jobs_from_list (jobs,
                                            errp,
-                                           jsctx->inactive,
+                                           plan_list (jsctx,
+                                                      &plan,
+                                                      jsctx->inactive,
+                                                      JOB_INDEX_LIST_INACTIVE),
                                            max_entries,
                                            attrs,
                                            since,
+                                           &plan,
                                            c)) < 0)
                 goto error;
         }
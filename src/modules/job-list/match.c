@@ -12,6 +12,7 @@
 #include "config.h"
 #endif
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
@@ -872,6 +873,122 @@ int job_match (const struct job *job,
     return constraint->match (constraint, job, &constraint->comparisons, errp);
 }
 
+static void plan_candidate (struct list_plan *plan,
+                            enum job_index_type type,
+                            const char *key,
+                            bool key_is_temporary,
+                            list_plan_cost_f cost,
+                            void *arg,
+                            size_t *best)
+{
+    size_t n = cost (type, key, arg);
+
+    if (plan->index == JOB_INDEX_COUNT || n < *best) {
+        plan->index = type;
+        if (key_is_temporary) {
+            snprintf (plan->keybuf, sizeof (plan->keybuf), "%s", key);
+            plan->key = plan->keybuf;
+        }
+        else
+            plan->key = key;
+        *best = n;
+    }
+}
+
+static void plan_t_inactive (struct list_plan *plan,
+                             struct timestamp_value *tv)
+{
+    plan->inactive_only = true;
+    if (tv->t_comp == MATCH_GREATER_THAN_EQUAL
+        || tv->t_comp == MATCH_GREATER_THAN) {
+        bool inclusive = (tv->t_comp == MATCH_GREATER_THAN_EQUAL);
+        if (tv->t_value > plan->t_inactive_min
+            || (tv->t_value == plan->t_inactive_min && !inclusive)) {
+            plan->t_inactive_min = tv->t_value;
+            plan->t_inactive_min_inclusive = inclusive;
+        }
+    }
+    else {
+        if (!plan->t_inactive_max_set
+            || tv->t_value < plan->t_inactive_max) {
+            plan->t_inactive_max = tv->t_value;
+            plan->t_inactive_max_set = true;
+        }
+    }
+}
+
+static void plan_constraint (struct list_constraint *c,
+                             list_plan_cost_f cost,
+                             void *arg,
+                             struct list_plan *plan,
+                             size_t *best)
+{
+    char buf[32];
+
+    if (c->match == match_and) {
+        struct list_constraint *cp = zlistx_first (c->values);
+        while (cp) {
+            plan_constraint (cp, cost, arg, plan, best);
+            cp = zlistx_next (c->values);
+        }
+        return;
+    }
+    if (c->match == match_results) {
+        int *results = zlistx_first (c->values);
+        plan->inactive_only = true;
+        if (*results != 0 && (*results & (*results - 1)) == 0) {
+            snprintf (buf, sizeof (buf), "%d", *results);
+            plan_candidate (plan, JOB_INDEX_RESULT, buf, true, cost, arg, best);
+        }
+        return;
+    }
+    if (c->match == match_timestamp) {
+        struct timestamp_value *tv = zlistx_first (c->values);
+        if (tv->t_type == MATCH_T_INACTIVE)
+            plan_t_inactive (plan, tv);
+        return;
+    }
+    if (zlistx_size (c->values) != 1)
+        return;
+    if (c->match == match_userid) {
+        uint32_t *userid = zlistx_first (c->values);
+        if (*userid != FLUX_USERID_UNKNOWN) {
+            snprintf (buf, sizeof (buf), "%u", (unsigned int)*userid);
+            plan_candidate (plan, JOB_INDEX_USERID, buf, true, cost, arg, best);
+        }
+    }
+    else if (c->match == match_queue)
+        plan_candidate (plan,
+                        JOB_INDEX_QUEUE,
+                        zlistx_first (c->values),
+                        false,
+                        cost,
+                        arg,
+                        best);
+    else if (c->match == match_name)
+        plan_candidate (plan,
+                        JOB_INDEX_NAME,
+                        zlistx_first (c->values),
+                        false,
+                        cost,
+                        arg,
+                        best);
+}
+
+void list_constraint_plan (struct list_constraint *constraint,
+                           list_plan_cost_f cost,
+                           void *arg,
+                           struct list_plan *plan)
+{
+    size_t best = 0;
+
+    memset (plan, 0, sizeof (*plan));
+    plan->index = JOB_INDEX_COUNT;
+    plan->t_inactive_min_inclusive = true;
+    if (constraint && cost)
+        plan_constraint (constraint, cost, arg, plan, &best);
+}
+
 static int config_parse_max_comparisons (struct match_ctx *mctx,
                                          const flux_conf_t *conf,
                                          flux_error_t *errp)
@@ -50,6 +50,39 @@ int job_match (const struct job *job,
                struct list_constraint *constraint,
                flux_error_t *errp);
 
+/*  A plan for finding the jobs matching a list constraint.  If 'index' is
+ *  not JOB_INDEX_COUNT, only jobs with 'key' in that index can match.  If
+ *  'inactive_only' is true, only inactive jobs can match, and then only
+ *  those with t_inactive between the given bounds.  Jobs found this way
+ *  must still be checked with job_match().
+ */
+struct list_plan {
+    enum job_index_type index;
+    const char *key;
+    char keybuf[32];
+    bool inactive_only;
+    double t_inactive_min;
+    bool t_inactive_min_inclusive;
+    double t_inactive_max;      // inclusive, if t_inactive_max_set
+    bool t_inactive_max_set;
+};
+
+/*  Return the number of jobs with 'key' in index 'type'.
+ */
+typedef size_t (*list_plan_cost_f)(enum job_index_type type,
+                                   const char *key,
+                                   void *arg);
+
+/*  Fill in 'plan' for 'constraint'.  Of the single-valued userid, queue,
+ *  name, and results terms that must all match (i.e. the constraint or
+ *  the terms of its top level "and"), the one with the fewest jobs as
+ *  reported by 'cost' is chosen to drive the search.
+ */
+void list_constraint_plan (struct list_constraint *constraint,
+                           list_plan_cost_f cost,
+                           void *arg,
+                           struct list_plan *plan);
+
 int job_match_config_reload (struct match_ctx *mctx,
                              const flux_conf_t *conf,
                              flux_error_t *errp);
@@ -0,0 +1,237 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* sortlist.c - sorted job list
+ *
+ * The pending, running, and inactive job lists were sorted zlistx lists,
+ * which cost O(n) per insert or reorder.  With many jobs retained, moving
+ * a job between lists or reprioritizing it became expensive.
+ *
+ * This is a skip list:  a sorted linked list in which each node is also
+ * linked into a random number of sparser "express" lists above it, so that
+ * a search skips most of the list.  Nodes are doubly linked at every level,
+ * so a node may be unlinked without searching for it, which is required
+ * since a job's sort key may already have changed when it is moved.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdlib.h>
+#include <stdint.h>
+#include <errno.h>
+
+#include "sortlist.h"
+
+/* With one in four nodes promoted to each next level, 16 levels keeps
+ * searches logarithmic for far more jobs than job-list will hold.
+ */
+#define MAX_LEVEL 16
+
+struct link {
+    struct node *prev;
+    struct node *next;
+};
+
+struct node {
+    void *item;
+    int level;
+    struct link links[];
+};
+
+struct sortlist {
+    sortlist_cmp_f cmp;
+    size_t size;
+    int level;                  // highest level in use
+    uint32_t seed;
+    struct node *cursor;
+    struct node *head;          // sentinel with MAX_LEVEL links
+};
+
+/* xorshift32 - deterministic, so benchmarks are repeatable.
+ */
+static int random_level (struct sortlist *sl)
+{
+    uint32_t x = sl->seed;
+    int level = 1;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    sl->seed = x;
+    while (level < MAX_LEVEL && (x & 3) == 0) {
+        level++;
+        x >>= 2;
+    }
+    return level;
+}
+
+static void node_unlink (struct sortlist *sl, struct node *n)
+{
+    for (int i = 0; i < n->level; i++) {
+        struct node *prev = n->links[i].prev;
+        struct node *next = n->links[i].next;
+
+        prev->links[i].next = next;
+        if (next)
+            next->links[i].prev = prev;
+    }
+    while (sl->level > 1 && !sl->head->links[sl->level - 1].next)
+        sl->level--;
+}
+
+static void node_link (struct sortlist *sl, struct node *n)
+{
+    struct node *update[MAX_LEVEL];
+    struct node *x = sl->head;
+
+    for (int i = sl->level - 1; i >= 0; i--) {
+        if (sl->cmp) {
+            while (x->links[i].next
+                   && sl->cmp (x->links[i].next->item, n->item) < 0)
+                x = x->links[i].next;
+        }
+        update[i] = x;
+    }
+    for (int i = sl->level; i < n->level; i++)
+        update[i] = sl->head;
+    if (sl->level < n->level)
+        sl->level = n->level;
+    for (int i = 0; i < n->level; i++) {
+        struct node *next = update[i]->links[i].next;
+
+        n->links[i].prev = update[i];
+        n->links[i].next = next;
+        if (next)
+            next->links[i].prev = n;
+        update[i]->links[i].next = n;
+    }
+}
+
+void *sortlist_insert (struct sortlist *sl, void *item)
+{
+    struct node *n;
+    int level;
+
+    if (!sl) {
+        errno = EINVAL;
+        return NULL;
+    }
+    level = random_level (sl);
+    if (!(n = calloc (1, sizeof (*n) + sizeof (n->links[0]) * level)))
+        return NULL;
+    n->item = item;
+    n->level = level;
+    node_link (sl, n);
+    sl->size++;
+    return n;
+}
+
+void sortlist_delete (struct sortlist *sl, void *handle)
+{
+    struct node *n = handle;
+
+    if (sl && n) {
+        if (sl->cursor == n)
+            sl->cursor = n->links[0].prev;
+        node_unlink (sl, n);
+        sl->size--;
+        free (n);
+    }
+}
+
+void sortlist_reorder (struct sortlist *sl, void *handle)
+{
+    struct node *n = handle;
+
+    if (sl && n && sl->cmp) {
+        if (sl->cursor == n)
+            sl->cursor = n->links[0].prev;
+        node_unlink (sl, n);
+        node_link (sl, n);
+    }
+}
+
+size_t sortlist_size (struct sortlist *sl)
+{
+    return sl ? sl->size : 0;
+}
+
+void *sortlist_first (struct sortlist *sl)
+{
+    if (!sl)
+        return NULL;
+    sl->cursor = sl->head->links[0].next;
+    return sl->cursor ? sl->cursor->item : NULL;
+}
+
+void *sortlist_next (struct sortlist *sl)
+{
+    if (!sl || !sl->cursor)
+        return NULL;
+    sl->cursor = sl->cursor->links[0].next;
+    return sl->cursor ? sl->cursor->item : NULL;
+}
+
+void *sortlist_seek (struct sortlist *sl, const void *key)
+{
+    struct node *x;
+
+    if (!sl)
+        return NULL;
+    x = sl->head;
+    if (sl->cmp) {
+        for (int i = sl->level - 1; i >= 0; i--) {
+            while (x->links[i].next
+                   && sl->cmp (x->links[i].next->item, key) < 0)
+                x = x->links[i].next;
+        }
+    }
+    sl->cursor = x->links[0].next;
+    return sl->cursor ? sl->cursor->item : NULL;
+}
+
+void sortlist_destroy (struct sortlist *sl)
+{
+    if (sl) {
+        int saved_errno = errno;
+        struct node *n = sl->head ? sl->head->links[0].next : NULL;
+        while (n) {
+            struct node *next = n->links[0].next;
+            free (n);
+            n = next;
+        }
+        free (sl->head);
+        free (sl);
+        errno = saved_errno;
+    }
+}
+
+struct sortlist *sortlist_create (sortlist_cmp_f cmp)
+{
+    struct sortlist *sl;
+    size_t headsize = sizeof (struct node) + sizeof (struct link) * MAX_LEVEL;
+
+    if (!(sl = calloc (1, sizeof (*sl)))
+        || !(sl->head = calloc (1, headsize))) {
+        sortlist_destroy (sl);
+        errno = ENOMEM;
+        return NULL;
+    }
+    sl->cmp = cmp;
+    sl->level = 1;
+    sl->seed = 2463534242;
+    sl->head->level = MAX_LEVEL;
+    return sl;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -0,0 +1,67 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _FLUX_JOB_LIST_SORTLIST_H
+#define _FLUX_JOB_LIST_SORTLIST_H
+
+#include <stddef.h>
+
+/* Return <0, 0, or >0 if item 'a' sorts before, equal to, or after 'b'.
+ * N.B. same signature as zlistx_comparator_fn.
+ */
+typedef int (*sortlist_cmp_f)(const void *a, const void *b);
+
+/* Create a list kept sorted by 'cmp'.  If 'cmp' is NULL the list is
+ * unordered and items are inserted at the front.
+ */
+struct sortlist *sortlist_create (sortlist_cmp_f cmp);
+
+/* Destroy the list.  Items are not destroyed.
+ */
+void sortlist_destroy (struct sortlist *sl);
+
+/* Insert 'item' in sorted position, before any items that compare equal,
+ * in O(log n).  Returns a handle for sortlist_delete()/sortlist_reorder(),
+ * or NULL on failure with errno set.
+ */
+void *sortlist_insert (struct sortlist *sl, void *item);
+
+/* Remove the item referred to by 'handle' in O(log n).  The handle is
+ * invalid afterwards.  The item need not compare the same way it did on
+ * insertion, so the item's sort key may be updated before removal.
+ */
+void sortlist_delete (struct sortlist *sl, void *handle);
+
+/* Move the item referred to by 'handle' to its sorted position after its
+ * sort key has changed, in O(log n).  The handle remains valid.
+ */
+void sortlist_reorder (struct sortlist *sl, void *handle);
+
+size_t sortlist_size (struct sortlist *sl);
+
+/* Iterate over items in sorted order.  sortlist_first() returns the first
+ * item or NULL if the list is empty, sortlist_next() returns the item after
+ * the last one returned, or NULL at the end.  The item most recently
+ * returned may be deleted without disturbing the iteration.
+ */
+void *sortlist_first (struct sortlist *sl);
+void *sortlist_next (struct sortlist *sl);
+
+/* Like sortlist_first(), but start at the first item that does not sort
+ * before 'key', found in O(log n).  'key' is passed to the comparator in
+ * place of an item, so it need only have the fields the comparator uses.
+ */
+void *sortlist_seek (struct sortlist *sl, const void *key);
+
+#endif /* ! _FLUX_JOB_LIST_SORTLIST_H */
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -0,0 +1,222 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <errno.h>
+#include <jansson.h>
+#include <flux/core.h>
+
+#include "src/common/libtap/tap.h"
+#include "src/modules/job-list/job_data.h"
+#include "src/modules/job-list/job_index.h"
+
+#define NUMCMP(a,b) ((a)==(b)?0:((a)<(b)?-1:1))
+
+static int priority_cmp (const void *a1, const void *a2)
+{
+    const struct job *j1 = a1;
+    const struct job *j2 = a2;
+    int rc;
+
+    if ((rc = (-1)*NUMCMP (j1->priority, j2->priority)) == 0)
+        rc = NUMCMP (j1->id, j2->id);
+    return rc;
+}
+
+static int inactive_cmp (const void *a1, const void *a2)
+{
+    const struct job *j1 = a1;
+    const struct job *j2 = a2;
+
+    return NUMCMP (j2->t_inactive, j1->t_inactive);
+}
+
+static struct job *create_job (flux_jobid_t id,
+                               uint32_t userid,
+                               const char *queue,
+                               const char *name)
+{
+    struct job *job;
+
+    if (!(job = job_create (NULL, id)))
+        BAIL_OUT ("job_create failed");
+    job->userid = userid;
+    job->queue = queue;
+    job->name = name;
+    return job;
+}
+
+static int count_list (struct sortlist *sl)
+{
+    int count = 0;
+    struct job *job = sortlist_first (sl);
+    while (job) {
+        count++;
+        job = sortlist_next (sl);
+    }
+    return count;
+}
+
+void test_index (void)
+{
+    struct job_index *idx;
+    struct job *job[4];
+    struct sortlist *sl;
+    json_t *stats;
+
+    idx = job_index_create (priority_cmp, priority_cmp, inactive_cmp);
+    ok (idx != NULL,
+        "job_index_create works");
+
+    job[0] = create_job (1, 100, "batch", "sleep");
+    job[1] = create_job (2, 100, "debug", "sleep");
+    job[2] = create_job (3, 200, "batch", NULL);
+    job[3] = create_job (4, 200, NULL, "hostname");
+    job[0]->priority = 10;
+    job[1]->priority = 20;
+
+    ok (job_index_add (idx, job[0], JOB_INDEX_LIST_PENDING) == 0
+        && job_index_add (idx, job[1], JOB_INDEX_LIST_PENDING) == 0
+        && job_index_add (idx, job[2], JOB_INDEX_LIST_RUNNING) == 0,
+        "job_index_add works");
+    job[3]->result = FLUX_JOB_RESULT_CANCELED;
+    job[3]->t_inactive = 1.0;
+    ok (job_index_add (idx, job[3], JOB_INDEX_LIST_INACTIVE) == 0,
+        "job_index_add inactive job works");
+    errno = 0;
+    ok (job_index_add (idx, job[3], JOB_INDEX_LIST_INACTIVE) < 0
+        && errno == EINVAL,
+        "job_index_add of indexed job fails with EINVAL");
+
+    ok (job_index_count (idx, JOB_INDEX_USERID, "100") == 2
+        && job_index_count (idx, JOB_INDEX_USERID, "200") == 2
+        && job_index_count (idx, JOB_INDEX_USERID, "300") == 0,
+        "job_index_count works for userid");
+    ok (job_index_count (idx, JOB_INDEX_QUEUE, "batch") == 2
+        && job_index_count (idx, JOB_INDEX_NAME, "sleep") == 2,
+        "job_index_count works for queue and name");
+    ok (job_index_count (idx, JOB_INDEX_RESULT, "4") == 1
+        && job_index_count (idx, JOB_INDEX_RESULT, "2") == 0,
+        "job_index_count works for result, which excludes active jobs");
+
+    sl = job_index_lookup (idx,
+                           JOB_INDEX_USERID,
+                           "100",
+                           JOB_INDEX_LIST_PENDING);
+    ok (sl != NULL
+        && sortlist_first (sl) == job[1]
+        && sortlist_next (sl) == job[0]
+        && sortlist_next (sl) == NULL,
+        "job_index_lookup returns jobs in list order");
+    ok (job_index_lookup (idx,
+                          JOB_INDEX_USERID,
+                          "100",
+                          JOB_INDEX_LIST_INACTIVE) == NULL,
+        "job_index_lookup returns NULL for empty list");
+
+    job[0]->priority = 30;
+    job_index_reorder (idx, job[0]);
+    ok (sortlist_first (sl) == job[0],
+        "job_index_reorder works");
+
+    job[1]->queue = "batch";
+    job[1]->name = "hostname";
+    ok (job_index_update (idx, job[1]) == 0,
+        "job_index_update works");
+    ok (job_index_count (idx, JOB_INDEX_QUEUE, "batch") == 3
+        && job_index_count (idx, JOB_INDEX_QUEUE, "debug") == 0
+        && job_index_count (idx, JOB_INDEX_NAME, "hostname") == 2,
+        "job_index_update re-indexed queue and name");
+
+    job_index_remove (idx, job[1]);
+    ok (job_index_count (idx, JOB_INDEX_USERID, "100") == 1
+        && job_index_count (idx, JOB_INDEX_QUEUE, "batch") == 2,
+        "job_index_remove works");
+    ok (count_list (sl) == 1,
+        "removed job is no longer in index list");
+    job_index_remove (idx, job[1]);
+    ok (job_index_count (idx, JOB_INDEX_USERID, "100") == 1,
+        "job_index_remove of unindexed job does nothing");
+
+    job_index_remove (idx, job[2]);
+    ok (job_index_add (idx, job[2], JOB_INDEX_LIST_INACTIVE) == 0
+        && job_index_count (idx, JOB_INDEX_RESULT, "2") == 1,
+        "job moved to inactive is indexed by result");
+
+    job_index_note_query (idx, JOB_INDEX_NAME);
+    job_index_note_query (idx, JOB_INDEX_COUNT);
+    job_index_note_query (idx, JOB_INDEX_COUNT);
+    stats = job_index_stats_get (idx);
+    ok (stats != NULL,
+        "job_index_stats_get works");
+    int name_keys = -1, name_queries = -1, scans = -1;
+    ok (json_unpack (stats,
+                     "{s:{s:i s:i} s:i}",
+                     "name",
+                       "keys", &name_keys,
+                       "queries", &name_queries,
+                     "scans", &scans) == 0
+        && name_keys == 2
+        && name_queries == 1
+        && scans == 2,
+        "job_index_stats_get reports keys and queries");
+    json_decref (stats);
+
+    for (int i = 0; i < 4; i++)
+        job_index_remove (idx, job[i]);
+    ok (job_index_count (idx, JOB_INDEX_USERID, "100") == 0
+        && job_index_count (idx, JOB_INDEX_USERID, "200") == 0,
+        "all jobs removed");
+    job_index_destroy (idx);
+    for (int i = 0; i < 4; i++)
+        job_destroy (job[i]);
+}
+
+void test_errors (void)
+{
+    struct job *job = create_job (1, 100, NULL, NULL);
+
+    errno = 0;
+    ok (job_index_add (NULL, job, JOB_INDEX_LIST_PENDING) < 0
+        && errno == EINVAL,
+        "job_index_add idx=NULL fails with EINVAL");
+    errno = 0;
+    ok (job_index_update (NULL, job) < 0 && errno == EINVAL,
+        "job_index_update idx=NULL fails with EINVAL");
+    ok (job_index_lookup (NULL,
+                          JOB_INDEX_USERID,
+                          "100",
+                          JOB_INDEX_LIST_PENDING) == NULL,
+        "job_index_lookup idx=NULL returns NULL");
+    ok (job_index_count (NULL, JOB_INDEX_USERID, "100") == 0,
+        "job_index_count idx=NULL returns 0");
+    lives_ok ({ job_index_remove (NULL, job);},
+        "job_index_remove idx=NULL doesn't crash");
+    lives_ok ({ job_index_destroy (NULL);},
+        "job_index_destroy idx=NULL doesn't crash");
+    job_destroy (job);
+}
+
+int main (int argc, char *argv[])
+{
+    plan (NO_PLAN);
+
+    test_index ();
+    test_errors ();
+
+    done_testing ();
+    return (0);
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -2092,6 +2092,91 @@ static void test_realworld (void)
     }
 }
 
+/* Pretend userid 42 has 10 jobs, queue "batch" 5, and name "sleep" 20.
+ */
+static size_t plan_cost (enum job_index_type type, const char *key, void *arg)
+{
+    if (type == JOB_INDEX_USERID && streq (key, "42"))
+        return 10;
+    if (type == JOB_INDEX_QUEUE && streq (key, "batch"))
+        return 5;
+    if (type == JOB_INDEX_NAME && streq (key, "sleep"))
+        return 20;
+    return 0;
+}
+
+struct plan_test {
+    const char *constraint;
+    enum job_index_type index;
+    const char *key;
+    bool inactive_only;
+    double t_inactive_min;
+    bool t_inactive_min_inclusive;
+    bool t_inactive_max_set;
+    double t_inactive_max;
+} plan_tests[] = {
+    { "{}", JOB_INDEX_COUNT, NULL, false, 0.0, true, false, 0.0 },
+    { "{ \"userid\": [ 42 ] }",
+      JOB_INDEX_USERID, "42", false, 0.0, true, false, 0.0 },
+    { "{ \"userid\": [ 4294967295 ] }",
+      JOB_INDEX_COUNT, NULL, false, 0.0, true, false, 0.0 },
+    { "{ \"and\": [ { \"userid\": [ 42 ] }, "
+      "{ \"queue\": [ \"batch\" ] }, { \"name\": [ \"sleep\" ] } ] }",
+      JOB_INDEX_QUEUE, "batch", false, 0.0, true, false, 0.0 },
+    { "{ \"and\": [ { \"userid\": [ 42 ] }, "
+      "{ \"and\": [ { \"name\": [ \"foo\" ] } ] } ] }",
+      JOB_INDEX_NAME, "foo", false, 0.0, true, false, 0.0 },
+    { "{ \"and\": [ { \"userid\": [ 42 ] }, "
+      "{ \"queue\": [ \"batch\", \"debug\" ] } ] }",
+      JOB_INDEX_USERID, "42", false, 0.0, true, false, 0.0 },
+    { "{ \"or\": [ { \"userid\": [ 42 ] }, "
+      "{ \"queue\": [ \"batch\" ] } ] }",
+      JOB_INDEX_COUNT, NULL, false, 0.0, true, false, 0.0 },
+    { "{ \"not\": [ { \"userid\": [ 42 ] } ] }",
+      JOB_INDEX_COUNT, NULL, false, 0.0, true, false, 0.0 },
+    { "{ \"and\": [ { \"userid\": [ 42 ] }, "
+      "{ \"results\": [ \"canceled\" ] } ] }",
+      JOB_INDEX_RESULT, "4", true, 0.0, true, false, 0.0 },
+    { "{ \"results\": [ \"canceled\", \"failed\" ] }",
+      JOB_INDEX_COUNT, NULL, true, 0.0, true, false, 0.0 },
+    { "{ \"and\": [ { \"t_inactive\": [ \">=100.0\" ] }, "
+      "{ \"t_inactive\": [ \">50.0\" ] }, "
+      "{ \"t_inactive\": [ \"<500.0\" ] }, "
+      "{ \"t_inactive\": [ \"<=200.0\" ] } ] }",
+      JOB_INDEX_COUNT, NULL, true, 100.0, true, true, 200.0 },
+    { "{ \"and\": [ { \"t_inactive\": [ \">=100.0\" ] }, "
+      "{ \"t_inactive\": [ \">100.0\" ] } ] }",
+      JOB_INDEX_COUNT, NULL, true, 100.0, false, false, 0.0 },
+    { "{ \"t_run\": [ \">=100.0\" ] }",
+      JOB_INDEX_COUNT, NULL, false, 0.0, true, false, 0.0 },
+    { NULL },
+};
+
+static void test_plan (void)
+{
+    struct plan_test *t = plan_tests;
+    int index = 0;
+
+    while (t->constraint) {
+        struct list_constraint *c;
+        struct list_plan plan;
+
+        c = create_list_constraint (t->constraint);
+        list_constraint_plan (c, plan_cost, NULL, &plan);
+        ok (plan.index == t->index
+            && (t->key ? plan.key && streq (plan.key, t->key) : true)
+            && plan.inactive_only == t->inactive_only
+            && plan.t_inactive_min == t->t_inactive_min
+            && plan.t_inactive_min_inclusive == t->t_inactive_min_inclusive
+            && plan.t_inactive_max_set == t->t_inactive_max_set
+            && plan.t_inactive_max == t->t_inactive_max,
+            "plan test #%d: %s", index, t->constraint);
+        list_constraint_destroy (c);
+        index++;
+        t++;
+    }
+}
+
 int main (int argc, char *argv[])
 {
     plan (NO_PLAN);
@@ -2109,6 +2194,7 @@ int main (int argc, char *argv[])
     test_basic_timestamp ();
     test_basic_conditionals ();
     test_realworld ();
+    test_plan ();
 
     done_testing ();
 }
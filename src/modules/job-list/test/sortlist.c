@@ -0,0 +1,329 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdlib.h>
+#include <stdint.h>
+#include <errno.h>
+
+#include "src/common/libtap/tap.h"
+#include "src/common/libutil/monotime.h"
+#include "src/common/libczmqcontainers/czmq_containers.h"
+#include "src/modules/job-list/sortlist.h"
+
+struct item {
+    int64_t priority;
+    uint64_t id;
+    void *handle;
+};
+
+#define NUMCMP(a,b) ((a)==(b)?0:((a)<(b)?-1:1))
+
+/* Same ordering as job_urgency_cmp() in job_state.c
+ */
+static int urgency_cmp (const void *a1, const void *a2)
+{
+    const struct item *i1 = a1;
+    const struct item *i2 = a2;
+    int rc;
+
+    if ((rc = (-1)*NUMCMP (i1->priority, i2->priority)) == 0)
+        rc = NUMCMP (i1->id, i2->id);
+    return rc;
+}
+
+/* Priority only, so that items may compare equal.
+ */
+static int priority_cmp (const void *a1, const void *a2)
+{
+    const struct item *i1 = a1;
+    const struct item *i2 = a2;
+
+    return NUMCMP (i2->priority, i1->priority);
+}
+
+static bool check_order (struct sortlist *sl, struct item **expected, int n)
+{
+    struct item *item;
+    int i = 0;
+
+    item = sortlist_first (sl);
+    while (item) {
+        if (i >= n || item != expected[i])
+            return false;
+        i++;
+        item = sortlist_next (sl);
+    }
+    return i == n;
+}
+
+void test_basic (void)
+{
+    struct sortlist *sl;
+    struct item it[4] = {
+        { .priority = 16, .id = 1 },
+        { .priority = 16, .id = 2 },
+        { .priority = 0, .id = 3 },
+        { .priority = 31, .id = 4 },
+    };
+
+    sl = sortlist_create (priority_cmp);
+    ok (sl != NULL,
+        "sortlist_create works");
+    ok (sortlist_first (sl) == NULL,
+        "sortlist_first on empty list returns NULL");
+    ok (sortlist_next (sl) == NULL,
+        "sortlist_next on empty list returns NULL");
+
+    for (int i = 0; i < 4; i++) {
+        if (!(it[i].handle = sortlist_insert (sl, &it[i])))
+            BAIL_OUT ("sortlist_insert failed");
+    }
+    ok (sortlist_size (sl) == 4,
+        "sortlist_size returns 4");
+    struct item *order1[] = { &it[3], &it[1], &it[0], &it[2] };
+    ok (check_order (sl, order1, 4),
+        "items are sorted, equal items newest first");
+
+    it[2].priority = 20;
+    sortlist_reorder (sl, it[2].handle);
+    struct item *order2[] = { &it[3], &it[2], &it[1], &it[0] };
+    ok (check_order (sl, order2, 4),
+        "sortlist_reorder moves item after key change");
+
+    it[3].priority = 0;
+    sortlist_delete (sl, it[3].handle);
+    struct item *order3[] = { &it[2], &it[1], &it[0] };
+    ok (sortlist_size (sl) == 3 && check_order (sl, order3, 3),
+        "sortlist_delete works after key change");
+
+    ok (sortlist_first (sl) == &it[2],
+        "sortlist_first returns first item");
+    sortlist_delete (sl, it[2].handle);
+    ok (sortlist_next (sl) == &it[1],
+        "sortlist_next works after deleting current item");
+    sortlist_delete (sl, it[1].handle);
+    ok (sortlist_next (sl) == &it[0],
+        "sortlist_next works after deleting current item again");
+    ok (sortlist_next (sl) == NULL,
+        "sortlist_next returns NULL at end of list");
+    ok (sortlist_size (sl) == 1,
+        "sortlist_size returns 1");
+
+    sortlist_destroy (sl);
+}
+
+void test_seek (void)
+{
+    struct sortlist *sl;
+    struct item it[5];
+    struct item key;
+
+    if (!(sl = sortlist_create (priority_cmp)))
+        BAIL_OUT ("sortlist_create failed");
+    for (int i = 0; i < 5; i++) {
+        it[i].priority = i * 10;
+        if (!(it[i].handle = sortlist_insert (sl, &it[i])))
+            BAIL_OUT ("sortlist_insert failed");
+    }
+    key.priority = 20;
+    ok (sortlist_seek (sl, &key) == &it[2]
+        && sortlist_next (sl) == &it[1],
+        "sortlist_seek finds equal item and sets cursor");
+    key.priority = 25;
+    ok (sortlist_seek (sl, &key) == &it[2],
+        "sortlist_seek finds next item");
+    key.priority = 100;
+    ok (sortlist_seek (sl, &key) == &it[4],
+        "sortlist_seek before first item returns first item");
+    key.priority = -1;
+    ok (sortlist_seek (sl, &key) == NULL
+        && sortlist_next (sl) == NULL,
+        "sortlist_seek after last item returns NULL");
+    ok (sortlist_seek (NULL, &key) == NULL,
+        "sortlist_seek sl=NULL returns NULL");
+    sortlist_destroy (sl);
+}
+
+void test_unsorted (void)
+{
+    struct sortlist *sl;
+    struct item it[3];
+
+    if (!(sl = sortlist_create (NULL)))
+        BAIL_OUT ("sortlist_create failed");
+    for (int i = 0; i < 3; i++) {
+        if (!(it[i].handle = sortlist_insert (sl, &it[i])))
+            BAIL_OUT ("sortlist_insert failed");
+    }
+    struct item *order1[] = { &it[2], &it[1], &it[0] };
+    ok (check_order (sl, order1, 3),
+        "unsorted list inserts at front");
+    sortlist_delete (sl, it[1].handle);
+    struct item *order2[] = { &it[2], &it[0] };
+    ok (check_order (sl, order2, 2),
+        "sortlist_delete works on unsorted list");
+    sortlist_destroy (sl);
+}
+
+void test_errors (void)
+{
+    int x;
+
+    errno = 0;
+    ok (sortlist_insert (NULL, &x) == NULL && errno == EINVAL,
+        "sortlist_insert sl=NULL fails with EINVAL");
+    ok (sortlist_size (NULL) == 0,
+        "sortlist_size sl=NULL returns 0");
+    ok (sortlist_first (NULL) == NULL,
+        "sortlist_first sl=NULL returns NULL");
+    ok (sortlist_next (NULL) == NULL,
+        "sortlist_next sl=NULL returns NULL");
+    lives_ok ({ sortlist_delete (NULL, NULL);},
+        "sortlist_delete sl=NULL doesn't crash");
+    lives_ok ({ sortlist_reorder (NULL, NULL);},
+        "sortlist_reorder sl=NULL doesn't crash");
+    lives_ok ({ sortlist_destroy (NULL);},
+        "sortlist_destroy sl=NULL doesn't crash");
+}
+
+/* Run the same inserts, priority changes, and deletes on a sortlist and
+ * on a sorted zlistx as job-list used to, and compare the results.  Each
+ * list gets its own copy of the items, since items must be reordered one
+ * at a time as their priority changes.  Timings are informational only.
+ */
+#define BENCH_JOBS      10000
+#define BENCH_PAGE      1000
+
+static bool same_order (struct sortlist *sl, zlistx_t *l)
+{
+    struct item *a = sortlist_first (sl);
+    struct item *b = zlistx_first (l);
+
+    while (a && b) {
+        if (a->id != b->id)
+            return false;
+        a = sortlist_next (sl);
+        b = zlistx_next (l);
+    }
+    return !a && !b;
+}
+
+void test_bench (void)
+{
+    static struct item it[BENCH_JOBS];
+    static struct item zit[BENCH_JOBS];
+    static int64_t newpri[BENCH_JOBS];
+    struct sortlist *sl;
+    zlistx_t *l;
+    struct timespec t0;
+    double t_sl, t_zl;
+    unsigned int seed = 42;
+    int count;
+
+    if (!(sl = sortlist_create (urgency_cmp))
+        || !(l = zlistx_new ()))
+        BAIL_OUT ("error creating lists");
+    zlistx_set_comparator (l, urgency_cmp);
+    for (int i = 0; i < BENCH_JOBS; i++) {
+        it[i].id = zit[i].id = i + 1;
+        it[i].priority = zit[i].priority = rand_r (&seed) % 1000;
+        newpri[i] = rand_r (&seed) % 1000;
+    }
+
+    monotime (&t0);
+    for (int i = 0; i < BENCH_JOBS; i++) {
+        if (!(it[i].handle = sortlist_insert (sl, &it[i])))
+            BAIL_OUT ("sortlist_insert failed");
+    }
+    t_sl = monotime_since (t0);
+    monotime (&t0);
+    for (int i = 0; i < BENCH_JOBS; i++) {
+        if (!(zit[i].handle = zlistx_insert (l, &zit[i], false)))
+            BAIL_OUT ("zlistx_insert failed");
+    }
+    t_zl = monotime_since (t0);
+    ok (same_order (sl, l),
+        "sortlist and zlistx agree after insert");
+    diag ("insert %d: sortlist %.3fms zlistx %.3fms", BENCH_JOBS, t_sl, t_zl);
+
+    monotime (&t0);
+    for (int i = 0; i < BENCH_JOBS; i++) {
+        it[i].priority = newpri[i];
+        sortlist_reorder (sl, it[i].handle);
+    }
+    t_sl = monotime_since (t0);
+    monotime (&t0);
+    for (int i = 0; i < BENCH_JOBS; i++) {
+        zit[i].priority = newpri[i];
+        zlistx_reorder (l, zit[i].handle, false);
+    }
+    t_zl = monotime_since (t0);
+    ok (same_order (sl, l),
+        "sortlist and zlistx agree after reorder");
+    diag ("reorder %d: sortlist %.3fms zlistx %.3fms", BENCH_JOBS, t_sl, t_zl);
+
+    monotime (&t0);
+    count = 0;
+    for (int i = 0; i < BENCH_JOBS / BENCH_PAGE; i++) {
+        struct item *item = sortlist_first (sl);
+        for (int j = 0; item && j < BENCH_PAGE; j++) {
+            count++;
+            item = sortlist_next (sl);
+        }
+    }
+    t_sl = monotime_since (t0);
+    monotime (&t0);
+    for (int i = 0; i < BENCH_JOBS / BENCH_PAGE; i++) {
+        struct item *item = zlistx_first (l);
+        for (int j = 0; item && j < BENCH_PAGE; j++) {
+            count--;
+            item = zlistx_next (l);
+        }
+    }
+    t_zl = monotime_since (t0);
+    ok (count == 0,
+        "sortlist and zlistx iterate the same number of items");
+    diag ("iterate %d pages of %d: sortlist %.3fms zlistx %.3fms",
+          BENCH_JOBS / BENCH_PAGE,
+          BENCH_PAGE,
+          t_sl,
+          t_zl);
+
+    for (int i = 0; i < BENCH_JOBS; i += 2) {
+        sortlist_delete (sl, it[i].handle);
+        zlistx_detach (l, zit[i].handle);
+    }
+    ok (sortlist_size (sl) == BENCH_JOBS / 2 && same_order (sl, l),
+        "sortlist and zlistx agree after delete");
+
+    zlistx_destroy (&l);
+    sortlist_destroy (sl);
+}
+
+int main (int argc, char *argv[])
+{
+    plan (NO_PLAN);
+
+    test_basic ();
+    test_seek ();
+    test_unsorted ();
+    test_errors ();
+    test_bench ();
+
+    done_testing ();
+    return (0);
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -49,10 +49,14 @@ struct alloc {
     flux_watcher_t *idle;
     unsigned int alloc_limit;   // will have a value of 0 in mode=unlimited
     char *sched_sender;         // scheduler uuid for disconnect processing
+    struct rlist *allocated;    // allocated resources, NULL if not built
     json_t *resource_status_cache;
+    struct flux_msglist *resource_status_watchers;
 };
 
 static void alloc_resource_status_invalidate (struct alloc *alloc);
+static void alloc_resource_status_add (struct alloc *alloc, json_t *R);
+static void alloc_resource_status_remove (struct alloc *alloc, json_t *R);
 
 static void requeue_pending (struct alloc *alloc, struct job *job)
 {
@@ -201,7 +205,7 @@ static void alloc_response_cb (flux_t *h,
             goto teardown;
         }
         job->R_redacted = json_incref (R);
-        alloc_resource_status_invalidate (alloc);
+        alloc_resource_status_add (alloc, R);
         if (annotations) {
             if (annotations_update_and_publish (ctx, job, annotations) < 0)
                 flux_log_error (h, "annotations_update: id=%s", idf58 (id));
@@ -348,8 +352,8 @@ static void hello_cb (flux_t *h,
     if (housekeeping_hello_respond (ctx->housekeeping, msg, partial_ok) < 0)
         goto error;
 
-    /* Housekeeping may have let go of partial allocations. Invalidate
-     * cached resource-status response just in case.
+    /* Housekeeping may have let go of partial allocations. Rebuild the
+     * allocated resource set just in case.
      */
     alloc_resource_status_invalidate (ctx->alloc);
 
@@ -512,7 +516,7 @@ int alloc_send_free_request (struct alloc *alloc,
                              flux_jobid_t id,
                              bool final)
 {
-    alloc_resource_status_invalidate (alloc);
+    alloc_resource_status_remove (alloc, R);
     if (alloc->scheduler_is_online) {
         if (free_request (alloc, id, R, final) < 0)
             return -1;
@@ -669,70 +673,113 @@ static void alloc_query_cb (flux_t *h,
     return;
 }
 
-static void resource_status_cb (flux_t *h,
-                                flux_msg_handler_t *mh,
-                                const flux_msg_t *msg,
-                                void *arg)
+/* Build the allocated resource set from scratch, from the R of each job
+ * holding resources plus resources still held by housekeeping.
+ */
+static struct rlist *resource_status_build (struct job_manager *ctx,
+                                            flux_error_t *error)
 {
-    struct job_manager *ctx = arg;
-    struct alloc *alloc = ctx->alloc;
-    struct rlist *rl = NULL;
-    json_t *R = NULL;
-    flux_error_t error;
+    struct rlist *rl;
     struct job *job;
 
-    if (alloc->resource_status_cache) {
-        if (flux_respond_pack (h,
-                               msg,
-                               "{s:O}",
-                               "allocated",
-                               alloc->resource_status_cache) < 0)
-            flux_log_error (h, "error responding to resource-status request");
-        return;
-    }
     if (!(rl = rlist_create ())) {
-        errprintf (&error, "error creating rlist object");
-        goto error;
+        errprintf (error, "error creating rlist object");
+        return NULL;
     }
-    job = zhashx_first (alloc->ctx->active_jobs);
+    job = zhashx_first (ctx->active_jobs);
     while (job) {
         if (job->R_redacted && !job->free_posted && !job->alloc_bypass) {
             struct rlist *rl2;
             json_error_t jerror;
 
             if (!(rl2 = rlist_from_json (job->R_redacted, &jerror))) {
-                errprintf (&error,
+                errprintf (error,
                            "%s: error converting JSON to rlist: %s",
                            idf58 (job->id),
                            jerror.text);
                 goto error;
             }
             if (rlist_append (rl, rl2) < 0) {
-                errprintf (&error, "%s: duplicate allocation", idf58 (job->id));
+                errprintf (error, "%s: duplicate allocation", idf58 (job->id));
                 rlist_destroy (rl2);
                 goto error;
             }
             rlist_destroy (rl2);
         }
-        job = zhashx_next (alloc->ctx->active_jobs);
+        job = zhashx_next (ctx->active_jobs);
     }
-    if (housekeeping_stat_append (ctx->housekeeping, rl, &error) < 0)
-        goto error;
-    if (!(R = rlist_to_R (rl))) {
-        errprintf (&error, "error converting rlist to JSON");
+    if (housekeeping_stat_append (ctx->housekeeping, rl, error) < 0)
         goto error;
+    return rl;
+error:
+    rlist_destroy (rl);
+    return NULL;
+}
+
+/* Return the allocated resource set as R, building it if necessary.
+ * The caller must not decref the result.
+ */
+static json_t *resource_status_get (struct alloc *alloc, flux_error_t *error)
+{
+    if (!alloc->resource_status_cache) {
+        if (!alloc->allocated
+            && !(alloc->allocated = resource_status_build (alloc->ctx,
+                                                           error)))
+            return NULL;
+        if (!(alloc->resource_status_cache = rlist_to_R (alloc->allocated))) {
+            errprintf (error, "error converting rlist to JSON");
+            return NULL;
+        }
+    }
+    return alloc->resource_status_cache;
+}
+
+/* Send {key:R} to each streaming resource-status request.
+ */
+static void resource_status_notify (struct alloc *alloc,
+                                    const char *key,
+                                    json_t *R)
+{
+    flux_t *h = alloc->ctx->h;
+    const flux_msg_t *msg;
+
+    msg = flux_msglist_first (alloc->resource_status_watchers);
+    while (msg) {
+        if (flux_respond_pack (h, msg, "{s:O}", key, R) < 0)
+            flux_log_error (h, "error responding to resource-status request");
+        msg = flux_msglist_next (alloc->resource_status_watchers);
     }
-    alloc->resource_status_cache = json_incref (R);
+}
+
+/* Respond to job-manager.resource-status with {"allocated":R}.
+ * If the request is streaming, keep it and follow up with {"add":R}
+ * or {"remove":R} as resources are allocated and freed.  If the allocated
+ * set has to be rebuilt, {"allocated":R} is sent again.
+ */
+static void resource_status_cb (flux_t *h,
+                                flux_msg_handler_t *mh,
+                                const flux_msg_t *msg,
+                                void *arg)
+{
+    struct job_manager *ctx = arg;
+    struct alloc *alloc = ctx->alloc;
+    json_t *R;
+    flux_error_t error;
+
+    if (!(R = resource_status_get (alloc, &error)))
+        goto error;
     if (flux_respond_pack (h, msg, "{s:O}", "allocated", R) < 0)
         flux_log_error (h, "error responding to resource-status request");
-    json_decref (R);
-    rlist_destroy (rl);
+    if (flux_msg_is_streaming (msg)) {
+        if (flux_msglist_append (alloc->resource_status_watchers, msg) < 0) {
+            errprintf (&error, "error saving resource-status request");
+            goto error;
+        }
+    }
     return;
 error:
     if (flux_respond_error (h, msg, EINVAL, error.text) < 0)
         flux_log_error (h, "error responding to resource-status request");
-    json_decref (R);
-    rlist_destroy (rl);
 }
 
 void alloc_disconnect_rpc (flux_t *h,
@@ -749,12 +796,94 @@ void alloc_disconnect_rpc (flux_t *h,
             && streq (sender, alloc->sched_sender))
             interface_teardown (ctx->alloc, "disconnect", 0);
     }
+    flux_msglist_disconnect (alloc->resource_status_watchers, msg);
 }
 
+/* Throw away the allocated resource set so that it is rebuilt from scratch
+ * on the next request, and terminate streaming requests with 'errmsg'.
+ */
+static void resource_status_reset (struct alloc *alloc, const char *errmsg)
+{
+    flux_t *h = alloc->ctx->h;
+    const flux_msg_t *msg;
+
+    json_decref (alloc->resource_status_cache);
+    alloc->resource_status_cache = NULL;
+    rlist_destroy (alloc->allocated);
+    alloc->allocated = NULL;
+
+    while ((msg = flux_msglist_pop (alloc->resource_status_watchers))) {
+        if (flux_respond_error (h, msg, EINVAL, errmsg) < 0)
+            flux_log_error (h, "error responding to resource-status request");
+        flux_msg_decref (msg);
+    }
+}
+
+/* Rebuild the allocated resource set from scratch and send it to
+ * streaming resource-status requests.
+ */
 static void alloc_resource_status_invalidate (struct alloc *alloc)
+{
+    flux_error_t error;
+    json_t *R;
+
+    json_decref (alloc->resource_status_cache);
+    alloc->resource_status_cache = NULL;
+    rlist_destroy (alloc->allocated);
+    alloc->allocated = NULL;
+
+    if (flux_msglist_count (alloc->resource_status_watchers) == 0)
+        return;
+    if (!(R = resource_status_get (alloc, &error))) {
+        resource_status_reset (alloc, error.text);
+        return;
+    }
+    resource_status_notify (alloc, "allocated", R);
+}
+
+/* Update the allocated resource set after a job is allocated resources 'R'.
+ * This avoids rebuilding the set from every running job's R on the next
+ * resource-status request.
+ */
+static void alloc_resource_status_add (struct alloc *alloc, json_t *R)
 {
     json_decref (alloc->resource_status_cache);
     alloc->resource_status_cache = NULL;
+    if (alloc->allocated) {
+        struct rlist *rl;
+
+        if (!(rl = rlist_from_json (R, NULL))
+            || rlist_append (alloc->allocated, rl) < 0) {
+            rlist_destroy (rl);
+            resource_status_reset (alloc, "error updating allocated set");
+            return;
+        }
+        rlist_destroy (rl);
+    }
+    resource_status_notify (alloc, "add", R);
+}
+
+/* Update the allocated resource set after resources 'R' are freed.
+ */
+static void alloc_resource_status_remove (struct alloc *alloc, json_t *R)
+{
+    json_decref (alloc->resource_status_cache);
+    alloc->resource_status_cache = NULL;
+    if (alloc->allocated) {
+        struct rlist *rl;
+        struct rlist *diff = NULL;
+
+        if (!(rl = rlist_from_json (R, NULL))
+            || !(diff = rlist_diff (alloc->allocated, rl))) {
+            rlist_destroy (rl);
+            resource_status_reset (alloc, "error updating allocated set");
+            return;
+        }
+        rlist_destroy (rl);
+        rlist_destroy (alloc->allocated);
+        alloc->allocated = diff;
+    }
+    resource_status_notify (alloc, "remove", R);
 }
 
 void alloc_ctx_destroy (struct alloc *alloc)
@@ -768,7 +897,9 @@ void alloc_ctx_destroy (struct alloc *alloc)
         zlistx_destroy (&alloc->queue);
         zlistx_destroy (&alloc->sent);
         free (alloc->sched_sender);
+        rlist_destroy (alloc->allocated);
         json_decref (alloc->resource_status_cache);
+        flux_msglist_destroy (alloc->resource_status_watchers);
         free (alloc);
         errno = saved_errno;
     }
@@ -812,7 +943,8 @@ struct alloc *alloc_ctx_create (struct job_manager *ctx)
         return NULL;
     alloc->ctx = ctx;
     if (!(alloc->queue = job_priority_queue_create ())
-        || !(alloc->sent = job_priority_queue_create ()))
+        || !(alloc->sent = job_priority_queue_create ())
+        || !(alloc->resource_status_watchers = flux_msglist_create ()))
         goto error;
     if (flux_msg_handler_addvec (ctx->h, htab, ctx, &alloc->handlers) < 0)
         goto error;
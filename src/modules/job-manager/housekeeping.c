@@ -127,6 +127,7 @@ struct housekeeping {
     struct job_manager *ctx;
     flux_cmd_t *cmd; // NULL if not configured
     double release_after;
+    bool tree_launch;
     char *imp_path;
     zlistx_t *allocations;
     flux_msg_handler_t **handlers;
@@ -218,6 +219,7 @@ static struct allocation *allocation_create (struct housekeeping *hk,
                                               id,
                                               "housekeeping",
                                                a))
+        || bulk_exec_set_tree_launch (a->bulk_exec, hk->tree_launch) < 0
         || update_cmd_env (hk->cmd, id, userid, a->rl) < 0
         || bulk_exec_push_cmd (a->bulk_exec, a->pending, hk->cmd, 0) < 0) {
         allocation_destroy (a);
@@ -486,10 +488,9 @@ int housekeeping_start (struct housekeeping *hk,
         goto skip;
     }
     /* Note: Though resources have transitioned from a job allocation to
-     * housekeeping, no job-manager.resource-status cache invalidation is
-     * needed here (alloc_resource_status_invalidate()): hk->allocations is
-     * updated synchronously above, and the caller sets job->free_posted=1
-     * in the same reactor loop.
+     * housekeeping, the job-manager.resource-status allocated set need not
+     * be updated here: hk->allocations is updated synchronously above, and
+     * the caller sets job->free_posted=1 in the same reactor loop.
      *
      * Therefore, the allocated resource set is unchanged until housekeeping
      * releases its first resources via alloc_send_free_request().
@@ -789,6 +790,7 @@ static int housekeeping_parse_config (const flux_conf_t *conf,
     const char *imp_path = NULL;
     char *imp_path_cpy = NULL;
     int use_systemd_unit = 0;
+    int tree_launch = 0;
     int exit_on_first_error = -1; /* Note: only for flux-run-system-scripts */
 
     if (flux_conf_unpack (conf,
@@ -805,10 +807,11 @@ static int housekeeping_parse_config (const flux_conf_t *conf,
     if (json_unpack_ex (housekeeping,
                         &jerror,
                         0,
-                        "{s?o s?s s?b s?b !}",
+                        "{s?o s?s s?b s?b s?b !}",
                         "command", &cmdline,
                         "release-after", &release_after_fsd,
                         "use-systemd-unit", &use_systemd_unit,
+                        "tree-launch", &tree_launch,
                         "exit-on-first-error", &exit_on_first_error) < 0)
         return errprintf (error, "job-manager.housekeeping: %s", jerror.text);
 
@@ -858,6 +861,7 @@ done:
     free (hk->imp_path);
     hk->imp_path = imp_path_cpy;
     hk->release_after = release_after;
+    hk->tree_launch = tree_launch;
     flux_log (hk->ctx->h,
               LOG_DEBUG,
               "housekeeping is %sconfigured%s",
@@ -81,25 +81,29 @@ static void stats_cb (flux_t *h, flux_msg_handler_t *mh,
     struct job_manager *ctx = arg;
     json_t *journal = journal_get_stats (ctx->journal);
     json_t *housekeeping = housekeeping_get_stats (ctx->housekeeping);
-    if (!housekeeping || !journal)
+    json_t *restart = restart_get_stats (ctx);
+    if (!housekeeping || !journal || !restart)
         goto error;
     if (flux_respond_pack (h,
                            msg,
-                           "{s:O s:i s:i s:I s:O}",
+                           "{s:O s:i s:i s:I s:O s:O}",
                            "journal", journal,
                            "active_jobs", zhashx_size (ctx->active_jobs),
                            "inactive_jobs", zhashx_size (ctx->inactive_jobs),
                            "max_jobid", ctx->max_jobid,
-                           "housekeeping", housekeeping) < 0) {
+                           "housekeeping", housekeeping,
+                           "restart", restart) < 0) {
         flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
         goto error;
     }
+    json_decref (restart);
     json_decref (housekeeping);
     json_decref (journal);
     return;
  error:
     if (flux_respond_error (h, msg, errno, NULL) < 0)
         flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+    json_decref (restart);
     json_decref (housekeeping);
     json_decref (journal);
 }
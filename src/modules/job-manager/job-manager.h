@@ -13,6 +13,17 @@
 
 #include "src/common/libczmqcontainers/czmq_containers.h"
 
+/* Statistics from restart_from_kvs(), times in seconds.
+ */
+struct restart_stats {
+    int jobs;               // jobs replayed from the KVS
+    int lost;               // jobs moved to job-lost+found
+    int dirs;               // job directories read
+    int max_inflight;       // KVS request window used for replay
+    double t_replay;        // time to fetch and replay all jobs
+    double t_ready;         // total restart time
+};
+
 struct job_manager {
     flux_t *h;
     flux_msg_handler_t **handlers;
@@ -37,6 +48,7 @@ struct job_manager {
     struct queue_ctx *queue;
     struct update *update;
     struct jobtap *jobtap;
+    struct restart_stats restart_stats;
 };
 
 #endif /* !_FLUX_JOB_MANAGER_H */
@@ -79,6 +79,7 @@ struct perilog_procdesc {
     bool prolog;
     bool per_rank;
     bool cancel_on_exception;
+    bool tree_launch;
     double timeout;
     double kill_timeout;
 };
@@ -179,6 +180,7 @@ static struct perilog_procdesc *perilog_procdesc_create (json_t *o,
 {
     struct perilog_procdesc *pd = NULL;
     int per_rank = 0;
+    int tree_launch = 0;
     int cancel_on_exception = -1;
     int exit_on_first_error = -1; /* Note: only for flux-run-system-scripts */
     const char *timeout;
@@ -196,11 +198,12 @@ static struct perilog_procdesc *perilog_procdesc_create (json_t *o,
     if (json_unpack_ex (o,
                         &error,
                         0,
-                        "{s?o s?s s?F s?b s?b s?b !}",
+                        "{s?o s?s s?F s?b s?b s?b s?b !}",
                         "command", &command,
                         "timeout", &timeout,
                         "kill-timeout", &kill_timeout,
                         "per-rank", &per_rank,
+                        "tree-launch", &tree_launch,
                         "cancel-on-exception", &cancel_on_exception,
                         "exit-on-first-error", &exit_on_first_error) < 0) {
         errprintf (errp, "%s", error.text);
@@ -250,6 +253,7 @@ static struct perilog_procdesc *perilog_procdesc_create (json_t *o,
     pd->cmd = cmd;
     pd->kill_timeout = kill_timeout > 0. ? kill_timeout : default_kill_timeout;
     pd->per_rank = per_rank;
+    pd->tree_launch = tree_launch;
     pd->prolog = prolog;
 
     /* If cancel_on_exception unset, default to prolog=true, epilog=false
@@ -850,6 +854,7 @@ static struct perilog_proc *procdesc_run (flux_t *h,
                                         id,
                                         perilog_proc_name (proc),
                                         NULL))
+        || bulk_exec_set_tree_launch (bulk_exec, pd->tree_launch) < 0
         || bulk_exec_push_cmd (bulk_exec, ranks, pd->cmd, 0) < 0) {
         flux_log_error (h,
                         "failed to create %s bulk exec cmd for %s",
@@ -1381,9 +1386,10 @@ static json_t *procdesc_to_json (struct perilog_procdesc *pd)
     if (!(cmd = cmdline_tojson (pd->cmd)))
         return NULL;
 
-    o = json_pack ("{s:O s:b s:b s:f s:f}",
+    o = json_pack ("{s:O s:b s:b s:b s:f s:f}",
                    "command", cmd,
                    "per_rank", pd->per_rank,
+                   "tree_launch", pd->tree_launch,
                    "cancel_on_exception", pd->cancel_on_exception,
                    "timeout", pd->timeout,
                    "kill-timeout", pd->kill_timeout);
@@ -21,6 +21,8 @@
 #include "src/common/libutil/fsd.h"
 #include "src/common/libutil/errprintf.h"
 #include "src/common/libccan/ccan/ptrint/ptrint.h"
+#include "src/common/libjob/idf58.h"
+#include "src/common/libjob/job_hash.h"
 
 #include "job-manager.h"
 #include "job.h"
@@ -46,6 +48,14 @@ struct purge {
 
 static const int purge_batch_max = 100; // max KVS ops per txn
 
+/* State of a streaming purge-ids request, stored in the request aux hash.
+ */
+struct purge_ids {
+    json_t *ids;
+    size_t index;   // next entry of 'ids' to process
+    int batch;      // max jobs per KVS transaction
+};
+
 /* Add an inactive job to the "purge queue".
  * The queue is ordered by the time the job became inactive, so
  * the first job in the queue is the oldest.
@@ -155,17 +165,16 @@ static int process_job_purge (struct purge *purge,
     return 0;
 }
 
+/* Look up an inactive job by id in O(1) via ctx->inactive_jobs.  Only jobs
+ * that are on the purge queue (job->handle set) are candidates.
+ */
 static struct job *find_purge_candidate (struct purge *purge,
                                          flux_jobid_t id,
                                          const char **errmsg)
 {
-    struct job *job = zlistx_first (purge->queue);
-    while (job) {
-        if (job->id == id)
-            break;
-        job = zlistx_next (purge->queue);
-    }
-    if (!job) {
+    struct job *job = zhashx_lookup (purge->ctx->inactive_jobs, &id);
+
+    if (!job || !job->handle) {
         if (!(job = zhashx_lookup (purge->ctx->active_jobs, &id))) {
             (*errmsg) = "id not found";
             errno = ENOENT;
@@ -223,6 +232,30 @@ static int purge_jobs (struct purge *purge,
     return 0;
 }
 
+/* Commit 'txn' containing unlinks for 'count' jobs and publish the ids
+ * in 'jobs'.  Return future with 'count' added to aux hash, or NULL on
+ * failure with errno set.
+ * N.B. if kvs commit fails, jobs are still removed from the hash/list.
+ * It doesn't seem worth the effort to structure the code to avoid this
+ * due to high complexity of solution, low probability of error, and
+ * minor consequences.
+ */
+static flux_future_t *purge_commit (struct purge *purge,
+                                    flux_kvs_txn_t *txn,
+                                    json_t *jobs,
+                                    int count)
+{
+    flux_future_t *f;
+
+    if (!(f = flux_kvs_commit (purge->ctx->h, NULL, 0, txn))
+        || flux_future_aux_set (f, "count", int2ptr (count), NULL) < 0
+        || purge_publish (purge, jobs) < 0) {
+        flux_future_destroy (f);
+        return NULL;
+    }
+    return f;
+}
+
 /* Send a KVS commit containing unlinks for one or more inactive jobs.
  * (only one if jobid specified).
  * Return future if successful, with 'count' added to aux hash.
@@ -238,7 +271,7 @@ static flux_future_t *purge_inactive_jobs (struct purge *purge,
 {
     flux_kvs_txn_t *txn;
     json_t *jobs = NULL;
-    flux_future_t *f = NULL;
+    flux_future_t *f;
     int count = 0;
 
     if (!(txn = flux_kvs_txn_create ()))
@@ -262,22 +295,62 @@ static flux_future_t *purge_inactive_jobs (struct purge *purge,
             goto error;
         count = 1;
     }
-    if (!(f = flux_kvs_commit (purge->ctx->h, NULL, 0, txn))
-        || flux_future_aux_set (f, "count", int2ptr (count), NULL) < 0
-        || purge_publish (purge, jobs) < 0)
+    if (!(f = purge_commit (purge, txn, jobs, count)))
+        goto error;
+    flux_kvs_txn_destroy (txn);
+    json_decref (jobs);
+    return f;
+error:
+    flux_kvs_txn_destroy (txn);
+    json_decref (jobs);
+    return NULL;
+}
+
+/* Send a KVS commit containing unlinks for the next batch of jobs in a
+ * purge-ids request.  Ids that are no longer purge candidates, e.g. because
+ * they were purged by limits after the request was validated, are skipped.
+ * Return future if successful, with 'count' added to aux hash.
+ * Return NULL on failure with errno set.
+ * N.B. Failure with errno=ENODATA means all ids have been processed.
+ */
+static flux_future_t *purge_ids_next (struct purge *purge,
+                                      struct purge_ids *pi)
+{
+    flux_kvs_txn_t *txn;
+    json_t *jobs = NULL;
+    flux_future_t *f;
+    int count = 0;
+
+    if (!(txn = flux_kvs_txn_create ()))
+        return NULL;
+    if (!(jobs = json_array ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    while (pi->index < json_array_size (pi->ids) && count < pi->batch) {
+        json_t *o = json_array_get (pi->ids, pi->index++);
+        flux_jobid_t id = json_integer_value (o);
+        const char *errmsg;
+        struct job *job;
+
+        if (!(job = find_purge_candidate (purge, id, &errmsg)))
+            continue;
+        if (process_job_purge (purge, job, txn, jobs) < 0)
+            goto error;
+        count++;
+    }
+    if (count == 0) {
+        errno = ENODATA;
+        goto error;
+    }
+    if (!(f = purge_commit (purge, txn, jobs, count)))
         goto error;
     flux_kvs_txn_destroy (txn);
     json_decref (jobs);
-    /* N.B. if kvs commit fails, jobs are still removed from the hash/list.
-     * It doesn't seem worth the effort to structure the code to avoid this
-     * due to high complexity of solution, low probability of error, and
-     * minor consequences.
-     */
     return f;
 error:
     flux_kvs_txn_destroy (txn);
     json_decref (jobs);
-    flux_future_destroy (f);
     return NULL;
 }
 
@@ -531,6 +604,166 @@ error:
         flux_log_error (h, "error responding to purge id request");
 }
 
+static void purge_ids_destroy (struct purge_ids *pi)
+{
+    if (pi) {
+        int saved_errno = errno;
+        json_decref (pi->ids);
+        free (pi);
+        errno = saved_errno;
+    }
+}
+
+static void purge_ids_continuation (flux_future_t *f, void *arg)
+{
+    flux_t *h = flux_future_get_flux (f);
+    struct purge *purge = arg;
+    int count = ptr2int (flux_future_aux_get (f, "count"));
+    const flux_msg_t *msg = find_request (purge->requests, f);
+    struct purge_ids *pi;
+    flux_future_t *f2;
+
+    assert (msg != NULL);
+    pi = flux_msg_aux_get (msg, "purge_ids");
+    if (flux_rpc_get (f, NULL) < 0) {
+        if (flux_respond_error (h, msg, errno, future_strerror (f, errno)) < 0)
+            flux_log_error (h, "error responding to purge-ids request");
+        goto done;
+    }
+    if (flux_respond_pack (h, msg, "{s:i}", "count", count) < 0)
+        flux_log_error (h, "error responding to purge-ids request");
+    if (!(f2 = purge_ids_next (purge, pi))
+        || flux_future_then (f2, -1, purge_ids_continuation, purge) < 0) {
+        flux_future_destroy (f2);
+        if (flux_respond_error (h, msg, errno, NULL) < 0) // ENODATA ends it
+            flux_log_error (h, "error responding to purge-ids request");
+        goto done;
+    }
+    // replaces (and destroys) f
+    if (flux_msg_aux_set (msg,
+                          "future",
+                          f2,
+                          (flux_free_f)flux_future_destroy) < 0) {
+        flux_future_destroy (f2);
+        if (flux_respond_error (h, msg, errno, NULL) < 0)
+            flux_log_error (h, "error responding to purge-ids request");
+        goto done;
+    }
+    return;
+done:
+    // assumes cursor still positioned from find_request(), and destroys f
+    flux_msglist_delete (purge->requests);
+}
+
+/* Purge a list of job ids, committing one KVS transaction per 'batch' jobs.
+ * All ids are checked before anything is purged, so an invalid id fails
+ * the whole request.  Responses {"count":i} are streamed as each batch is
+ * committed, followed by ENODATA.  Without 'force', a single response with
+ * the number of ids that would be purged is sent instead.
+ */
+static void purge_ids_request_cb (flux_t *h,
+                                  flux_msg_handler_t *mh,
+                                  const flux_msg_t *msg,
+                                  void *arg)
+{
+    struct purge *purge = arg;
+    json_t *ids;
+    int batch;
+    int force;
+    size_t index;
+    json_t *o;
+    struct purge_ids *pi = NULL;
+    zhashx_t *candidates = NULL;
+    flux_future_t *f;
+    const char *errmsg = NULL;
+    flux_error_t error;
+
+    if (flux_request_unpack (msg,
+                             NULL,
+                             "{s:o s:i s:b}",
+                             "ids", &ids,
+                             "batch", &batch,
+                             "force", &force) < 0)
+        goto error;
+    if (!flux_msg_is_streaming (msg)) {
+        errno = EPROTO;
+        goto error;
+    }
+    if (!json_is_array (ids)) {
+        errmsg = "ids must be an array";
+        errno = EPROTO;
+        goto error;
+    }
+    if (batch < 1 || batch > purge_batch_max) {
+        errprintf (&error, "batch must be >= 1 and <= %d", purge_batch_max);
+        errmsg = error.text;
+        errno = EINVAL;
+        goto error;
+    }
+    /* Without force, count unique candidates, since duplicate ids are
+     * only purged once.
+     */
+    if (!force && !(candidates = job_hash_create ()))
+        goto error;
+    json_array_foreach (ids, index, o) {
+        flux_jobid_t id = json_integer_value (o);
+        struct job *job;
+        const char *s;
+
+        if (!json_is_integer (o) || id == FLUX_JOBID_ANY) {
+            errmsg = "ids must be valid job ids";
+            errno = EPROTO;
+            goto error;
+        }
+        if (!(job = find_purge_candidate (purge, id, &s))) {
+            errprintf (&error, "%s: %s", idf58 (id), s);
+            errmsg = error.text;
+            goto error;
+        }
+        if (candidates)
+            (void)zhashx_insert (candidates, &job->id, job); // skip dups
+    }
+    if (!force) { // just return count
+        if (flux_respond_pack (h,
+                               msg,
+                               "{s:i}",
+                               "count", (int)zhashx_size (candidates)) < 0)
+            flux_log_error (h, "error responding to purge-ids request");
+        errno = ENODATA;
+        goto error;
+    }
+    if (!(pi = calloc (1, sizeof (*pi))))
+        goto error;
+    pi->ids = json_incref (ids);
+    pi->batch = batch;
+    if (flux_msg_aux_set (msg,
+                          "purge_ids",
+                          pi,
+                          (flux_free_f)purge_ids_destroy) < 0) {
+        purge_ids_destroy (pi);
+        goto error;
+    }
+    if (!(f = purge_ids_next (purge, pi))
+        || flux_future_then (f, -1, purge_ids_continuation, purge) < 0) {
+        flux_future_destroy (f);
+        goto error; // ENODATA if 'ids' is empty
+    }
+    if (flux_msg_aux_set (msg,
+                          "future",
+                          f,
+                          (flux_free_f)flux_future_destroy) < 0) {
+        flux_future_destroy (f);
+        goto error;
+    }
+    if (flux_msglist_append (purge->requests, msg) < 0)
+        goto error; // future destroyed with msg by dispatcher
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, errmsg) < 0)
+        flux_log_error (h, "error responding to purge-ids request");
+    zhashx_destroy (&candidates);
+}
+
 static int purge_parse_config (const flux_conf_t *conf,
                                flux_error_t *error,
                                void *arg)
@@ -571,6 +804,7 @@ static int purge_parse_config (const flux_conf_t *conf,
 static const struct flux_msg_handler_spec htab[] = {
     { FLUX_MSGTYPE_REQUEST, "job-manager.purge", purge_request_cb, 0 },
     { FLUX_MSGTYPE_REQUEST, "job-manager.purge-id", purge_id_request_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "job-manager.purge-ids", purge_ids_request_cb, 0 },
     FLUX_MSGHANDLER_TABLE_END,
 };
 
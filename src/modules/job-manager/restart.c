@@ -14,11 +14,13 @@
 #include "config.h"
 #endif
 #include <stdlib.h>
+#include <stdarg.h>
 #include <flux/core.h>
 
 #include "src/common/libjob/idf58.h"
 #include "src/common/libutil/fluid.h"
 #include "src/common/libutil/errprintf.h"
+#include "src/common/libutil/monotime.h"
 #include "src/common/libczmqcontainers/czmq_containers.h"
 
 #include "job.h"
@@ -37,6 +39,11 @@ const char *checkpoint_key = "checkpoint.job-manager";
 
 #define CHECKPOINT_VERSION 1
 
+/* Default maximum number of KVS requests outstanding during replay.
+ * Override with job-manager.restart-max-inflight.
+ */
+#define RESTART_MAX_INFLIGHT_DEFAULT 1024
+
 int restart_count_char (const char *s, char c)
 {
     int count = 0;
@@ -75,64 +82,6 @@ static const char *lookup_job_data_get (flux_future_t *f,
     return result;
 }
 
-static struct job *lookup_job (flux_t *h,
-                               flux_jobid_t id,
-                               flux_error_t *error,
-                               bool *fatal)
-{
-    flux_future_t *f1 = NULL;
-    flux_future_t *f2 = NULL;
-    flux_future_t *f3 = NULL;
-    const char *eventlog;
-    const char *jobspec;
-    const char *R;
-    struct job *job = NULL;
-    flux_error_t e;
-
-    if (!(f1 = lookup_job_data (h, id, "eventlog"))
-        || !(f2 = lookup_job_data (h, id, "jobspec"))
-        || !(f3 = lookup_job_data (h, id, "R"))) {
-        errprintf (error,
-                   "cannot send lookup requests for job %s: %s",
-                   idf58 (id),
-                   strerror (errno));
-        *fatal = true;
-        goto done;
-    }
-    if (!(eventlog = lookup_job_data_get (f1, error))) {
-        *fatal = false;
-        goto done;
-    }
-    if (!(jobspec = lookup_job_data_get (f2, error))) {
-        *fatal = false;
-        goto done;
-    }
-    /* Ignore error if this returns NULL, since R is only available
-     * after resources have been allocated.
-     */
-    R = lookup_job_data_get (f3, NULL);
-
-    /* Treat these errors as non-fatal to avoid a nuisance on restart.
-     * See also: flux-framework/flux-core#6123
-     */
-    if (!(job = job_create_from_eventlog (id,
-                                          eventlog,
-                                          jobspec,
-                                          R,
-                                          &e))) {
-        errprintf (error,
-                   "replay %s: %s",
-                   flux_kvs_lookup_get_key (f1),
-                   e.text);
-        *fatal = false;
-    }
-done:
-    flux_future_destroy (f1);
-    flux_future_destroy (f2);
-    flux_future_destroy (f3);
-    return job;
-}
-
 /* A job could not be reloaded due to some problem like a truncated eventlog.
  * Move job data to job-lost+found for manual cleanup.
  */
@@ -154,127 +103,502 @@ static void move_to_lost_found (flux_t *h, const char *key, flux_jobid_t id)
     flux_future_destroy (f);
 }
 
-/* Create a 'struct job' from the KVS, using synchronous KVS RPCs.
- * Return 1 on success, 0 on non-fatal error, or -1 on a fatal error,
- * where a fatal error will prevent flux from starting.
+/* Replay engine.
+ *
+ * The job directory is walked with READDIR requests, and each job's
+ * eventlog, jobspec, and R are fetched with KVS lookups.  Up to
+ * 'max_inflight' requests are kept outstanding, and responses are
+ * handled in completion order by continuations running on a private
+ * reactor, using a clone of the job manager's handle.  Other messages
+ * received by the clone (e.g. requests for job-manager services) are
+ * requeued to the main handle once replay is complete, so no other
+ * job manager handlers run during replay.
+ *
+ * Jobs are collected in a list and handed to the restart_map_f callback
+ * in job ID order once all responses have been received.
  */
-static int depthfirst_map_one (flux_t *h,
-                               const char *key,
-                               int dirskip,
-                               restart_map_f cb,
-                               void *arg,
-                               flux_error_t *error)
-{
+struct replay_job {
+    struct replay *rp;
     flux_jobid_t id;
-    struct job *job = NULL;
-    int rc = -1;
+    char *key;
+    flux_future_t *f_eventlog;
+    flux_future_t *f_jobspec;
+    flux_future_t *f_R;
+    int pending;
+    void *handle;           // handle in replay->active
+};
+
+struct replay {
+    flux_t *h;              // job manager handle
+    flux_t *h_replay;       // clone of 'h' attached to 'r'
+    flux_reactor_t *r;
+    int dirskip;
+    int max_inflight;
+    int inflight;           // outstanding KVS requests
+    zlist_t *dirs;          // directory keys awaiting READDIR
+    zlistx_t *pending;      // replay_jobs awaiting lookups
+    zlistx_t *active;       // replay_jobs with lookups outstanding
+    zlistx_t *jobs;         // replayed jobs, sorted by ID after replay
+    zlistx_t *lost;         // replay_jobs that could not be replayed
+    int dir_count;
+    bool failed;
+    flux_error_t error;
+};
+
+static void replay_job_destroy (struct replay_job *rj)
+{
+    if (rj) {
+        int saved_errno = errno;
+        flux_future_destroy (rj->f_eventlog);
+        flux_future_destroy (rj->f_jobspec);
+        flux_future_destroy (rj->f_R);
+        free (rj->key);
+        free (rj);
+        errno = saved_errno;
+    }
+}
 
-    if (strlen (key) <= dirskip) {
-        errprintf (error, "internal error key=%s dirskip=%d", key, dirskip);
+// zlistx_destructor_fn signature
+static void replay_job_destructor (void **item)
+{
+    if (item) {
+        replay_job_destroy (*item);
+        *item = NULL;
+    }
+}
+
+static struct replay_job *replay_job_create (struct replay *rp,
+                                             const char *key,
+                                             flux_error_t *error)
+{
+    struct replay_job *rj;
+
+    if (strlen (key) <= rp->dirskip) {
+        errprintf (error,
+                   "internal error key=%s dirskip=%d",
+                   key,
+                   rp->dirskip);
         errno = EINVAL;
+        return NULL;
+    }
+    if (!(rj = calloc (1, sizeof (*rj))))
+        goto nomem;
+    rj->rp = rp;
+    if (!(rj->key = strdup (key)))
+        goto nomem;
+    if (fluid_decode (key + rp->dirskip + 1,
+                      &rj->id,
+                      FLUID_STRING_DOTHEX) < 0) {
+        errprintf (error,
+                   "could not decode %s to job ID",
+                   key + rp->dirskip + 1);
+        replay_job_destroy (rj);
+        return NULL;
+    }
+    return rj;
+nomem:
+    errprintf (error, "out of memory");
+    replay_job_destroy (rj);
+    errno = ENOMEM;
+    return NULL;
+}
+
+// zlistx_destructor_fn signature
+static void job_list_destructor (void **item)
+{
+    if (item) {
+        job_decref (*item);
+        *item = NULL;
+    }
+}
+
+// zlistx_comparator_fn signature
+static int job_id_comparator (const void *a1, const void *a2)
+{
+    const struct job *j1 = a1;
+    const struct job *j2 = a2;
+
+    if (j1->id < j2->id)
         return -1;
+    return j1->id > j2->id ? 1 : 0;
+}
+
+static void replay_destroy (struct replay *rp)
+{
+    if (rp) {
+        int saved_errno = errno;
+        zlistx_destroy (&rp->pending);
+        zlistx_destroy (&rp->active);
+        zlistx_destroy (&rp->lost);
+        zlistx_destroy (&rp->jobs);
+        if (rp->dirs) {
+            char *key;
+            while ((key = zlist_pop (rp->dirs)))
+                free (key);
+            zlist_destroy (&rp->dirs);
+        }
+        if (rp->h_replay) {
+            (void)flux_dispatch_requeue (rp->h_replay);
+            flux_close (rp->h_replay);
+        }
+        flux_reactor_destroy (rp->r);
+        free (rp);
+        errno = saved_errno;
     }
-    if (fluid_decode (key + dirskip + 1, &id, FLUID_STRING_DOTHEX) < 0) {
-        errprintf (error, "could not decode %s to job ID", key + dirskip + 1);
+}
+
+static struct replay *replay_create (flux_t *h,
+                                     int dirskip,
+                                     int max_inflight)
+{
+    struct replay *rp;
+
+    if (!(rp = calloc (1, sizeof (*rp))))
+        return NULL;
+    rp->h = h;
+    rp->dirskip = dirskip;
+    rp->max_inflight = max_inflight;
+    if (!(rp->r = flux_reactor_create (0))
+        || !(rp->h_replay = flux_clone (h))
+        || flux_set_reactor (rp->h_replay, rp->r) < 0)
+        goto error;
+    if (!(rp->dirs = zlist_new ())
+        || !(rp->pending = zlistx_new ())
+        || !(rp->active = zlistx_new ())
+        || !(rp->lost = zlistx_new ())
+        || !(rp->jobs = zlistx_new ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    zlistx_set_destructor (rp->pending, replay_job_destructor);
+    zlistx_set_destructor (rp->active, replay_job_destructor);
+    zlistx_set_destructor (rp->lost, replay_job_destructor);
+    zlistx_set_destructor (rp->jobs, job_list_destructor);
+    zlistx_set_comparator (rp->jobs, job_id_comparator);
+    return rp;
+error:
+    replay_destroy (rp);
+    return NULL;
+}
+
+/* Stop replay on a fatal error.  Only the first error is recorded.
+ */
+static void replay_fail (struct replay *rp, const char *fmt, ...)
+{
+    if (!rp->failed) {
+        va_list ap;
+        va_start (ap, fmt);
+        vsnprintf (rp->error.text, sizeof (rp->error.text), fmt, ap);
+        va_end (ap);
+        rp->failed = true;
+    }
+    flux_reactor_stop (rp->r);
+}
+
+static int replay_queue_dir (struct replay *rp, const char *key)
+{
+    char *cpy;
+
+    if (!(cpy = strdup (key)))
+        return -1;
+    if (zlist_append (rp->dirs, cpy) < 0) {
+        free (cpy);
+        errno = ENOMEM;
         return -1;
     }
+    return 0;
+}
 
-    flux_error_t lookup_error;
-    bool fatal = false;
-    if (!(job = lookup_job (h, id, &lookup_error, &fatal))) {
-        if (fatal) {
-            errprintf (error, "%s", lookup_error.text);
-            return -1;
-        }
-        move_to_lost_found (h, key, id);
-        flux_log (h,
-                  LOG_ERR,
-                  "job %s not replayed: %s",
-                  idf58 (id),
-                  lookup_error.text);
-        return 0;
+static void replay_pump (struct replay *rp);
+
+/* Called once all lookups for a job have completed.
+ * Errors here are treated as non-fatal to avoid a nuisance on restart
+ * (see also: flux-framework/flux-core#6123).  The job is moved to the
+ * lost list and its KVS data is moved to job-lost+found after replay.
+ */
+static void replay_job_complete (struct replay_job *rj)
+{
+    struct replay *rp = rj->rp;
+    const char *eventlog;
+    const char *jobspec;
+    const char *R;
+    struct job *job;
+    flux_error_t error;
+    flux_error_t e;
+
+    if (!(eventlog = lookup_job_data_get (rj->f_eventlog, &error))
+        || !(jobspec = lookup_job_data_get (rj->f_jobspec, &error)))
+        goto lost;
+    /* Ignore error if this returns NULL, since R is only available
+     * after resources have been allocated.
+     */
+    R = lookup_job_data_get (rj->f_R, NULL);
+
+    if (!(job = job_create_from_eventlog (rj->id, eventlog, jobspec, R, &e))) {
+        errprintf (&error,
+                   "replay %s: %s",
+                   flux_kvs_lookup_get_key (rj->f_eventlog),
+                   e.text);
+        goto lost;
+    }
+    if (!zlistx_add_end (rp->jobs, job)) {
+        job_decref (job);
+        replay_fail (rp, "out of memory adding job %s", idf58 (rj->id));
+        return;
     }
+    zlistx_delete (rp->active, rj->handle);
+    return;
+lost:
+    flux_log (rp->h,
+              LOG_ERR,
+              "job %s not replayed: %s",
+              idf58 (rj->id),
+              error.text);
+    zlistx_detach (rp->active, rj->handle);
+    rj->handle = NULL;
+    flux_future_destroy (rj->f_eventlog);
+    flux_future_destroy (rj->f_jobspec);
+    flux_future_destroy (rj->f_R);
+    rj->f_eventlog = rj->f_jobspec = rj->f_R = NULL;
+    if (!zlistx_add_end (rp->lost, rj)) {
+        replay_job_destroy (rj);
+        replay_fail (rp, "out of memory adding lost job");
+    }
+}
 
-    if (cb (job, arg, error) < 0)
-        goto done;
-    rc = 1;
-done:
-    job_decref (job);
-    return rc;
+static void replay_job_continuation (flux_future_t *f, void *arg)
+{
+    struct replay_job *rj = arg;
+    struct replay *rp = rj->rp;
+
+    rp->inflight--;
+    if (--rj->pending == 0)
+        replay_job_complete (rj);
+    replay_pump (rp);
 }
 
-static int depthfirst_map (flux_t *h,
-                           const char *key,
-                           int dirskip,
-                           restart_map_f cb,
-                           void *arg,
-                           flux_error_t *error)
+static int replay_job_start (struct replay_job *rj)
 {
-    flux_future_t *f;
+    flux_t *h = rj->rp->h_replay;
+
+    if (!(rj->f_eventlog = lookup_job_data (h, rj->id, "eventlog"))
+        || flux_future_then (rj->f_eventlog,
+                             -1,
+                             replay_job_continuation,
+                             rj) < 0
+        || !(rj->f_jobspec = lookup_job_data (h, rj->id, "jobspec"))
+        || flux_future_then (rj->f_jobspec,
+                             -1,
+                             replay_job_continuation,
+                             rj) < 0
+        || !(rj->f_R = lookup_job_data (h, rj->id, "R"))
+        || flux_future_then (rj->f_R, -1, replay_job_continuation, rj) < 0)
+        return -1;
+    rj->pending = 3;
+    rj->rp->inflight += 3;
+    return 0;
+}
+
+/* Queue the children of a job directory.  Children of a directory
+ * at path level 3 (e.g. job.0000.0004.b200.0000) are job directories,
+ * otherwise they are intermediate directories that must be read.
+ */
+static void replay_dir_continuation (flux_future_t *f, void *arg)
+{
+    struct replay *rp = arg;
+    const char *key = flux_kvs_lookup_get_key (f);
+    int path_level = restart_count_char (key + rp->dirskip, '.');
     const flux_kvsdir_t *dir;
-    flux_kvsitr_t *itr;
+    flux_kvsitr_t *itr = NULL;
     const char *name;
-    int path_level;
-    int count = 0;
-    int rc = -1;
+    char *nkey = NULL;
 
-    path_level = restart_count_char (key + dirskip, '.');
-    if (!(f = flux_kvs_lookup (h, NULL, FLUX_KVS_READDIR, key))) {
-        errprintf (error,
-                   "cannot send lookup request for %s: %s",
-                   key,
-                   strerror (errno));
-        return -1;
-    }
+    rp->inflight--;
     if (flux_kvs_lookup_get_dir (f, &dir) < 0) {
-        if (errno == ENOENT && path_level == 0)
-            rc = 0;
-        else {
-            errprintf (error,
-                       "could not look up %s: %s",
-                       key,
-                       strerror (errno));
-        }
+        if (errno != ENOENT || path_level != 0)
+            replay_fail (rp, "could not look up %s: %s", key, strerror (errno));
         goto done;
     }
     if (!(itr = flux_kvsitr_create (dir))) {
-        errprintf (error,
-                   "could not create iterator for %s: %s",
-                   key,
-                   strerror (errno));
+        replay_fail (rp,
+                     "could not create iterator for %s: %s",
+                     key,
+                     strerror (errno));
         goto done;
     }
     while ((name = flux_kvsitr_next (itr))) {
-        char *nkey;
-        int n;
         if (!flux_kvsdir_isdir (dir, name))
             continue;
         if (!(nkey = flux_kvsdir_key_at (dir, name))) {
-            errprintf (error,
-                       "could not build key for %s in %s: %s",
-                       name,
-                       key,
-                       strerror (errno));
-            goto done_destroyitr;
+            replay_fail (rp,
+                         "could not build key for %s in %s: %s",
+                         name,
+                         key,
+                         strerror (errno));
+            goto done;
         }
-        if (path_level == 3) // orig 'key' = .A.B.C, thus 'nkey' is complete
-            n = depthfirst_map_one (h, nkey, dirskip, cb, arg, error);
-        else
-            n = depthfirst_map (h, nkey, dirskip, cb, arg, error);
-        if (n < 0) {
-            int saved_errno = errno;
-            free (nkey);
-            errno = saved_errno;
-            goto done_destroyitr;
+        // orig 'key' = .A.B.C, thus 'nkey' is complete
+        if (path_level == 3) {
+            struct replay_job *rj;
+            if (!(rj = replay_job_create (rp, nkey, &rp->error))) {
+                rp->failed = true;
+                flux_reactor_stop (rp->r);
+                goto done;
+            }
+            if (!zlistx_add_end (rp->pending, rj)) {
+                replay_job_destroy (rj);
+                replay_fail (rp, "out of memory queuing %s", nkey);
+                goto done;
+            }
+        }
+        else if (replay_queue_dir (rp, nkey) < 0) {
+            replay_fail (rp, "out of memory queuing %s", nkey);
+            goto done;
         }
-        count += n;
         free (nkey);
+        nkey = NULL;
     }
-    rc = count;
-done_destroyitr:
-    flux_kvsitr_destroy (itr);
+    rp->dir_count++;
 done:
+    free (nkey);
+    flux_kvsitr_destroy (itr);
     flux_future_destroy (f);
+    replay_pump (rp);
+}
+
+/* Keep up to max_inflight requests outstanding.  Job lookups are
+ * preferred over READDIR requests so that the set of discovered but
+ * unreplayed jobs stays small.  Stop the reactor when all work is done.
+ */
+static void replay_pump (struct replay *rp)
+{
+    struct replay_job *rj;
+    char *key;
+
+    if (rp->failed)
+        return;
+    while (rp->inflight < rp->max_inflight) {
+        if ((rj = zlistx_first (rp->pending))) {
+            zlistx_detach_cur (rp->pending);
+            if (!(rj->handle = zlistx_add_end (rp->active, rj))) {
+                replay_job_destroy (rj);
+                replay_fail (rp, "out of memory");
+                return;
+            }
+            if (replay_job_start (rj) < 0) {
+                replay_fail (rp,
+                             "cannot send lookup requests for job %s: %s",
+                             idf58 (rj->id),
+                             strerror (errno));
+                return;
+            }
+        }
+        else if ((key = zlist_pop (rp->dirs))) {
+            flux_future_t *f;
+
+            if (!(f = flux_kvs_lookup (rp->h_replay,
+                                       NULL,
+                                       FLUX_KVS_READDIR,
+                                       key))
+                || flux_future_then (f,
+                                     -1,
+                                     replay_dir_continuation,
+                                     rp) < 0) {
+                replay_fail (rp,
+                             "cannot send lookup request for %s: %s",
+                             key,
+                             strerror (errno));
+                flux_future_destroy (f);
+                free (key);
+                return;
+            }
+            rp->inflight++;
+            free (key);
+        }
+        else
+            break;
+    }
+    if (rp->inflight == 0)
+        flux_reactor_stop (rp->r);
+}
+
+static int replay_max_inflight (flux_t *h, int *valp, flux_error_t *error)
+{
+    int max_inflight = RESTART_MAX_INFLIGHT_DEFAULT;
+    flux_error_t e;
+
+    if (flux_conf_unpack (flux_get_conf (h),
+                          &e,
+                          "{s?{s?i}}",
+                          "job-manager",
+                            "restart-max-inflight", &max_inflight) < 0)
+        return errprintf (error,
+                          "job-manager.restart-max-inflight: %s",
+                          e.text);
+    if (max_inflight < 1)
+        return errprintf (error,
+                          "job-manager.restart-max-inflight: must be >= 1");
+    *valp = max_inflight;
+    return 0;
+}
+
+/* Replay all jobs under 'key', calling 'cb' on each in job ID order.
+ * Return the number of jobs replayed, or -1 on a fatal error, where a
+ * fatal error will prevent flux from starting.
+ */
+static int replay_map (struct job_manager *ctx,
+                       const char *key,
+                       int dirskip,
+                       restart_map_f cb,
+                       void *arg,
+                       flux_error_t *error)
+{
+    struct replay *rp;
+    struct replay_job *rj;
+    struct job *job;
+    int max_inflight;
+    int count = 0;
+    int rc = -1;
+
+    if (replay_max_inflight (ctx->h, &max_inflight, error) < 0)
+        return -1;
+    if (!(rp = replay_create (ctx->h, dirskip, max_inflight))) {
+        errprintf (error, "error setting up replay: %s", strerror (errno));
+        return -1;
+    }
+    ctx->restart_stats.max_inflight = max_inflight;
+    if (replay_queue_dir (rp, key) < 0) {
+        errprintf (error, "out of memory");
+        goto done;
+    }
+    replay_pump (rp);
+    if (!rp->failed && flux_reactor_run (rp->r, 0) < 0)
+        replay_fail (rp, "replay reactor: %s", strerror (errno));
+    if (rp->failed) {
+        errprintf (error, "%s", rp->error.text);
+        goto done;
+    }
+    ctx->restart_stats.dirs = rp->dir_count;
+    /* Move any jobs that could not be replayed out of the way now that
+     * replay is complete, so the main handle may be used synchronously.
+     */
+    rj = zlistx_first (rp->lost);
+    while (rj) {
+        move_to_lost_found (ctx->h, rj->key, rj->id);
+        ctx->restart_stats.lost++;
+        rj = zlistx_next (rp->lost);
+    }
+    zlistx_sort (rp->jobs);
+    job = zlistx_first (rp->jobs);
+    while (job) {
+        if (cb (job, arg, error) < 0)
+            goto done;
+        count++;
+        job = zlistx_next (rp->jobs);
+    }
+    rc = count;
+done:
+    replay_destroy (rp);
     return rc;
 }
 
@@ -386,20 +710,29 @@ int restart_from_kvs (struct job_manager *ctx)
     struct job *job;
     zlistx_t *active_jobs;
     flux_error_t error;
+    struct timespec t0;
+
+    monotime (&t0);
 
     /* Load any active jobs present in the KVS at startup.
      */
-    count = depthfirst_map (ctx->h,
-                            dirname,
-                            dirskip,
-                            restart_map_cb,
-                            ctx,
-                            &error);
+    count = replay_map (ctx,
+                        dirname,
+                        dirskip,
+                        restart_map_cb,
+                        ctx,
+                        &error);
     if (count < 0) {
         flux_log (ctx->h, LOG_ERR, "restart failed: %s", error.text);
         return -1;
     }
-    flux_log (ctx->h, LOG_INFO, "restart: %d jobs", count);
+    ctx->restart_stats.jobs = count;
+    ctx->restart_stats.t_replay = monotime_since (t0) / 1000.;
+    flux_log (ctx->h,
+              LOG_INFO,
+              "restart: %d jobs replayed in %.3fs",
+              count,
+              ctx->restart_stats.t_replay);
 
     /* Get active jobs as list for safe iteration:
      */
@@ -495,9 +828,27 @@ int restart_from_kvs (struct job_manager *ctx)
               LOG_DEBUG,
               "restart: max_jobid=%s",
               idf58 (ctx->max_jobid));
+    ctx->restart_stats.t_ready = monotime_since (t0) / 1000.;
     return 0;
 }
 
+json_t *restart_get_stats (struct job_manager *ctx)
+{
+    struct restart_stats *stats = &ctx->restart_stats;
+    double rate = 0.;
+
+    if (stats->t_replay > 0.)
+        rate = stats->jobs / stats->t_replay;
+    return json_pack ("{s:i s:i s:i s:i s:f s:f s:f}",
+                      "jobs", stats->jobs,
+                      "lost", stats->lost,
+                      "directories", stats->dirs,
+                      "max_inflight", stats->max_inflight,
+                      "replay_time", stats->t_replay,
+                      "replay_rate", rate,
+                      "ready_time", stats->t_ready);
+}
+
 /*
  * vi:tabstop=4 shiftwidth=4 expandtab
  */
@@ -17,6 +17,10 @@
 
 int restart_from_kvs (struct job_manager *ctx);
 
+/* Return replay statistics for the 'job-manager.stats-get' response.
+ */
+json_t *restart_get_stats (struct job_manager *ctx);
+
 /* exposed for unit testing only */
 int restart_count_char (const char *s, char c);
 
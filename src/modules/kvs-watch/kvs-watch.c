@@ -41,7 +41,7 @@ struct watcher {
     int initial_rootseq;        // initial rootseq returned by initial rpc
     char *key;                  // lookup key
     int flags;                  // kvs_lookup flags
-    zlist_t *lookups;           // list of futures, in commit order
+    zlist_t *lookups;           // list of struct lookup, in commit order
     zlist_t *loads;             // list of futures, content loads in ref order
 
     struct ns_monitor *nsm;     // back pointer for removal
@@ -51,6 +51,33 @@ struct watcher {
     int prev_end_index;         // previous end index loaded
     int loaded_blob_count;      // number of indices loaded (for FLUX_KVS_STREAM)
     void *handle;               // zlistx_t handle
+    struct watch_key *wk;       // key index entry
+    void *key_handle;           // wk->watchers handle
+    void *full_handle;          // nsm->full_watchers handle (WATCH_FULL)
+};
+
+/* A kvs.lookup-plus RPC.  Watchers of the same key that need the same
+ * lookup at the same root share one RPC, and the response is handed to
+ * each subscribed watcher in turn.  Each subscriber holds a reference.
+ */
+struct lookup {
+    flux_future_t *f;
+    int refcount;
+    int flags;                  // lookup flags sent to the KVS
+    struct flux_msg_cred cred;  // lookup cred
+    struct watch_key *wk;       // set while on wk->lookups
+    struct watcher **watchers;  // subscribers, NULL once unsubscribed
+    int count;
+    int size;
+};
+
+/* Watchers of one normalized key in a namespace.
+ */
+struct watch_key {
+    char *key;                  // hash key for nsm->keys
+    zlistx_t *watchers;         // watchers of this key
+    int rootseq;                // root sequence number of 'lookups'
+    zlist_t *lookups;           // lookups sent at 'rootseq', for coalescing
 };
 
 /* Current KVS root.
@@ -70,6 +97,10 @@ struct commit {
  * and survive entry removals.  That cannot be done with zhashx_t without
  * retrieving a costly zhashx_keys() list.  Thus, we have watchers on a list
  * and a separate hash for quick lookup access to watchers.
+ *
+ * Watchers are also indexed by key, so that a setroot event need only
+ * visit watchers of the keys changed by the commit, plus WATCH_FULL
+ * watchers, which respond to every commit.
  */
 struct ns_monitor {
     char *ns_name;              // namespace name, hash key for ctx->namespaces
@@ -80,6 +111,11 @@ struct ns_monitor {
     struct watch_ctx *ctx;      // back-pointer to watch_ctx
     zlistx_t *watchers;         // list of watchers of this namespace
     zhashx_t *watcher_matchtags;// matchtags -> watchers quick lookup
+    zhashx_t *keys;             // key -> struct watch_key
+    zlistx_t *full_watchers;    // WATCH_FULL watchers
+    int pending;                // indexed watchers yet to send initial rpc
+    unsigned long lookups;      // lookup RPCs sent
+    unsigned long coalesced;    // lookups satisfied by another watcher's RPC
     char *topic;                // topic string for subscription
     bool subscribed;            // subscription active
     flux_future_t *getrootf;    // initial getroot future
@@ -93,8 +129,57 @@ struct watch_ctx {
     flux_msg_handler_t **handlers;
     zhashx_t *namespaces;        // hash of monitored namespaces
     zhashx_t *namespace_matchtags; // matchtags -> namespaces w/ requests
+    unsigned long lookups;       // lookup RPCs sent, all namespaces
+    unsigned long coalesced;     // lookups coalesced, all namespaces
 };
 
+static void lookup_destroy (struct lookup *l)
+{
+    if (l) {
+        int saved_errno = errno;
+        flux_future_destroy (l->f);
+        free (l->watchers);
+        free (l);
+        errno = saved_errno;
+    }
+}
+
+static void lookup_decref (struct lookup *l)
+{
+    if (l && --l->refcount == 0)
+        lookup_destroy (l);
+}
+
+static int lookup_subscribe (struct lookup *l, struct watcher *w)
+{
+    if (l->count == l->size) {
+        int size = l->size ? l->size * 2 : 1;
+        struct watcher **watchers;
+        if (!(watchers = realloc (l->watchers, size * sizeof (*watchers))))
+            return -1;
+        l->watchers = watchers;
+        l->size = size;
+    }
+    if (zlist_append (w->lookups, l) < 0) {
+        errno = ENOMEM;
+        return -1;
+    }
+    l->watchers[l->count++] = w;
+    l->refcount++;
+    return 0;
+}
+
+static void lookup_unsubscribe (struct lookup *l, struct watcher *w)
+{
+    for (int i = 0; i < l->count; i++) {
+        if (l->watchers[i] == w) {
+            l->watchers[i] = NULL;
+            break;
+        }
+    }
+    lookup_decref (l);
+}
+
 static void watcher_destroy (struct watcher *w)
 {
     if (w) {
@@ -103,9 +188,9 @@ static void watcher_destroy (struct watcher *w)
         free (w->matchtag_key);
         free (w->key);
         if (w->lookups) {
-            flux_future_t *f;
-            while ((f = zlist_pop (w->lookups)))
-                flux_future_destroy (f);
+            struct lookup *l;
+            while ((l = zlist_pop (w->lookups)))
+                lookup_unsubscribe (l, w);
             zlist_destroy (&w->lookups);
         }
         if (w->loads) {
@@ -184,13 +269,65 @@ static struct commit *commit_create (const char *rootref,
     return commit;
 }
 
+static void watch_key_clear_lookups (struct watch_key *wk)
+{
+    struct lookup *l;
+
+    while ((l = zlist_pop (wk->lookups))) {
+        l->wk = NULL;
+        lookup_decref (l);
+    }
+}
+
+static void watch_key_destroy (struct watch_key *wk)
+{
+    if (wk) {
+        int saved_errno = errno;
+        if (wk->lookups) {
+            watch_key_clear_lookups (wk);
+            zlist_destroy (&wk->lookups);
+        }
+        zlistx_destroy (&wk->watchers);
+        free (wk->key);
+        free (wk);
+        errno = saved_errno;
+    }
+}
+
+static void watch_key_destructor (void **item)
+{
+    if (item) {
+        watch_key_destroy (*item);
+        *item = NULL;
+    }
+}
+
+static struct watch_key *watch_key_create (const char *key)
+{
+    struct watch_key *wk;
+
+    if (!(wk = calloc (1, sizeof (*wk)))
+        || !(wk->key = strdup (key))
+        || !(wk->watchers = zlistx_new ())
+        || !(wk->lookups = zlist_new ())) {
+        watch_key_destroy (wk);
+        errno = ENOMEM;
+        return NULL;
+    }
+    wk->rootseq = -1;
+    return wk;
+}
+
 static void namespace_destroy (void **data)
 {
     if (data) {
         struct ns_monitor *nsm = *data;
         int saved_errno = errno;
         commit_destroy (nsm->commit);
+        /* watchers refer to key index entries, so destroy them first */
         zlistx_destroy (&nsm->watchers);
+        zlistx_destroy (&nsm->full_watchers);
+        zhashx_destroy (&nsm->keys);
         zhashx_destroy (&nsm->watcher_matchtags);
         if (nsm->subscribed) {
             flux_future_t *f;
@@ -230,6 +367,14 @@ static struct ns_monitor *namespace_create (struct watch_ctx *ctx,
     zlistx_set_destructor (nsm->watchers, watcher_destructor);
     if (!(nsm->watcher_matchtags = zhashx_new ()))
         goto error;
+    if (!(nsm->keys = zhashx_new ()))
+        goto error;
+    /* key index entries own their keys */
+    zhashx_set_key_duplicator (nsm->keys, NULL);
+    zhashx_set_key_destructor (nsm->keys, NULL);
+    zhashx_set_destructor (nsm->keys, watch_key_destructor);
+    if (!(nsm->full_watchers = zlistx_new ()))
+        goto error;
     if (!(nsm->ns_name = strdup (ns)))
         goto error;
     nsm->owner = FLUX_USERID_UNKNOWN;
@@ -249,10 +394,56 @@ static bool key_match (json_t *o, const char *key)
     return false;
 }
 
+/* Add watcher to the namespace key index.
+ */
+static int watcher_index (struct ns_monitor *nsm, struct watcher *w)
+{
+    struct watch_key *wk;
+
+    if (!(wk = zhashx_lookup (nsm->keys, w->key))) {
+        if (!(wk = watch_key_create (w->key)))
+            return -1;
+        (void)zhashx_insert (nsm->keys, wk->key, wk);
+    }
+    if (!(w->key_handle = zlistx_add_end (wk->watchers, w))) {
+        if (zlistx_size (wk->watchers) == 0)
+            zhashx_delete (nsm->keys, wk->key);
+        errno = ENOMEM;
+        return -1;
+    }
+    w->wk = wk;
+    if (w->rootseq == -1)
+        nsm->pending++;
+    if ((w->flags & FLUX_KVS_WATCH_FULL)
+        && !(w->full_handle = zlistx_add_end (nsm->full_watchers, w))) {
+        errno = ENOMEM;
+        return -1;
+    }
+    return 0;
+}
+
+static void watcher_unindex (struct ns_monitor *nsm, struct watcher *w)
+{
+    if (w->full_handle) {
+        zlistx_delete (nsm->full_watchers, w->full_handle);
+        w->full_handle = NULL;
+    }
+    if (w->wk) {
+        if (w->rootseq == -1)
+            nsm->pending--;
+        zlistx_delete (w->wk->watchers, w->key_handle);
+        if (zlistx_size (w->wk->watchers) == 0)
+            zhashx_delete (nsm->keys, w->wk->key);
+        w->wk = NULL;
+        w->key_handle = NULL;
+    }
+}
+
 static void watcher_cleanup (struct ns_monitor *nsm, struct watcher *w)
 {
     /* it is possible lookups & loads are in flight, they will be
      * cleaned in watcher_destroy() */
+    watcher_unindex (nsm, w);
     zhashx_delete (nsm->watcher_matchtags, w->matchtag_key);
     zhashx_delete (nsm->ctx->namespace_matchtags, w->matchtag_key);
     zlistx_delete (nsm->watchers, w->handle);
@@ -831,20 +1022,19 @@ finished:
     w->finished = true;
 }
 
-/* One lookup has completed.
- * Pop ready futures off w->lookups and send responses, until
- * the list is empty, or a non-ready future is encountered.
+/* Pop ready lookups off w->lookups and send responses, until
+ * the list is empty, or a non-ready lookup is encountered.
  */
-static void lookup_continuation (flux_future_t *f, void *arg)
+static void watcher_process_lookups (struct watcher *w)
 {
-    struct watcher *w = arg;
     struct ns_monitor *nsm = w->nsm;
+    struct lookup *l;
 
-    while ((f = zlist_first (w->lookups)) && flux_future_is_ready (f)) {
-        f = zlist_pop (w->lookups);
+    while ((l = zlist_first (w->lookups)) && flux_future_is_ready (l->f)) {
+        l = zlist_pop (w->lookups);
         if (!w->finished)
-            handle_lookup_response (f, w);
-        flux_future_destroy (f);
+            handle_lookup_response (l->f, w);
+        lookup_unsubscribe (l, w);
         /* if WAITCREATE and (!WATCH and !STREAM), then we only care
          * about sending one response and being done.  We can use the
          * responded flag to indicate that condition.
@@ -859,6 +1049,36 @@ static void lookup_continuation (flux_future_t *f, void *arg)
         watcher_cleanup (nsm, w);
 }
 
+/* One lookup has completed.
+ * Process lookups of each subscribed watcher.  A watcher may be destroyed
+ * along the way, so hold a reference on 'l' until done.
+ */
+static void lookup_continuation (flux_future_t *f, void *arg)
+{
+    struct lookup *l = arg;
+
+    l->refcount++;
+    /* no more watchers will subscribe once the response is in */
+    if (l->wk) {
+        zlist_remove (l->wk->lookups, l);
+        l->wk = NULL;
+        l->refcount--;
+    }
+    for (int i = 0; i < l->count; i++) {
+        if (l->watchers[i])
+            watcher_process_lookups (l->watchers[i]);
+    }
+    lookup_decref (l);
+}
+
+static int lookup_flags (int flags)
+{
+    if ((flags & FLUX_KVS_WATCH_APPEND)
+        || (flags & FLUX_KVS_STREAM))
+        flags |= FLUX_KVS_TREEOBJ;
+    return flags;
+}
+
 /* Like flux_kvs_lookupat() except:
  * - targets kvs.lookup-plus, so root_ref & root_seq are available in
  *   response
@@ -877,13 +1097,10 @@ static flux_future_t *lookupat (flux_t *h,
     json_t *o = NULL;
     flux_future_t *f;
     int saved_errno;
-    int flags = w->flags;
+    int flags = lookup_flags (w->flags);
 
     if (!(msg = flux_request_encode ("kvs.lookup-plus", NULL)))
         return NULL;
-    if ((flags & FLUX_KVS_WATCH_APPEND)
-        || (flags & FLUX_KVS_STREAM))
-        flags |= FLUX_KVS_TREEOBJ;
     if (!w->initial_rpc_sent) {
         if (flux_msg_pack (msg,
                            "{s:s s:s s:i}",
@@ -932,26 +1149,92 @@ error:
     return NULL;
 }
 
-static int process_lookup_response (struct ns_monitor *nsm, struct watcher *w)
+static struct lookup *lookup_create (struct ns_monitor *nsm,
+                                     struct watcher *w)
 {
-    flux_future_t *f;
-    if (!(f = lookupat (nsm->ctx->h,
-                        w,
-                        nsm->commit->rootref,
-                        nsm->commit->rootseq,
-                        nsm->ns_name))) {
+    struct lookup *l;
+
+    if (!(l = calloc (1, sizeof (*l))))
+        return NULL;
+    l->flags = lookup_flags (w->flags);
+    l->cred = w->cred;
+    if (!(l->f = lookupat (nsm->ctx->h,
+                           w,
+                           nsm->commit->rootref,
+                           nsm->commit->rootseq,
+                           nsm->ns_name))) {
         flux_log_error (nsm->ctx->h, "%s: lookupat", __FUNCTION__);
-        return -1;
+        goto error;
     }
-    if (zlist_append (w->lookups, f) < 0) {
-        flux_future_destroy (f);
-        errno = ENOMEM;
-        return -1;
+    if (flux_future_then (l->f, -1., lookup_continuation, l) < 0)
+        goto error;
+    nsm->lookups++;
+    nsm->ctx->lookups++;
+    return l;
+error:
+    lookup_destroy (l);
+    return NULL;
+}
+
+/* Find a lookup already sent for another watcher of w->key at the
+ * current root that is equivalent to the one 'w' would send.
+ */
+static struct lookup *watch_key_find_lookup (struct watch_key *wk,
+                                             struct watcher *w)
+{
+    int flags = lookup_flags (w->flags);
+    struct lookup *l;
+
+    l = zlist_first (wk->lookups);
+    while (l) {
+        if (l->flags == flags
+            && l->cred.userid == w->cred.userid
+            && l->cred.rolemask == w->cred.rolemask)
+            return l;
+        l = zlist_next (wk->lookups);
     }
-    if (flux_future_then (f, -1., lookup_continuation, w) < 0) {
-        flux_future_destroy (f);
+    return NULL;
+}
+
+/* Send lookup for 'w' at the current root, or subscribe 'w' to an
+ * equivalent one already sent.  The initial lookup is never shared,
+ * since it is made against whatever root the KVS has when it arrives.
+ */
+static int process_lookup_response (struct ns_monitor *nsm, struct watcher *w)
+{
+    struct watch_key *wk = w->wk;
+    bool initial = !w->initial_rpc_sent;
+    struct lookup *l = NULL;
+
+    if (!initial) {
+        if (wk->rootseq == nsm->commit->rootseq)
+            l = watch_key_find_lookup (wk, w);
+        else {
+            watch_key_clear_lookups (wk);
+            wk->rootseq = nsm->commit->rootseq;
+        }
+    }
+    if (l) {
+        nsm->coalesced++;
+        nsm->ctx->coalesced++;
+    }
+    else {
+        if (!(l = lookup_create (nsm, w)))
+            return -1;
+        if (!initial) {
+            if (zlist_append (wk->lookups, l) == 0) {
+                l->wk = wk;
+                l->refcount++;
+            }
+        }
+    }
+    if (lookup_subscribe (l, w) < 0) {
+        if (l->refcount == 0)
+            lookup_destroy (l);
         return -1;
     }
+    if (w->rootseq == -1)
+        nsm->pending--;
     w->rootseq = nsm->commit->rootseq;
     return 0;
 }
@@ -1059,6 +1342,75 @@ static void watcher_respond_ns (struct ns_monitor *nsm)
     }
 }
 
+/* Respond to watchers affected by the current commit, that is, watchers
+ * of keys changed by the commit and WATCH_FULL watchers.  Fall back to
+ * watcher_respond_ns() if an error is pending for all watchers, or some
+ * watcher has not yet sent its initial lookup.
+ *
+ * N.B. watcher_respond() only ever destroys the watcher passed to it, and
+ * `nsm` is only destroyed once it has no watchers, so it is safe to walk
+ * a copy of the affected watchers.
+ */
+static void watcher_respond_commit (struct ns_monitor *nsm)
+{
+    json_t *keys = nsm->commit ? nsm->commit->keys : NULL;
+    struct watcher **v;
+    struct watcher *w;
+    size_t count = 0;
+
+    if (!keys
+        || nsm->pending > 0
+        || nsm->errnum != 0
+        || nsm->fatal_errnum != 0
+        || !(v = malloc (zlistx_size (nsm->watchers) * sizeof (*v)))) {
+        watcher_respond_ns (nsm);
+        return;
+    }
+    /* Walk whichever is smaller, the changed keys or the watched keys.
+     */
+    if (json_object_size (keys) < zhashx_size (nsm->keys)) {
+        const char *key;
+        json_t *value;
+
+        json_object_foreach (keys, key, value) {
+            struct watch_key *wk;
+
+            if (!(wk = zhashx_lookup (nsm->keys, key)))
+                continue;
+            w = zlistx_first (wk->watchers);
+            while (w) {
+                if (!(w->flags & FLUX_KVS_WATCH_FULL))
+                    v[count++] = w;
+                w = zlistx_next (wk->watchers);
+            }
+        }
+    }
+    else {
+        struct watch_key *wk;
+
+        wk = zhashx_first (nsm->keys);
+        while (wk) {
+            if (key_match (keys, wk->key)) {
+                w = zlistx_first (wk->watchers);
+                while (w) {
+                    if (!(w->flags & FLUX_KVS_WATCH_FULL))
+                        v[count++] = w;
+                    w = zlistx_next (wk->watchers);
+                }
+            }
+            wk = zhashx_next (nsm->keys);
+        }
+    }
+    w = zlistx_first (nsm->full_watchers);
+    while (w) {
+        v[count++] = w;
+        w = zlistx_next (nsm->full_watchers);
+    }
+    for (size_t i = 0; i < count; i++)
+        watcher_respond (nsm, v[i]);
+    free (v);
+}
+
 /* Cancel watcher 'w' if it matches:
  * - credentials and matchtag if cancel true
  * - credentials if cancel false
@@ -1293,7 +1645,7 @@ static void setroot_cb (flux_t *h,
     if (nsm->owner == FLUX_USERID_UNKNOWN)
         nsm->owner = owner;
 done:
-    watcher_respond_ns (nsm);
+    watcher_respond_commit (nsm);
 }
 
 /* kvs.getroot response for initial namespace creation
@@ -1489,6 +1841,11 @@ static void lookup_cb (flux_t *h,
         errno = EINVAL;
         goto error;
     }
+    if (watcher_index (nsm, w) < 0) {
+        watcher_cleanup (nsm, w);
+        errno = ENOMEM;
+        goto error;
+    }
     if (nsm->commit)
         watcher_respond (nsm, w);
     return;
@@ -1539,13 +1896,17 @@ static void stats_cb (flux_t *h,
         goto nomem;
     nsm = zhashx_first (ctx->namespaces);
     while (nsm) {
-        json_t *o = json_pack ("{s:i s:i s:s s:i}",
+        json_t *o = json_pack ("{s:i s:i s:s s:i s:i s:I s:I}",
                                "owner", (int)nsm->owner,
                                "rootseq", nsm->commit ? nsm->commit->rootseq
                                                       : -1,
                                "rootref", nsm->commit ? nsm->commit->rootref
                                                       : "(null)",
-                               "watchers", (int)zlistx_size (nsm->watchers));
+                               "watchers", (int)zlistx_size (nsm->watchers),
+                               "keys", (int)zhashx_size (nsm->keys),
+                               "lookups", (json_int_t)nsm->lookups,
+                               "lookups-coalesced",
+                               (json_int_t)nsm->coalesced);
         if (!o)
             goto nomem;
         if (json_object_set_new (stats, nsm->ns_name, o) < 0) {
@@ -1557,8 +1918,10 @@ static void stats_cb (flux_t *h,
     }
     if (flux_respond_pack (h,
                            msg,
-                           "{s:i s:i s:O}",
+                           "{s:i s:I s:I s:i s:O}",
                            "watchers", watchers,
+                           "lookups", (json_int_t)ctx->lookups,
+                           "lookups-coalesced", (json_int_t)ctx->coalesced,
                            "namespace-count", (int)zhashx_size (ctx->namespaces),
                            "namespaces", stats) < 0)
         flux_log_error (h,
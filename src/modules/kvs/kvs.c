@@ -1372,6 +1372,73 @@ stall:
     return NULL;
 }
 
+/* Respond to a FLUX_KVS_RAW lookup with the value as the message payload,
+ * followed by a terminating zero byte.  The blobs of a valref are copied
+ * from the cache, where lookup() guarantees they are valid.
+ */
+static int lookup_respond_raw (struct kvs_ctx *ctx,
+                               const flux_msg_t *msg,
+                               json_t *val)
+{
+    flux_msg_t *response = NULL;
+    void *buf = NULL;
+    size_t size = 0;
+
+    if (treeobj_is_valref (val)) {
+        int count = treeobj_get_count (val);
+        const void *data;
+        int len;
+        char *p;
+
+        for (int i = 0; i < count; i++) {
+            struct cache_entry *entry;
+            const char *ref = treeobj_get_blobref (val, i);
+
+            if (!ref
+                || !(entry = cache_lookup (ctx->cache, ref))
+                || !cache_entry_get_valid (entry)
+                || cache_entry_get_raw (entry, NULL, &len) < 0) {
+                errno = ENOTRECOVERABLE;
+                return -1;
+            }
+            size += len;
+        }
+        if (!(buf = malloc (size + 1)))
+            return -1;
+        p = buf;
+        for (int i = 0; i < count; i++) {
+            struct cache_entry *entry;
+
+            entry = cache_lookup (ctx->cache, treeobj_get_blobref (val, i));
+            (void)cache_entry_get_raw (entry, &data, &len);
+            if (len > 0)
+                memcpy (p, data, len);
+            p += len;
+        }
+        *p = '\0';
+    }
+    else {
+        /* N.B. treeobj_decode_val() allocates an extra zero byte that is
+         * not reflected in 'size', or returns NULL for an empty value.
+         */
+        if (treeobj_decode_val (val, &buf, &size) < 0)
+            return -1;
+        if (!buf && !(buf = calloc (1, 1)))
+            return -1;
+    }
+    if (!(response = flux_response_derive (msg, 0))
+        || flux_msg_set_payload_nocopy (response, buf, size + 1) < 0)
+        goto error;
+    buf = NULL;
+    if (flux_send_new (ctx->h, &response, 0) < 0)
+        goto error;
+    return 0;
+error:
+    ERRNO_SAFE_WRAP (free, buf);
+    flux_msg_decref (response);
+    return -1;
+}
+
 static void lookup_request_cb (flux_t *h,
                                flux_msg_handler_t *mh,
                                const flux_msg_t *msg,
@@ -1394,7 +1461,14 @@ static void lookup_request_cb (flux_t *h,
         errno = ENOENT;
         goto error;
     }
-    if (flux_respond_pack (h, msg, "{ s:O }", "val", val) < 0)
+    if ((lookup_get_flags (lh) & FLUX_KVS_RAW)) {
+        if (lookup_respond_raw (ctx, msg, val) < 0) {
+            flux_log_error (h, "%s: lookup_respond_raw", __FUNCTION__);
+            json_decref (val);
+            goto error;
+        }
+    }
+    else if (flux_respond_pack (h, msg, "{ s:O }", "val", val) < 0)
         flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
     /* N.B. lookup_handle 'lh' owned by message, will be destroyed
      * when message destroyed */
@@ -1438,6 +1512,11 @@ static void lookup_plus_request_cb (flux_t *h,
         }
         goto error;
     }
+    /* FLUX_KVS_RAW responses cannot carry root information */
+    if ((lookup_get_flags (lh) & FLUX_KVS_RAW)) {
+        errno = EINVAL;
+        goto error;
+    }
 
     root_ref = lookup_get_root_ref (lh);
     assert (root_ref);
@@ -1540,6 +1619,9 @@ static int guest_treeobj_authorize (json_t *treeobj, flux_error_t *error)
     return -1;
 }
 
+/* N.B. "blob" operations are skipped, since they become valrefs to raw
+ * values carried in the request, which guests may commit.
+ */
 static int guest_commit_authorize (json_t *ops, flux_error_t *error)
 {
     size_t index;
@@ -1547,6 +1629,8 @@ static int guest_commit_authorize (json_t *ops, flux_error_t *error)
 
     json_array_foreach (ops, index, op) {
         json_t *treeobj;
+        if (json_object_get (op, "blob"))
+            continue;
         if (txn_decode_op (op, NULL, NULL, &treeobj) < 0) {
             errprintf (error, "could not decode commit operation");
             return -1;
@@ -1610,46 +1694,47 @@ error:
         flux_log_error (h, "%s: error_event_send_to_name", __FUNCTION__);
 }
 
-/* kvs.commit
- * Sent from users to local kvs module.
+/* Decode a kvs.commit request.  The payload is a JSON object, which may
+ * be followed after its terminating zero byte by blobs referenced from
+ * "blob" operations (see flux_kvs_commit()).  The blobs are encoded as
+ * for a content-backing.batch-store request.
  */
-static void commit_request_cb (flux_t *h,
-                               flux_msg_handler_t *mh,
-                               const flux_msg_t *msg,
-                               void *arg)
+static json_t *commit_request_decode (const flux_msg_t *msg,
+                                      const void **blobs,
+                                      size_t *blobs_size)
 {
-    struct kvs_ctx *ctx = arg;
-    struct kvsroot *root;
-    const char *ns;
-    int flags;
-    bool stall = false;
-    json_t *ops = NULL;
-    flux_error_t error;
-    const char *errmsg = NULL;
-    char name[128];
+    const char *buf;
+    size_t size;
+    const char *end;
+    json_t *hdr;
 
-    if (flux_request_unpack (msg,
-                             NULL,
-                             "{ s:o s:s s:i }",
-                             "ops", &ops,
-                             "namespace", &ns,
-                             "flags", &flags) < 0) {
-        flux_log_error (h, "%s: flux_request_unpack", __FUNCTION__);
-        goto error;
+    if (flux_request_decode_raw (msg, NULL, (const void **)&buf, &size) < 0)
+        return NULL;
+    if (!buf || !(end = memchr (buf, '\0', size))) {
+        errno = EPROTO;
+        return NULL;
     }
-    if (flux_msg_authorize (msg, FLUX_USERID_UNKNOWN) < 0
-        && guest_commit_authorize (ops, &error) < 0) {
-        errmsg = error.text;
-        goto error;
+    if (!(hdr = json_loadb (buf, end - buf, 0, NULL))) {
+        errno = EPROTO;
+        return NULL;
     }
+    *blobs = end + 1;
+    *blobs_size = size - (end - buf) - 1;
+    return hdr;
+}
 
-    if (!(root = getroot (ctx, ns, mh, msg, &stall))) {
-        if (stall) {
-            request_tracking_add (ctx, msg);
-            return;
-        }
-        goto error;
-    }
+/* Add the transaction 'ops' from a kvs.commit request to 'root', or
+ * relay it to rank 0.
+ */
+static int commit_apply (struct kvs_ctx *ctx,
+                         struct kvsroot *root,
+                         const flux_msg_t *msg,
+                         const char *ns,
+                         int flags,
+                         json_t *ops)
+{
+    flux_t *h = ctx->h;
+    char name[128];
 
     /* save copy of request, will be used later via
      * finalize_transaction_bynames() to send error code to original
@@ -1666,7 +1751,7 @@ static void commit_request_cb (flux_t *h,
         flux_log_error (h,
                         "%s: kvsroot_save_transaction_request",
                         __FUNCTION__);
-        goto error;
+        return -1;
     }
 
     if (ctx->rank == 0) {
@@ -1677,7 +1762,7 @@ static void commit_request_cb (flux_t *h,
                                         0) < 0) {
             flux_log_error (h, "%s: kvstxn_mgr_add_transaction",
                             __FUNCTION__);
-            goto error;
+            return -1;
         }
 
         tstat_push (&ctx->txn_commit_stats, (double)json_array_size (ops));
@@ -1698,17 +1783,241 @@ static void commit_request_cb (flux_t *h,
                                  "namespace", ns,
                                  "flags", flags))) {
             flux_log_error (h, "%s: flux_rpc_pack", __FUNCTION__);
-            goto error;
+            return -1;
         }
         flux_future_destroy (f);
     }
+    return 0;
+}
+
+/* Replace each "blob" operation in 'ops' with a valref to its stored
+ * blob, returning a new ops array.
+ */
+static json_t *commit_resolve_blobs (struct kvs_ctx *ctx,
+                                     json_t *ops,
+                                     flux_future_t *f)
+{
+    json_t *nops;
+    size_t index;
+    json_t *op;
+
+    if (!(nops = json_array ()))
+        goto nomem;
+    json_array_foreach (ops, index, op) {
+        const char *key;
+        int flags;
+        int blob;
+        char name[16];
+        flux_future_t *cf;
+        const char *blobref;
+        json_t *dirent;
+        json_t *nop;
+
+        if (!json_object_get (op, "blob")) {
+            if (json_array_append (nops, op) < 0)
+                goto nomem;
+            continue;
+        }
+        if (json_unpack (op,
+                         "{s:s s:i s:i !}",
+                         "key", &key,
+                         "flags", &flags,
+                         "blob", &blob) < 0) {
+            errno = EPROTO;
+            goto error;
+        }
+        snprintf (name, sizeof (name), "%d", blob);
+        if (!(cf = flux_future_get_child (f, name))) {
+            errno = EPROTO;
+            goto error;
+        }
+        if (content_store_get_blobref (cf, ctx->hash_name, &blobref) < 0
+            || !(dirent = treeobj_create_valref (blobref)))
+            goto error;
+        if (txn_encode_op (key, flags, dirent, &nop) < 0) {
+            ERRNO_SAFE_WRAP (json_decref, dirent);
+            goto error;
+        }
+        json_decref (dirent);
+        if (json_array_append_new (nops, nop) < 0)
+            goto nomem;
+    }
+    return nops;
+nomem:
+    errno = ENOMEM;
+error:
+    ERRNO_SAFE_WRAP (json_decref, nops);
+    return NULL;
+}
+
+static void commit_blobs_continuation (flux_future_t *f, void *arg)
+{
+    struct kvs_ctx *ctx = arg;
+    const flux_msg_t *msg = flux_future_aux_get (f, "msg");
+    json_t *hdr = flux_future_aux_get (f, "hdr");
+    struct kvsroot *root;
+    const char *ns;
+    int flags;
+    json_t *ops;
+    json_t *nops = NULL;
+
+    if (flux_future_get (f, NULL) < 0) {
+        flux_log_error (ctx->h, "%s: content_store", __FUNCTION__);
+        goto error;
+    }
+    if (json_unpack (hdr,
+                     "{s:o s:s s:i}",
+                     "ops", &ops,
+                     "namespace", &ns,
+                     "flags", &flags) < 0) {
+        errno = EPROTO;
+        goto error;
+    }
+    if (!(nops = commit_resolve_blobs (ctx, ops, f)))
+        goto error;
+    /* namespace may have been removed while blobs were stored */
+    if (!(root = kvsroot_mgr_lookup_root_safe (ctx->krm, ns))) {
+        errno = ENOTSUP;
+        goto error;
+    }
+    if (commit_apply (ctx, root, msg, ns, flags, nops) < 0)
+        goto error;
+    json_decref (nops);
+    flux_future_destroy (f);
+    return;
+error:
+    if (flux_respond_error (ctx->h, msg, errno, NULL) < 0)
+        flux_log_error (ctx->h, "%s: flux_respond_error", __FUNCTION__);
+    request_tracking_remove (ctx, msg);
+    json_decref (nops);
+    flux_future_destroy (f);
+}
+
+/* Store the blobs of a kvs.commit request.  commit_blobs_continuation()
+ * then substitutes valrefs for "blob" operations and applies the commit.
+ * The content store returns each blob's blobref, so the sender's data
+ * need not be hashed or trusted here.
+ */
+static int commit_store_blobs (struct kvs_ctx *ctx,
+                               const flux_msg_t *msg,
+                               json_t *hdr,
+                               const void *blobs,
+                               size_t blobs_size)
+{
+    flux_future_t *f;
+    const flux_msg_t *msgref;
+    size_t cursor = 0;
+    const void *data;
+    size_t len;
+    int n = 0;
+    int rc;
+
+    if (!(f = flux_future_wait_all_create ()))
+        return -1;
+    flux_future_set_flux (f, ctx->h);
+    while ((rc = content_store_batch_next (blobs,
+                                           blobs_size,
+                                           &cursor,
+                                           &data,
+                                           &len)) > 0) {
+        flux_future_t *cf;
+        char name[16];
+
+        snprintf (name, sizeof (name), "%d", n++);
+        if (!(cf = content_store (ctx->h, data, len, 0))
+            || flux_future_push (f, name, cf) < 0) {
+            flux_future_destroy (cf);
+            goto error;
+        }
+    }
+    if (rc < 0)
+        goto error;
+    msgref = flux_msg_incref (msg);
+    if (flux_future_aux_set (f,
+                             "msg",
+                             (void *)msgref,
+                             (flux_free_f)flux_msg_decref) < 0) {
+        flux_msg_decref (msgref);
+        goto error;
+    }
+    if (flux_future_aux_set (f,
+                             "hdr",
+                             json_incref (hdr),
+                             (flux_free_f)json_decref) < 0) {
+        json_decref (hdr);
+        goto error;
+    }
+    if (flux_future_then (f, -1., commit_blobs_continuation, ctx) < 0)
+        goto error;
+    return 0;
+error:
+    flux_future_destroy (f);
+    return -1;
+}
+
+/* kvs.commit
+ * Sent from users to local kvs module.
+ */
+static void commit_request_cb (flux_t *h,
+                               flux_msg_handler_t *mh,
+                               const flux_msg_t *msg,
+                               void *arg)
+{
+    struct kvs_ctx *ctx = arg;
+    struct kvsroot *root;
+    const char *ns;
+    int flags;
+    bool stall = false;
+    json_t *hdr;
+    json_t *ops = NULL;
+    const void *blobs;
+    size_t blobs_size;
+    flux_error_t error;
+    const char *errmsg = NULL;
+
+    if (!(hdr = commit_request_decode (msg, &blobs, &blobs_size))
+        || json_unpack (hdr,
+                        "{ s:o s:s s:i }",
+                        "ops", &ops,
+                        "namespace", &ns,
+                        "flags", &flags) < 0) {
+        if (hdr)
+            errno = EPROTO;
+        flux_log_error (h, "%s: commit_request_decode", __FUNCTION__);
+        goto error;
+    }
+    if (flux_msg_authorize (msg, FLUX_USERID_UNKNOWN) < 0
+        && guest_commit_authorize (ops, &error) < 0) {
+        errmsg = error.text;
+        goto error;
+    }
+
+    if (!(root = getroot (ctx, ns, mh, msg, &stall))) {
+        if (stall) {
+            request_tracking_add (ctx, msg);
+            json_decref (hdr);
+            return;
+        }
+        goto error;
+    }
+
+    if (blobs_size > 0) {
+        if (commit_store_blobs (ctx, msg, hdr, blobs, blobs_size) < 0) {
+            flux_log_error (h, "%s: commit_store_blobs", __FUNCTION__);
+            goto error;
+        }
+    }
+    else if (commit_apply (ctx, root, msg, ns, flags, ops) < 0)
+        goto error;
     request_tracking_add (ctx, msg);
+    json_decref (hdr);
     return;
 
 error:
     if (flux_respond_error (h, msg, errno, errmsg) < 0)
         flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
     request_tracking_remove (ctx, msg);
+    json_decref (hdr);
 }
 
 static void wait_version_request_cb (flux_t *h,
@@ -36,6 +36,11 @@
 
 #include "kvstxn.h"
 
+/* A directory with more entries than this is stored as a sharded dirref
+ * when it is modified, see treeobj_is_dirref_sharded().
+ */
+#define KVSTXN_SHARD_DIR_MAX 1024
+
 struct kvstxn_mgr {
     struct cache *cache;
     const char *ns_name;
@@ -382,8 +387,140 @@ static int store_cache (kvstxn_t *kt,
     return -1;
 }
 
+static int kvstxn_treeobj_to_cache (kvstxn_t *kt,
+                                    json_t *o,
+                                    char *ref,
+                                    int ref_len)
+{
+    struct cache_entry *entry;
+    int ret;
+
+    if ((ret = store_cache (kt, o, false, ref, ref_len, &entry)) < 0)
+        return -1;
+    if (ret) {
+        if (kvstxn_add_dirty_cache_entry (kt, entry) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+static int kvstxn_unroll (kvstxn_t *kt, json_t *dir);
+static json_t *kvstxn_store_dir (kvstxn_t *kt, json_t *dir, int depth);
+
+/* Store the modified shards of sharded dirref 'dirref' at 'depth',
+ * replacing them with blobrefs.  Shards that are still blobrefs were
+ * not modified and are left alone.
+ */
+static int kvstxn_unroll_shards (kvstxn_t *kt, json_t *dirref, int depth)
+{
+    json_t *data;
+
+    if (!(data = treeobj_get_data (dirref)))
+        return -1;
+    for (int i = 0; i < TREEOBJ_SHARD_FANOUT; i++) {
+        json_t *shard = json_array_get (data, i);
+        char ref[BLOBREF_MAX_STRING_SIZE];
+        const char *shard_ref;
+        json_t *ktmp;
+
+        if (json_is_string (shard))
+            continue;
+        if (treeobj_is_dir (shard)) {
+            if (kvstxn_unroll (kt, shard) < 0
+                || !(ktmp = kvstxn_store_dir (kt, shard, depth + 1)))
+                return -1;
+        }
+        else {
+            if (kvstxn_unroll_shards (kt, shard, depth + 1) < 0)
+                return -1;
+            ktmp = json_incref (shard);
+        }
+        /* A shard blob is a dir or a sharded dirref, never a plain dirref.
+         */
+        if (treeobj_is_dirref_sharded (ktmp)) {
+            if (kvstxn_treeobj_to_cache (kt, ktmp, ref, sizeof (ref)) < 0) {
+                ERRNO_SAFE_WRAP (json_decref, ktmp);
+                return -1;
+            }
+            shard_ref = ref;
+        }
+        else if (!(shard_ref = treeobj_get_blobref (ktmp, 0))) {
+            ERRNO_SAFE_WRAP (json_decref, ktmp);
+            return -1;
+        }
+        if (json_array_set_new (data, i, json_string (shard_ref)) < 0) {
+            json_decref (ktmp);
+            errno = ENOMEM;
+            return -1;
+        }
+        json_decref (ktmp);
+    }
+    return 0;
+}
+
+/* Split the entries of 'dir' into a new sharded dirref at 'depth', whose
+ * shards are dir objects that must then be stored.
+ */
+static json_t *kvstxn_shard_split (json_t *dir, int depth)
+{
+    json_t *dirref;
+    json_t *data;
+    json_t *dir_data;
+    const char *name;
+    json_t *o;
+
+    if (!(dir_data = treeobj_get_data (dir))
+        || !(dirref = treeobj_create_dirref (NULL)))
+        return NULL;
+    data = treeobj_get_data (dirref);
+    for (int i = 0; i < TREEOBJ_SHARD_FANOUT; i++) {
+        if (json_array_append_new (data, treeobj_create_dir ()) < 0) {
+            errno = ENOMEM;
+            goto error;
+        }
+    }
+    json_object_foreach (dir_data, name, o) {
+        int index;
+
+        if ((index = treeobj_shard_index (name, depth)) < 0
+            || treeobj_insert_entry_novalidate (json_array_get (data, index),
+                                                name,
+                                                o) < 0)
+            goto error;
+    }
+    return dirref;
+error:
+    ERRNO_SAFE_WRAP (json_decref, dirref);
+    return NULL;
+}
+
+/* Store unrolled dir 'dir' and return a dirref to it.  A dir with more
+ * than KVSTXN_SHARD_DIR_MAX entries is split into shards at 'depth'
+ * if possible, and a sharded dirref is returned.
+ */
+static json_t *kvstxn_store_dir (kvstxn_t *kt, json_t *dir, int depth)
+{
+    char ref[BLOBREF_MAX_STRING_SIZE];
+    json_t *dirref;
+
+    if (treeobj_get_count (dir) > KVSTXN_SHARD_DIR_MAX
+        && depth < TREEOBJ_SHARD_MAX_DEPTH) {
+        if (!(dirref = kvstxn_shard_split (dir, depth)))
+            return NULL;
+        if (kvstxn_unroll_shards (kt, dirref, depth) < 0) {
+            ERRNO_SAFE_WRAP (json_decref, dirref);
+            return NULL;
+        }
+        return dirref;
+    }
+    if (kvstxn_treeobj_to_cache (kt, dir, ref, sizeof (ref)) < 0)
+        return NULL;
+    return treeobj_create_dirref (ref);
+}
+
 /* Store DIRVAL objects, converting them to DIRREFs.
  * Store (large) FILEVAL objects, converting them to FILEREFs.
+ * Store modified shards of sharded DIRREFs.
  * Return 0 on success, -1 on error
  */
 static int kvstxn_unroll (kvstxn_t *kt, json_t *dir)
@@ -411,18 +548,7 @@ static int kvstxn_unroll (kvstxn_t *kt, json_t *dir)
         if (treeobj_is_dir (dir_entry)) {
             if (kvstxn_unroll (kt, dir_entry) < 0) /* depth first */
                 return -1;
-            if ((ret = store_cache (kt,
-                                    dir_entry,
-                                    false,
-                                    ref,
-                                    sizeof (ref),
-                                    &entry)) < 0)
-                return -1;
-            if (ret) {
-                if (kvstxn_add_dirty_cache_entry (kt, entry) < 0)
-                    return -1;
-            }
-            if (!(ktmp = treeobj_create_dirref (ref)))
+            if (!(ktmp = kvstxn_store_dir (kt, dir_entry, 0)))
                 return -1;
             if (json_object_iter_set_new (dir, iter, ktmp) < 0) {
                 // jansson decrefs the new object on failure
@@ -430,6 +556,10 @@ static int kvstxn_unroll (kvstxn_t *kt, json_t *dir)
                 return -1;
             }
         }
+        else if (treeobj_is_dirref_sharded (dir_entry)) {
+            if (kvstxn_unroll_shards (kt, dir_entry, 0) < 0)
+                return -1;
+        }
         else if (treeobj_is_val (dir_entry)) {
             json_t *val_data;
 
@@ -612,6 +742,66 @@ static int kvstxn_append (kvstxn_t *kt,
     return 0;
 }
 
+/* Descend through sharded dirref 'dirref' in the root copy to the shard
+ * dir that holds entry 'name'.  Shards are copied from the cache as they
+ * are visited and replace their blobrefs in 'dirref', so that changes
+ * stay in the root copy until kvstxn_unroll_shards() stores them.  If a
+ * shard is not cached, '*dirp' is set to NULL and 'missing_ref' is set.
+ */
+static int kvstxn_shard_dir (kvstxn_t *kt,
+                             json_t *dirref,
+                             const char *name,
+                             json_t **dirp,
+                             const char **missing_ref)
+{
+    int depth = 0;
+
+    while (1) {
+        json_t *data;
+        json_t *shard;
+        int index;
+
+        if ((index = treeobj_shard_index (name, depth)) < 0
+            || !(data = treeobj_get_data (dirref)))
+            return -1;
+        shard = json_array_get (data, index);
+        if (json_is_string (shard)) {
+            struct cache_entry *entry;
+            const json_t *shardktmp;
+            const char *ref = json_string_value (shard);
+
+            if (!(entry = cache_lookup (kt->ktm->cache, ref))
+                || !cache_entry_get_valid (entry)) {
+                *missing_ref = ref;
+                *dirp = NULL;
+                return 0; /* stall */
+            }
+            if (!(shardktmp = cache_entry_get_treeobj (entry))) {
+                errno = ENOTRECOVERABLE;
+                return -1;
+            }
+            /* do not corrupt store by modifying orig. */
+            if (!(shard = treeobj_deep_copy (shardktmp)))
+                return -1;
+            if (json_array_set_new (data, index, shard) < 0) {
+                errno = ENOMEM;
+                return -1;
+            }
+        }
+        if (treeobj_is_dir (shard)) {
+            *dirp = shard;
+            return 0;
+        }
+        if (!treeobj_is_dirref_sharded (shard)
+            || ++depth == TREEOBJ_SHARD_MAX_DEPTH) {
+            flux_log (kt->ktm->h, LOG_ERR, "invalid directory shard");
+            errno = ENOTRECOVERABLE;
+            return -1;
+        }
+        dirref = shard;
+    }
+}
+
 /* link (key, dirent) into directory 'dir'.
  */
 static int kvstxn_link_dirent (kvstxn_t *kt,
@@ -647,6 +837,13 @@ static int kvstxn_link_dirent (kvstxn_t *kt,
     while ((next = strchr (name, '.'))) {
         *next++ = '\0';
 
+        if (treeobj_is_dirref_sharded (dir)) {
+            if (kvstxn_shard_dir (kt, dir, name, &dir, missing_ref) < 0)
+                goto done;
+            if (!dir)
+                goto success; /* stall */
+        }
+
         if (!treeobj_is_dir (dir)) {
             errno = ENOTRECOVERABLE;
             goto done;
@@ -667,6 +864,10 @@ static int kvstxn_link_dirent (kvstxn_t *kt,
         else if (treeobj_is_dir (dir_entry)) {
             subdir = dir_entry;
         }
+        else if (treeobj_is_dirref_sharded (dir_entry)) {
+            /* shards are loaded by kvstxn_shard_dir() for the next name */
+            subdir = dir_entry;
+        }
         else if (treeobj_is_dirref (dir_entry)) {
             struct cache_entry *entry;
             const char *ref;
@@ -757,6 +958,12 @@ static int kvstxn_link_dirent (kvstxn_t *kt,
         name = next;
         dir = subdir;
     }
+    if (treeobj_is_dirref_sharded (dir)) {
+        if (kvstxn_shard_dir (kt, dir, name, &dir, missing_ref) < 0)
+            goto done;
+        if (!dir)
+            goto success; /* stall */
+    }
     /* This is the final path component of the key.  Add/modify/delete
      * it in the directory.
      */
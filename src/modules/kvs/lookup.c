@@ -83,6 +83,9 @@ struct lookup {
     const json_t *valref_missing_refs;
     const char *missing_ref;
 
+    /* shard blobrefs missing when reading a sharded directory */
+    json_t *shard_missing_refs;
+
     /* for namespace callback */
 
     char *missing_namespace;
@@ -340,6 +343,54 @@ cleanup:
     return ret;
 }
 
+/* Descend through sharded dirref 'dirref' to the shard dir that holds
+ * directory entry 'name'.  On success, '*dirp' is set to the shard and
+ * '*entryp' to the cache entry that contains it.
+ */
+static lookup_process_t walk_shards (lookup_t *lh,
+                                     const json_t *dirref,
+                                     const char *name,
+                                     const json_t **dirp,
+                                     struct cache_entry **entryp)
+{
+    int depth = 0;
+
+    while (1) {
+        struct cache_entry *entry;
+        const json_t *shard;
+        const char *refstr;
+        int index;
+
+        if ((index = treeobj_shard_index (name, depth)) < 0
+            || !(refstr = treeobj_get_blobref (dirref, index))) {
+            lh->errnum = errno;
+            return LOOKUP_PROCESS_ERROR;
+        }
+        if (!(entry = cache_lookup (lh->cache, refstr))
+            || !cache_entry_get_valid (entry)) {
+            lh->missing_ref = refstr;
+            return LOOKUP_PROCESS_LOAD_MISSING_REFS;
+        }
+        if (!(shard = cache_entry_get_treeobj (entry))) {
+            flux_log (lh->h, LOG_ERR, "dirref points to non-treeobj");
+            lh->errnum = ENOTRECOVERABLE;
+            return LOOKUP_PROCESS_ERROR;
+        }
+        if (treeobj_is_dir (shard)) {
+            *dirp = shard;
+            *entryp = entry;
+            return LOOKUP_PROCESS_FINISHED;
+        }
+        if (!treeobj_is_dirref_sharded (shard)
+            || ++depth == TREEOBJ_SHARD_MAX_DEPTH) {
+            flux_log (lh->h, LOG_ERR, "invalid directory shard");
+            lh->errnum = ENOTRECOVERABLE;
+            return LOOKUP_PROCESS_ERROR;
+        }
+        dirref = shard;
+    }
+}
+
 /* Get dirent of the requested path starting at the given root.
  *
  * Return true on success or error, error code is returned in ep and
@@ -364,7 +415,16 @@ static lookup_process_t walk (lookup_t *lh)
 
         /* Get directory of dirent */
 
-        if (treeobj_is_dirref (wl->dirent)) {
+        if (treeobj_is_dirref_sharded (wl->dirent)) {
+            lookup_process_t sret;
+
+            sret = walk_shards (lh, wl->dirent, pathcomp, &dir, &entry);
+            if (sret == LOOKUP_PROCESS_ERROR)
+                goto error;
+            else if (sret == LOOKUP_PROCESS_LOAD_MISSING_REFS)
+                return LOOKUP_PROCESS_LOAD_MISSING_REFS;
+        }
+        else if (treeobj_is_dirref (wl->dirent)) {
             const char *refstr;
             int refcount;
 
@@ -584,6 +644,7 @@ void lookup_destroy (lookup_t *lh)
         free (lh->root_ref);
         free (lh->path);
         json_decref (lh->val);
+        json_decref (lh->shard_missing_refs);
         free (lh->missing_namespace);
         zlist_destroy (&lh->levels);
         free (lh);
@@ -636,7 +697,16 @@ int lookup_iter_missing_refs (lookup_t *lh, lookup_ref_f cb, void *data)
         && (lh->state == LOOKUP_STATE_CHECK_ROOT
             || lh->state == LOOKUP_STATE_WALK
             || lh->state == LOOKUP_STATE_VALUE)) {
-        if (lh->valref_missing_refs) {
+        if (lh->shard_missing_refs) {
+            size_t index;
+            json_t *o;
+
+            json_array_foreach (lh->shard_missing_refs, index, o) {
+                if (cb (lh, json_string_value (o), data) < 0)
+                    return -1;
+            }
+        }
+        else if (lh->valref_missing_refs) {
             int refcount, i;
 
             if (!treeobj_is_valref (lh->valref_missing_refs)) {
@@ -692,6 +762,13 @@ const char *lookup_get_namespace (lookup_t *lh)
     return NULL;
 }
 
+int lookup_get_flags (lookup_t *lh)
+{
+    if (lh)
+        return lh->flags;
+    return 0;
+}
+
 const char *lookup_get_root_ref (lookup_t *lh)
 {
     if (lh && lh->state == LOOKUP_STATE_FINISHED)
@@ -878,6 +955,100 @@ done:
     return rc;
 }
 
+/* Copy the entries of every shard of sharded dirref 'dirref' into 'dir'.
+ * Shards that are not cached are appended to 'missing' and skipped.
+ * Return 0 on success, -1 on failure with errno set.
+ */
+static int get_shards (lookup_t *lh,
+                       const json_t *dirref,
+                       int depth,
+                       json_t *dir,
+                       json_t *missing)
+{
+    for (int i = 0; i < TREEOBJ_SHARD_FANOUT; i++) {
+        struct cache_entry *entry;
+        const json_t *shard;
+        const char *ref;
+
+        if (!(ref = treeobj_get_blobref (dirref, i)))
+            return -1;
+        if (!(entry = cache_lookup (lh->cache, ref))
+            || !cache_entry_get_valid (entry)) {
+            if (json_array_append_new (missing, json_string (ref)) < 0) {
+                errno = ENOMEM;
+                return -1;
+            }
+            continue;
+        }
+        if (!(shard = cache_entry_get_treeobj (entry))) {
+            flux_log (lh->h, LOG_ERR, "dirref points to non-treeobj");
+            errno = ENOTRECOVERABLE;
+            return -1;
+        }
+        if (treeobj_is_dir (shard)) {
+            const char *name;
+            json_t *o;
+
+            /* N.B. safe to cast away const, 'shard' is not modified */
+            json_object_foreach (treeobj_get_data ((json_t *)shard),
+                                 name,
+                                 o) {
+                json_t *cpy;
+
+                if (!(cpy = treeobj_deep_copy (o))
+                    || treeobj_insert_entry_novalidate (dir, name, cpy) < 0) {
+                    ERRNO_SAFE_WRAP (json_decref, cpy);
+                    return -1;
+                }
+                json_decref (cpy);
+            }
+        }
+        else if (treeobj_is_dirref_sharded (shard)
+                 && depth + 1 < TREEOBJ_SHARD_MAX_DEPTH) {
+            if (get_shards (lh, shard, depth + 1, dir, missing) < 0)
+                return -1;
+        }
+        else {
+            flux_log (lh->h, LOG_ERR, "invalid directory shard");
+            errno = ENOTRECOVERABLE;
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* Merge the shards of a sharded dirref into one dir.  Return 0 on
+ * success, -1 on failure.  On success, stall should be checked.  Missing
+ * shards are all reported at once, but a missing interior shard hides
+ * the shards below it until it has been loaded.
+ */
+static int get_sharded_dir_value (lookup_t *lh, bool *stall)
+{
+    json_t *dir;
+
+    json_decref (lh->shard_missing_refs);
+    if (!(lh->shard_missing_refs = json_array ())) {
+        lh->errnum = ENOMEM;
+        return -1;
+    }
+    if (!(dir = treeobj_create_dir ())
+        || get_shards (lh, lh->wdirent, 0, dir, lh->shard_missing_refs) < 0) {
+        lh->errnum = errno;
+        json_decref (dir);
+        return -1;
+    }
+    if (json_array_size (lh->shard_missing_refs) > 0) {
+        json_decref (dir);
+        (*stall) = true;
+        return 0;
+    }
+    json_decref (lh->shard_missing_refs);
+    lh->shard_missing_refs = NULL;
+    lh->val = dir;
+    (*stall) = false;
+    return 0;
+}
+
 lookup_process_t lookup (lookup_t *lh)
 {
     const json_t *valtmp = NULL;
@@ -1044,6 +1215,15 @@ lookup_process_t lookup (lookup_t *lh)
                     lh->errnum = errno;
                     goto error;
                 }
+                if (refcount == TREEOBJ_SHARD_FANOUT) {
+                    bool stall;
+
+                    if (get_sharded_dir_value (lh, &stall) < 0)
+                        goto error;
+                    if (stall)
+                        return LOOKUP_PROCESS_LOAD_MISSING_REFS;
+                    break;
+                }
                 if (refcount != 1) {
                     flux_log (lh->h, LOG_ERR, "invalid dirref count: %d",
                               refcount);
@@ -1097,7 +1277,25 @@ lookup_process_t lookup (lookup_t *lh)
                     lh->errnum = ENOTRECOVERABLE;
                     goto error;
                 }
-                if (refcount == 1) {
+                if ((lh->flags & FLUX_KVS_RAW)) {
+                    int total_len;
+
+                    /* Return the valref once its blobs are cached.  The
+                     * caller sends their contents without re-encoding.
+                     */
+                    if (get_multi_blobref_valref_length (lh,
+                                                         refcount,
+                                                         &total_len,
+                                                         &stall) < 0)
+                        goto error;
+                    if (stall)
+                        return LOOKUP_PROCESS_LOAD_MISSING_REFS;
+                    if (!(lh->val = treeobj_deep_copy (lh->wdirent))) {
+                        lh->errnum = errno;
+                        goto error;
+                    }
+                }
+                else if (refcount == 1) {
                     if (get_single_blobref_valref_value (lh, &stall) < 0)
                         goto error;
                     if (stall)
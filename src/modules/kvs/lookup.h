@@ -64,7 +64,8 @@ int lookup_set_aux_errnum (lookup_t *lh, int errnum);
 /* Get resulting value of lookup() after lookup() returns
  * LOOKUP_PROCESS_FINISHED.  The json object returned gives a
  * reference to the caller and must be json_decref()'ed to free
- * memory. */
+ * memory.  If FLUX_KVS_RAW was specified, a valref is returned
+ * unmodified, and all of its blobs are valid in the cache. */
 json_t *lookup_get_value (lookup_t *lh);
 
 /* On lookup stall b/c of missing reference(s), get missing reference
@@ -92,6 +93,10 @@ int lookup_get_current_epoch (lookup_t *lh);
  */
 const char *lookup_get_namespace (lookup_t *lh);
 
+/* Get flags passed in via lookup_create().
+ */
+int lookup_get_flags (lookup_t *lh);
+
 /* Convenience functions to get root ref & seq used in lookup.
  * root_ref will be the root_ref passed in via lookup_create() or the
  * root_ref used from the namespace.  The root_seq is only if the
@@ -3013,6 +3013,152 @@ void kvstxn_process_giant_dir (void)
     json_decref (root);
 }
 
+void kvstxn_process_sharded_dir (void)
+{
+    struct cache *cache;
+    kvsroot_mgr_t *krm;
+    kvstxn_mgr_t *ktm;
+    kvstxn_t *kt;
+    lookup_t *lh;
+    json_t *ops;
+    json_t *o;
+    char rootref[BLOBREF_MAX_STRING_SIZE];
+    char newroot1[BLOBREF_MAX_STRING_SIZE];
+    const char *newroot;
+    struct flux_msg_cred cred = { .rolemask = FLUX_ROLE_OWNER, .userid = 0 };
+    int count = 0;
+    int i;
+
+    cache = create_cache_with_empty_rootdir (rootref, sizeof (rootref));
+
+    ok ((krm = kvsroot_mgr_create (NULL, NULL)) != NULL,
+        "kvsroot_mgr_create works");
+
+    setup_kvsroot (krm, KVS_PRIMARY_NAMESPACE, cache, ref_dummy);
+
+    ok ((ktm = kvstxn_mgr_create (cache,
+                                  KVS_PRIMARY_NAMESPACE,
+                                  "sha1",
+                                  NULL,
+                                  &test_global)) != NULL,
+        "kvstxn_mgr_create works");
+
+    /* a directory with more entries than KVSTXN_SHARD_DIR_MAX
+     * is stored sharded
+     */
+    ops = json_array ();
+    for (i = 0; i < 2000; i++) {
+        char key[64];
+        char val[64];
+        snprintf (key, sizeof (key), "dir.key%d", i);
+        snprintf (val, sizeof (val), "%d", i);
+        ops_append (ops, key, val, 0);
+    }
+    ok (kvstxn_mgr_add_transaction (ktm, "transaction1", ops, 0, 0) == 0,
+        "kvstxn_mgr_add_transaction works");
+    json_decref (ops);
+
+    ok ((kt = kvstxn_mgr_get_ready_transaction (ktm)) != NULL,
+        "kvstxn_mgr_get_ready_transaction returns ready kvstxn");
+
+    ok (kvstxn_process (kt, rootref, 0) == KVSTXN_PROCESS_DIRTY_CACHE_ENTRIES,
+        "kvstxn_process returns KVSTXN_PROCESS_DIRTY_CACHE_ENTRIES");
+
+    ok (kvstxn_iter_dirty_cache_entries (kt, cache_noop_cb, NULL) == 0,
+        "kvstxn_iter_dirty_cache_entries works for dirty cache entries");
+
+    ok (kvstxn_process (kt, rootref, 0) == KVSTXN_PROCESS_FINISHED,
+        "kvstxn_process returns KVSTXN_PROCESS_FINISHED");
+
+    ok ((newroot = kvstxn_get_newroot_ref (kt)) != NULL,
+        "kvstxn_get_newroot_ref returns != NULL when processing complete");
+    strcpy (newroot1, newroot);
+
+    kvstxn_mgr_remove_transaction (ktm, kt, false);
+
+    ok ((lh = lookup_create (cache,
+                             krm,
+                             KVS_PRIMARY_NAMESPACE,
+                             newroot1,
+                             0,
+                             "dir",
+                             cred,
+                             FLUX_KVS_TREEOBJ,
+                             NULL)) != NULL,
+        "lookup_create dir works");
+    ok (lookup (lh) == LOOKUP_PROCESS_FINISHED,
+        "lookup found result");
+    o = lookup_get_value (lh);
+    ok (treeobj_is_dirref_sharded (o),
+        "dir was stored as a sharded dirref");
+    json_decref (o);
+    lookup_destroy (lh);
+
+    verify_value (cache, krm, KVS_PRIMARY_NAMESPACE, newroot1, "dir.key0", "0");
+    verify_value (cache, krm, KVS_PRIMARY_NAMESPACE, newroot1, "dir.key1999",
+                  "1999");
+    verify_value (cache, krm, KVS_PRIMARY_NAMESPACE, newroot1, "dir.nokey",
+                  NULL);
+
+    /* modify one key and delete another, only the shards holding
+     * them and the root directory should be stored
+     */
+    ops = json_array ();
+    ops_append (ops, "dir.key5", "foo", 0);
+    ops_append (ops, "dir.key6", NULL, 0);
+    ok (kvstxn_mgr_add_transaction (ktm, "transaction2", ops, 0, 0) == 0,
+        "kvstxn_mgr_add_transaction works");
+    json_decref (ops);
+
+    ok ((kt = kvstxn_mgr_get_ready_transaction (ktm)) != NULL,
+        "kvstxn_mgr_get_ready_transaction returns ready kvstxn");
+
+    ok (kvstxn_process (kt, newroot1, 0) == KVSTXN_PROCESS_DIRTY_CACHE_ENTRIES,
+        "kvstxn_process returns KVSTXN_PROCESS_DIRTY_CACHE_ENTRIES");
+
+    ok (kvstxn_iter_dirty_cache_entries (kt, cache_count_dirty_cb, &count) == 0,
+        "kvstxn_iter_dirty_cache_entries works for dirty cache entries");
+
+    ok (count >= 2 && count <= 3,
+        "only modified shards and root were dirty");
+
+    ok (kvstxn_process (kt, newroot1, 0) == KVSTXN_PROCESS_FINISHED,
+        "kvstxn_process returns KVSTXN_PROCESS_FINISHED");
+
+    ok ((newroot = kvstxn_get_newroot_ref (kt)) != NULL,
+        "kvstxn_get_newroot_ref returns != NULL when processing complete");
+
+    verify_value (cache, krm, KVS_PRIMARY_NAMESPACE, newroot, "dir.key5",
+                  "foo");
+    verify_value (cache, krm, KVS_PRIMARY_NAMESPACE, newroot, "dir.key6",
+                  NULL);
+    verify_value (cache, krm, KVS_PRIMARY_NAMESPACE, newroot, "dir.key7", "7");
+
+    ok ((lh = lookup_create (cache,
+                             krm,
+                             KVS_PRIMARY_NAMESPACE,
+                             newroot,
+                             0,
+                             "dir",
+                             cred,
+                             FLUX_KVS_READDIR,
+                             NULL)) != NULL,
+        "lookup_create dir works");
+    ok (lookup (lh) == LOOKUP_PROCESS_FINISHED,
+        "lookup found result");
+    o = lookup_get_value (lh);
+    ok (treeobj_is_dir (o) && treeobj_get_count (o) == 1999,
+        "readdir of sharded dir returns all entries");
+    json_decref (o);
+    lookup_destroy (lh);
+
+    kvstxn_mgr_remove_transaction (ktm, kt, false);
+
+    kvstxn_mgr_destroy (ktm);
+    kvsroot_mgr_destroy (krm);
+    cache_destroy (cache);
+}
+
 void kvstxn_process_append (void)
 {
     struct cache *cache;
@@ -3575,6 +3721,7 @@ int main (int argc, char *argv[])
     kvstxn_process_bad_dirrefs ();
     kvstxn_process_big_fileval ();
     kvstxn_process_giant_dir ();
+    kvstxn_process_sharded_dir ();
     kvstxn_process_append ();
     kvstxn_process_append_errors ();
     kvstxn_process_append_no_duplicate ();
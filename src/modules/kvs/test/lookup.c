@@ -3329,6 +3329,133 @@ void lookup_stall_ref_expire_cache_entries (void) {
     json_decref (root);
 }
 
+/* lookup through a sharded dirref, stalling on missing shards */
+void lookup_stall_ref_sharded (void) {
+    json_t *root;
+    json_t *shards[TREEOBJ_SHARD_FANOUT];
+    json_t *dirref;
+    json_t *test;
+    struct cache *cache;
+    kvsroot_mgr_t *krm;
+    lookup_t *lh;
+    char shard_refs[TREEOBJ_SHARD_FANOUT][BLOBREF_MAX_STRING_SIZE];
+    char root_ref[BLOBREF_MAX_STRING_SIZE];
+    int a_index;
+    int i;
+
+    ltest_init (&cache, &krm);
+
+    /* This cache is
+     *
+     * shard_refs[i]
+     * entries of "dir" whose treeobj_shard_index (name, 0) is i,
+     * "a" : val to "foo"
+     * "b" : val to "bar"
+     *
+     * root_ref
+     * "dir" : sharded dirref to shard_refs[0..15]
+     *
+     */
+
+    dirref = treeobj_create_dirref (NULL);
+    for (i = 0; i < TREEOBJ_SHARD_FANOUT; i++)
+        shards[i] = treeobj_create_dir ();
+    a_index = treeobj_shard_index ("a", 0);
+    _treeobj_insert_entry_val (shards[a_index], "a", "foo", 3);
+    _treeobj_insert_entry_val (shards[treeobj_shard_index ("b", 0)],
+                               "b",
+                               "bar",
+                               3);
+    for (i = 0; i < TREEOBJ_SHARD_FANOUT; i++) {
+        treeobj_hash ("sha1", shards[i], shard_refs[i], sizeof (shard_refs[i]));
+        treeobj_append_blobref (dirref, shard_refs[i]);
+    }
+
+    root = treeobj_create_dir ();
+    treeobj_insert_entry (root, "dir", dirref);
+    treeobj_hash ("sha1", root, root_ref, sizeof (root_ref));
+
+    setup_kvsroot (krm, KVS_PRIMARY_NAMESPACE, cache, root_ref, 0);
+
+    /* do not insert entries into cache until later for these stall tests */
+
+    /* lookup dir.a, should stall on root and the shard holding "a" */
+    ok ((lh = lookup_create (cache,
+                             krm,
+                             KVS_PRIMARY_NAMESPACE,
+                             NULL,
+                             0,
+                             "dir.a",
+                             owner_cred,
+                             0,
+                             NULL)) != NULL,
+        "lookup_create stalltest dir.a");
+    check_stall (lh, EAGAIN, 1, root_ref, "dir.a stall #1");
+
+    (void)cache_insert (cache, create_cache_entry_treeobj (root_ref, root));
+
+    check_stall (lh, EAGAIN, 1, shard_refs[a_index], "dir.a stall #2");
+
+    (void)cache_insert (cache,
+                        create_cache_entry_treeobj (shard_refs[a_index],
+                                                    shards[a_index]));
+
+    /* lookup dir.a, should succeed */
+    test = treeobj_create_val ("foo", 3);
+    check_value (lh, test, "dir.a");
+    json_decref (test);
+
+    /* lookup dir, should stall on all other shards at once */
+    ok ((lh = lookup_create (cache,
+                             krm,
+                             KVS_PRIMARY_NAMESPACE,
+                             NULL,
+                             0,
+                             "dir",
+                             owner_cred,
+                             FLUX_KVS_READDIR,
+                             NULL)) != NULL,
+        "lookup_create stalltest dir");
+    check_stall (lh,
+                 EAGAIN,
+                 TREEOBJ_SHARD_FANOUT - 1,
+                 NULL,
+                 "dir stall #1");
+
+    for (i = 0; i < TREEOBJ_SHARD_FANOUT; i++) {
+        if (!cache_lookup (cache, shard_refs[i]))
+            (void)cache_insert (cache,
+                                create_cache_entry_treeobj (shard_refs[i],
+                                                            shards[i]));
+    }
+
+    /* lookup dir, should succeed and merge the shards */
+    test = treeobj_create_dir ();
+    _treeobj_insert_entry_val (test, "a", "foo", 3);
+    _treeobj_insert_entry_val (test, "b", "bar", 3);
+    check_value (lh, test, "dir");
+    json_decref (test);
+
+    /* lookup dir with FLUX_KVS_TREEOBJ, should return sharded dirref */
+    ok ((lh = lookup_create (cache,
+                             krm,
+                             KVS_PRIMARY_NAMESPACE,
+                             NULL,
+                             0,
+                             "dir",
+                             owner_cred,
+                             FLUX_KVS_TREEOBJ,
+                             NULL)) != NULL,
+        "lookup_create dir treeobj");
+    check_value (lh, dirref, "dir treeobj");
+
+    ltest_finalize (cache, krm);
+    for (i = 0; i < TREEOBJ_SHARD_FANOUT; i++)
+        json_decref (shards[i]);
+    json_decref (dirref);
+    json_decref (root);
+}
+
 int main (int argc, char *argv[])
 {
     plan (NO_PLAN);
@@ -3351,6 +3478,7 @@ int main (int argc, char *argv[])
     lookup_stall_ref ();
     lookup_stall_namespace_removed ();
     lookup_stall_ref_expire_cache_entries ();
+    lookup_stall_ref_sharded ();
 
     done_testing ();
     return (0);
@@ -17,6 +17,7 @@
 #include "src/common/libzmqutil/cert.h"
 #include "src/common/libzmqutil/monitor.h"
 #include "src/common/libzmqutil/zap.h"
+#include "src/common/libzmqutil/msg_zsock.h"
 #include "topology.h"
 #include "ovconf.h"
 #include "ccan/str/str.h"
@@ -146,6 +147,13 @@ int children_watch (struct children *ctx,
  */
 int children_sendmsg (struct children *ctx, const flux_msg_t *msg);
 
+/* Send pre-encoded message 'mc' to child 'uuid' via bind socket.
+ * Returns 0 on success, -1 on error.
+ */
+int children_sendmsg_mcast (struct children *ctx,
+                            struct zmqutil_msg_mcast *mc,
+                            const char *uuid);
+
 /* Receive message from children via bind socket.
  * Returns message on success, NULL on error with errno set.
  */
@@ -37,7 +37,6 @@
 #include "src/common/libutil/monotime.h"
 #include "src/common/libutil/errprintf.h"
 #include "src/common/librouter/rpc_track.h"
-#include "src/common/libflux/message_route.h" // for msg_route_sendto()
 #include "ccan/str/str.h"
 #ifndef HAVE_STRLCPY
 #include "src/common/libmissing/strlcpy.h"
@@ -121,6 +120,12 @@ struct overlay {
 
     struct flux_msglist *health_requests;
     struct flux_msglist *trace_requests;
+
+    struct {
+        unsigned long count;        // events multicast to children
+        unsigned long encoded_bytes;// bytes encoded, once per event
+        unsigned long sent_bytes;   // bytes sent, summed over children
+    } mcast;
 };
 
 static void overlay_mcast_child (struct overlay *ov, flux_msg_t *msg);
@@ -739,17 +744,13 @@ static int overlay_sendmsg_child (struct overlay *ov, const flux_msg_t *msg)
     return rc;
 }
 
-// callback for msg_route_sendto()
-static int overlay_mcast_send (const flux_msg_t *msg, void *arg)
-{
-    struct overlay *ov = arg;
-    return overlay_sendmsg_child (ov, msg);
-}
-
 /* Forward an event message to downstream peers.
+ * The message is encoded once, on the first send, and the encoded parts
+ * are shared by all children.  Only the child identity frame differs.
  */
 static void overlay_mcast_child (struct overlay *ov, flux_msg_t *msg)
 {
+    struct zmqutil_msg_mcast *mc = NULL;
     struct child *child;
     int count = 0;
 
@@ -757,21 +758,40 @@ static void overlay_mcast_child (struct overlay *ov, flux_msg_t *msg)
 
     children_foreach (ov->children, child) {
         if (child_is_online (child)) {
-            if (msg_route_sendto (msg,
-                                  child->uuid,
-                                  overlay_mcast_send,
-                                  ov) < 0) {
-                if (errno != EHOSTUNREACH) {
+            if (!mc) {
+                if (!(mc = zmqutil_msg_mcast_create (msg))) {
+                    flux_log_error (ov->h, "mcast error encoding event");
+                    return;
+                }
+                ov->mcast.encoded_bytes += zmqutil_msg_mcast_size (mc);
+            }
+            if (children_sendmsg_mcast (ov->children, mc, child->uuid) < 0) {
+                /* Since ROUTER socket has ZMQ_ROUTER_MANDATORY set,
+                 * EHOSTUNREACH on a connected peer signifies a disconnect.
+                 */
+                if (errno == EHOSTUNREACH) {
+                    log_lost_connection (ov, child, "failed");
+                    overlay_child_status_update (ov,
+                                                 child,
+                                                 SUBTREE_STATUS_LOST,
+                                                 "lost connection");
+                }
+                else {
                     flux_log_error (ov->h,
                                     "mcast error to child rank %lu",
                                     (unsigned long)child->rank);
                 }
             }
-            else
+            else {
+                ov->mcast.sent_bytes += zmqutil_msg_mcast_size (mc)
+                                        + strlen (child->uuid);
                 count++;
+            }
         }
     }
+    zmqutil_msg_mcast_destroy (mc);
     if (count > 0) {
+        ov->mcast.count++;
         trace_overlay_msg (ov->h,
                            "tx",
                            FLUX_NODEID_ANY,
@@ -1561,7 +1581,7 @@ static void overlay_stats_get_cb (flux_t *h,
     int child_connected = children_get_online_count (ov->children);
     if (flux_respond_pack (h,
                            msg,
-                           "{s:i s:i s:i s:i s:i s:{s:i s:i}}",
+                           "{s:i s:i s:i s:i s:i s:{s:i s:i} s:{s:I s:I s:I}}",
                            "child-count", ov->children ? ov->children->count : 0,
                            "child-connected", child_connected,
                            "parent-count", ov->parent ? 1 : 0,
@@ -1569,7 +1589,13 @@ static void overlay_stats_get_cb (flux_t *h,
                            "child-rpc", child_rpc_track_count (ov),
                            "interthread",
                              "sendq", (int)sendq,
-                             "recvq", (int)recvq) < 0)
+                             "recvq", (int)recvq,
+                           "mcast",
+                             "count", (json_int_t)ov->mcast.count,
+                             "encoded-bytes",
+                             (json_int_t)ov->mcast.encoded_bytes,
+                             "sent-bytes",
+                             (json_int_t)ov->mcast.sent_bytes) < 0)
         flux_log_error (h, "error responding to overlay.stats-get");
     return;
 error:
@@ -14,6 +14,9 @@
  * In addition, remote access to rank 0 is prohibited on multi-user instances.
  * This is a precaution for system instances where rank 0 is deployed on a
  * management node with restricted user access.
+ *
+ * The module also provides tree-exec requests, which start a command on
+ * many ranks by forwarding the request down the TBON.  See tree.c.
  */
 
 #if HAVE_CONFIG_H
@@ -27,9 +30,12 @@
 #include "src/common/libsubprocess/server.h"
 #include "src/common/libutil/errprintf.h"
 
+#include "tree.h"
+
 struct rexec_ctx {
     flux_msg_handler_t **handlers;
     subprocess_server_t *ss;
+    struct tree *tree;
     flux_t *h;
     flux_future_t *f_shutdown;
 };
@@ -102,8 +108,27 @@ static void shutdown_cb (flux_t *h,
     }
 }
 
+/* Report tree-exec requests in progress and available matchtags, so that
+ * leaked forwarded requests can be detected.
+ */
+static void stats_cb (flux_t *h,
+                      flux_msg_handler_t *mh,
+                      const flux_msg_t *msg,
+                      void *arg)
+{
+    struct rexec_ctx *ctx = arg;
+
+    if (flux_respond_pack (h,
+                           msg,
+                           "{s:i s:i}",
+                           "tree-exec", tree_request_count (ctx->tree),
+                           "matchtags", (int)flux_matchtag_avail (h)) < 0)
+        flux_log_error (h, "error responding to stats-get request");
+}
+
 static const struct flux_msg_handler_spec htab[] = {
     { FLUX_MSGTYPE_REQUEST,  "shutdown", shutdown_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST,  "stats-get", stats_cb, 0 },
     FLUX_MSGHANDLER_TABLE_END,
 };
 
@@ -134,6 +159,14 @@ static int mod_main (flux_t *h, int argc, char *argv[])
     }
     if (rank == 0)
         subprocess_server_set_auth_cb (ctx.ss, reject_nonlocal, &ctx);
+    if (!(ctx.tree = tree_create (h,
+                                  name,
+                                  rank == 0 ? reject_nonlocal : NULL,
+                                  &ctx))) {
+        flux_log_error (h, "error setting up tree-exec service");
+        goto done;
+    }
+    subprocess_server_set_disconnect_cb (ctx.ss, tree_disconnect, ctx.tree);
     if (flux_msg_handler_addvec_ex (h, name, htab, &ctx, &ctx.handlers) < 0) {
         flux_log_error (h, "error registering message handlers");
         goto done;
@@ -146,6 +179,7 @@ static int mod_main (flux_t *h, int argc, char *argv[])
 done:
     flux_future_destroy (ctx.f_shutdown);
     flux_msg_handler_delvec (ctx.handlers);
+    tree_destroy (ctx.tree);
     subprocess_server_destroy (ctx.ss);
     return rc;
 }
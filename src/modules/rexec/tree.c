@@ -0,0 +1,985 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* tree.c - launch a command on a set of ranks along the TBON
+ *
+ * A tree-exec request carries an idset of target ranks.  The receiving
+ * broker starts the command locally if its own rank is a target, and
+ * forwards one tree-exec request to each child whose subtree contains
+ * targets.  Started and finished responses from the local process and
+ * from children are merged and sent upstream in batches, so the number
+ * of messages handled by the root grows with the fanout and the number
+ * of distinct exit codes rather than with the number of ranks.  Output
+ * and failures are not batched.
+ *
+ * The local process is launched through the subprocess server of this
+ * module, so it is managed exactly like a process started by a regular
+ * <service>.exec request.
+ *
+ * Requests received by this broker from a client are identified by the
+ * sender and matchtag for tree-write and tree-kill requests.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <signal.h>
+#include <jansson.h>
+#include <flux/core.h>
+#include <flux/idset.h>
+
+#include "src/common/libczmqcontainers/czmq_containers.h"
+#include "src/common/libsubprocess/command_private.h"
+#include "src/common/libsubprocess/client.h"
+#include "src/common/libioencode/ioencode.h"
+#include "src/common/libutil/errno_safe.h"
+#include "src/common/libutil/errprintf.h"
+#include "src/common/librouter/tbon_children.h"
+#include "ccan/str/str.h"
+
+#include "tree.h"
+
+static const double batch_timeout = 0.01;
+
+static const int valid_flags = SUBPROCESS_REXEC_STDOUT
+                               | SUBPROCESS_REXEC_STDERR
+                               | SUBPROCESS_REXEC_CHANNEL;
+
+struct tree {
+    flux_t *h;
+    char *service_name;
+    uint32_t rank;
+    struct tbon_children *tbon;
+    zlistx_t *requests;
+    flux_msg_handler_t **handlers;
+    subprocess_server_auth_f auth_cb;
+    void *arg;
+};
+
+struct tree_fwd {
+    uint32_t rank;
+    struct idset *ranks;
+    flux_future_t *f;
+    bool eos;                       // response stream has ended
+};
+
+struct tree_exec {
+    struct tree *tree;
+    const flux_msg_t *msg;
+    json_t *cmd;
+    int flags;
+    int local_flags;
+    struct idset *pending;          // ranks not yet finished or failed
+    struct idset *pending_start;    // ranks not yet started or failed
+    flux_subprocess_t *p;
+    struct tree_fwd *fwd;
+    size_t nfwd;
+    json_t *started;                // batched rank => pid
+    zhashx_t *finished;             // batched wait status => idset
+    flux_watcher_t *timer;
+    bool disconnected;              // requester is gone, do not respond
+    void *handle;
+};
+
+static void tree_exec_destroy (struct tree_exec *te)
+{
+    if (te) {
+        int saved_errno = errno;
+        flux_subprocess_destroy (te->p);
+        for (int i = 0; i < te->nfwd; i++) {
+            flux_future_destroy (te->fwd[i].f);
+            idset_destroy (te->fwd[i].ranks);
+        }
+        free (te->fwd);
+        flux_watcher_destroy (te->timer);
+        zhashx_destroy (&te->finished);
+        json_decref (te->started);
+        idset_destroy (te->pending_start);
+        idset_destroy (te->pending);
+        json_decref (te->cmd);
+        flux_msg_decref (te->msg);
+        free (te);
+        errno = saved_errno;
+    }
+}
+
+// zlistx_destructor_fn signature
+static void tree_exec_destructor (void **item)
+{
+    if (item) {
+        tree_exec_destroy (*item);
+        *item = NULL;
+    }
+}
+
+// zhashx_destructor_fn signature
+static void idset_destructor (void **item)
+{
+    if (item) {
+        idset_destroy (*item);
+        *item = NULL;
+    }
+}
+
+static void tree_exec_respond_error (struct tree_exec *te,
+                                     int errnum,
+                                     const char *errstr)
+{
+    if (te->disconnected)
+        return;
+    if (flux_respond_error (te->tree->h, te->msg, errnum, errstr) < 0)
+        flux_log_error (te->tree->h, "error responding to tree-exec request");
+}
+
+/* Send batched started and finished responses, in that order.
+ */
+static void tree_exec_flush (struct tree_exec *te)
+{
+    flux_t *h = te->tree->h;
+
+    flux_watcher_stop (te->timer);
+    if (te->disconnected) {
+        json_object_clear (te->started);
+        zhashx_purge (te->finished);
+        return;
+    }
+    if (json_object_size (te->started) > 0) {
+        if (flux_respond_pack (h,
+                               te->msg,
+                               "{s:s s:O}",
+                               "type", "started",
+                               "pids", te->started) < 0)
+            flux_log_error (h, "error responding to tree-exec request");
+        json_object_clear (te->started);
+    }
+    if (zhashx_size (te->finished) > 0) {
+        struct idset *ids;
+        json_t *o;
+
+        if (!(o = json_object ()))
+            goto nomem;
+        ids = zhashx_first (te->finished);
+        while (ids) {
+            const char *key = zhashx_cursor (te->finished);
+            char *s;
+            json_t *val = NULL;
+
+            if (!(s = idset_encode (ids, IDSET_FLAG_RANGE))
+                || !(val = json_string (s))
+                || json_object_set_new (o, key, val) < 0) {
+                json_decref (val);
+                free (s);
+                json_decref (o);
+                goto nomem;
+            }
+            free (s);
+            ids = zhashx_next (te->finished);
+        }
+        if (flux_respond_pack (h,
+                               te->msg,
+                               "{s:s s:O}",
+                               "type", "finished",
+                               "status", o) < 0)
+            flux_log_error (h, "error responding to tree-exec request");
+        json_decref (o);
+        zhashx_purge (te->finished);
+    }
+    return;
+nomem:
+    flux_log (h, LOG_ERR, "tree-exec: out of memory flushing batch");
+}
+
+/* If all target ranks are finished or failed, and the response streams of
+ * all forwarded requests have ended, end the response stream and destroy
+ * the request.  A child sends its last finished batch before it ends its
+ * stream, so the request must be kept until then, or the matchtag of the
+ * forwarded request would never be freed.  N.B. 'te' may not be accessed
+ * afterwards if it was destroyed.
+ */
+static void tree_exec_check_done (struct tree_exec *te)
+{
+    if (idset_count (te->pending) > 0)
+        return;
+    tree_exec_flush (te);
+    for (int i = 0; i < te->nfwd; i++) {
+        if (te->fwd[i].f && !te->fwd[i].eos)
+            return;
+    }
+    tree_exec_respond_error (te, ENODATA, NULL);
+    zlistx_delete (te->tree->requests, te->handle);
+}
+
+static void tree_exec_arm_timer (struct tree_exec *te)
+{
+    if (!flux_watcher_is_active (te->timer)) {
+        flux_timer_watcher_reset (te->timer, batch_timeout, 0.);
+        flux_watcher_start (te->timer);
+    }
+}
+
+static void batch_timeout_cb (flux_reactor_t *r,
+                              flux_watcher_t *w,
+                              int revents,
+                              void *arg)
+{
+    tree_exec_flush (arg);
+}
+
+static void tree_exec_add_started (struct tree_exec *te,
+                                   const char *rank,
+                                   json_t *pid)
+{
+    if (json_object_set (te->started, rank, pid) < 0) {
+        flux_log (te->tree->h, LOG_ERR, "tree-exec: error batching pid");
+        return;
+    }
+    (void)idset_clear (te->pending_start, strtoul (rank, NULL, 10));
+    if (idset_count (te->pending_start) == 0)
+        tree_exec_flush (te);
+    else
+        tree_exec_arm_timer (te);
+}
+
+static void tree_exec_add_finished (struct tree_exec *te,
+                                    int status,
+                                    const struct idset *ranks)
+{
+    struct idset *ids;
+    char key[32];
+
+    snprintf (key, sizeof (key), "%d", status);
+    if (!(ids = zhashx_lookup (te->finished, key))) {
+        if (!(ids = idset_create (0, IDSET_FLAG_AUTOGROW))
+            || zhashx_insert (te->finished, key, ids) < 0) {
+            idset_destroy (ids);
+            flux_log (te->tree->h, LOG_ERR, "tree-exec: error batching exit");
+            return;
+        }
+    }
+    if (idset_add (ids, ranks) < 0
+        || idset_subtract (te->pending, ranks) < 0) {
+        flux_log_error (te->tree->h, "tree-exec: error batching exit");
+        return;
+    }
+    if (idset_count (te->pending) > 0)
+        tree_exec_arm_timer (te);
+}
+
+/* Report 'ranks' as failed.  Ranks that already finished or failed
+ * are ignored.
+ */
+static void tree_exec_fail (struct tree_exec *te,
+                            const struct idset *ranks,
+                            int errnum,
+                            const char *errstr)
+{
+    flux_t *h = te->tree->h;
+    struct idset *ids;
+    char *s = NULL;
+
+    if (!(ids = idset_intersect (ranks, te->pending))
+        || idset_count (ids) == 0)
+        goto out;
+    if (!(s = idset_encode (ids, IDSET_FLAG_RANGE)))
+        goto error;
+    tree_exec_flush (te);
+    if (!te->disconnected
+        && flux_respond_pack (h,
+                           te->msg,
+                           "{s:s s:s s:i s:s}",
+                           "type", "failed",
+                           "ranks", s,
+                           "errnum", errnum,
+                           "errstr", errstr ? errstr : strerror (errnum)) < 0)
+        flux_log_error (h, "error responding to tree-exec request");
+    if (idset_subtract (te->pending, ids) < 0
+        || idset_subtract (te->pending_start, ids) < 0)
+        goto error;
+out:
+    free (s);
+    idset_destroy (ids);
+    return;
+error:
+    flux_log_error (h, "tree-exec: error failing ranks");
+    goto out;
+}
+
+static void tree_exec_fail_rank (struct tree_exec *te,
+                                 uint32_t rank,
+                                 int errnum,
+                                 const char *errstr)
+{
+    struct idset *ids;
+
+    if (!(ids = idset_create (0, IDSET_FLAG_AUTOGROW))
+        || idset_set (ids, rank) < 0) {
+        flux_log_error (te->tree->h, "tree-exec: error failing rank");
+        idset_destroy (ids);
+        return;
+    }
+    tree_exec_fail (te, ids, errnum, errstr);
+    idset_destroy (ids);
+}
+
+/* Forward an output or failed response from a child verbatim, after
+ * sending any batched responses that preceded it.
+ */
+static void tree_exec_forward (struct tree_exec *te, const char *payload)
+{
+    tree_exec_flush (te);
+    if (!te->disconnected
+        && flux_respond (te->tree->h, te->msg, payload) < 0)
+        flux_log_error (te->tree->h, "error responding to tree-exec request");
+}
+
+static void local_state_cb (flux_subprocess_t *p,
+                            flux_subprocess_state_t state)
+{
+    struct tree_exec *te = flux_subprocess_aux_get (p, "tree_exec");
+    char rank[16];
+
+    snprintf (rank, sizeof (rank), "%u", (unsigned int)te->tree->rank);
+    if (state == FLUX_SUBPROCESS_RUNNING) {
+        json_t *pid;
+        if (!(pid = json_integer (flux_subprocess_pid (p)))) {
+            flux_log (te->tree->h, LOG_ERR, "tree-exec: out of memory");
+            return;
+        }
+        tree_exec_add_started (te, rank, pid);
+        json_decref (pid);
+    }
+    else if (state == FLUX_SUBPROCESS_FAILED) {
+        tree_exec_fail_rank (te,
+                             te->tree->rank,
+                             flux_subprocess_fail_errno (p),
+                             flux_subprocess_fail_error (p));
+        tree_exec_check_done (te);
+    }
+}
+
+static void local_completion_cb (flux_subprocess_t *p)
+{
+    struct tree_exec *te = flux_subprocess_aux_get (p, "tree_exec");
+    struct idset *ids;
+
+    if (flux_subprocess_state (p) != FLUX_SUBPROCESS_EXITED)
+        return;
+    if (!(ids = idset_create (0, IDSET_FLAG_AUTOGROW))
+        || idset_set (ids, te->tree->rank) < 0) {
+        flux_log_error (te->tree->h, "tree-exec: error recording exit");
+        idset_destroy (ids);
+        return;
+    }
+    tree_exec_add_finished (te, flux_subprocess_status (p), ids);
+    idset_destroy (ids);
+    tree_exec_check_done (te);
+}
+
+static void local_output_cb (flux_subprocess_t *p, const char *stream)
+{
+    struct tree_exec *te = flux_subprocess_aux_get (p, "tree_exec");
+    flux_t *h = te->tree->h;
+    const char *data;
+    char rank[16];
+    json_t *io;
+    int len;
+    bool eof;
+
+    if ((len = flux_subprocess_read (p, stream, &data)) < 0) {
+        flux_log_error (h, "tree-exec: flux_subprocess_read");
+        return;
+    }
+    /* With LOCAL_UNBUF, eof is delivered in a separate callback with no
+     * data, so only forward eof once.
+     */
+    eof = len == 0 && flux_subprocess_read_stream_closed (p, stream);
+    if ((len == 0 && !eof) || te->disconnected)
+        return;
+    snprintf (rank, sizeof (rank), "%u", (unsigned int)te->tree->rank);
+    if (!(io = ioencode (stream, rank, data, len, eof))) {
+        flux_log_error (h, "tree-exec: ioencode");
+        return;
+    }
+    tree_exec_flush (te);
+    if (flux_respond_pack (h,
+                           te->msg,
+                           "{s:s s:O}",
+                           "type", "output",
+                           "io", io) < 0)
+        flux_log_error (h, "error responding to tree-exec request");
+    json_decref (io);
+}
+
+static int tree_exec_local (struct tree_exec *te)
+{
+    flux_subprocess_ops_t ops = {
+        .on_completion = local_completion_cb,
+        .on_state_change = local_state_cb,
+    };
+    flux_cmd_t *cmd;
+
+    if (te->flags & SUBPROCESS_REXEC_STDOUT)
+        ops.on_stdout = local_output_cb;
+    if (te->flags & SUBPROCESS_REXEC_STDERR)
+        ops.on_stderr = local_output_cb;
+    if (te->flags & SUBPROCESS_REXEC_CHANNEL)
+        ops.on_channel_out = local_output_cb;
+    if (!(cmd = cmd_fromjson (te->cmd, NULL)))
+        return -1;
+    te->p = flux_rexec_ex (te->tree->h,
+                           te->tree->service_name,
+                           te->tree->rank,
+                           te->local_flags | FLUX_SUBPROCESS_FLAGS_LOCAL_UNBUF,
+                           cmd,
+                           &ops,
+                           flux_llog,
+                           te->tree->h);
+    flux_cmd_destroy (cmd);
+    if (!te->p
+        || flux_subprocess_aux_set (te->p, "tree_exec", te, NULL) < 0)
+        return -1;
+    return 0;
+}
+
+static void tree_exec_started (struct tree_exec *te, json_t *pids)
+{
+    const char *key;
+    json_t *value;
+
+    json_object_foreach (pids, key, value)
+        tree_exec_add_started (te, key, value);
+}
+
+static void tree_exec_finished (struct tree_exec *te, json_t *status)
+{
+    const char *key;
+    json_t *value;
+
+    json_object_foreach (status, key, value) {
+        struct idset *ids;
+        if (!(ids = idset_decode (json_string_value (value)))) {
+            flux_log_error (te->tree->h, "tree-exec: invalid finished ranks");
+            continue;
+        }
+        tree_exec_add_finished (te, strtol (key, NULL, 10), ids);
+        idset_destroy (ids);
+    }
+}
+
+static void fwd_continuation (flux_future_t *f, void *arg)
+{
+    struct tree_exec *te = arg;
+    struct tree_fwd *fwd = NULL;
+    const char *payload;
+    const char *type;
+    json_t *o;
+
+    for (int i = 0; i < te->nfwd; i++) {
+        if (te->fwd[i].f == f)
+            fwd = &te->fwd[i];
+    }
+    if (flux_rpc_get (f, &payload) < 0
+        || flux_rpc_get_unpack (f, "{s:s}", "type", &type) < 0) {
+        /* A child that ends its stream normally has already reported
+         * all of its ranks.  Otherwise, e.g. EHOSTUNREACH if the child
+         * was lost, fail whatever it has not reported.  Either way, the
+         * stream has ended.
+         */
+        int errnum = errno == ENODATA ? EPROTO : errno;
+        fwd->eos = true;
+        tree_exec_fail (te, fwd->ranks, errnum, future_strerror (f, errnum));
+        tree_exec_check_done (te);
+        return;
+    }
+    if (streq (type, "started")) {
+        if (flux_rpc_get_unpack (f, "{s:o}", "pids", &o) == 0)
+            tree_exec_started (te, o);
+    }
+    else if (streq (type, "finished")) {
+        if (flux_rpc_get_unpack (f, "{s:o}", "status", &o) == 0)
+            tree_exec_finished (te, o);
+    }
+    else if (streq (type, "failed")) {
+        const char *s;
+        struct idset *ids;
+        if (flux_rpc_get_unpack (f, "{s:s}", "ranks", &s) == 0
+            && (ids = idset_decode (s))) {
+            tree_exec_forward (te, payload);
+            (void)idset_subtract (te->pending, ids);
+            (void)idset_subtract (te->pending_start, ids);
+            idset_destroy (ids);
+        }
+    }
+    else
+        tree_exec_forward (te, payload);
+    flux_future_reset (f);
+    tree_exec_check_done (te);
+}
+
+static int tree_exec_forward_children (struct tree_exec *te,
+                                       const struct tbon_child *children,
+                                       size_t nchildren)
+{
+    struct tree *tree = te->tree;
+    char topic[256];
+
+    if (!(te->fwd = calloc (nchildren, sizeof (te->fwd[0]))))
+        return -1;
+    snprintf (topic, sizeof (topic), "%s.tree-exec", tree->service_name);
+    for (int i = 0; i < nchildren; i++) {
+        struct tree_fwd *fwd = &te->fwd[te->nfwd];
+        char *s;
+
+        if (!(fwd->ranks = idset_intersect (te->pending,
+                                            children[i].subtree)))
+            return -1;
+        if (idset_count (fwd->ranks) == 0) {
+            idset_destroy (fwd->ranks);
+            fwd->ranks = NULL;
+            continue;
+        }
+        fwd->rank = children[i].rank;
+        te->nfwd++;
+        if (!(s = idset_encode (fwd->ranks, IDSET_FLAG_RANGE)))
+            return -1;
+        fwd->f = flux_rpc_pack (tree->h,
+                                topic,
+                                fwd->rank,
+                                FLUX_RPC_STREAMING,
+                                "{s:O s:i s:i s:s}",
+                                "cmd", te->cmd,
+                                "flags", te->flags,
+                                "local_flags", te->local_flags,
+                                "ranks", s);
+        free (s);
+        if (!fwd->f
+            || flux_future_then (fwd->f, -1., fwd_continuation, te) < 0) {
+            fwd->eos = true; // no responses will be handled
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static struct tree_exec *tree_exec_create (struct tree *tree,
+                                           const flux_msg_t *msg,
+                                           json_t *cmd,
+                                           int flags,
+                                           int local_flags,
+                                           struct idset *ranks)
+{
+    struct tree_exec *te;
+
+    if (!(te = calloc (1, sizeof (*te))))
+        return NULL;
+    te->tree = tree;
+    te->msg = flux_msg_incref (msg);
+    te->cmd = json_incref (cmd);
+    te->flags = flags;
+    te->local_flags = local_flags;
+    if (!(te->pending = idset_copy (ranks))
+        || !(te->pending_start = idset_copy (ranks))
+        || !(te->started = json_object ())
+        || !(te->finished = zhashx_new ())
+        || !(te->timer = flux_timer_watcher_create (flux_get_reactor (tree->h),
+                                                    batch_timeout,
+                                                    0.,
+                                                    batch_timeout_cb,
+                                                    te)))
+        goto error;
+    zhashx_set_destructor (te->finished, idset_destructor);
+    return te;
+error:
+    tree_exec_destroy (te);
+    return NULL;
+}
+
+static void tree_exec_cb (flux_t *h,
+                          flux_msg_handler_t *mh,
+                          const flux_msg_t *msg,
+                          void *arg)
+{
+    struct tree *tree = arg;
+    struct tree_exec *te = NULL;
+    struct idset *ranks = NULL;
+    struct idset *subtree = NULL;
+    const struct tbon_child *children;
+    size_t nchildren;
+    const char *s;
+    json_t *cmd;
+    int flags;
+    int local_flags;
+    flux_error_t error;
+    const char *errmsg = NULL;
+    size_t count;
+
+    if (flux_request_unpack (msg,
+                             NULL,
+                             "{s:o s:i s:i s:s}",
+                             "cmd", &cmd,
+                             "flags", &flags,
+                             "local_flags", &local_flags,
+                             "ranks", &s) < 0)
+        goto error;
+    if (!flux_msg_is_streaming (msg)
+        || (flags & ~valid_flags)
+        || (local_flags & FLUX_SUBPROCESS_FLAGS_SIGN)
+        || !(ranks = idset_decode (s))
+        || idset_count (ranks) == 0) {
+        errno = EPROTO;
+        goto error;
+    }
+    if (tree->auth_cb && (*tree->auth_cb) (msg, tree->arg, &error) < 0) {
+        errno = EPERM;
+        errmsg = error.text;
+        goto error;
+    }
+    if (!(children = tbon_children_get (tree->tbon, &nchildren))) {
+        errmsg = "TBON topology is not yet known";
+        errno = EAGAIN;
+        goto error;
+    }
+    /* All target ranks must be within this broker's subtree.
+     */
+    if (!(subtree = idset_create (0, IDSET_FLAG_AUTOGROW))
+        || idset_set (subtree, tree->rank) < 0)
+        goto error;
+    for (int i = 0; i < nchildren; i++) {
+        if (idset_add (subtree, children[i].subtree) < 0)
+            goto error;
+    }
+    count = idset_count (subtree);
+    if (idset_subtract (subtree, ranks) < 0)
+        goto error;
+    if (idset_count (subtree) + idset_count (ranks) != count) {
+        errmsg = "target ranks are not in this broker's subtree";
+        errno = EINVAL;
+        goto error;
+    }
+    if (!(te = tree_exec_create (tree, msg, cmd, flags, local_flags, ranks))
+        || !(te->handle = zlistx_add_end (tree->requests, te)))
+        goto error;
+    if (tree_exec_forward_children (te, children, nchildren) < 0) {
+        errmsg = "error forwarding tree-exec request";
+        goto error_started;
+    }
+    if (idset_test (ranks, tree->rank) && tree_exec_local (te) < 0) {
+        errprintf (&error, "%s", strerror (errno));
+        tree_exec_fail_rank (te, tree->rank, errno, error.text);
+        tree_exec_check_done (te);
+    }
+    idset_destroy (subtree);
+    idset_destroy (ranks);
+    return;
+error_started:
+    /* The request is on the list and children may already be running it,
+     * so fail the remaining ranks rather than the request.
+     */
+    tree_exec_fail (te, te->pending, errno, errmsg);
+    tree_exec_check_done (te);
+    idset_destroy (subtree);
+    idset_destroy (ranks);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, errmsg) < 0)
+        flux_log_error (h, "error responding to tree-exec request");
+    if (te && !te->handle)
+        tree_exec_destroy (te);
+    else if (te)
+        zlistx_delete (tree->requests, te->handle);
+    idset_destroy (subtree);
+    idset_destroy (ranks);
+}
+
+static struct tree_exec *tree_exec_lookup (struct tree *tree,
+                                           const flux_msg_t *msg,
+                                           uint32_t matchtag)
+{
+    const char *sender = flux_msg_route_first (msg);
+    struct tree_exec *te;
+
+    te = zlistx_first (tree->requests);
+    while (te) {
+        uint32_t tag;
+        const char *s = flux_msg_route_first (te->msg);
+
+        if (flux_msg_get_matchtag (te->msg, &tag) == 0
+            && tag == matchtag
+            && s && sender && streq (s, sender))
+            return te;
+        te = zlistx_next (tree->requests);
+    }
+    return NULL;
+}
+
+/* Send a tree-kill request to each child with unfinished ranks in 'ranks'.
+ * Children do not respond.  Errors are only logged.
+ */
+static void tree_exec_kill_children (struct tree_exec *te,
+                                     const struct idset *ranks,
+                                     int signum)
+{
+    flux_t *h = te->tree->h;
+    char topic[256];
+
+    snprintf (topic, sizeof (topic), "%s.tree-kill", te->tree->service_name);
+    for (int i = 0; i < te->nfwd; i++) {
+        struct tree_fwd *fwd = &te->fwd[i];
+        struct idset *ids = NULL;
+        struct idset *tmp;
+        flux_future_t *f = NULL;
+        char *s = NULL;
+
+        if (!fwd->f || fwd->eos)
+            continue;
+        if (!(tmp = idset_intersect (ranks, fwd->ranks))
+            || !(ids = idset_intersect (tmp, te->pending))) {
+            idset_destroy (tmp);
+            goto error;
+        }
+        idset_destroy (tmp);
+        if (idset_count (ids) > 0) {
+            if (!(s = idset_encode (ids, IDSET_FLAG_RANGE))
+                || !(f = flux_rpc_pack (h,
+                                        topic,
+                                        fwd->rank,
+                                        FLUX_RPC_NORESPONSE,
+                                        "{s:i s:s s:i}",
+                                        "matchtag",
+                                        (int)flux_rpc_get_matchtag (fwd->f),
+                                        "ranks", s,
+                                        "signum", signum))) {
+                free (s);
+                idset_destroy (ids);
+                goto error;
+            }
+            flux_future_destroy (f);
+            free (s);
+        }
+        idset_destroy (ids);
+        continue;
+error:
+        flux_log_error (h,
+                        "tree-kill: error forwarding to rank %u",
+                        (unsigned int)fwd->rank);
+    }
+}
+
+static void tree_exec_kill (struct tree_exec *te,
+                            const struct idset *ranks,
+                            int signum)
+{
+    if (te->p
+        && idset_test (ranks, te->tree->rank)
+        && flux_subprocess_active (te->p)) {
+        flux_future_t *f;
+        if (!(f = flux_subprocess_kill (te->p, signum)))
+            flux_log_error (te->tree->h, "tree-kill: flux_subprocess_kill");
+        flux_future_destroy (f);
+    }
+    tree_exec_kill_children (te, ranks, signum);
+}
+
+static void tree_kill_cb (flux_t *h,
+                          flux_msg_handler_t *mh,
+                          const flux_msg_t *msg,
+                          void *arg)
+{
+    struct tree *tree = arg;
+    struct tree_exec *te;
+    struct idset *ranks = NULL;
+    const char *s;
+    int matchtag;
+    int signum;
+
+    if (flux_request_unpack (msg,
+                             NULL,
+                             "{s:i s:s s:i}",
+                             "matchtag", &matchtag,
+                             "ranks", &s,
+                             "signum", &signum) < 0)
+        goto error;
+    if (!(ranks = idset_decode (s))) {
+        errno = EPROTO;
+        goto error;
+    }
+    if (!(te = tree_exec_lookup (tree, msg, matchtag))) {
+        errno = ESRCH;
+        goto error;
+    }
+    tree_exec_kill (te, ranks, signum);
+    if (flux_respond (h, msg, NULL) < 0)
+        flux_log_error (h, "error responding to tree-kill request");
+    idset_destroy (ranks);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        flux_log_error (h, "error responding to tree-kill request");
+    idset_destroy (ranks);
+}
+
+/* Write to the local process and forward to children.  There is no
+ * response, so errors are only logged.
+ */
+static void tree_write_cb (flux_t *h,
+                           flux_msg_handler_t *mh,
+                           const flux_msg_t *msg,
+                           void *arg)
+{
+    struct tree *tree = arg;
+    struct tree_exec *te;
+    const char *stream;
+    const char *rank;
+    char *data = NULL;
+    int len;
+    bool eof;
+    int matchtag;
+    json_t *io;
+    char topic[256];
+
+    if (flux_request_unpack (msg,
+                             NULL,
+                             "{s:i s:o}",
+                             "matchtag", &matchtag,
+                             "io", &io) < 0
+        || iodecode (io, &stream, &rank, &data, &len, &eof) < 0) {
+        flux_log_error (h, "tree-write: error decoding request");
+        return;
+    }
+    if (!(te = tree_exec_lookup (tree, msg, matchtag))) {
+        flux_log (h, LOG_DEBUG, "tree-write: no matching tree-exec request");
+        goto out;
+    }
+    if (te->p && flux_subprocess_active (te->p)) {
+        if (len > 0 && flux_subprocess_write (te->p, stream, data, len) < len)
+            flux_log_error (h, "tree-write: flux_subprocess_write");
+        if (eof && flux_subprocess_close (te->p, stream) < 0)
+            flux_log_error (h, "tree-write: flux_subprocess_close");
+    }
+    snprintf (topic, sizeof (topic), "%s.tree-write", tree->service_name);
+    for (int i = 0; i < te->nfwd; i++) {
+        flux_future_t *f;
+
+        if (!te->fwd[i].f || te->fwd[i].eos)
+            continue;
+        if (!(f = flux_rpc_pack (h,
+                                 topic,
+                                 te->fwd[i].rank,
+                                 FLUX_RPC_NORESPONSE,
+                                 "{s:i s:O}",
+                                 "matchtag",
+                                 (int)flux_rpc_get_matchtag (te->fwd[i].f),
+                                 "io", io))) {
+            flux_log_error (h,
+                            "tree-write: error forwarding to rank %u",
+                            (unsigned int)te->fwd[i].rank);
+        }
+        flux_future_destroy (f);
+    }
+out:
+    free (data);
+}
+
+/* Kill the requests of a disconnected client on this broker and, via
+ * tree-kill, on all children.  Each request is destroyed as usual once its
+ * ranks are finished and the response streams of its children have ended,
+ * but no more responses are sent to the client.
+ */
+void tree_disconnect (const flux_msg_t *msg, void *arg)
+{
+    struct tree *tree = arg;
+    struct tree_exec *te;
+    zlistx_t *l;
+
+    if (!(l = zlistx_new ())) {
+        flux_log (tree->h, LOG_ERR, "tree-exec: out of memory");
+        return;
+    }
+    te = zlistx_first (tree->requests);
+    while (te) {
+        if (flux_disconnect_match (te->msg, msg)
+            && !te->disconnected
+            && !zlistx_add_end (l, te)) {
+            flux_log (tree->h, LOG_ERR, "tree-exec: out of memory");
+            break;
+        }
+        te = zlistx_next (tree->requests);
+    }
+    /* N.B. tree_exec_check_done() may remove 'te' from tree->requests,
+     * so it is not called while iterating over that list.
+     */
+    te = zlistx_first (l);
+    while (te) {
+        te->disconnected = true;
+        tree_exec_kill (te, te->pending, SIGKILL);
+        tree_exec_check_done (te);
+        te = zlistx_next (l);
+    }
+    zlistx_destroy (&l);
+}
+
+int tree_request_count (struct tree *tree)
+{
+    return zlistx_size (tree->requests);
+}
+
+static const struct flux_msg_handler_spec htab[] = {
+    { FLUX_MSGTYPE_REQUEST, "tree-exec", tree_exec_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "tree-kill", tree_kill_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "tree-write", tree_write_cb, 0 },
+    FLUX_MSGHANDLER_TABLE_END,
+};
+
+void tree_destroy (struct tree *tree)
+{
+    if (tree) {
+        int saved_errno = errno;
+        flux_msg_handler_delvec (tree->handlers);
+        zlistx_destroy (&tree->requests);
+        tbon_children_destroy (tree->tbon);
+        free (tree->service_name);
+        free (tree);
+        errno = saved_errno;
+    }
+}
+
+struct tree *tree_create (flux_t *h,
+                          const char *service_name,
+                          subprocess_server_auth_f auth_cb,
+                          void *arg)
+{
+    struct tree *tree;
+
+    if (!(tree = calloc (1, sizeof (*tree))))
+        return NULL;
+    tree->h = h;
+    tree->auth_cb = auth_cb;
+    tree->arg = arg;
+    if (!(tree->service_name = strdup (service_name))
+        || !(tree->requests = zlistx_new ()))
+        goto error;
+    zlistx_set_destructor (tree->requests, tree_exec_destructor);
+    if (flux_get_rank (h, &tree->rank) < 0)
+        goto error;
+    if (flux_msg_handler_addvec_ex (h,
+                                    service_name,
+                                    htab,
+                                    tree,
+                                    &tree->handlers) < 0)
+        goto error;
+    if (!(tree->tbon = tbon_children_create (h, tree->rank)))
+        goto error;
+    return tree;
+error:
+    tree_destroy (tree);
+    return NULL;
+}
+
+// vi:ts=4 sw=4 expandtab
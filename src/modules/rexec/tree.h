@@ -0,0 +1,39 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _REXEC_TREE_H
+#define _REXEC_TREE_H
+
+#include <flux/core.h>
+
+#include "src/common/libsubprocess/server.h"
+
+/* Register <service_name>.tree-exec, tree-write, and tree-kill handlers.
+ * If 'auth_cb' is non-NULL, it is called to allow/deny each tree-exec
+ * request, like the subprocess server auth callback.
+ */
+struct tree *tree_create (flux_t *h,
+                          const char *service_name,
+                          subprocess_server_auth_f auth_cb,
+                          void *arg);
+void tree_destroy (struct tree *tree);
+
+/* Kill and forget all tree-exec requests from the sender of 'msg'.
+ * Suitable for use as a subprocess_server_disconnect_f.
+ */
+void tree_disconnect (const flux_msg_t *msg, void *arg);
+
+/* Return the number of tree-exec requests in progress on this broker.
+ */
+int tree_request_count (struct tree *tree);
+
+#endif /* !_REXEC_TREE_H */
+
+// vi:ts=4 sw=4 expandtab
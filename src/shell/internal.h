@@ -15,6 +15,8 @@
 #include <flux/optparse.h>
 #include <flux/shell.h>
 #include <limits.h>
+#include <time.h>
+#include <jansson.h>
 
 #include "src/common/libutil/aux.h"
 #include "src/common/libczmqcontainers/czmq_containers.h"
@@ -51,8 +53,20 @@ struct flux_shell {
     int verbose;
     int nosetpgrp;
 
+    json_t **rank_info;         /* cached rank info objects by shell rank */
+
+    struct timespec t_phase;    /* start of current startup phase */
+    json_t *phases;             /* startup phase name => seconds */
+
     struct aux_item *aux;
 };
 
+/* Cached info objects behind flux_shell_info_unpack() and
+ * flux_shell_rank_info_unpack().  They are owned by the shell and must not
+ * be modified.  A shell_rank of -1 refers to this shell.
+ */
+json_t *shell_info_object (flux_shell_t *shell);
+json_t *shell_rank_info_object (flux_shell_t *shell, int shell_rank);
+
 #endif /* !_SHELL_INTERNAL_H */
 
@@ -16,6 +16,7 @@
  *  "output": {
  *    "mode": "truncate|append",
  *    "client": { "lwm": integer, "hwm": integer },
+ *    "chunk": { "size": integer|"size", "timeout": number|"fsd" },
  *    "stdout" {
  *      "type": "kvs|file",
  *      "path": "template",
@@ -49,12 +50,16 @@
 
 #include <flux/shell.h>
 
+#include "src/common/libutil/parse_size.h"
+#include "src/common/libutil/fsd.h"
 #include "ccan/str/str.h"
 
 #include "output/conf.h"
 
 static const int default_client_lwm = 100;
 static const int default_client_hwm = 1000;
+static const double default_chunk_timeout = 0.1;
+static const uint64_t max_chunk_size = 1048576;
 
 /* Detect if a mustache template is per-shell or per-task by rendering
  * per-rank template on rank 0 and rank 1, then a per-task template using
@@ -144,6 +149,55 @@ static int output_stream_getopts (flux_shell_t *shell,
     return 0;
 }
 
+/* Read output.chunk.size and output.chunk.timeout.  Chunking of task
+ * output is disabled unless a nonzero size is given.
+ */
+static int output_chunk_getopts (flux_shell_t *shell,
+                                 struct output_config *conf)
+{
+    json_t *size = NULL;
+    json_t *timeout = NULL;
+    uint64_t n;
+
+    if (flux_shell_getopt_unpack (shell,
+                                  "output",
+                                  "{s?{s?o s?o}}",
+                                  "chunk",
+                                    "size", &size,
+                                    "timeout", &timeout) < 0) {
+        shell_log_error ("failed to read output.chunk options");
+        return -1;
+    }
+    if (size) {
+        if (json_is_integer (size) && json_integer_value (size) >= 0)
+            n = json_integer_value (size);
+        else if (!json_is_string (size)
+                 || parse_size (json_string_value (size), &n) < 0)
+            goto badsize;
+        if (n > max_chunk_size)
+            goto badsize;
+        conf->chunk_size = n;
+    }
+    if (timeout) {
+        double t;
+        if (json_is_number (timeout))
+            t = json_number_value (timeout);
+        else if (!json_is_string (timeout)
+                 || fsd_parse_duration (json_string_value (timeout), &t) < 0)
+            goto badtimeout;
+        if (t <= 0.)
+            goto badtimeout;
+        conf->chunk_timeout = t;
+    }
+    return 0;
+badsize:
+    shell_log_error ("invalid output.chunk.size (maximum is 1M)");
+    return -1;
+badtimeout:
+    shell_log_error ("output.chunk.timeout is not a valid positive FSD");
+    return -1;
+}
+
 void output_config_destroy (struct output_config *conf)
 {
     if (conf) {
@@ -175,6 +229,10 @@ struct output_config *output_config_create (flux_shell_t *shell)
     if (output_stream_getopts (shell, "stderr", &conf->err) < 0)
         goto error;
 
+    conf->chunk_timeout = default_chunk_timeout;
+    if (output_chunk_getopts (shell, conf) < 0)
+        goto error;
+
     return conf;
 error:
     output_config_destroy (conf);
@@ -34,6 +34,8 @@ struct output_stream {
 struct output_config {
     struct output_stream out;
     struct output_stream err;
+    size_t chunk_size;      /* coalesce line output up to this size (0=off) */
+    double chunk_timeout;   /* max time output is held in a chunk */
 };
 
 struct output_config *output_config_create (flux_shell_t *shell);
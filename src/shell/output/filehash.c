@@ -24,6 +24,7 @@
 #endif
 
 #include <unistd.h>
+#include <string.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -64,10 +65,20 @@ int file_entry_write (struct file_entry *fp,
                       const char *data,
                       int len)
 {
-    if (len > 0) {
-        if (fp->label && dprintf (fp->fd, "%s: ", label) < 0)
-            return -1;
+    if (len > 0 && !fp->label)
         return write_all (fp->fd, data, len);
+
+    /* Label each line, since data may hold several lines of chunked output.
+     */
+    while (len > 0) {
+        const char *nl = memchr (data, '\n', len);
+        int n = nl ? nl - data + 1 : len;
+
+        if (dprintf (fp->fd, "%s: ", label) < 0
+            || write_all (fp->fd, data, n) < 0)
+            return -1;
+        data += n;
+        len -= n;
     }
     return 0;
 }
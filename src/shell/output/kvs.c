@@ -21,6 +21,15 @@
  *    single vs multiuser instances (see SINGLEUSER_OUTPUT_LIMIT
  *    and MULTIUSER_OUTPUT_LIMIT below) Output is truncated once
  *    the limit is reached and a warning is logged.
+ *  - If output.blob.size is set, data is accumulated into raw content
+ *    store blobs of up to that size and data events carry only a blob
+ *    reference, offset, and length (see ioencode_blobref()).  Each blob
+ *    is also committed as a valref to output-blobs.<n>, so that it is
+ *    reachable from the KVS root and survives dump/restore and garbage
+ *    collection.  Events that follow a blob are held until the blob is
+ *    stored and committed so that the eventlog never references a missing
+ *    blob and order is preserved.  If a blob cannot be stored or
+ *    committed, its data is logged inline instead.
  */
 #if HAVE_CONFIG_H
 #include "config.h"
@@ -34,6 +43,9 @@
 
 #include "src/common/libioencode/ioencode.h"
 #include "src/common/libeventlog/eventlogger.h"
+#include "src/common/libcontent/content.h"
+#include "src/common/libkvs/treeobj.h"
+#include "src/common/libczmqcontainers/czmq_containers.h"
 #include "src/common/libutil/parse_size.h"
 #include "src/common/libutil/errno_safe.h"
 #include "ccan/str/str.h"
@@ -49,6 +61,22 @@
 #define OUTPUT_LIMIT_MAX        1073741824
 /* 104857600 = 100M */
 #define OUTPUT_LIMIT_WARNING    104857600
+#define OUTPUT_BLOB_SIZE_MAX    16777216
+
+/* An eventlog entry waiting on a blob store, or a blob of output data.
+ */
+struct pending_entry {
+    struct kvs_output *kvs;
+    char *name;
+    json_t *context;
+    flux_future_t *f;       /* blob store+commit, NULL while blob is open */
+    char *key;              /* KVS key of blob valref */
+    char *blobref;          /* set once blob is stored */
+    char *buf;              /* blob data */
+    size_t len;
+    size_t size;
+    json_t *records;        /* array of [stream, rank, offset, len, eof] */
+};
 
 struct kvs_output {
     flux_shell_t *shell;
@@ -58,6 +86,14 @@ struct kvs_output {
     size_t stdout_bytes;
     size_t stderr_bytes;
     struct eventlogger *ev;
+    size_t blob_size;
+    double blob_timeout;
+    const char *hash_name;
+    zlist_t *pending;
+    struct pending_entry *blob;     /* open blob (tail of pending list) */
+    flux_watcher_t *blob_timer;
+    int blob_count;
+    bool blob_error_logged;
 };
 
 static void kvs_output_truncation_warning (struct kvs_output *kvs)
@@ -88,8 +124,274 @@ static void kvs_output_truncation_warning (struct kvs_output *kvs)
     }
 }
 
+static int kvs_append (struct kvs_output *kvs,
+                       const char *name,
+                       json_t *context)
+{
+    return eventlogger_append_pack (kvs->ev, 0, "output", name, "O", context);
+}
+
+static void pending_entry_destroy (struct pending_entry *pe)
+{
+    if (pe) {
+        int saved_errno = errno;
+        free (pe->name);
+        json_decref (pe->context);
+        flux_future_destroy (pe->f);
+        free (pe->key);
+        free (pe->blobref);
+        free (pe->buf);
+        json_decref (pe->records);
+        free (pe);
+        errno = saved_errno;
+    }
+}
+
+static struct pending_entry *pending_entry_create (struct kvs_output *kvs,
+                                                   const char *name,
+                                                   json_t *context)
+{
+    struct pending_entry *pe;
+
+    if (!(pe = calloc (1, sizeof (*pe))))
+        return NULL;
+    pe->kvs = kvs;
+    if (name) {
+        if (!(pe->name = strdup (name)))
+            goto error;
+        pe->context = json_incref (context);
+    }
+    else if (!(pe->records = json_array ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    return pe;
+error:
+    pending_entry_destroy (pe);
+    return NULL;
+}
+
+/* Append data events for the contents of a stored blob.  If the blob
+ * could not be stored and committed, append its data inline instead.
+ */
+static int kvs_append_blob (struct kvs_output *kvs, struct pending_entry *pe)
+{
+    const char *blobref = NULL;
+    size_t index;
+    json_t *entry;
+    int rc = 0;
+
+    if (pe->f && flux_future_get (pe->f, NULL) == 0)
+        blobref = pe->blobref;
+    else if (!kvs->blob_error_logged) {
+        shell_log_errno ("error storing output blob, writing data inline");
+        kvs->blob_error_logged = true;
+    }
+    json_array_foreach (pe->records, index, entry) {
+        const char *stream;
+        const char *rank;
+        int offset;
+        int len;
+        int eof;
+        json_t *o;
+
+        if (json_unpack (entry,
+                         "[s s i i b]",
+                         &stream,
+                         &rank,
+                         &offset,
+                         &len,
+                         &eof) < 0) {
+            errno = EPROTO;
+            return -1;
+        }
+        if (blobref)
+            o = ioencode_blobref (stream, rank, blobref, offset, len, eof);
+        else
+            o = ioencode (stream, rank, pe->buf + offset, len, eof);
+        if (!o || kvs_append (kvs, "data", o) < 0)
+            rc = -1;
+        json_decref (o);
+    }
+    return rc;
+}
+
+/* Append pending entries to the eventlog in order, up to the first
+ * blob that is still open or being stored.
+ */
+static void kvs_pending_process (struct kvs_output *kvs)
+{
+    struct pending_entry *pe;
+
+    while ((pe = zlist_first (kvs->pending))) {
+        if (pe->records) {
+            if (pe == kvs->blob
+                || (pe->f && !flux_future_is_ready (pe->f)))
+                break;
+            if (kvs_append_blob (kvs, pe) < 0)
+                shell_log_errno ("error appending output data");
+            flux_shell_remove_completion_ref (kvs->shell, "output.blob");
+        }
+        else if (kvs_append (kvs, pe->name, pe->context) < 0)
+            shell_log_errno ("eventlogger_append");
+        pending_entry_destroy (zlist_pop (kvs->pending));
+    }
+}
+
+static void blob_commit_continuation (flux_future_t *f, void *arg)
+{
+    struct pending_entry *pe = arg;
+    kvs_pending_process (pe->kvs);
+}
+
+/* Once a blob is stored, commit a valref to it so that it is reachable
+ * from the KVS root.
+ */
+static void blob_store_continuation (flux_future_t *f, void *arg)
+{
+    struct pending_entry *pe = arg;
+    flux_t *h = flux_future_get_flux (f);
+    const char *blobref;
+    json_t *valref = NULL;
+    char *s = NULL;
+    flux_kvs_txn_t *txn = NULL;
+    flux_future_t *f2 = NULL;
+
+    if (content_store_get_blobref (f, pe->kvs->hash_name, &blobref) < 0
+        || !(pe->blobref = strdup (blobref))
+        || !(valref = treeobj_create_valref (blobref))
+        || !(s = json_dumps (valref, JSON_COMPACT))
+        || !(txn = flux_kvs_txn_create ())
+        || flux_kvs_txn_put_treeobj (txn, 0, pe->key, s) < 0
+        || !(f2 = flux_kvs_commit (h, NULL, 0, txn)))
+        goto error;
+    flux_future_continue (f, f2);
+    goto done;
+error:
+    flux_future_continue_error (f, errno, NULL);
+done:
+    flux_kvs_txn_destroy (txn);
+    free (s);
+    json_decref (valref);
+    flux_future_destroy (f);
+}
+
+/* Send the open blob to the content store, then commit a valref to it.
+ * If the requests cannot be sent, pe->f remains NULL and the data is
+ * appended inline.
+ */
+static void kvs_blob_seal (struct kvs_output *kvs)
+{
+    struct pending_entry *pe = kvs->blob;
+    flux_future_t *f;
+
+    if (!pe)
+        return;
+    kvs->blob = NULL;
+    flux_watcher_stop (kvs->blob_timer);
+    flux_shell_add_completion_ref (kvs->shell, "output.blob");
+    if (asprintf (&pe->key, "output-blobs.%d", kvs->blob_count++) < 0
+        || !(f = content_store (flux_shell_get_flux (kvs->shell),
+                                pe->buf,
+                                pe->len,
+                                0)))
+        goto done;
+    if (!(pe->f = flux_future_and_then (f, blob_store_continuation, pe))) {
+        flux_future_destroy (f);
+        goto done;
+    }
+    if (flux_future_then (pe->f, -1., blob_commit_continuation, pe) < 0) {
+        flux_future_destroy (pe->f);
+        pe->f = NULL;
+    }
+done:
+    kvs_pending_process (kvs);
+}
+
+static void blob_timer_cb (flux_reactor_t *r,
+                           flux_watcher_t *w,
+                           int revents,
+                           void *arg)
+{
+    kvs_blob_seal (arg);
+}
+
+static int kvs_blob_append (struct kvs_output *kvs, json_t *context)
+{
+    struct pending_entry *pe;
+    const char *stream;
+    const char *rank;
+    char *data = NULL;
+    int len;
+    bool eof;
+    int rc = -1;
+
+    if (iodecode (context, &stream, &rank, &data, &len, &eof) < 0)
+        return -1;
+    if (kvs->blob && kvs->blob->len + len > kvs->blob_size)
+        kvs_blob_seal (kvs);
+    if (!(pe = kvs->blob)) {
+        if (!(pe = pending_entry_create (kvs, NULL, NULL)))
+            goto out;
+        if (zlist_append (kvs->pending, pe) < 0) {
+            pending_entry_destroy (pe);
+            errno = ENOMEM;
+            goto out;
+        }
+        kvs->blob = pe;
+        flux_timer_watcher_reset (kvs->blob_timer, kvs->blob_timeout, 0.);
+        flux_watcher_start (kvs->blob_timer);
+    }
+    if (pe->len + len > pe->size) {
+        size_t size = pe->len + len > kvs->blob_size
+                      ? pe->len + len : kvs->blob_size;
+        char *buf;
+        if (!(buf = realloc (pe->buf, size)))
+            goto out;
+        pe->buf = buf;
+        pe->size = size;
+    }
+    if (json_array_append_new (pe->records,
+                               json_pack ("[s s i i b]",
+                                          stream,
+                                          rank,
+                                          (int)pe->len,
+                                          len,
+                                          eof)) < 0) {
+        errno = ENOMEM;
+        goto out;
+    }
+    memcpy (pe->buf + pe->len, data, len);
+    pe->len += len;
+    if (pe->len >= kvs->blob_size)
+        kvs_blob_seal (kvs);
+    rc = 0;
+out:
+    ERRNO_SAFE_WRAP (free, data);
+    return rc;
+}
+
+/* Seal any open blob and wait for all blob stores to complete.
+ */
+static void kvs_pending_flush (struct kvs_output *kvs)
+{
+    struct pending_entry *pe;
+
+    kvs_blob_seal (kvs);
+    while ((pe = zlist_first (kvs->pending))) {
+        if (pe->f)
+            (void)flux_future_wait_for (pe->f, -1.);
+        kvs_pending_process (kvs);
+        if (zlist_first (kvs->pending) == pe) {
+            shell_log_error ("error flushing pending output");
+            break;
+        }
+    }
+}
+
 void kvs_output_flush (struct kvs_output *kvs)
 {
+    kvs_pending_flush (kvs);
     if (eventlogger_flush (kvs->ev) < 0)
         shell_log_errno ("eventlogger_flush");
 }
@@ -106,8 +408,18 @@ void kvs_output_destroy (struct kvs_output *kvs)
 {
     if (kvs) {
         int saved_errno = errno;
-        if (kvs->ev && eventlogger_flush (kvs->ev) < 0)
-            shell_log_errno ("eventlogger_flush");
+        if (kvs->ev) {
+            kvs_pending_flush (kvs);
+            if (eventlogger_flush (kvs->ev) < 0)
+                shell_log_errno ("eventlogger_flush");
+        }
+        if (kvs->pending) {
+            struct pending_entry *pe;
+            while ((pe = zlist_pop (kvs->pending)))
+                pending_entry_destroy (pe);
+            zlist_destroy (&kvs->pending);
+        }
+        flux_watcher_destroy (kvs->blob_timer);
         eventlogger_destroy (kvs->ev);
         free (kvs);
         errno = saved_errno;
@@ -166,6 +478,48 @@ static int get_output_limit (struct kvs_output *kvs)
     return 0;
 }
 
+static int get_output_blob (struct kvs_output *kvs, double timeout)
+{
+    flux_t *h = flux_shell_get_flux (kvs->shell);
+    json_t *val = NULL;
+    uint64_t size;
+
+    if (flux_shell_getopt_unpack (kvs->shell,
+                                  "output",
+                                  "{s?{s?o}}",
+                                  "blob",
+                                    "size", &val) < 0) {
+        shell_log_error ("Unable to unpack shell output.blob");
+        return -1;
+    }
+    if (!val)
+        return 0;
+    if (json_is_integer (val) && json_integer_value (val) >= 0)
+        size = json_integer_value (val);
+    else if (!json_is_string (val)
+             || parse_size (json_string_value (val), &size) < 0)
+        size = OUTPUT_BLOB_SIZE_MAX + 1;
+    if (size > OUTPUT_BLOB_SIZE_MAX) {
+        shell_log_error ("Invalid output.blob.size (maximum is 16M)");
+        return -1;
+    }
+    if (size == 0)
+        return 0;
+    if (!(kvs->hash_name = flux_attr_get (h, "content.hash"))) {
+        shell_warn ("content.hash unavailable, ignoring output.blob.size");
+        return 0;
+    }
+    if (!(kvs->blob_timer = flux_timer_watcher_create (kvs->shell->r,
+                                                       timeout,
+                                                       0.,
+                                                       blob_timer_cb,
+                                                       kvs)))
+        return shell_log_errno ("flux_timer_watcher_create");
+    kvs->blob_size = size;
+    kvs->blob_timeout = timeout;
+    return 0;
+}
+
 static void output_ref (struct eventlogger *ev, void *arg)
 {
     struct kvs_output *kvs = arg;
@@ -235,8 +589,11 @@ struct kvs_output *kvs_output_create (flux_shell_t *shell)
 
     kvs->shell = shell;
     kvs->ntasks = shell->info->total_ntasks;
+    if (!(kvs->pending = zlist_new ()))
+        goto error;
 
     if (get_output_limit (kvs) < 0
+        || get_output_blob (kvs, batch_timeout) < 0
         || kvs_eventlogger_start (kvs, batch_timeout) < 0
         || write_kvs_header (kvs) < 0)
         goto error;
@@ -322,16 +679,30 @@ int kvs_output_write_entry (struct kvs_output *kvs,
     }
     if (truncate && !eof)
         return 0;
-    return eventlogger_append_pack (kvs->ev, 0, "output", type, "O", context);
+    if (kvs->blob_size > 0 && len > 0 && !truncate)
+        return kvs_blob_append (kvs, context);
+    if (zlist_size (kvs->pending) > 0) {
+        struct pending_entry *pe;
+        if (!(pe = pending_entry_create (kvs, type, context)))
+            return -1;
+        if (zlist_append (kvs->pending, pe) < 0) {
+            pending_entry_destroy (pe);
+            errno = ENOMEM;
+            return -1;
+        }
+        return 0;
+    }
+    return kvs_append (kvs, type, context);
 }
 
 void kvs_output_reconnect (struct kvs_output *kvs)
 {
     /* during a reconnect, response to event logging may not occur,
      * thus output_unref() may not be called. Clear all completion
-     * references to inflight transactions.
+     * references to inflight transactions and blob stores.
      */
     while (flux_shell_remove_completion_ref (kvs->shell, "output.txn") == 0);
+    while (flux_shell_remove_completion_ref (kvs->shell, "output.blob") == 0);
 }
 
 /* vi: ts=4 sw=4 expandtab
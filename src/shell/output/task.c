@@ -19,6 +19,12 @@
  * Functions are provided to obtain the output "file entry" for any
  * task in the case output is to file, and also to write data
  * to the same destination as any local task rank.
+ *
+ * If output.chunk.size is set, line buffered output destined for the
+ * KVS or the leader shell is coalesced per task and stream into chunks
+ * of complete lines, which are written when the chunk fills, when
+ * output.chunk.timeout expires, or before any other data or EOF from
+ * the same task and stream.
  */
 
 #if HAVE_CONFIG_H
@@ -26,6 +32,7 @@
 #endif
 
 #include <stdio.h>
+#include <string.h>
 #include <fcntl.h>
 
 /* Note: necessary for shell_log functions
@@ -47,6 +54,14 @@ typedef int (*task_output_f) (struct task_output *to,
                               int len,
                               bool eof);
 
+struct task_chunk {
+    struct task_output *to;
+    const char *stream;
+    char *buf;
+    size_t len;
+    flux_watcher_t *timer;
+};
+
 struct task_output {
     struct shell_output *out;
     flux_shell_task_t *task;
@@ -56,6 +71,8 @@ struct task_output {
     struct file_entry *stderr_fp;
     task_output_f stdout_f;
     task_output_f stderr_f;
+    struct task_chunk *stdout_chunk;
+    struct task_chunk *stderr_chunk;
 };
 
 struct task_output_list {
@@ -63,12 +80,25 @@ struct task_output_list {
     zlistx_t *task_outputs;
 };
 
+static void task_chunk_destroy (struct task_chunk *chunk)
+{
+    if (chunk) {
+        int saved_errno = errno;
+        flux_watcher_destroy (chunk->timer);
+        free (chunk->buf);
+        free (chunk);
+        errno = saved_errno;
+    }
+}
+
 void task_output_destroy (struct task_output *to)
 {
     if (to) {
         int saved_errno = errno;
         file_entry_close (to->stdout_fp);
         file_entry_close (to->stderr_fp);
+        task_chunk_destroy (to->stdout_chunk);
+        task_chunk_destroy (to->stderr_chunk);
         free (to);
         errno = saved_errno;
     }
@@ -238,6 +268,86 @@ static task_output_f task_write_fn (struct task_output *to,
     return to->stderr_f;
 }
 
+static struct task_chunk *task_chunk_get (struct task_output *to,
+                                          const char *stream)
+{
+    if (streq (stream, "stdout"))
+        return to->stdout_chunk;
+    return to->stderr_chunk;
+}
+
+static void task_chunk_write (struct task_chunk *chunk,
+                              const char *data,
+                              int len)
+{
+    struct task_output *to = chunk->to;
+    task_output_f fn = task_write_fn (to, chunk->stream);
+
+    if ((*fn) (to, chunk->stream, data, len, false) < 0)
+        shell_log_errno ("write %s task %d", chunk->stream, to->rank);
+}
+
+static void task_chunk_flush (struct task_chunk *chunk)
+{
+    if (chunk && chunk->len > 0) {
+        task_chunk_write (chunk, chunk->buf, chunk->len);
+        chunk->len = 0;
+        flux_watcher_stop (chunk->timer);
+    }
+}
+
+static void task_chunk_timer_cb (flux_reactor_t *r,
+                                 flux_watcher_t *w,
+                                 int revents,
+                                 void *arg)
+{
+    task_chunk_flush (arg);
+}
+
+/* Append one line of output to 'chunk'.  Output is written immediately
+ * if the line alone would fill the chunk.
+ */
+static void task_chunk_append (struct task_chunk *chunk,
+                               const char *data,
+                               int len)
+{
+    struct output_config *conf = chunk->to->out->conf;
+
+    if (chunk->len + len > conf->chunk_size)
+        task_chunk_flush (chunk);
+    if (len >= conf->chunk_size) {
+        task_chunk_write (chunk, data, len);
+        return;
+    }
+    memcpy (chunk->buf + chunk->len, data, len);
+    if (chunk->len == 0) {
+        flux_timer_watcher_reset (chunk->timer, conf->chunk_timeout, 0.);
+        flux_watcher_start (chunk->timer);
+    }
+    chunk->len += len;
+}
+
+static struct task_chunk *task_chunk_create (struct task_output *to,
+                                             const char *stream)
+{
+    struct task_chunk *chunk;
+    struct output_config *conf = to->out->conf;
+
+    if (!(chunk = calloc (1, sizeof (*chunk)))
+        || !(chunk->buf = malloc (conf->chunk_size))
+        || !(chunk->timer = flux_timer_watcher_create (to->out->shell->r,
+                                                       conf->chunk_timeout,
+                                                       0.,
+                                                       task_chunk_timer_cb,
+                                                       chunk))) {
+        task_chunk_destroy (chunk);
+        return NULL;
+    }
+    chunk->to = to;
+    chunk->stream = stream;
+    return chunk;
+}
+
 static void task_write (struct task_output *to,
                         const char *stream,
                         const char *data,
@@ -246,6 +356,10 @@ static void task_write (struct task_output *to,
     task_output_f fn = task_write_fn (to, stream);
     flux_subprocess_t *proc = flux_shell_task_subprocess (to->task);
 
+    /* Preserve ordering with any output held in a chunk.
+     */
+    task_chunk_flush (task_chunk_get (to, stream));
+
     if (len > 0) {
         if ((*fn) (to, stream, data, len, false) < 0)
             shell_log_errno ("write %s task %d", stream, to->rank);
@@ -287,6 +401,7 @@ static void task_line_output_cb (struct shell_task *task,
 {
     struct task_output *to = arg;
     flux_subprocess_t *proc = flux_shell_task_subprocess (to->task);
+    struct task_chunk *chunk;
     const char *data;
     int len;
 
@@ -295,6 +410,10 @@ static void task_line_output_cb (struct shell_task *task,
         shell_log_errno ("read %s task %d", stream, to->rank);
         return;
     }
+    if (len > 0 && (chunk = task_chunk_get (to, stream))) {
+        task_chunk_append (chunk, data, len);
+        return;
+    }
     task_write (to, stream, data, len);
 }
 
@@ -319,6 +438,19 @@ static int task_output_setup_stream (struct task_output *to,
         }
         output_cb = task_none_output_cb;
     }
+    else if (to->out->conf->chunk_size > 0
+             && task_write_fn (to, name) != task_output_write_file) {
+        struct task_chunk *chunk;
+
+        if (!(chunk = task_chunk_create (to, name))) {
+            shell_log_errno ("failed to create %s output chunk", name);
+            return -1;
+        }
+        if (streq (name, "stdout"))
+            to->stdout_chunk = chunk;
+        else
+            to->stderr_chunk = chunk;
+    }
 
     /* Subscribe to this task channel with appropriate buffering:
      */
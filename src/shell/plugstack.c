@@ -176,6 +176,21 @@ int plugstack_call (struct plugstack *st,
     return rc;
 }
 
+bool plugstack_has_handler (struct plugstack *st, const char *name)
+{
+    flux_plugin_t *p;
+
+    if (!st || !name)
+        return false;
+    p = zlistx_first (st->plugins);
+    while (p) {
+        if (flux_plugin_match_handler (p, name))
+            return true;
+        p = zlistx_next (st->plugins);
+    }
+    return false;
+}
+
 static int plugin_aux_from_zhashx (flux_plugin_t *p, zhashx_t *aux)
 {
     const char *key;
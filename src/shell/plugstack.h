@@ -11,6 +11,7 @@
 #ifndef _SHELL_PLUGSTACK_H
 #define _SHELL_PLUGSTACK_H
 
+#include <stdbool.h>
 #include <flux/core.h>
 
 struct plugstack * plugstack_create (void);
@@ -61,6 +62,10 @@ int plugstack_call (struct plugstack *st,
                     const char *name,
                     flux_plugin_arg_t *args);
 
+/*  Return true if any plugin in the stack has a handler matching 'name'.
+ */
+bool plugstack_has_handler (struct plugstack *st, const char *name);
+
 #endif /* !_SHELL_PLUGSTACK_H */
 
 /* vi: ts=4 sw=4 expandtab
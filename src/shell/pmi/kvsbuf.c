@@ -0,0 +1,178 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* kvsbuf.c - compact PMI key-value encoding
+ *
+ * PMI values are strings without embedded NULs, so pairs can be encoded
+ * as NUL-terminated strings back to back.  This lets shells merge the
+ * contributions of their children with memcpy() instead of parsing and
+ * re-encoding JSON at each level of the exchange tree.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <jansson.h>
+
+#include "kvsbuf.h"
+
+#define KVSBUF_MINSIZE 4096
+
+void kvsbuf_init (struct kvsbuf *kb)
+{
+    kb->data = NULL;
+    kb->len = 0;
+    kb->size = 0;
+}
+
+void kvsbuf_clear (struct kvsbuf *kb)
+{
+    if (kb) {
+        int saved_errno = errno;
+        free (kb->data);
+        kvsbuf_init (kb);
+        errno = saved_errno;
+    }
+}
+
+static int kvsbuf_reserve (struct kvsbuf *kb, size_t len)
+{
+    if (kb->len + len > kb->size) {
+        size_t size = kb->size ? kb->size : KVSBUF_MINSIZE;
+        char *data;
+
+        while (size < kb->len + len)
+            size *= 2;
+        if (!(data = realloc (kb->data, size)))
+            return -1;
+        kb->data = data;
+        kb->size = size;
+    }
+    return 0;
+}
+
+int kvsbuf_append (struct kvsbuf *kb, const void *data, size_t len)
+{
+    if (!kb || (len > 0 && !data)) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (len == 0)
+        return 0;
+    if (kvsbuf_reserve (kb, len) < 0)
+        return -1;
+    memcpy (kb->data + kb->len, data, len);
+    kb->len += len;
+    return 0;
+}
+
+int kvsbuf_put (struct kvsbuf *kb, const char *key, const char *val)
+{
+    size_t keylen;
+    size_t vallen;
+
+    if (!kb || !key || !val) {
+        errno = EINVAL;
+        return -1;
+    }
+    keylen = strlen (key) + 1;
+    vallen = strlen (val) + 1;
+    if (kvsbuf_reserve (kb, keylen + vallen) < 0)
+        return -1;
+    memcpy (kb->data + kb->len, key, keylen);
+    memcpy (kb->data + kb->len + keylen, val, vallen);
+    kb->len += keylen + vallen;
+    return 0;
+}
+
+int kvsbuf_append_dict (struct kvsbuf *kb, json_t *dict)
+{
+    const char *key;
+    json_t *o;
+
+    if (!kb || !json_is_object (dict)) {
+        errno = EINVAL;
+        return -1;
+    }
+    json_object_foreach (dict, key, o) {
+        const char *val;
+
+        if (!(val = json_string_value (o))) {
+            errno = EINVAL;
+            return -1;
+        }
+        if (kvsbuf_put (kb, key, val) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+int kvsbuf_next (const void *data,
+                 size_t len,
+                 size_t *cursor,
+                 const char **keyp,
+                 const char **valp)
+{
+    const char *buf = data;
+    const char *key;
+    const char *val;
+    const char *end;
+
+    if (!cursor || (len > 0 && !data)) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (*cursor >= len)
+        return 0;
+    key = buf + *cursor;
+    if (!(end = memchr (key, '\0', len - *cursor)))
+        goto eproto;
+    val = end + 1;
+    if (val >= buf + len || !(end = memchr (val, '\0', buf + len - val)))
+        goto eproto;
+    *cursor = end + 1 - buf;
+    if (keyp)
+        *keyp = key;
+    if (valp)
+        *valp = val;
+    return 1;
+eproto:
+    errno = EPROTO;
+    return -1;
+}
+
+int kvsbuf_update_dict (json_t *dict, const void *data, size_t len)
+{
+    size_t cursor = 0;
+    const char *key;
+    const char *val;
+    int rc;
+
+    if (!json_is_object (dict)) {
+        errno = EINVAL;
+        return -1;
+    }
+    while ((rc = kvsbuf_next (data, len, &cursor, &key, &val)) == 1) {
+        json_t *o;
+
+        if (!(o = json_string (val))
+            || json_object_set_new (dict, key, o) < 0) {
+            errno = ENOMEM;
+            return -1;
+        }
+    }
+    return rc;
+}
+
+/* vi: ts=4 sw=4 expandtab
+ */
@@ -0,0 +1,55 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef SHELL_PMI_KVSBUF_H
+#define SHELL_PMI_KVSBUF_H
+
+#include <stddef.h>
+#include <jansson.h>
+
+/* Compact encoding of PMI key-value pairs for shell to shell messages.
+ * Each pair is stored as a NUL-terminated key followed by a NUL-terminated
+ * value.  Buffers may be concatenated without decoding.  When decoded,
+ * a later pair replaces an earlier pair with the same key.
+ */
+struct kvsbuf {
+    char *data;
+    size_t len;
+    size_t size;
+};
+
+void kvsbuf_init (struct kvsbuf *kb);
+void kvsbuf_clear (struct kvsbuf *kb);
+
+/* Append one pair, an encoded buffer, or all string values in 'dict'.
+ */
+int kvsbuf_put (struct kvsbuf *kb, const char *key, const char *val);
+int kvsbuf_append (struct kvsbuf *kb, const void *data, size_t len);
+int kvsbuf_append_dict (struct kvsbuf *kb, json_t *dict);
+
+/* Iterate over the pairs in encoded buffer 'data'.  Set '*cursor' to
+ * zero before the first call.  Returns 1 with 'key' and 'val' set to
+ * the next pair, 0 when there are no more pairs, or -1 with errno set
+ * to EPROTO if the buffer is malformed.
+ */
+int kvsbuf_next (const void *data,
+                 size_t len,
+                 size_t *cursor,
+                 const char **key,
+                 const char **val);
+
+/* Decode encoded buffer 'data' into 'dict'.
+ */
+int kvsbuf_update_dict (json_t *dict, const void *data, size_t len);
+
+#endif /* !SHELL_PMI_KVSBUF_H */
+
+/* vi: ts=4 sw=4 expandtab
+ */
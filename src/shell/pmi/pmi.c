@@ -76,14 +76,16 @@
 #include "internal.h"
 #include "task.h"
 #include "pmi_exchange.h"
+#include "pmi_direct.h"
 
 struct shell_pmi {
     flux_shell_t *shell;
     struct pmi_simple_server *server;
-    json_t *global; // already exchanged
+    json_t *global; // already exchanged (kvs=direct: fetched or own)
     json_t *pending;// pending to be exchanged
     json_t *locals;  // never exchanged
     struct pmi_exchange *exchange;
+    struct pmi_direct *direct;
 };
 
 /* pmi_simple_ops->warn() signature */
@@ -149,6 +151,17 @@ done:
     pmi_simple_server_barrier_complete (pmi->server, rc);
 }
 
+static const char *lookup_dict (struct shell_pmi *pmi, const char *key)
+{
+    json_t *o;
+
+    if ((o = json_object_get (pmi->locals, key))
+        || (o = json_object_get (pmi->pending, key))
+        || (o = json_object_get (pmi->global, key)))
+        return json_string_value (o);
+    return NULL;
+}
+
 /* pmi_simple_ops->kvs_get() signature */
 static int exchange_kvs_get (void *arg,
                              void *cli,
@@ -156,13 +169,9 @@ static int exchange_kvs_get (void *arg,
                              const char *key)
 {
     struct shell_pmi *pmi = arg;
-    json_t *o;
-    const char *val = NULL;
+    const char *val;
 
-    if ((o = json_object_get (pmi->locals, key))
-        || (o = json_object_get (pmi->pending, key))
-        || (o = json_object_get (pmi->global, key))) {
-        val = json_string_value (o);
+    if ((val = lookup_dict (pmi, key))) {
         pmi_simple_server_kvs_get_complete (pmi->server, cli, val);
         return 0;
     }
@@ -203,6 +212,120 @@ static int exchange_kvs_put (void *arg,
     return put_dict (pmi->pending, key, val);
 }
 
+/**
+ ** ops for storing each key on a home shell and fetching keys on demand
+ ** This is used if pmi.kvs=direct option is provided.
+ **/
+
+struct direct_get {
+    struct shell_pmi *pmi;
+    void *cli;
+    char key[];
+};
+
+static void direct_barrier_cb (struct pmi_exchange *pex, void *arg)
+{
+    struct shell_pmi *pmi = arg;
+    int rc = -1;
+
+    if (pmi_exchange_has_error (pex)) {
+        shell_warn ("barrier failed");
+        goto done;
+    }
+    /* Values fetched in the last epoch may have been replaced, so drop
+     * them and keep only this shell's own values.
+     */
+    json_object_clear (pmi->global);
+    if (json_object_update (pmi->global, pmi->pending) < 0) {
+        shell_warn ("failed to update dict after successful barrier");
+        goto done;
+    }
+    json_object_clear (pmi->pending);
+    rc = 0;
+done:
+    pmi_simple_server_barrier_complete (pmi->server, rc);
+}
+
+static void direct_put_cb (struct pmi_direct *pd, int rc, void *arg)
+{
+    struct shell_pmi *pmi = arg;
+    json_t *empty;
+
+    if (rc < 0) {
+        shell_warn ("failed to store keys on their home shells");
+        goto error;
+    }
+    if (!(empty = json_object ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    rc = pmi_exchange (pmi->exchange, empty, direct_barrier_cb, pmi);
+    json_decref (empty);
+    if (rc < 0) {
+        shell_warn ("pmi_exchange %s", flux_strerror (errno));
+        goto error;
+    }
+    return;
+error:
+    pmi_simple_server_barrier_complete (pmi->server, -1);
+}
+
+/* pmi_simple_ops->barrier_enter() signature */
+static int direct_barrier_enter (void *arg)
+{
+    struct shell_pmi *pmi = arg;
+
+    if (pmi->shell->info->shell_size == 1) {
+        pmi_simple_server_barrier_complete (pmi->server, 0);
+        return 0;
+    }
+    if (pmi_direct_put (pmi->direct, pmi->pending, direct_put_cb, pmi) < 0) {
+        shell_warn ("pmi_direct_put %s", flux_strerror (errno));
+        return -1; // PMI_FAIL
+    }
+    return 0;
+}
+
+static void direct_get_cb (struct pmi_direct *pd, const char *val, void *arg)
+{
+    struct direct_get *get = arg;
+    struct shell_pmi *pmi = get->pmi;
+
+    if (val && put_dict (pmi->global, get->key, val) < 0)
+        shell_warn ("failed to cache %s", get->key);
+    pmi_simple_server_kvs_get_complete (pmi->server, get->cli, val);
+    free (get);
+}
+
+/* pmi_simple_ops->kvs_get() signature */
+static int direct_kvs_get (void *arg,
+                           void *cli,
+                           const char *kvsname,
+                           const char *key)
+{
+    struct shell_pmi *pmi = arg;
+    struct direct_get *get;
+    const char *val;
+
+    if ((val = lookup_dict (pmi, key))) {
+        pmi_simple_server_kvs_get_complete (pmi->server, cli, val);
+        return 0;
+    }
+    if (pmi->shell->info->shell_size == 1)
+        return -1; // PMI_ERR_INVALID_KEY
+    if (!(get = calloc (1, sizeof (*get) + strlen (key) + 1)))
+        return -1;
+    get->pmi = pmi;
+    get->cli = cli;
+    strcpy (get->key, key);
+    if (pmi_direct_get (pmi->direct, key, direct_get_cb, get) < 0) {
+        shell_warn ("pmi_direct_get %s", flux_strerror (errno));
+        free (get);
+        return -1;
+    }
+    return 0;
+}
+
 /**
  ** end of KVS implementations
  **/
@@ -349,6 +472,7 @@ static void pmi_destroy (struct shell_pmi *pmi)
         int saved_errno = errno;
         pmi_simple_server_destroy (pmi->server);
         pmi_exchange_destroy (pmi->exchange);
+        pmi_direct_destroy (pmi->direct);
         json_decref (pmi->global);
         json_decref (pmi->pending);
         json_decref (pmi->locals);
@@ -410,6 +534,14 @@ static struct shell_pmi *pmi_create (flux_shell_t *shell, json_t *config)
         if (!(pmi->exchange = pmi_exchange_create (shell, exchange_k)))
             goto error;
     }
+    else if (streq (kvs, "direct")) {
+        shell_pmi_ops.kvs_put = exchange_kvs_put;
+        shell_pmi_ops.kvs_get = direct_kvs_get;
+        shell_pmi_ops.barrier_enter = direct_barrier_enter;
+        if (!(pmi->exchange = pmi_exchange_create (shell, exchange_k))
+            || !(pmi->direct = pmi_direct_create (shell)))
+            goto error;
+    }
     else {
         shell_log_error ("Unknown kvs implementation %s", kvs);
         errno = EINVAL;
@@ -0,0 +1,348 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* pmi_direct.c - PMI KVS distributed across shells
+ *
+ * Each key has a home shell chosen by hashing the key.  At fence, each
+ * shell sends its new key-value pairs to their home shells, with one
+ * kvsbuf-encoded request per home shell.  Once the fence barrier
+ * completes, a shell fetches any key its tasks read but it does not
+ * have from the key's home shell.
+ *
+ * Thus each shell stores about 1/N of the keys and receives only the
+ * values its tasks actually read, rather than the entire dictionary.
+ * The barrier itself is left to the caller.
+ */
+#define FLUX_SHELL_PLUGIN_NAME "pmi-simple"
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include <jansson.h>
+#include <flux/core.h>
+#include <flux/shell.h>
+
+#include "src/common/libczmqcontainers/czmq_containers.h"
+
+#include "info.h"
+#include "internal.h"
+#include "svc.h"
+
+#include "kvsbuf.h"
+#include "pmi_direct.h"
+
+struct pmi_direct {
+    flux_shell_t *shell;
+    int size;
+    int rank;
+    zhashx_t *store;            // keys homed on this shell: key => value
+    zlist_t *requests;          // outstanding put and get requests
+
+    pmi_direct_put_f put_cb;
+    void *put_arg;
+    int put_count;              // number of put requests outstanding
+    int put_errors;
+};
+
+struct get_request {
+    struct pmi_direct *pd;
+    pmi_direct_get_f cb;
+    void *arg;
+};
+
+static void valfree (void **item)
+{
+    if (item) {
+        free (*item);
+        *item = NULL;
+    }
+}
+
+/* 32-bit FNV-1a
+ */
+static int home_rank (struct pmi_direct *pd, const char *key)
+{
+    uint32_t hash = 2166136261u;
+
+    while (*key) {
+        hash ^= (unsigned char)*key++;
+        hash *= 16777619u;
+    }
+    return hash % pd->size;
+}
+
+static int store_update (struct pmi_direct *pd, const void *data, size_t len)
+{
+    size_t cursor = 0;
+    const char *key;
+    const char *val;
+    int rc;
+
+    while ((rc = kvsbuf_next (data, len, &cursor, &key, &val)) == 1)
+        zhashx_update (pd->store, key, (char *)val);
+    return rc;
+}
+
+static void request_remove (struct pmi_direct *pd, flux_future_t *f)
+{
+    zlist_remove (pd->requests, f);
+    flux_future_destroy (f);
+}
+
+static int request_add (struct pmi_direct *pd, flux_future_t *f)
+{
+    if (zlist_append (pd->requests, f) < 0) {
+        errno = ENOMEM;
+        return -1;
+    }
+    return 0;
+}
+
+static void put_complete (struct pmi_direct *pd)
+{
+    if (pd->put_count == 0 && pd->put_cb) {
+        pmi_direct_put_f cb = pd->put_cb;
+
+        pd->put_cb = NULL;
+        cb (pd, pd->put_errors > 0 ? -1 : 0, pd->put_arg);
+    }
+}
+
+static void put_continuation (flux_future_t *f, void *arg)
+{
+    struct pmi_direct *pd = arg;
+
+    if (flux_rpc_get (f, NULL) < 0) {
+        shell_warn ("pmi-direct-put: %s", future_strerror (f, errno));
+        pd->put_errors++;
+    }
+    request_remove (pd, f);
+    pd->put_count--;
+    put_complete (pd);
+}
+
+int pmi_direct_put (struct pmi_direct *pd,
+                    json_t *dict,
+                    pmi_direct_put_f cb,
+                    void *arg)
+{
+    struct kvsbuf *bufs;
+    const char *key;
+    json_t *o;
+    int rc = -1;
+
+    if (pd->put_cb) {
+        errno = EINPROGRESS;
+        return -1;
+    }
+    if (!(bufs = calloc (pd->size, sizeof (bufs[0]))))
+        return -1;
+    json_object_foreach (dict, key, o) {
+        const char *val = json_string_value (o);
+
+        if (!val) {
+            errno = EINVAL;
+            goto out;
+        }
+        if (kvsbuf_put (&bufs[home_rank (pd, key)], key, val) < 0)
+            goto out;
+    }
+    pd->put_cb = cb;
+    pd->put_arg = arg;
+    pd->put_errors = 0;
+    pd->put_count = 1; // hold completion until all requests are sent
+    for (int i = 0; i < pd->size; i++) {
+        flux_future_t *f;
+
+        if (bufs[i].len == 0)
+            continue;
+        if (i == pd->rank) {
+            if (store_update (pd, bufs[i].data, bufs[i].len) < 0)
+                pd->put_errors++;
+            continue;
+        }
+        if (!(f = shell_svc_raw (pd->shell->svc,
+                                 "pmi-direct-put",
+                                 i,
+                                 0,
+                                 bufs[i].data,
+                                 bufs[i].len))
+            || flux_future_then (f, -1, put_continuation, pd) < 0
+            || request_add (pd, f) < 0) {
+            flux_future_destroy (f);
+            shell_warn ("error sending pmi-direct-put request");
+            pd->put_errors++;
+            continue;
+        }
+        pd->put_count++;
+    }
+    pd->put_count--;
+    put_complete (pd);
+    rc = 0;
+out:
+    for (int i = 0; i < pd->size; i++)
+        kvsbuf_clear (&bufs[i]);
+    free (bufs);
+    return rc;
+}
+
+static void get_continuation (flux_future_t *f, void *arg)
+{
+    struct get_request *req = arg;
+    const char *val = NULL;
+    size_t len;
+
+    if (flux_rpc_get_raw (f, (const void **)&val, &len) < 0) {
+        if (errno != ENOENT)
+            shell_warn ("pmi-direct-get: %s", future_strerror (f, errno));
+        val = NULL;
+    }
+    else if (len == 0 || val[len - 1] != '\0')
+        val = NULL;
+    req->cb (req->pd, val, req->arg);
+    request_remove (req->pd, f);
+}
+
+int pmi_direct_get (struct pmi_direct *pd,
+                    const char *key,
+                    pmi_direct_get_f cb,
+                    void *arg)
+{
+    int home = home_rank (pd, key);
+    struct get_request *req;
+    flux_future_t *f;
+
+    if (home == pd->rank) {
+        cb (pd, zhashx_lookup (pd->store, key), arg);
+        return 0;
+    }
+    if (!(f = shell_svc_raw (pd->shell->svc,
+                             "pmi-direct-get",
+                             home,
+                             0,
+                             key,
+                             strlen (key) + 1)))
+        return -1;
+    if (!(req = calloc (1, sizeof (*req)))
+        || flux_future_aux_set (f, NULL, req, free) < 0) {
+        free (req);
+        goto error;
+    }
+    req->pd = pd;
+    req->cb = cb;
+    req->arg = arg;
+    if (flux_future_then (f, -1, get_continuation, req) < 0
+        || request_add (pd, f) < 0)
+        goto error;
+    return 0;
+error:
+    flux_future_destroy (f);
+    return -1;
+}
+
+static void put_request_cb (flux_t *h,
+                            flux_msg_handler_t *mh,
+                            const flux_msg_t *msg,
+                            void *arg)
+{
+    struct pmi_direct *pd = arg;
+    const void *data;
+    size_t len;
+
+    if (flux_request_decode_raw (msg, NULL, &data, &len) < 0
+        || store_update (pd, data, len) < 0)
+        goto error;
+    if (flux_respond (h, msg, NULL) < 0)
+        shell_warn ("error responding to pmi-direct-put request");
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        shell_warn ("error responding to pmi-direct-put request");
+}
+
+static void get_request_cb (flux_t *h,
+                            flux_msg_handler_t *mh,
+                            const flux_msg_t *msg,
+                            void *arg)
+{
+    struct pmi_direct *pd = arg;
+    const char *key;
+    size_t len;
+    const char *val;
+
+    if (flux_request_decode_raw (msg, NULL, (const void **)&key, &len) < 0)
+        goto error;
+    if (len == 0 || key[len - 1] != '\0') {
+        errno = EPROTO;
+        goto error;
+    }
+    if (!(val = zhashx_lookup (pd->store, key))) {
+        errno = ENOENT;
+        goto error;
+    }
+    if (flux_respond_raw (h, msg, val, strlen (val) + 1) < 0)
+        shell_warn ("error responding to pmi-direct-get request");
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        shell_warn ("error responding to pmi-direct-get request");
+}
+
+void pmi_direct_destroy (struct pmi_direct *pd)
+{
+    if (pd) {
+        int saved_errno = errno;
+        if (pd->requests) {
+            flux_future_t *f;
+            while ((f = zlist_pop (pd->requests)))
+                flux_future_destroy (f);
+            zlist_destroy (&pd->requests);
+        }
+        zhashx_destroy (&pd->store);
+        free (pd);
+        errno = saved_errno;
+    }
+}
+
+struct pmi_direct *pmi_direct_create (flux_shell_t *shell)
+{
+    struct pmi_direct *pd;
+
+    if (!(pd = calloc (1, sizeof (*pd))))
+        return NULL;
+    pd->shell = shell;
+    pd->size = shell->info->shell_size;
+    pd->rank = shell->info->shell_rank;
+    if (!(pd->store = zhashx_new ())
+        || !(pd->requests = zlist_new ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    zhashx_set_destructor (pd->store, valfree);
+    zhashx_set_duplicator (pd->store, (zhashx_duplicator_fn *)strdup);
+    if (flux_shell_service_register (shell,
+                                     "pmi-direct-put",
+                                     put_request_cb,
+                                     pd) < 0
+        || flux_shell_service_register (shell,
+                                        "pmi-direct-get",
+                                        get_request_cb,
+                                        pd) < 0)
+        goto error;
+    return pd;
+error:
+    pmi_direct_destroy (pd);
+    return NULL;
+}
+
+/* vi: ts=4 sw=4 expandtab
+ */
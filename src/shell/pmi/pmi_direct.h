@@ -0,0 +1,44 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef SHELL_PMI_DIRECT_H
+#define SHELL_PMI_DIRECT_H
+
+struct pmi_direct *pmi_direct_create (flux_shell_t *shell);
+void pmi_direct_destroy (struct pmi_direct *pd);
+
+typedef void (*pmi_direct_put_f)(struct pmi_direct *pd, int rc, void *arg);
+typedef void (*pmi_direct_get_f)(struct pmi_direct *pd,
+                                 const char *val,
+                                 void *arg);
+
+/* Store the key-value pairs in 'dict' on their home shells.
+ * 'cb' is invoked with rc=0 once all pairs are stored, or rc=-1 on error.
+ * 'cb' may be invoked before pmi_direct_put() returns.
+ * Only one put may be in progress at a time.
+ */
+int pmi_direct_put (struct pmi_direct *pd,
+                    json_t *dict,
+                    pmi_direct_put_f cb,
+                    void *arg);
+
+/* Fetch the value of 'key' from its home shell.  'cb' is invoked with
+ * the value, or with val=NULL if the key is not found or an error occurs.
+ * 'cb' may be invoked before pmi_direct_get() returns.
+ */
+int pmi_direct_get (struct pmi_direct *pd,
+                    const char *key,
+                    pmi_direct_get_f cb,
+                    void *arg);
+
+#endif /* !SHELL_PMI_DIRECT_H */
+
+/* vi: ts=4 sw=4 expandtab
+ */
@@ -17,6 +17,11 @@
  * a callback.  Upon completion of the exchange, the callback is invoked.
  * The callback may access an updated json_t dictionary.
  *
+ * Dictionaries are sent in the compact kvsbuf encoding, so each shell
+ * merges its children's contributions by concatenation and relays the
+ * aggregate from its parent to its children without decoding it.  Only
+ * pmi_exchange_get_dict() decodes the result, once per shell.
+ *
  * A binary tree is computed across all shell ranks.
  * Gather aggregates hashes at each tree level, reducing the number
  * of messages that have to be handled by shell 0.
@@ -41,13 +46,18 @@
 
 #include "info.h"
 #include "internal.h"
+#include "svc.h"
 
+#include "kvsbuf.h"
 #include "pmi_exchange.h"
 
 #define DEFAULT_TREE_K 2
 
 struct session {
-    json_t *dict;               // container for gathered dictionary
+    struct kvsbuf kb;           // gathered key-value pairs
+    const void *result;         // exchange result (kb or parent response)
+    size_t result_len;
+    json_t *dict;               // result decoded by pmi_exchange_get_dict()
     pmi_exchange_f cb;          // callback for exchange completion
     void *cb_arg;
 
@@ -82,6 +92,7 @@ static void session_destroy (struct session *ses)
             zlist_destroy (&ses->requests);
         }
         flux_future_destroy (ses->f);
+        kvsbuf_clear (&ses->kb);
         json_decref (ses->dict);
         free (ses);
         errno = saved_errno;
@@ -95,10 +106,9 @@ static struct session *session_create (struct pmi_exchange *pex)
     if (!(ses = calloc (1, sizeof (*ses))))
         return NULL;
     ses->pex = pex;
+    kvsbuf_init (&ses->kb);
     if (!(ses->requests = zlist_new ()))
         goto nomem;
-    if (!(ses->dict = json_object ()))
-        goto nomem;
     return ses;
 nomem:
     errno = ENOMEM;
@@ -125,12 +135,12 @@ static void session_process (struct session *ses)
     if (pex->rank > 0 && !ses->f) {
         flux_future_t *f;
 
-        if (!(f = flux_shell_rpc_pack (pex->shell,
-                                       "pmi-exchange",
-                                       pex->parent_rank,
-                                       0,
-                                       "O",
-                                       ses->dict))
+        if (!(f = shell_svc_raw (pex->shell->svc,
+                                 "pmi-exchange",
+                                 pex->parent_rank,
+                                 0,
+                                 ses->kb.data,
+                                 ses->kb.len))
                 || flux_future_then (f,
                                      -1,
                                      exchange_response_completion,
@@ -147,11 +157,15 @@ static void session_process (struct session *ses)
      */
     if (ses->f && !flux_future_is_ready (ses->f))
         return;
+    if (!ses->f) {
+        ses->result = ses->kb.data;
+        ses->result_len = ses->kb.len;
+    }
 
     /* Send exchange response(s), if needed.
      */
     while ((msg = zlist_pop (ses->requests))) {
-        if (flux_respond_pack (h, msg, "O", ses->dict) < 0) {
+        if (flux_respond_raw (h, msg, ses->result, ses->result_len) < 0) {
             shell_warn ("error responding to pmi-exchange request");
             flux_msg_decref (msg);
             ses->has_error = 1;
@@ -170,19 +184,16 @@ done:
 static void exchange_response_completion (flux_future_t *f, void *arg)
 {
     struct pmi_exchange *pex = arg;
-    json_t *dict;
 
-    if (flux_rpc_get_unpack (f, "o", &dict) < 0) {
+    /* The response holds the complete result, including this shell's
+     * contribution.  It remains valid until the session is destroyed.
+     */
+    if (flux_rpc_get_raw (f,
+                          &pex->session->result,
+                          &pex->session->result_len) < 0) {
         shell_warn ("pmi-exchange request: %s", future_strerror (f, errno));
         pex->session->has_error = 1;
-        goto done;
-    }
-    if (json_object_update (pex->session->dict, dict) < 0) {
-        shell_warn ("pmi-exchange response handling failed to update dict");
-        pex->session->has_error = 1;
-        goto done;
     }
-done:
     session_process (pex->session);
 }
 
@@ -194,10 +205,11 @@ static void exchange_request_cb (flux_t *h,
                                  void *arg)
 {
     struct pmi_exchange *pex = arg;
-    json_t *dict;
+    const void *data;
+    size_t len;
     const char *errstr = NULL;
 
-    if (flux_request_unpack (msg, NULL, "o", &dict) < 0)
+    if (flux_request_decode_raw (msg, NULL, &data, &len) < 0)
         goto error;
     if (!pex->session) {
         if (!(pex->session = session_create (pex)))
@@ -208,7 +220,7 @@ static void exchange_request_cb (flux_t *h,
         errno = EINPROGRESS;
         goto error;
     }
-    if (json_object_update (pex->session->dict, dict) < 0) {
+    if (kvsbuf_append (&pex->session->kb, data, len) < 0) {
         errstr = "pmi-exchange request failed to update dict";
         goto nomem;
     }
@@ -246,10 +258,8 @@ int pmi_exchange (struct pmi_exchange *pex,
     pex->session->cb = cb;
     pex->session->cb_arg = arg;
     pex->session->local = 1;
-    if (json_object_update (pex->session->dict, dict) < 0) {
-        errno = ENOMEM;
+    if (kvsbuf_append_dict (&pex->session->kb, dict) < 0)
         return -1;
-    }
     session_process (pex->session);
     return 0;
 }
@@ -320,7 +330,19 @@ bool pmi_exchange_has_error (struct pmi_exchange *pex)
 
 json_t *pmi_exchange_get_dict (struct pmi_exchange *pex)
 {
-    return pex->session->dict;
+    struct session *ses = pex->session;
+
+    if (!ses->dict) {
+        if (!(ses->dict = json_object ())
+            || kvsbuf_update_dict (ses->dict,
+                                   ses->result,
+                                   ses->result_len) < 0) {
+            json_decref (ses->dict);
+            ses->dict = NULL;
+            return NULL;
+        }
+    }
+    return ses->dict;
 }
 
 /* vi: ts=4 sw=4 expandtab
@@ -30,7 +30,7 @@ int pmi_exchange (struct pmi_exchange *pex,
 
 /* Accessors may be called only from pmi_exchange_f callback.
  * pmi_exchange_get_dict() returns a json object that is invalidated when
- * the callback returns.
+ * the callback returns, or NULL on error.
  */
 bool pmi_exchange_has_error (struct pmi_exchange *pex);
 json_t *pmi_exchange_get_dict (struct pmi_exchange *pex);
@@ -0,0 +1,231 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <jansson.h>
+
+#include "src/common/libtap/tap.h"
+#include "src/common/libutil/monotime.h"
+#include "ccan/str/str.h"
+
+#include "pmi/kvsbuf.h"
+
+static void test_basic (void)
+{
+    struct kvsbuf kb;
+    size_t cursor = 0;
+    const char *key;
+    const char *val;
+
+    kvsbuf_init (&kb);
+    ok (kb.data == NULL && kb.len == 0,
+        "kvsbuf_init works");
+    ok (kvsbuf_next (kb.data, kb.len, &cursor, &key, &val) == 0,
+        "kvsbuf_next on empty buffer returns 0");
+    ok (kvsbuf_put (&kb, "a", "1") == 0
+        && kvsbuf_put (&kb, "b", "") == 0,
+        "kvsbuf_put works");
+    ok (kb.len == 7,
+        "buffer has expected length");
+    ok (kvsbuf_next (kb.data, kb.len, &cursor, &key, &val) == 1
+        && streq (key, "a")
+        && streq (val, "1"),
+        "kvsbuf_next returns first pair");
+    ok (kvsbuf_next (kb.data, kb.len, &cursor, &key, &val) == 1
+        && streq (key, "b")
+        && streq (val, ""),
+        "kvsbuf_next returns second pair with empty value");
+    ok (kvsbuf_next (kb.data, kb.len, &cursor, &key, &val) == 0,
+        "kvsbuf_next returns 0 at end of buffer");
+    kvsbuf_clear (&kb);
+    ok (kb.data == NULL && kb.len == 0 && kb.size == 0,
+        "kvsbuf_clear works");
+}
+
+static void test_merge (void)
+{
+    struct kvsbuf kb1;
+    struct kvsbuf kb2;
+    json_t *dict;
+    json_t *out;
+
+    kvsbuf_init (&kb1);
+    kvsbuf_init (&kb2);
+    if (!(dict = json_pack ("{s:s s:s}", "x", "1", "y", "2"))
+        || !(out = json_object ()))
+        BAIL_OUT ("error creating dicts");
+
+    ok (kvsbuf_append_dict (&kb1, dict) == 0,
+        "kvsbuf_append_dict works");
+    ok (kvsbuf_put (&kb2, "y", "3") == 0
+        && kvsbuf_put (&kb2, "z", "4") == 0,
+        "kvsbuf_put works on second buffer");
+    ok (kvsbuf_append (&kb1, kb2.data, kb2.len) == 0,
+        "kvsbuf_append concatenates buffers");
+    ok (kvsbuf_update_dict (out, kb1.data, kb1.len) == 0,
+        "kvsbuf_update_dict works");
+    ok (json_object_size (out) == 3
+        && streq (json_string_value (json_object_get (out, "x")), "1")
+        && streq (json_string_value (json_object_get (out, "y")), "3")
+        && streq (json_string_value (json_object_get (out, "z")), "4"),
+        "later pairs replace earlier pairs with the same key");
+    ok (kvsbuf_append (&kb1, NULL, 0) == 0,
+        "kvsbuf_append of empty buffer works");
+
+    json_decref (dict);
+    json_decref (out);
+    kvsbuf_clear (&kb1);
+    kvsbuf_clear (&kb2);
+}
+
+static void test_errors (void)
+{
+    struct kvsbuf kb;
+    json_t *dict;
+    size_t cursor;
+    const char *key;
+    const char *val;
+
+    kvsbuf_init (&kb);
+    errno = 0;
+    ok (kvsbuf_put (&kb, "a", NULL) < 0 && errno == EINVAL,
+        "kvsbuf_put val=NULL fails with EINVAL");
+    errno = 0;
+    ok (kvsbuf_put (NULL, "a", "b") < 0 && errno == EINVAL,
+        "kvsbuf_put kb=NULL fails with EINVAL");
+    errno = 0;
+    ok (kvsbuf_append (&kb, NULL, 1) < 0 && errno == EINVAL,
+        "kvsbuf_append data=NULL len=1 fails with EINVAL");
+
+    if (!(dict = json_pack ("{s:i}", "a", 1)))
+        BAIL_OUT ("json_pack failed");
+    errno = 0;
+    ok (kvsbuf_append_dict (&kb, dict) < 0 && errno == EINVAL,
+        "kvsbuf_append_dict fails with EINVAL on non-string value");
+    errno = 0;
+    ok (kvsbuf_update_dict (NULL, "a\0b", 4) < 0 && errno == EINVAL,
+        "kvsbuf_update_dict dict=NULL fails with EINVAL");
+    json_decref (dict);
+
+    cursor = 0;
+    errno = 0;
+    ok (kvsbuf_next ("abc", 3, &cursor, &key, &val) < 0 && errno == EPROTO,
+        "kvsbuf_next fails with EPROTO on unterminated key");
+    cursor = 0;
+    errno = 0;
+    ok (kvsbuf_next ("a\0", 2, &cursor, &key, &val) < 0 && errno == EPROTO,
+        "kvsbuf_next fails with EPROTO on missing value");
+    cursor = 0;
+    errno = 0;
+    ok (kvsbuf_next ("a\0bc", 4, &cursor, &key, &val) < 0 && errno == EPROTO,
+        "kvsbuf_next fails with EPROTO on unterminated value");
+    kvsbuf_clear (&kb);
+}
+
+/* Compare merging and relaying NCHILD contributions of NKEYS business
+ * cards each as JSON, as pmi_exchange used to, against kvsbuf.  Timings
+ * are informational only.
+ */
+#define BENCH_NCHILD    8
+#define BENCH_NKEYS     1000
+
+static void test_bench (void)
+{
+    char key[64];
+    char val[128];
+    char *json[BENCH_NCHILD];
+    struct kvsbuf kb[BENCH_NCHILD];
+    struct kvsbuf merged;
+    struct timespec t0;
+    double t_json, t_kvsbuf;
+    json_t *dict;
+    json_t *out;
+    char *s;
+
+    for (int i = 0; i < BENCH_NCHILD; i++) {
+        json_t *o;
+        if (!(o = json_object ()))
+            BAIL_OUT ("json_object failed");
+        kvsbuf_init (&kb[i]);
+        for (int j = 0; j < BENCH_NKEYS; j++) {
+            snprintf (key, sizeof (key), "P%d-businesscard", i * 1000 + j);
+            snprintf (val, sizeof (val), "port#%d$description#node%d$", j, i);
+            if (json_object_set_new (o, key, json_string (val)) < 0
+                || kvsbuf_put (&kb[i], key, val) < 0)
+                BAIL_OUT ("error building dicts");
+        }
+        if (!(json[i] = json_dumps (o, JSON_COMPACT)))
+            BAIL_OUT ("json_dumps failed");
+        json_decref (o);
+    }
+
+    monotime (&t0);
+    if (!(dict = json_object ()))
+        BAIL_OUT ("json_object failed");
+    for (int i = 0; i < BENCH_NCHILD; i++) {
+        json_t *o;
+        if (!(o = json_loads (json[i], 0, NULL))
+            || json_object_update (dict, o) < 0)
+            BAIL_OUT ("error merging JSON");
+        json_decref (o);
+    }
+    if (!(s = json_dumps (dict, JSON_COMPACT)))
+        BAIL_OUT ("json_dumps failed");
+    t_json = monotime_since (t0);
+    free (s);
+
+    monotime (&t0);
+    kvsbuf_init (&merged);
+    for (int i = 0; i < BENCH_NCHILD; i++) {
+        if (kvsbuf_append (&merged, kb[i].data, kb[i].len) < 0)
+            BAIL_OUT ("kvsbuf_append failed");
+    }
+    t_kvsbuf = monotime_since (t0);
+
+    if (!(out = json_object ()))
+        BAIL_OUT ("json_object failed");
+    ok (kvsbuf_update_dict (out, merged.data, merged.len) == 0
+        && json_equal (out, dict),
+        "merged kvsbuf decodes to the same dict as merged JSON");
+    diag ("merge %d x %d keys: json %.3fms kvsbuf %.3fms",
+          BENCH_NCHILD,
+          BENCH_NKEYS,
+          t_json,
+          t_kvsbuf);
+
+    json_decref (out);
+    json_decref (dict);
+    kvsbuf_clear (&merged);
+    for (int i = 0; i < BENCH_NCHILD; i++) {
+        kvsbuf_clear (&kb[i]);
+        free (json[i]);
+    }
+}
+
+int main (int argc, char *argv[])
+{
+    plan (NO_PLAN);
+
+    test_basic ();
+    test_merge ();
+    test_errors ();
+    test_bench ();
+
+    done_testing ();
+    return 0;
+}
+
+/* vi: ts=4 sw=4 expandtab
+ */
@@ -246,6 +246,11 @@ error:
     return -1;
 }
 
+static int pty_task_exec (flux_plugin_t *p,
+                          const char *topic,
+                          flux_plugin_arg_t *args,
+                          void *arg);
+
 static void server_empty (struct flux_terminus_server *ts, void *arg)
 {
     flux_shell_t *shell = arg;
@@ -307,6 +312,12 @@ static int pty_init (flux_plugin_t *p,
             shell_log_errno ("failed to enable pty server notification");
             return -1;
         }
+        /*  Only register task.exec when a pty is active on this shell,
+         *   since any task.exec handler forces tasks to be started with
+         *   fork(2) instead of posix_spawn(3).
+         */
+        if (flux_plugin_add_handler (p, "task.exec", pty_task_exec, NULL) < 0)
+            return shell_log_errno ("failed to add task.exec handler");
     }
 
     /*  Create a pty session for each local target
@@ -514,7 +525,6 @@ static int pty_task_exit (flux_plugin_t *p,
 struct shell_builtin builtin_pty = {
     .name = FLUX_SHELL_PLUGIN_NAME,
     .init = pty_init,
-    .task_exec = pty_task_exec,
     .task_fork = pty_task_fork,
     .task_exit = pty_task_exit,
 };
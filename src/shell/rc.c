@@ -30,6 +30,7 @@
 #include "ccan/str/str.h"
 #include "internal.h"
 #include "info.h"
+#include "task.h"
 
 /*  Lua plugin helper types:
  */
@@ -407,15 +408,10 @@ static int l_source_if_exists (lua_State *L)
  */
 static int l_shell_info (lua_State *L)
 {
-    int rc = 1;
-    char *json_str;
-    if (flux_shell_get_info (rc_shell, &json_str) < 0) {
-        return lua_pusherror (L, "flux_shell_get_info: %s", strerror (errno));
-    }
-    if (json_object_string_to_lua (L, json_str) < 0)
-        rc = lua_pusherror (L, "json_string_to_lua: %s", strerror (errno));
-    free (json_str);
-    return rc;
+    json_t *o;
+    if (!(o = shell_info_object (rc_shell)))
+        return lua_pusherror (L, "shell_info_object: %s", strerror (errno));
+    return json_object_to_lua (L, o);
 }
 
 /*  shell.options indexer
@@ -513,19 +509,18 @@ static int l_shell_setenv (lua_State *L)
  */
 static int l_shell_rankinfo (lua_State *L)
 {
-    int rc = 1;
-    char *json_str = NULL;
+    json_t *o;
     int shell_rank = -1;
 
     if (lua_isnumber (L, -1))
         shell_rank = lua_tointeger (L, -1);
-
-    if (flux_shell_get_rank_info (rc_shell, shell_rank, &json_str) < 0)
+    if (shell_rank < -1) {
+        errno = EINVAL;
         return lua_pusherror (L, "%s", strerror (errno));
-    if (json_object_string_to_lua (L, json_str) < 0)
-        rc = lua_pusherror (L, "json_object_to_lua: %s", strerror (errno));
-    free (json_str);
-    return rc;
+    }
+    if (!(o = shell_rank_info_object (rc_shell, shell_rank)))
+        return lua_pusherror (L, "%s", strerror (errno));
+    return json_object_to_lua (L, o);
 }
 
 static void get_lua_sourceinfo (lua_State *L,
@@ -740,16 +735,15 @@ static int l_shell_newindex (lua_State *L)
  */
 static int l_task_info (lua_State *L, flux_shell_task_t *task)
 {
-    int rc = 1;
-    char *json_str;
-    if (flux_shell_task_get_info (task, &json_str) < 0) {
-        return lua_pusherror (L, "flux_shell_task_get_info: %s",
-                                 strerror (errno));
+    json_t *o;
+    if (!task) {
+        errno = EINVAL;
+        return lua_pusherror (L, "task info: %s", strerror (errno));
     }
-    if (json_object_string_to_lua (L, json_str) < 0)
-        rc = lua_pusherror (L, "json_string_to_lua: %s", strerror (errno));
-    free (json_str);
-    return rc;
+    if (!(o = shell_task_info_object (task)))
+        return lua_pusherror (L, "shell_task_info_object: %s",
+                                 strerror (errno));
+    return json_object_to_lua (L, o);
 }
 
 /*  task.getenv
@@ -34,8 +34,6 @@ struct rankinfo {
     const char *gpus;
     char *adjusted_cores;
     char *adjusted_gpus;
-    struct idset *cpuset;
-    struct idset *gpuset;
 };
 
 struct allocinfo {
@@ -46,7 +44,6 @@ struct allocinfo {
 struct rcalc {
     json_t *json;
     json_t *R_lite;
-    struct idset *orig_ranks;
     int nranks;
     int ncores;
     int ngpus;
@@ -77,10 +74,7 @@ void rcalc_destroy (rcalc_t *r)
     if (r == NULL)
         return;
     json_decref (r->json);
-    idset_destroy (r->orig_ranks);
     for (int i = 0; i < r->nranks; i++) {
-        idset_destroy (r->ranks[i].cpuset);
-        idset_destroy (r->ranks[i].gpuset);
         free (r->ranks[i].adjusted_cores);
         free (r->ranks[i].adjusted_gpus);
     }
@@ -90,47 +84,41 @@ void rcalc_destroy (rcalc_t *r)
     free (r);
 }
 
-static struct idset * rcalc_ranks (rcalc_t *r, flux_error_t *errp)
+/*  Count the ranks in R_lite so that rankinfo can be allocated at once.
+ */
+static int rcalc_count_ranks (rcalc_t *r, flux_error_t *errp)
 {
     json_t *entry;
     size_t index;
     json_error_t error;
-    struct idset *ranks;
-
-    if (!(ranks = idset_create (0, IDSET_FLAG_AUTOGROW)))
-        return NULL;
+    int count = 0;
 
     json_array_foreach (r->R_lite, index, entry) {
         struct idset *ids;
         const char *rank;
         if (json_unpack_ex (entry, &error, 0,
                             "{s:s}",
-                            "rank", &rank) < 0) {
-            errprintf (errp, "%s", error.text);
-            goto err;
-        }
-        if (!(ids = idset_decode (rank))) {
-            errprintf (errp, "invalid idset %s", rank);
-            goto err;
-        }
-        if (idset_add (ranks, ids) < 0) {
-            idset_destroy (ids);
-            errprintf (errp, "idset_add (%s): %s", rank, strerror (errno));
-            goto err;
-        }
+                            "rank", &rank) < 0)
+            return errprintf (errp, "%s", error.text);
+        if (!(ids = idset_decode (rank)))
+            return errprintf (errp, "invalid idset %s", rank);
+        count += idset_count (ids);
         idset_destroy (ids);
     }
-    return ranks;
-err:
-    idset_destroy (ranks);
-    return NULL;
+    return count;
 }
 
+/*  Decode the children of one R_lite entry.  The result is shared by
+ *   every rank in the entry, so core and gpu idsets are decoded once
+ *   per entry rather than once per rank.
+ */
 static int rankinfo_get_children (struct rankinfo *ri,
                                   json_t *children,
                                   flux_error_t *errp)
 {
     json_error_t error;
+    struct idset *cpuset;
+    struct idset *gpuset;
 
     if (json_unpack_ex (children, &error, 0,
                         "{s:s s?s}",
@@ -138,13 +126,15 @@ static int rankinfo_get_children (struct rankinfo *ri,
                         "gpu", &ri->gpus) < 0)
         return errprintf (errp, "%s", error.text);
 
-    if (!(ri->cpuset = idset_decode (ri->cores))
-        || !(ri->gpuset = idset_decode (ri->gpus ? ri->gpus : "")))
+    if (!(cpuset = idset_decode (ri->cores))
+        || !(gpuset = idset_decode (ri->gpus ? ri->gpus : ""))) {
+        idset_destroy (cpuset);
         return errprintf (errp, "Failed to decode cpu or gpu sets");
-
-    ri->ncores = idset_count (ri->cpuset);
-    ri->ngpus = idset_count (ri->gpuset);
-
+    }
+    ri->ncores = idset_count (cpuset);
+    ri->ngpus = idset_count (gpuset);
+    idset_destroy (cpuset);
+    idset_destroy (gpuset);
     return 0;
 }
 
@@ -170,6 +160,7 @@ static int rcalc_process_all_ranks (rcalc_t *r, flux_error_t *errp)
         json_t *children;
         unsigned int i;
         struct idset *ids;
+        struct rankinfo template = { 0 };
 
         if (json_unpack_ex (entry, &error, 0,
                             "{s:s s:o}",
@@ -177,6 +168,9 @@ static int rcalc_process_all_ranks (rcalc_t *r, flux_error_t *errp)
                             "children", &children) < 0)
             return errprintf (errp, "%s", error.text);
 
+        if (rankinfo_get_children (&template, children, errp) < 0)
+            return -1;
+
         if (!(ids = idset_decode (rank)))
             return errprintf (errp,
                               "idset_decode (%s): %s",
@@ -186,6 +180,7 @@ static int rcalc_process_all_ranks (rcalc_t *r, flux_error_t *errp)
         i = idset_first (ids);
         while (i != IDSET_INVALID_ID) {
             struct rankinfo *ri = &r->ranks[n];
+            *ri = template;
             ri->id = n;
             ri->rank = i;
 
@@ -196,10 +191,6 @@ static int rcalc_process_all_ranks (rcalc_t *r, flux_error_t *errp)
             else
                 sorted = false;
 
-            if (rankinfo_get_children (ri, children, errp) < 0) {
-                idset_destroy (ids);
-                return -1;
-            }
             r->ncores += ri->ncores;
             r->ngpus += ri->ngpus;
             n++;
@@ -238,11 +229,11 @@ rcalc_t * rcalc_create_json (json_t *o)
         errno = EINVAL;
         goto fail;
     }
-    if (!(r->orig_ranks = rcalc_ranks (r, &error)))
+    if ((r->nranks = rcalc_count_ranks (r, &error)) < 0)
+        goto fail;
+    if (!(r->ranks = calloc (r->nranks, sizeof (struct rankinfo)))
+        || !(r->alloc = calloc (r->nranks, sizeof (struct allocinfo))))
         goto fail;
-    r->nranks = idset_count (r->orig_ranks);
-    r->ranks = calloc (r->nranks, sizeof (struct rankinfo));
-    r->alloc = calloc (r->nranks, sizeof (struct allocinfo));
 
     if (rcalc_process_all_ranks (r, &error) < 0)
         goto fail;
@@ -444,13 +435,21 @@ int rcalc_distribute_per_resource (rcalc_t *r, const char *name, int ntasks)
     return 0;
 }
 
+/*  r->ranks is sorted by broker rank, see rcalc_process_all_ranks().
+ */
 static struct rankinfo *rcalc_rankinfo_find (rcalc_t *r, int rank)
 {
-    int i;
-    for (i = 0; i < r->nranks; i++) {
-        struct rankinfo *ri = &r->ranks[i];
+    int lo = 0;
+    int hi = r->nranks - 1;
+    while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
+        struct rankinfo *ri = &r->ranks[mid];
         if (ri->rank == rank)
             return (ri);
+        if (ri->rank < rank)
+            lo = mid + 1;
+        else
+            hi = mid - 1;
     }
     return (NULL);
 }
@@ -518,18 +517,33 @@ int rcalc_has_rank (rcalc_t *r, int rank)
     return (0);
 }
 
+/*  Return a copy of idset string 's' truncated to its first 'total' ids.
+ *  The idset is decoded only here, since most ranks are not adjusted.
+ */
+static char *idset_string_truncate (const char *s, int total)
+{
+    struct idset *ids;
+    unsigned int i;
+    int n = 0;
+    char *result;
+
+    if (!(ids = idset_decode (s ? s : "")))
+        return NULL;
+    i = idset_first (ids);
+    while (i != IDSET_INVALID_ID) {
+        if (++n > total)
+            idset_clear (ids, i);
+        i = idset_next (ids, i);
+    }
+    result = idset_encode (ids, IDSET_FLAG_RANGE);
+    idset_destroy (ids);
+    return result;
+}
+
 static int rankinfo_adjust_cores (struct rankinfo *ri, int total)
 {
     if (ri->ncores > total) {
-        int n = 0;
-        unsigned int i = idset_first (ri->cpuset);
-        while (i != IDSET_INVALID_ID) {
-            if (++n > total)
-                idset_clear (ri->cpuset, i);
-            i = idset_next (ri->cpuset, i);
-        }
-        if (!(ri->adjusted_cores = idset_encode (ri->cpuset,
-                                                 IDSET_FLAG_RANGE)))
+        if (!(ri->adjusted_cores = idset_string_truncate (ri->cores, total)))
             return -1;
     }
     return 0;
@@ -538,15 +552,7 @@ static int rankinfo_adjust_cores (struct rankinfo *ri, int total)
 static int rankinfo_adjust_gpus (struct rankinfo *ri, int total)
 {
     if (ri->ngpus > total) {
-        int n = 0;
-        unsigned int i = idset_first (ri->gpuset);
-        while (i != IDSET_INVALID_ID) {
-            if (++n > total)
-                idset_clear (ri->gpuset, i);
-            i = idset_next (ri->gpuset, i);
-        }
-        if (!(ri->adjusted_gpus = idset_encode (ri->gpuset,
-                                                IDSET_FLAG_RANGE)))
+        if (!(ri->adjusted_gpus = idset_string_truncate (ri->gpus, total)))
             return -1;
     }
     return 0;
@@ -33,6 +33,7 @@
 #include "src/common/libutil/fdutils.h"
 #include "src/common/libutil/basename.h"
 #include "src/common/libutil/jpath.h"
+#include "src/common/libutil/monotime.h"
 #include "src/common/libjob/idf58.h"
 #include "src/common/libtaskmap/taskmap_private.h"
 #include "ccan/str/str.h"
@@ -530,7 +531,7 @@ const struct hostlist *flux_shell_get_hostlist (flux_shell_t *shell)
     return shell->info->hostlist;
 }
 
-static json_t *flux_shell_get_info_object (flux_shell_t *shell)
+json_t *shell_info_object (flux_shell_t *shell)
 {
     json_error_t err;
     json_t *o = NULL;
@@ -573,7 +574,7 @@ int flux_shell_get_info (flux_shell_t *shell, char **json_str)
         errno = EINVAL;
         return -1;
     }
-    if (!(o = flux_shell_get_info_object (shell)))
+    if (!(o = shell_info_object (shell)))
         return -1;
     if (!(s = json_dumps (o, JSON_COMPACT))) {
         errno = ENOMEM;
@@ -591,7 +592,7 @@ int flux_shell_info_vunpack (flux_shell_t *shell, const char *fmt, va_list ap)
         errno = EINVAL;
         return -1;
     }
-    if (!(o = flux_shell_get_info_object (shell)))
+    if (!(o = shell_info_object (shell)))
         return -1;
     return json_vunpack_ex (o, &err, 0, fmt, ap);
 }
@@ -617,11 +618,10 @@ static char *get_rank_task_idset (struct taskmap *map, int nodeid)
     return idset_encode (ids, IDSET_FLAG_RANGE);
 }
 
-static json_t *flux_shell_get_rank_info_object (flux_shell_t *shell, int rank)
+json_t *shell_rank_info_object (flux_shell_t *shell, int rank)
 {
     json_t *o;
     json_error_t error;
-    char key [128];
     char *taskids = NULL;
     struct taskmap *map;
     struct rcalc_rankinfo rankinfo;
@@ -638,10 +638,12 @@ static json_t *flux_shell_get_rank_info_object (flux_shell_t *shell, int rank)
         errno = EINVAL;
         return NULL;
     }
-    if (snprintf (key, sizeof (key), "shell::rinfo%d", rank) >= sizeof (key))
+    if (!shell->rank_info
+        && !(shell->rank_info = calloc (shell->info->shell_size,
+                                        sizeof (shell->rank_info[0]))))
         return NULL;
 
-    if ((o = flux_shell_aux_get (shell, key)))
+    if ((o = shell->rank_info[rank]))
         return o;
 
     map = shell->info->taskmap;
@@ -649,7 +651,7 @@ static json_t *flux_shell_get_rank_info_object (flux_shell_t *shell, int rank)
         return NULL;
 
     if (rcalc_get_nth (shell->info->rcalc, rank, &rankinfo) < 0)
-        return NULL;
+        goto error;
 
     /* Note: Drop const on `struct hostlist *` here. The cursor will be
      * moved, but this should be fine here since the hostlist itself is not
@@ -657,7 +659,7 @@ static json_t *flux_shell_get_rank_info_object (flux_shell_t *shell, int rank)
      */
     if (!(hl = (struct hostlist *) flux_shell_get_hostlist (shell))
         || !(nodename = hostlist_nth (hl, rank)))
-        return NULL;
+        goto error;
 
     o = json_pack_ex (&error,
                       0,
@@ -672,16 +674,15 @@ static json_t *flux_shell_get_rank_info_object (flux_shell_t *shell, int rank)
                        "cores", rankinfo.cores,
                        "gpus",  rankinfo.gpus);
     free (taskids);
-
-    if (o == NULL)
-        return NULL;
-
-    if (flux_shell_aux_set (shell, key, o, (flux_free_f) json_decref) < 0) {
-        json_decref (o);
+    if (o == NULL) {
+        errno = ENOMEM;
         return NULL;
     }
-
+    shell->rank_info[rank] = o;
     return o;
+error:
+    ERRNO_SAFE_WRAP (free, taskids);
+    return NULL;
 }
 
 int flux_shell_get_rank_info (flux_shell_t *shell,
@@ -695,7 +696,7 @@ int flux_shell_get_rank_info (flux_shell_t *shell,
         errno = EINVAL;
         return -1;
     }
-    if (!(o = flux_shell_get_rank_info_object (shell, shell_rank)))
+    if (!(o = shell_rank_info_object (shell, shell_rank)))
         return -1;
     if (!(s = json_dumps (o, JSON_COMPACT))) {
         errno = ENOMEM;
@@ -716,7 +717,7 @@ int flux_shell_rank_info_vunpack (flux_shell_t *shell,
         errno = EINVAL;
         return -1;
     }
-    if (!(o = flux_shell_get_rank_info_object (shell, shell_rank)))
+    if (!(o = shell_rank_info_object (shell, shell_rank)))
         return -1;
     return json_vunpack_ex (o, &err, 0, fmt, ap);
 }
@@ -1040,6 +1041,12 @@ static void shell_finalize (flux_shell_t *shell)
     mustache_renderer_destroy (shell->mr);
     shell_eventlogger_destroy (shell->ev);
     shell_svc_destroy (shell->svc);
+    if (shell->rank_info) {
+        for (int i = 0; i < shell->info->shell_size; i++)
+            json_decref (shell->rank_info[i]);
+        free (shell->rank_info);
+    }
+    json_decref (shell->phases);
     shell_info_destroy (shell->info);
 
     flux_reactor_destroy (shell->r);
@@ -1134,7 +1141,7 @@ static int mustache_render_node (flux_shell_t *shell,
     json_t *o;
     json_t *val;
 
-    if (!(o = flux_shell_get_rank_info_object (shell, shell_rank)))
+    if (!(o = shell_rank_info_object (shell, shell_rank)))
         return -1;
 
     /* forward past "node." */
@@ -1817,6 +1824,58 @@ out:
     return rc;
 }
 
+/*  Add startup timing to the shell.init event context: the time the
+ *   leader shell spent fetching job info, and the time from leader shell
+ *   start until all shells completed initialization.
+ */
+static int shell_register_startup_context (flux_shell_t *shell,
+                                           double t_info,
+                                           double t_init)
+{
+    if (shell->info->shell_rank != 0)
+        return 0;
+    return flux_shell_add_event_context (shell,
+                                         "shell.init",
+                                         0,
+                                         "{s:{s:f s:f}}",
+                                         "startup",
+                                           "info", t_info,
+                                           "init", t_init);
+}
+
+/*  Record the time since the previous mark as startup phase 'name' and
+ *   start the next phase.  Returns the phase duration in seconds.
+ */
+static double shell_phase_mark (flux_shell_t *shell, const char *name)
+{
+    double t = monotime_since (shell->t_phase) / 1000;
+
+    if ((shell->phases || (shell->phases = json_object ()))
+        && json_object_set_new (shell->phases, name, json_real (t)) < 0)
+        shell_log_error ("error recording startup phase %s", name);
+    monotime (&shell->t_phase);
+    return t;
+}
+
+/*  Log startup phase timing on every shell at debug verbosity, and add
+ *   it to the shell.start event context from the leader shell.
+ */
+static int shell_phases_report (flux_shell_t *shell)
+{
+    if (shell->verbose) {
+        char *s = json_dumps (shell->phases, JSON_COMPACT);
+        shell_debug ("startup phases: %s", s ? s : "{}");
+        free (s);
+    }
+    if (shell->info->shell_rank != 0 || !shell->phases)
+        return 0;
+    return flux_shell_add_event_context (shell,
+                                         "shell.start",
+                                         0,
+                                         "{s:O}",
+                                         "phases", shell->phases);
+}
+
 /*  Setup common environment for this job directly in the jobspec environment.
  *  Task-specific environment is setup in shell_task_create().
  */
@@ -1940,9 +1999,41 @@ static int shell_create_tasks (flux_shell_t *shell)
     return 0;
 }
 
+static void shell_task_start_or_die (flux_shell_t *shell,
+                                     flux_shell_task_t *task)
+{
+    if (shell_task_start (shell, task, task_completion_cb, shell) < 0) {
+        int ec = 1;
+        /* bash standard, 126 for permission/access denied, 127
+         * for command not found.  Note that shell only launches
+         * local tasks, therefore no need to check for
+         * EHOSTUNREACH.
+         */
+        if (errno == EPERM || errno == EACCES)
+            ec = 126;
+        else if (errno == ENOENT)
+            ec = 127;
+        shell_die (ec,
+                   "task %d (host %s): start failed: %s: %s",
+                   task->rank,
+                   shell->hostname,
+                   flux_cmd_arg (task->cmd, 0),
+                   strerror (errno));
+    }
+    if (flux_shell_add_completion_ref (shell, "task%d", task->rank) < 0)
+        shell_die (1, "flux_shell_add_completion_ref");
+}
+
+/*  Launch tasks in three passes so that each phase is handled in bulk
+ *   and can be timed separately: prepare all commands (task.init), then
+ *   spawn all tasks, then call task.fork for each.  If no plugin handles
+ *   task.exec after task.init, tasks are started without a pre-exec hook,
+ *   which allows libsubprocess to use posix_spawn(3) instead of fork(2).
+ */
 static int shell_start_tasks (flux_shell_t *shell)
 {
     flux_shell_task_t *task;
+    bool need_exec_hook;
 
     task = zlist_first (shell->tasks);
     while (task) {
@@ -1958,27 +2049,28 @@ static int shell_start_tasks (flux_shell_t *shell)
         if (frob_command (shell, task->cmd))
             shell_die (1, "failed rendering of mustachioed command args");
 
-        if (shell_task_start (shell, task, task_completion_cb, shell) < 0) {
-            int ec = 1;
-            /* bash standard, 126 for permission/access denied, 127
-             * for command not found.  Note that shell only launches
-             * local tasks, therefore no need to check for
-             * EHOSTUNREACH.
-             */
-            if (errno == EPERM || errno == EACCES)
-                ec = 126;
-            else if (errno == ENOENT)
-                ec = 127;
-            shell_die (ec,
-                       "task %d (host %s): start failed: %s: %s",
-                       task->rank,
-                       shell->hostname,
-                       flux_cmd_arg (task->cmd, 0),
-                       strerror (errno));
-        }
+        task = zlist_next (shell->tasks);
+    }
+    shell_phase_mark (shell, "task.init");
 
-        if (flux_shell_add_completion_ref (shell, "task%d", task->rank) < 0)
-            shell_die (1, "flux_shell_add_completion_ref");
+    need_exec_hook = plugstack_has_handler (shell->plugstack, "task.exec");
+    shell_debug ("starting %d tasks with %s",
+                 (int)zlist_size (shell->tasks),
+                 need_exec_hook ? "fork" : "posix_spawn");
+
+    task = zlist_first (shell->tasks);
+    while (task) {
+        shell->current_task = task;
+        if (!need_exec_hook)
+            task->pre_exec_cb = NULL;
+        shell_task_start_or_die (shell, task);
+        task = zlist_next (shell->tasks);
+    }
+    shell_phase_mark (shell, "task.spawn");
+
+    task = zlist_first (shell->tasks);
+    while (task) {
+        shell->current_task = task;
 
         /*  Call all plugin task_fork callbacks:
          */
@@ -1987,6 +2079,7 @@ static int shell_start_tasks (flux_shell_t *shell)
 
         task = zlist_next (shell->tasks);
     }
+    shell_phase_mark (shell, "task.fork");
     shell->current_task = NULL;
     return 0;
 }
@@ -1994,8 +2087,12 @@ static int shell_start_tasks (flux_shell_t *shell)
 int main (int argc, char *argv[])
 {
     flux_shell_t shell;
+    struct timespec t_start;
+    double t_info;
 
+    monotime (&t_start);
     memset (&shell, 0, sizeof (shell));
+    shell.t_phase = t_start;
 
     /* Initialize locale from environment
      */
@@ -2022,12 +2119,14 @@ int main (int argc, char *argv[])
     /* Subscribe to shell-<id>.* events. (no-op on loopback connector)
      */
     shell_events_subscribe (&shell);
+    shell_phase_mark (&shell, "connect");
 
     /* Populate 'struct shell_info' for general use by shell components.
      * Fetches missing info from shell handle if set.
      */
     if (!(shell.info = shell_info_create (&shell)))
         shell_die (1, "failed to initialize shell info");
+    t_info = shell_phase_mark (&shell, "info");
 
     if (shell_export_environment_from_job (&shell) < 0)
         shell_die (1, "failed to initialize shell environment");
@@ -2056,6 +2155,7 @@ int main (int argc, char *argv[])
      */
     if (shell_initrc (&shell) < 0)
         shell_die_errno (1, "shell_initrc");
+    shell_phase_mark (&shell, "initrc");
 
     if (shell_taskmap (&shell) < 0)
         shell_die (1, "shell_taskmap");
@@ -2074,6 +2174,12 @@ int main (int argc, char *argv[])
     if (shell_register_event_context (&shell) < 0)
         shell_die (1, "failed to add standard shell event context");
 
+    /* Build the info objects used by plugins now that rcalc and the
+     * taskmap are final.
+     */
+    if (!shell_info_object (&shell) || !shell_rank_info_object (&shell, -1))
+        shell_die (1, "failed to create shell info objects");
+
     /* Setup common environment for job.
      */
     if (shell_setup_environment (&shell) < 0)
@@ -2084,11 +2190,13 @@ int main (int argc, char *argv[])
      */
     if (shell_create_tasks (&shell) < 0)
         shell_die_errno (1, "shell_create_tasks");
+    shell_phase_mark (&shell, "setup");
 
     /* Call "shell_init" plugins.
      */
     if (shell_init (&shell) < 0)
         shell_die_errno (1, "shell_init");
+    shell_phase_mark (&shell, "shell.init");
 
     /* Now that verbosity, task mapping, etc. may have changed, log
      * basic shell info.
@@ -2099,6 +2207,12 @@ int main (int argc, char *argv[])
      */
     if (shell_barrier (&shell, "init") < 0)
         shell_die_errno (1, "shell_barrier");
+    shell_phase_mark (&shell, "barrier.init");
+
+    if (shell_register_startup_context (&shell,
+                                        t_info,
+                                        monotime_since (t_start) / 1000) < 0)
+        shell_die (1, "failed to add startup timing to shell.init context");
 
     /*  Emit an event after barrier completion from rank 0
      */
@@ -2110,6 +2224,7 @@ int main (int argc, char *argv[])
      */
     if (shell_post_init (&shell) < 0)
         shell_die_errno (1, "shell_post_init");
+    shell_phase_mark (&shell, "shell.post-init");
 
     /* Start all tasks
      */
@@ -2118,9 +2233,14 @@ int main (int argc, char *argv[])
 
     if (shell_start (&shell) < 0)
         shell_die_errno (1, "shell.start callback(s) failed");
+    shell_phase_mark (&shell, "shell.start");
 
     if (shell_barrier (&shell, "start") < 0)
         shell_die_errno (1, "shell_barrier");
+    shell_phase_mark (&shell, "barrier.start");
+
+    if (shell_phases_report (&shell) < 0)
+        shell_die (1, "failed to add startup phases to shell.start context");
 
     /*  Emit an event after barrier completion from rank 0
      */
@@ -106,6 +106,24 @@ flux_future_t *shell_svc_vpack (struct shell_svc *svc,
     return flux_rpc_vpack (svc->shell->h, topic, rank, flags, fmt, ap);
 }
 
+flux_future_t *shell_svc_raw (struct shell_svc *svc,
+                              const char *method,
+                              int shell_rank,
+                              int flags,
+                              const void *data,
+                              size_t len)
+{
+    char topic[TOPIC_STRING_SIZE];
+    int rank;
+
+    if (lookup_rank (svc, shell_rank, &rank) < 0)
+        return NULL;
+    if (build_topic (svc, method, topic, sizeof (topic)) < 0)
+        return NULL;
+
+    return flux_rpc_raw (svc->shell->h, topic, data, len, rank, flags);
+}
+
 int shell_svc_allowed (struct shell_svc *svc, const flux_msg_t *msg)
 {
     return flux_msg_authorize (msg, svc->uid);
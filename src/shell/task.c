@@ -171,6 +171,9 @@ static void subproc_preexec_hook (flux_subprocess_t *p, void *arg)
         (*task->pre_exec_cb) (task, task->pre_exec_arg);
 }
 
+/*  The pre-exec hook is only passed to libsubprocess if task->pre_exec_cb
+ *   is set, since any hook forces fork(2) in place of posix_spawn(3).
+ */
 int shell_task_start (struct flux_shell *shell,
                       struct shell_task *task,
                       shell_task_completion_f cb,
@@ -190,7 +193,7 @@ int shell_task_start (struct flux_shell *shell,
                                      flags,
                                      task->cmd,
                                      &subproc_ops,
-                                     &hooks,
+                                     task->pre_exec_cb ? &hooks : NULL,
                                      NULL,
                                      NULL);
     if (!task->proc)
@@ -334,7 +337,7 @@ static const char * task_state (flux_shell_task_t *task)
         return "Init";
 }
 
-static json_t *get_task_object (flux_shell_task_t *task)
+json_t *shell_task_info_object (flux_shell_task_t *task)
 {
     json_error_t err;
     json_t *o;
@@ -375,7 +378,7 @@ int flux_shell_task_get_info (flux_shell_task_t *task, char **json_str)
         errno = EINVAL;
         return -1;
     }
-    if (!(o = get_task_object (task)))
+    if (!(o = shell_task_info_object (task)))
         return -1;
     *json_str = json_dumps (o, JSON_COMPACT);
     return (*json_str ? 0 : -1);
@@ -391,7 +394,7 @@ int flux_shell_task_info_vunpack (flux_shell_task_t *task,
         errno = EINVAL;
         return -1;
     }
-    if (!(o = get_task_object (task)))
+    if (!(o = shell_task_info_object (task)))
         return -1;
     return json_vunpack_ex (o, &err, 0, fmt, ap);
 }
@@ -12,6 +12,7 @@
 #define SHELL_TASK_H
 
 #include <flux/core.h>
+#include <jansson.h>
 
 #include "src/common/libczmqcontainers/czmq_containers.h"
 #include "src/common/libutil/aux.h"
@@ -54,6 +55,11 @@ struct shell_task {
 
 void shell_task_destroy (struct shell_task *task);
 
+/* Cached info object behind flux_shell_task_info_unpack(), which is owned
+ * by the task and must not be modified.
+ */
+json_t *shell_task_info_object (struct shell_task *task);
+
 struct shell_task *shell_task_create (flux_shell_t *shell,
                                       int index,
                                       int taskid);
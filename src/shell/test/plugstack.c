@@ -200,6 +200,13 @@ int main (int argc, char **argv)
     ok (called_bar == 2 && called_foo == 0,
         "plugstack_call didn't call foo() only bar()");
 
+    ok (plugstack_has_handler (st, "callback"),
+        "plugstack_has_handler returns true for registered topic");
+    ok (!plugstack_has_handler (st, "nosuchtopic"),
+        "plugstack_has_handler returns false for unregistered topic");
+    ok (!plugstack_has_handler (NULL, "callback"),
+        "plugstack_has_handler (NULL, topic) returns false");
+
     plugstack_destroy (st);
     flux_plugin_arg_destroy (args);
 
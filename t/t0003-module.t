@@ -346,5 +346,54 @@ test_expect_success 'but only logging with broker.module-nopanic=1' '
 test_expect_success 'flux module stats connector-local works' '
 	flux module stats connector-local
 '
+# Usage: router_stat name
+router_stat() {
+	flux module stats connector-local | jq -r ".router.services.$1"
+}
+# rtrtest.py registers a service from a local client and sends it the
+# requested number of requests, which connector-local should count as
+# hash hits.  Then it sends "rtrtest" with no method, which the broker
+# routes to the client but which matches none of its services (a miss).
+test_expect_success 'create script that sends requests to a client service' '
+	cat >rtrtest.py <<-EOT &&
+	import sys, errno
+	import flux
+	from flux.constants import FLUX_MSGTYPE_REQUEST
+
+	count = int(sys.argv[1])
+	h = flux.Flux()
+	h.service_register("rtrtest").get()
+
+	def request_cb(h, t, msg, arg):
+	    h.respond(msg, None)
+
+	def response_cb(f):
+	    global count
+	    f.get()
+	    count -= 1
+	    if count == 0:
+	        f.get_flux().reactor_stop()
+
+	w = h.msg_watcher_create(request_cb, FLUX_MSGTYPE_REQUEST, "rtrtest.*")
+	w.start()
+	for i in range(count):
+	    h.rpc("rtrtest.ping").then(response_cb)
+	h.reactor_run()
+	try:
+	    h.rpc("rtrtest").get()
+	    sys.exit(1)
+	except OSError as e:
+	    if e.errno != errno.ENOSYS:
+	        raise
+	EOT
+	chmod +x rtrtest.py
+'
+test_expect_success 'connector-local counts routed client service requests' '
+	hits=$(router_stat hash_hits) &&
+	misses=$(router_stat misses) &&
+	flux python ./rtrtest.py 8 &&
+	test $(router_stat hash_hits) -eq $(($hits+8)) &&
+	test $(router_stat misses) -eq $(($misses+1))
+'
 
 test_done
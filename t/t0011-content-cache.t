@@ -229,6 +229,26 @@ test_expect_success 'content load with no blobrefs fails' '
 	test_must_fail flux content load </dev/null
 '
 
+test_expect_success 'content.preload primes the cache of target ranks' '
+	LAST=$(($SIZE-1)) &&
+	echo preload-test | flux content store >preload.ref &&
+	before=$(flux exec -r $LAST \
+		flux module stats --type int --parse count content) &&
+	jq -j -c -n "{ranks:\"1-$LAST\",blobrefs:[\"$(cat preload.ref)\"]}" \
+		| $RPC content.preload &&
+	after=$(flux exec -r $LAST \
+		flux module stats --type int --parse count content) &&
+	test $after -eq $(($before+1))
+'
+test_expect_success 'content.preload of missing blob fails with ENOENT(2)' '
+	HASHSTR=$(echo preload-missing | $BLOBREF $HASHFUN) &&
+	jq -j -c -n "{ranks:\"1\",blobrefs:[\"$HASHSTR\"]}" \
+		| $RPC content.preload 2
+'
+test_expect_success 'content.preload with bad payload fails with EPROTO(71)' '
+	jq -j -c -n "{ranks:\"1\",blobrefs:[42]}" \
+		| $RPC content.preload 71
+'
 test_expect_success 'remove content module' '
 	flux exec flux module remove content
 '
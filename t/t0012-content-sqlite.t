@@ -135,6 +135,20 @@ test_expect_success 'exercise batching of synchronous flush to backing store' '
 	test ${NDIRTY} -eq 0
 '
 
+test_expect_success 'rank 0 cache flushed to content-sqlite with batch-store' '
+	flux module stats content-sqlite >stats.json &&
+	jq -e ".batch_store.size.count > 0" <stats.json &&
+	jq -e ".batch_store.size.max <= $FLUSH_BATCH_LIMIT" <stats.json &&
+	jq -e ".batch_store.commit_time.count > 0" <stats.json
+'
+test_expect_success 'content-backing.batch-store empty batch fails with EPROTO' '
+	$RPC content-backing.batch-store 71 </dev/null
+'
+test_expect_success 'content-backing.batch-store truncated batch fails' '
+	printf "\000\000\000\010xxx" >badbatch &&
+	$RPC content-backing.batch-store 71 <badbatch
+'
+
 test_expect_success 'drop the cache' '
 	flux content dropcache
 '
@@ -302,6 +316,147 @@ test_expect_success 'invalid config fails (synchronous)' '
 	   flux module stats content-sqlite &&
 	rm content-sqlite.toml
 '
+test_expect_success 'compression = "lz4hc" config works' '
+	cat >content-sqlite.toml <<-EOT &&
+	[content-sqlite]
+	compression = "lz4hc"
+	compression_level = 12
+	EOT
+	flux start --config-path=$(pwd) \
+	   -Sbroker.rc1_path="$rc1_kvs" -Sbroker.rc3_path="$rc3_kvs" \
+	   bash -c "${SPAMUTIL} 100 100 >/dev/null && \
+	       flux content flush && \
+	       flux module stats content-sqlite" >lz4hc.out &&
+	jq -e ".config.compression == \"lz4hc\"" <lz4hc.out &&
+	jq -e ".config.compression_level == 12" <lz4hc.out &&
+	rm content-sqlite.toml
+'
+test_expect_success 'invalid compression config fails' '
+	cat >content-sqlite.toml <<-EOT &&
+	[content-sqlite]
+	compression = "zip"
+	EOT
+	test_must_fail flux start --config-path=$(pwd) \
+	   -Sbroker.rc1_path="$rc1_kvs" -Sbroker.rc3_path="$rc3_kvs" \
+	   flux module stats content-sqlite &&
+	rm content-sqlite.toml
+'
+test_expect_success 'invalid compression_level config fails' '
+	cat >content-sqlite.toml <<-EOT &&
+	[content-sqlite]
+	compression = "lz4hc"
+	compression_level = 13
+	EOT
+	test_must_fail flux start --config-path=$(pwd) \
+	   -Sbroker.rc1_path="$rc1_kvs" -Sbroker.rc3_path="$rc3_kvs" \
+	   flux module stats content-sqlite &&
+	rm content-sqlite.toml
+'
+test_expect_success 'dictionary config requires lz4 compression' '
+	cat >content-sqlite.toml <<-EOT &&
+	[content-sqlite]
+	compression = "lz4hc"
+	dictionary = true
+	EOT
+	test_must_fail flux start --config-path=$(pwd) \
+	   -Sbroker.rc1_path="$rc1_kvs" -Sbroker.rc3_path="$rc3_kvs" \
+	   flux module stats content-sqlite &&
+	rm content-sqlite.toml
+'
+test_expect_success 'dictionary compression trains and uses a dictionary' '
+	mkdir -p dictconf dictdb &&
+	cat >dictconf/content-sqlite.toml <<-EOT &&
+	[content-sqlite]
+	dictionary = true
+	EOT
+	cat >dict1.sh <<-EOT &&
+	#!/bin/sh -e
+	flux module load content
+	flux module load content-sqlite
+	${SPAMUTIL} 3000 100 >/dev/null
+	flux content flush
+	echo "spam-o-matic dictionary test blob" >dict.blob
+	flux content store <dict.blob >dict.blobref
+	flux content flush
+	flux content compression --json >dict.json
+	flux module stats content-sqlite >dict.stats
+	flux module remove content-sqlite
+	flux module remove content
+	EOT
+	chmod +x dict1.sh &&
+	flux start --config-path=$(pwd)/dictconf -Sstatedir=$(pwd)/dictdb \
+	   -Sbroker.rc1_path= -Sbroker.rc3_path= ./dict1.sh &&
+	jq -e ".config.dictionary == true" <dict.stats &&
+	jq -e ".compression.dictionary > 0" <dict.stats &&
+	jq -e "map(select(.dict > 0)) | .[0].count > 0" <dict.json
+'
+test_expect_success 'dictionary compressed blobs can be read after restart' '
+	cat >dict2.sh <<-EOT &&
+	#!/bin/sh -e
+	flux module load content
+	flux module load content-sqlite
+	flux content load <dict.blobref >dict.blob.out
+	flux module remove content-sqlite
+	flux module remove content
+	EOT
+	chmod +x dict2.sh &&
+	flux start -Sstatedir=$(pwd)/dictdb \
+	   -Sbroker.rc1_path= -Sbroker.rc3_path= ./dict2.sh &&
+	test_cmp dict.blob dict.blob.out
+'
+test_expect_success 'flux content compression reports totals' '
+	flux start -Sstatedir=$(pwd)/dictdb \
+	   -Sbroker.rc1_path= -Sbroker.rc3_path= \
+	   bash -c "flux module load content && \
+	       flux module load content-sqlite && \
+	       flux content compression; rc=\$?; \
+	       flux module remove content-sqlite; \
+	       flux module remove content; \
+	       exit \$rc" >compression.out &&
+	test_debug "cat compression.out" &&
+	grep "^CODEC" compression.out &&
+	grep "^total" compression.out
+'
+test_expect_success 'flux content compression counts blobs stored earlier' '
+	flux start -Sstatedir=$(pwd)/dictdb \
+	   -Sbroker.rc1_path= -Sbroker.rc3_path= \
+	   bash -c "flux module load content && \
+	       flux module load content-sqlite && \
+	       flux content compression --json >count.json && \
+	       flux module stats content-sqlite >count.stats; rc=\$?; \
+	       flux module remove content-sqlite; \
+	       flux module remove content; \
+	       exit \$rc" &&
+	total=$(jq "map(.count) | add" <count.json) &&
+	test "$total" -eq $(jq .object_count <count.stats)
+'
+test_expect_success 'config reload that changes compression is rejected' '
+	mkdir -p reloadconf &&
+	cat >reloadconf/content-sqlite.toml <<-EOT &&
+	[content-sqlite]
+	compression = "lz4"
+	EOT
+	cat >reload.sh <<-EOT &&
+	#!/bin/sh -e
+	flux module load content
+	flux module load content-sqlite
+	flux config reload
+	cat >reloadconf/content-sqlite.toml <<-EOF
+	[content-sqlite]
+	compression = "lz4hc"
+	EOF
+	flux config reload 2>reload.err && exit 1
+	flux module stats content-sqlite >reload.stats
+	flux module remove content-sqlite
+	flux module remove content
+	EOT
+	chmod +x reload.sh &&
+	flux start --config-path=$(pwd)/reloadconf \
+	   -Sbroker.rc1_path= -Sbroker.rc3_path= ./reload.sh &&
+	test_debug "cat reload.err" &&
+	grep "cannot be changed" reload.err &&
+	jq -e ".config.compression == \"lz4\"" <reload.stats
+'
 
 
 # Will create in WAL mode since statedir is set
@@ -456,6 +456,29 @@ test_expect_success 'kvs: put --raw a=- b=- works with a getting all of stdin' '
 	test_cmp rawstdin3a.expected rawstdin3a.actual &&
 	test_cmp /dev/null rawstdin3b.actual
 '
+test_expect_success 'kvs: put/get --raw works with large binary value' '
+	flux kvs unlink -Rf $DIR &&
+	dd if=/dev/urandom bs=4096 count=4 >rawlarge.expected &&
+	flux kvs put --raw $DIR.a=- <rawlarge.expected &&
+	flux kvs get --raw $DIR.a >rawlarge.actual &&
+	test_cmp rawlarge.expected rawlarge.actual
+'
+test_expect_success 'kvs: put/get --raw works with large value on rank 1' '
+	flux kvs unlink -Rf $DIR &&
+	flux exec -r 1 sh -c "flux kvs put --raw $DIR.a=- <rawlarge.expected" &&
+	flux kvs get --raw $DIR.a >rawlarge1.actual &&
+	test_cmp rawlarge.expected rawlarge1.actual &&
+	flux exec -r 1 flux kvs get --raw $DIR.a >rawlarge2.actual &&
+	test_cmp rawlarge.expected rawlarge2.actual
+'
+test_expect_success 'kvs: get --raw works with large appended value' '
+	flux kvs unlink -Rf $DIR &&
+	flux kvs put --raw $DIR.a=- <rawlarge.expected &&
+	flux kvs put --raw --append $DIR.a=- <rawlarge.expected &&
+	cat rawlarge.expected rawlarge.expected >rawappend.expected &&
+	flux kvs get --raw $DIR.a >rawappend.actual &&
+	test_cmp rawappend.expected rawappend.actual
+'
 
 #
 # get/put --treeobj tests
@@ -1176,6 +1199,52 @@ test_expect_success 'kvs: --sequence on write ops works' '
         test $VER -eq $SEQ
 '
 
+#
+# sharded directory tests
+#
+
+test_expect_success 'kvs: large directory is stored sharded' '
+	flux kvs unlink -Rf $DIR &&
+	flux kvs put $(seq 0 1999 | sed "s/.*/$DIR.big.k&=&/") &&
+	flux kvs get --treeobj $DIR.big >big.treeobj &&
+	jq -e ".type == \"dirref\" and (.data | length) == 16" <big.treeobj
+'
+test_expect_success 'kvs: get works in sharded directory' '
+	test $(flux kvs get $DIR.big.k0) -eq 0 &&
+	test $(flux kvs get $DIR.big.k1999) -eq 1999 &&
+	test_must_fail flux kvs get $DIR.big.k2000
+'
+test_expect_success 'kvs: get works in sharded directory on rank 1' '
+	test $(flux exec -r 1 flux kvs get $DIR.big.k1234) -eq 1234
+'
+test_expect_success 'kvs: put works in sharded directory' '
+	flux kvs put $DIR.big.k5=foo $DIR.big.sub.a=bar &&
+	test $(flux kvs get $DIR.big.k5) = foo &&
+	test $(flux kvs get $DIR.big.sub.a) = bar
+'
+test_expect_success 'kvs: unlink works in sharded directory' '
+	flux kvs unlink $DIR.big.k6 &&
+	test_must_fail flux kvs get $DIR.big.k6
+'
+test_expect_success 'kvs: ls lists all entries of sharded directory' '
+	flux kvs ls -1 $DIR.big >big.ls &&
+	test $(wc -l <big.ls) -eq 2000 &&
+	grep -x k7 big.ls &&
+	grep -x sub big.ls
+'
+test_expect_success 'kvs: dir -R descends into sharded directory' '
+	flux kvs dir -R $DIR.big >big.dir &&
+	grep "^$DIR.big.sub.a" big.dir
+'
+test_expect_success 'kvs: copy of sharded directory works' '
+	flux kvs copy $DIR.big $DIR.big2 &&
+	test $(flux kvs get $DIR.big2.k8) -eq 8
+'
+test_expect_success 'kvs: unlink -R of sharded directory works' '
+	flux kvs unlink -R $DIR.big $DIR.big2 &&
+	test_must_fail flux kvs ls $DIR.big
+'
+
 #
 # version/wait tests
 #
@@ -47,6 +47,29 @@ test_expect_success NO_CHAIN_LINT 'kvs-watch stats reports active watcher' '
        wait $pid
 '
 
+test_expect_success NO_CHAIN_LINT 'kvs-watch coalesces lookups of one key' '
+	flux kvs put test.coalesce=0
+	pids=""
+	for i in $(seq 1 4); do
+		flux kvs get --watch --count=2 test.coalesce >coalesce.$i.out &
+		pids="$pids $!"
+	done
+	for i in $(seq 1 4); do
+		$waitfile --count=1 --timeout=10 --pattern="[0-9]+" \
+			coalesce.$i.out >/dev/null
+	done &&
+	keys=$(flux module stats --parse=namespaces.primary.keys kvs-watch) &&
+	test $keys -eq 1 &&
+	before=$(flux module stats --parse=lookups-coalesced kvs-watch) &&
+	flux kvs put test.coalesce=1 &&
+	wait $pids &&
+	after=$(flux module stats --parse=lookups-coalesced kvs-watch) &&
+	test $(($after-$before)) -eq 3 &&
+	for i in $(seq 1 4); do
+		test $(tail -1 coalesce.$i.out) -eq 1 || return 1
+	done
+'
+
 # Check that stdin contains an integer on each line that
 # is one more than the integer on the previous line.
 test_monotonicity() {
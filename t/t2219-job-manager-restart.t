@@ -38,6 +38,32 @@ test_expect_success 'verify that job manager can restart with current dump' '
 test_expect_success 'and max_jobid is greater than zero' '
 	jq -e ".max_jobid > 0" <stats.out
 '
+test_expect_success 'and restart stats show one job replayed' '
+	jq -e ".restart.jobs == 1 and .restart.lost == 0" <stats.out &&
+	jq -e ".restart.directories > 0" <stats.out
+'
+test_expect_success 'job manager can restart with restart-max-inflight=1' '
+	mkdir -p conf.inflight &&
+	cat >conf.inflight/job-manager.toml <<-EOT &&
+	[job-manager]
+	restart-max-inflight = 1
+	EOT
+	flux start --config-path=$(pwd)/conf.inflight \
+	    -Scontent.restore=dump.tar \
+	    flux module stats job-manager >stats-inflight.out &&
+	jq -e ".restart.jobs == 1 and .restart.max_inflight == 1" \
+	    <stats-inflight.out
+'
+test_expect_success 'job manager fails to start with restart-max-inflight=0' '
+	mkdir -p conf.inflight0 &&
+	cat >conf.inflight0/job-manager.toml <<-EOT &&
+	[job-manager]
+	restart-max-inflight = 0
+	EOT
+	test_must_fail flux start --config-path=$(pwd)/conf.inflight0 \
+	    -Scontent.restore=dump.tar true 2>inflight0.err &&
+	grep "restart-max-inflight: must be >= 1" inflight0.err
+'
 test_expect_success 'delete checkpoint from dump' '
 	mkdir -p tmp &&
 	(cd tmp && tar -xf -) <dump.tar &&
@@ -5,6 +5,8 @@ test_description='Test job manager housekeeping'
 
 test_under_flux 4 full -Slog-stderr-level=1
 
+waitfile="${SHARNESS_TEST_SRCDIR}/scripts/waitfile.lua"
+
 # Usage: list_jobs
 list_jobs () {
 	flux housekeeping list -no {id}
@@ -417,4 +419,36 @@ test_expect_success 'release-after is -1 after reconfig' '
 	jq -e ".\"release-after\" == -1" config2.json
 '
 
+test_expect_success 'create resource-status streaming script' '
+	cat >status-stream.py <<-EOF
+	import sys
+	import flux
+	from flux.constants import FLUX_RPC_STREAMING
+	from flux.resource import ResourceSet
+	h = flux.Flux()
+	f = h.rpc("job-manager.resource-status", flags=FLUX_RPC_STREAMING)
+	for i in range(int(sys.argv[1])):
+	    for key, R in f.get().items():
+	        print(key, ResourceSet(R).ranks, flush=True)
+	    f.reset()
+	EOF
+'
+test_expect_success NO_CHAIN_LINT 'resource-status streams allocation deltas' '
+	wait_for_running 0 &&
+	flux python status-stream.py 3 >stream.out &
+	pid=$! &&
+	$waitfile --count=1 --timeout=30 --pattern=allocated stream.out &&
+	flux run -N2 --requires=ranks:1-2 true &&
+	wait $pid &&
+	test_debug "cat stream.out" &&
+	grep "^add 1-2" stream.out &&
+	grep "^remove 1-2" stream.out
+'
+test_expect_success 'resource-status matches sched.resource-status' '
+	wait_for_running 0 &&
+	test $(flux resource list -s allocated -no {nnodes}) -eq \
+	    $(FLUX_RESOURCE_LIST_RPC=sched.resource-status \
+		flux resource list -s allocated -no {nnodes})
+'
+
 test_done
@@ -428,6 +428,26 @@ test_expect_success 'flux job list invalid queue' '
 	test $(cat list_constraint_invalid_queue.out | wc -l) -eq 0
 '
 
+test_expect_success 'flux job list hostname jobs uses name index' '
+	before=$(flux module stats job-list | jq .index.name.queries) &&
+	constraint="{ name:[\"hostname\"] }" &&
+	jq -j -c -n  "{max_entries:1000, attrs:[], constraint:${constraint}}" \
+	  | $RPC_STREAM job-list.list | jq .jobs[].id > list_index_name.out &&
+	cat pending.ids completed.ids > list_index_name.exp &&
+	test_cmp list_index_name.exp list_index_name.out &&
+	after=$(flux module stats job-list | jq .index.name.queries) &&
+	test $after -eq $((before+1))
+'
+
+test_expect_success 'job-list stats count full scans' '
+	before=$(flux module stats job-list | jq .index.scans) &&
+	constraint="{ or: [ {name:[\"hostname\"]}, {name:[\"sleep\"]} ] }" &&
+	jq -j -c -n  "{max_entries:1000, attrs:[], constraint:${constraint}}" \
+	  | $RPC_STREAM job-list.list >/dev/null &&
+	after=$(flux module stats job-list | jq .index.scans) &&
+	test $after -eq $((before+1))
+'
+
 test_expect_success 'flux job list active (1)' '
 	state1=`${JOB_CONV} strtostate SCHED` &&
 	state2=`${JOB_CONV} strtostate RUN` &&
@@ -0,0 +1,210 @@
+#!/bin/sh
+
+test_description='Test tree-based launch of bulk-exec commands'
+
+. $(dirname $0)/sharness.sh
+
+test_under_flux 4 full -Stbon.fanout=2 -Slog-stderr-level=1
+
+bulk_exec=${FLUX_BUILD_DIR}/src/common/libsubprocess/bulk-exec
+waitfile=${SHARNESS_TEST_SRCDIR}/scripts/waitfile.lua
+
+test_expect_success 'tree-exec: bulk-exec --tree runs on all ranks' '
+	${bulk_exec} --tree flux getattr rank >tree.out 2>tree.err &&
+	test_debug "cat tree.out tree.err" &&
+	sort tree.out >tree.sorted &&
+	cat >tree.expected <<-EOF &&
+	0: 0
+	1: 1
+	2: 2
+	3: 3
+	EOF
+	test_cmp tree.expected tree.sorted &&
+	grep started tree.err &&
+	grep complete tree.err
+'
+test_expect_success 'tree-exec: bulk-exec --tree works on a subset of ranks' '
+	${bulk_exec} --tree --rank=2-3 flux getattr rank >subset.out &&
+	sort subset.out >subset.sorted &&
+	cat >subset.expected <<-EOF &&
+	2: 2
+	3: 3
+	EOF
+	test_cmp subset.expected subset.sorted
+'
+test_expect_success 'tree-exec: bulk-exec --tree works with multiple cmds' '
+	${bulk_exec} --tree --ncmds=2 flux getattr rank >ncmds.out &&
+	test $(wc -l <ncmds.out) -eq 4
+'
+test_expect_success 'tree-exec: bulk-exec --tree reports exit of all ranks' '
+	${bulk_exec} --tree sh -c "exit \$(flux getattr rank)" 2>exit.err &&
+	test_debug "cat exit.err" &&
+	grep "exited" exit.err
+'
+test_expect_success 'tree-exec: bulk-exec --tree reports each rank exited once' '
+	${bulk_exec} --tree true 2>true.err &&
+	test_debug "cat true.err" &&
+	sed -n "s/.*ranks \(.*\): exited/\1/p" true.err >true.ranks &&
+	cat >check-exited.py <<-EOF &&
+	import sys
+	from flux.idset import IDset
+	ids = IDset()
+	count = 0
+	for line in open(sys.argv[1]):
+	    count += IDset(line.strip()).count()
+	    ids += line.strip()
+	sys.exit(not (count == 4 and str(ids) == "0-3"))
+	EOF
+	flux python check-exited.py true.ranks
+'
+test_expect_success 'tree-exec: nonexistent command fails on all ranks' '
+	test_must_fail ${bulk_exec} --tree /nonexistent 2>noent.err &&
+	test_debug "cat noent.err" &&
+	grep "Failed" noent.err
+'
+test_expect_success 'tree-exec: request with rank outside of TBON fails' '
+	cat >tree-exec.py <<-EOF &&
+	import flux, sys
+	h = flux.Flux()
+	cmd = {"cmdline": ["true"], "env": {}, "cwd": "/", "opts": {},
+	       "channels": [], "flags": 0}
+	f = h.rpc("rexec.tree-exec",
+	          {"cmd": cmd, "flags": 0, "local_flags": 0, "ranks": "0-7"},
+	          flags=flux.constants.FLUX_RPC_STREAMING)
+	try:
+	    f.get()
+	except OSError as e:
+	    print(e.strerror)
+	    sys.exit(1)
+	EOF
+	test_must_fail flux python tree-exec.py >badrank.out 2>&1 &&
+	test_debug "cat badrank.out" &&
+	grep "not in this broker" badrank.out
+'
+test_expect_success 'tree-exec: tree-kill of unknown request fails' '
+	test_must_fail flux python -c "import flux; \
+	    flux.Flux().rpc(\"rexec.tree-kill\", \
+	    {\"matchtag\": 42, \"ranks\": \"0\", \"signum\": 9}).get()"
+'
+test_expect_success 'tree-exec: bulk-exec --tree can be interrupted' '
+	${bulk_exec} --tree sleep 30 >sigint.out 2>&1 &
+	pid=$! &&
+	$waitfile -t 10 -v -p started sigint.out &&
+	kill -INT $pid &&
+	wait $pid &&
+	test_debug "cat sigint.out" &&
+	grep "sending signal 2" sigint.out &&
+	grep complete sigint.out
+'
+# Usage: rexec_stats RANK KEY
+rexec_stats() {
+	flux exec -r $1 flux module stats rexec | jq -r .$2
+}
+# Usage: wait_rexec_idle RANK MATCHTAGS
+# Wait until no tree-exec requests are in progress on RANK and all
+# matchtags used to forward them to children have been freed.
+wait_rexec_idle() {
+	count=0 &&
+	while test $(rexec_stats $1 \"tree-exec\") -ne 0 \
+		|| test $(rexec_stats $1 matchtags) -ne $2; do
+		count=$((count+1)) &&
+		test $count -lt 100 &&
+		sleep 0.1 || return 1
+	done
+}
+test_expect_success 'tree-exec: interior broker frees forwarded requests' '
+	matchtags=$(rexec_stats 1 matchtags) &&
+	for i in 1 2 3 4 5; do
+		${bulk_exec} --tree --rank=1,3 true || return 1
+	done &&
+	wait_rexec_idle 1 $matchtags
+'
+test_expect_success 'tree-exec: disconnect frees forwarded requests' '
+	matchtags0=$(rexec_stats 0 matchtags) &&
+	matchtags=$(rexec_stats 1 matchtags) &&
+	${bulk_exec} --tree --rank=1,3 sleep 30 >disconnect.out 2>&1 &
+	pid=$! &&
+	$waitfile -t 10 -v -p started disconnect.out &&
+	kill -9 $pid &&
+	test_expect_code 137 wait $pid &&
+	wait_rexec_idle 0 $matchtags0 &&
+	wait_rexec_idle 1 $matchtags
+'
+test_expect_success 'job-exec: enable exec.tree-launch' '
+	flux config load <<-EOF &&
+	[exec]
+	tree-launch = true
+	EOF
+	flux module stats job-exec | jq -e ".[\"bulk-exec\"].config.tree_launch == 1"
+'
+test_expect_success 'job-exec: multi-node job works with tree-launch' '
+	flux run -N4 flux getattr rank | sort >job.out &&
+	test_debug "cat job.out" &&
+	cat >job.expected <<-EOF &&
+	0
+	1
+	2
+	3
+	EOF
+	test_cmp job.expected job.out
+'
+test_expect_success 'job-exec: job exit code is reported with tree-launch' '
+	test_expect_code 3 flux run -N4 sh -c "exit 3"
+'
+test_expect_success 'job-exec: job can be canceled with tree-launch' '
+	id=$(flux submit -N4 sleep 300) &&
+	flux job wait-event -t 30 $id start &&
+	flux cancel $id &&
+	test_must_fail flux job attach $id
+'
+test_expect_success 'job-exec: job with nonexistent command fails' '
+	test_expect_code 127 flux run -N4 /nonexistent
+'
+test_expect_success 'housekeeping: runs on all ranks with tree-launch' '
+	flux config load <<-EOF &&
+	[exec]
+	tree-launch = true
+	[job-manager.housekeeping]
+	command = ["sh", "-c", "touch $(pwd)/hk.\$(flux getattr rank)"]
+	tree-launch = true
+	release-after = "0"
+	EOF
+	flux run -N4 true &&
+	count=0 &&
+	while test $(ls hk.* 2>/dev/null | wc -l) -ne 4; do
+		count=$((count+1)) &&
+		test $count -lt 300 &&
+		sleep 0.1 || return 1
+	done &&
+	flux config load </dev/null
+'
+test_expect_success 'perilog: per-rank prolog runs with tree-launch' '
+	flux jobtap load perilog.so &&
+	flux config load <<-EOF &&
+	[job-manager.prolog]
+	command = ["sh", "-c", "touch $(pwd)/prolog.\$(flux getattr rank)"]
+	per-rank = true
+	tree-launch = true
+	EOF
+	flux jobtap query perilog.so | jq -e ".conf.prolog.tree_launch" &&
+	flux run -N4 true &&
+	test $(ls prolog.* | wc -l) -eq 4
+'
+test_expect_success 'perilog: failed prolog fails job with tree-launch' '
+	flux config load <<-EOF &&
+	[job-manager.prolog]
+	command = ["sh", "-c", "test \$(flux getattr rank) -ne 3"]
+	per-rank = true
+	tree-launch = true
+	EOF
+	test_must_fail flux run -N4 true 2>prolog-fail.err &&
+	test_debug "cat prolog-fail.err" &&
+	grep prolog prolog-fail.err &&
+	flux config load </dev/null &&
+	flux jobtap remove perilog.so &&
+	undrain_ranks=$(flux resource status -no {ranks} -s drain) &&
+	if test -n "$undrain_ranks"; then
+		flux resource undrain $undrain_ranks
+	fi
+'
+test_done
@@ -437,4 +437,85 @@ test_expect_success 'job-shell: slow shell.exit does not prevent rank 0 from exi
 	EOF
 	flux run -N4 -t 3m -o userrc=test-finish.lua true
 '
+test_expect_success 'job-shell: output.chunk.size coalesces lines' '
+	id=$(flux submit -N4 -n8 -o output.chunk.size=4k seq 1 100) &&
+	flux job attach $id >chunk.out &&
+	test $(wc -l <chunk.out) -eq 800 &&
+	flux job eventlog -p guest.output $id >chunk.eventlog &&
+	test $(grep -c "data.*\"stdout\"" chunk.eventlog) -lt 100
+'
+test_expect_success 'job-shell: attach --label-io labels each chunked line' '
+	flux job attach --label-io $id >chunk-label.out &&
+	test $(grep -c "^[0-7]: [0-9]*$" chunk-label.out) -eq 800
+'
+test_expect_success 'job-shell: output.chunk.timeout flushes partial chunks' '
+	id=$(flux submit -o output.chunk.size=1M -o output.chunk.timeout=0.1 \
+		sh -c "echo foo; sleep 300") &&
+	count=0 &&
+	until flux job eventlog -f json -p guest.output $id 2>/dev/null \
+		| grep -q "\"data\":\"foo"; do
+		count=$((count+1)) &&
+		test $count -lt 100 &&
+		sleep 0.1 || return 1
+	done &&
+	test $(flux jobs -no {state} $id) = RUN &&
+	flux cancel $id
+'
+test_expect_success 'job-shell: invalid output.chunk.size is rejected' '
+	test_must_fail flux run -o output.chunk.size=2M hostname &&
+	test_must_fail flux run -o output.chunk.size=foo hostname
+'
+test_expect_success 'job-shell: invalid output.chunk.timeout is rejected' '
+	test_must_fail flux run -o output.chunk.size=1k \
+		-o output.chunk.timeout=-1 hostname
+'
+test_expect_success 'job-shell: output.blob.size stores output in blobs' '
+	id=$(flux submit -n4 -o output.blob.size=16k seq 1 10000) &&
+	flux job attach $id >blob.out &&
+	for i in 1 2 3 4; do seq 1 10000; done | sort >blob.expected &&
+	sort blob.out >blob.sorted &&
+	test_cmp blob.expected blob.sorted &&
+	flux job eventlog -p guest.output $id >blob.eventlog &&
+	grep blobref blob.eventlog
+'
+test_expect_success 'job-shell: attach --label-io works with output blobs' '
+	flux job attach --label-io $id >blob-label.out &&
+	test $(grep -c "^[0-3]: [0-9]*$" blob-label.out) -eq 40000
+'
+test_expect_success 'job-shell: output blobs are reachable from the KVS' '
+	flux job wait-event -t 30 $id clean &&
+	flux job eventlog -f json -p guest.output $id \
+		| jq -r "select(.context.blobref) | .context.blobref" \
+		| sort -u >blobrefs.eventlog &&
+	kvsdir=$(flux job id --to=kvs $id).guest.output-blobs &&
+	for key in $(flux kvs ls -1 $kvsdir); do
+		flux kvs get --treeobj $kvsdir.$key | jq -r ".data[0]" || return 1
+	done | sort -u >blobrefs.kvs &&
+	test_debug "cat blobrefs.eventlog blobrefs.kvs" &&
+	test -s blobrefs.kvs &&
+	test_cmp blobrefs.eventlog blobrefs.kvs
+'
+test_expect_success 'job-shell: flux submit --watch reads output blobs' '
+	flux submit --watch -n4 -o output.blob.size=16k seq 1 10000 \
+		>blob-watch.out &&
+	sort blob-watch.out >blob-watch.sorted &&
+	test_cmp blob.expected blob-watch.sorted
+'
+test_expect_success 'job-shell: job_output() reads output blobs' '
+	flux python -c "import flux, sys; \
+	    from flux.job.output import job_output; \
+	    sys.stdout.write(job_output(flux.Flux(), sys.argv[1]).stdout)" \
+	    $id >blob-python.out &&
+	sort blob-python.out >blob-python.sorted &&
+	test_cmp blob.expected blob-python.sorted
+'
+test_expect_success 'job-shell: output.blob.size preserves binary data' '
+	dd if=/dev/urandom of=blob.bin bs=1k count=64 &&
+	flux run -o output.blob.size=4k cat blob.bin >blob.bin.out &&
+	test_cmp blob.bin blob.bin.out
+'
+test_expect_success 'job-shell: invalid output.blob.size is rejected' '
+	test_must_fail flux run -o output.blob.size=32M hostname &&
+	test_must_fail flux run -o output.blob.size=foo hostname
+'
 test_done
@@ -29,6 +29,44 @@ test_expect_success 'flux-shell: 2N: init and start shell events are emitted' '
 	flux job wait-event -vt 5 -p exec \
 		${id} shell.start
 '
+test_expect_success 'flux-shell: shell.init event includes startup timing' '
+	id=$(flux submit -n2 -N2 true) &&
+	flux job wait-event -t 5 -p exec -f json ${id} shell.init \
+		>init-startup.json &&
+	jq -e ".context.startup.info >= 0" <init-startup.json &&
+	jq -e ".context.startup.init >= .context.startup.info" \
+		<init-startup.json
+'
+test_expect_success 'flux-shell: shell.start event includes startup phases' '
+	id=$(flux submit -n2 -N2 true) &&
+	flux job wait-event -t 5 -p exec -f json ${id} shell.start \
+		>start-phases.json &&
+	jq -e ".context.phases.initrc >= 0" <start-phases.json &&
+	jq -e ".context.phases[\"shell.init\"] >= 0" <start-phases.json &&
+	jq -e ".context.phases[\"barrier.start\"] >= 0" <start-phases.json
+'
+test_expect_success 'flux-shell: shell.start phases include task launch' '
+	id=$(flux submit -n4 -N1 true) &&
+	flux job wait-event -t 5 -p exec -f json ${id} shell.start \
+		>launch-phases.json &&
+	jq -e ".context.phases[\"task.init\"] >= 0" <launch-phases.json &&
+	jq -e ".context.phases[\"task.spawn\"] >= 0" <launch-phases.json &&
+	jq -e ".context.phases[\"task.fork\"] >= 0" <launch-phases.json
+'
+test_expect_success 'flux-shell: tasks are started with posix_spawn' '
+	flux run -n2 -N1 -o verbose true 2>spawn.err &&
+	test_debug "cat spawn.err" &&
+	grep "starting 2 tasks with posix_spawn" spawn.err
+'
+test_expect_success 'flux-shell: tasks are started with fork with -o pty' '
+	flux run -n2 -N1 -o pty -o verbose true 2>fork.err &&
+	test_debug "cat fork.err" &&
+	grep "starting 2 tasks with fork" fork.err
+'
+test_expect_success 'flux-shell: shells log startup phases with verbose' '
+	flux run -n2 -N2 -o verbose true 2>phases.err &&
+	test $(grep -c "startup phases:" phases.err) -eq 2
+'
 test_expect_success 'flux-shell: plugin can add event context' '
 	cat >test-event.lua <<-EOT &&
 	plugin.searchpath = "${INITRC_PLUGINPATH}"
@@ -180,6 +180,49 @@ test_expect_success 'flux job purge the last remaining inactive job' '
 	test_must_fail flux job purge --force $jobid1 >id_last_one.out 2>&1 &&
 	grep "id not found" id_last_one.out
 '
+test_expect_success 'create 5 inactive jobs' '
+	flux submit --cc=1-5 true > bulk.ids &&
+	flux queue drain
+'
+test_expect_success 'flux job purge with an active id purges nothing' '
+	test_must_fail flux job purge --force \
+	    $(cat bulk.ids) $(cat active.id) >bulk_active.out 2>&1 &&
+	grep "cannot purge active job" bulk_active.out &&
+	for id in $(cat bulk.ids); do \
+	    flux job eventlog $id >/dev/null || return 1; \
+	done
+'
+test_expect_success 'flux job purge --batch=2 with 5 ids says use force' '
+	flux job purge --batch=2 $(cat bulk.ids) >bulk_no_force.out &&
+	grep "use --force to purge 5" bulk_no_force.out
+'
+test_expect_success 'flux job purge --force --batch=2 purges 5 jobs' '
+	flux job purge --force --batch=2 $(cat bulk.ids) >bulk_force.out &&
+	grep "purged 5 inactive jobs" bulk_force.out &&
+	for id in $(cat bulk.ids); do \
+	    test_must_fail flux job eventlog $id || return 1; \
+	done
+'
+test_expect_success 'flux job purge with duplicate ids counts and purges once' '
+	flux submit true >dup.id &&
+	flux queue drain &&
+	flux job purge $(cat dup.id) $(cat dup.id) >dup_no_force.out &&
+	grep "use --force to purge 1" dup_no_force.out &&
+	flux job purge --force $(cat dup.id) $(cat dup.id) >dup.out &&
+	grep "purged 1 inactive jobs" dup.out
+'
+test_expect_success 'job-manager.purge-ids rejects non-streaming request' '
+	cat >purge_ids.py <<-EOF &&
+	import flux
+	import sys
+	from flux.job import JobID
+	ids = [JobID(x) for x in sys.argv[1:]]
+	payload = {"ids": ids, "batch": 1, "force": False}
+	flux.Flux().rpc("job-manager.purge-ids", payload).get()
+	EOF
+	test_must_fail flux python purge_ids.py $(cat active.id) 2>nostream.err &&
+	grep "Protocol error" nostream.err
+'
 test_expect_success 'cleanup running job' '
 	flux cancel $(cat active.id) &&
 	flux job wait-event $(cat active.id) clean
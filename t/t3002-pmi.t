@@ -116,6 +116,18 @@ test_expect_success 'kvstest fails with -o pmi-simple.kvs=unknown' '
 test_expect_success 'kvstest -N8 works' '
 	flux run -n${SIZE} -N${SIZE} ${kvstest} -N8
 '
+test_expect_success 'kvstest works with -o pmi-simple.kvs=direct' '
+	flux run -n${SIZE} -N${SIZE} -o pmi-simple.kvs=direct ${kvstest}
+'
+test_expect_success 'kvstest -N8 works with -o pmi-simple.kvs=direct' '
+	flux run -n${SIZE} -N${SIZE} -o pmi-simple.kvs=direct ${kvstest} -N8
+'
+test_expect_success 'kvstest works with -o pmi-simple.kvs=direct on one node' '
+	flux run -n4 -N1 -o pmi-simple.kvs=direct ${kvstest}
+'
+test_expect_success 'pmi_info works with -o pmi-simple.kvs=direct' '
+	flux run -n${SIZE} -N${SIZE} -o pmi-simple.kvs=direct ${pmi_info}
+'
 
 test_expect_success 'verbose=2 shell option enables PMI server side tracing' '
 	flux run -n${SIZE} -N${SIZE} -o verbose=2 ${kvstest} 2>trace.out &&
@@ -32,6 +32,13 @@ test_expect_success 'broker overlay shows 2 connected children' '
 	test $(overlay_connected_children) -eq 2
 '
 
+test_expect_success 'overlay encodes each event once for all children' '
+	flux event pub test.mcast &&
+	flux python -c "import flux; print(flux.Flux().rpc(\"overlay.stats-get\",nodeid=0).get_str())" >mcast.json &&
+	jq -e ".mcast.count > 0" mcast.json &&
+	jq -e ".mcast[\"sent-bytes\"] > .mcast[\"encoded-bytes\"]" mcast.json
+'
+
 test_expect_success 'overlay status is full' '
 	test "$(flux overlay status --timeout=0 --summary)" = "full"
 '